@@ -42,6 +42,25 @@ public:
         return p;
     }
 
+    /// Add distortion to every point (column) of points, in place.
+    /// One virtual call per batch: models override it with a loop the compiler can vectorize.
+    virtual void addDistortionToPoints(Mat2X& points) const
+    {
+        for(Eigen::Index i = 0; i < points.cols(); ++i)
+        {
+            points.col(i) = addDistortion(points.col(i));
+        }
+    }
+
+    /// Remove distortion from every point (column) of points, in place
+    virtual void removeDistortionFromPoints(Mat2X& points) const
+    {
+        for(Eigen::Index i = 0; i < points.cols(); ++i)
+        {
+            points.col(i) = removeDistortion(points.col(i));
+        }
+    }
+
     virtual double getUndistortedRadius(double r) const
     {
         return r;
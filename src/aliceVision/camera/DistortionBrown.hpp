@@ -42,7 +42,7 @@ public:
         const double epsilon = 1e-8; // criteria to stop the iteration
         Vec2 p_u = p;
 
-        while((addDistortion(p_u) - p).lpNorm<1>() > epsilon) // manhattan distance between the two points
+        while((p_u + distoFunction(_distortionParams, p_u) - p).lpNorm<1>() > epsilon) // manhattan distance between the two points
         {
             p_u = p - distoFunction(_distortionParams, p_u);
         }
@@ -50,6 +50,33 @@ public:
         return p_u;
     }
 
+    void addDistortionToPoints(Mat2X& points) const override
+    {
+        const double k1 = _distortionParams[0], k2 = _distortionParams[1], k3 = _distortionParams[2];
+        const double t1 = _distortionParams[3], t2 = _distortionParams[4];
+
+        // Same operations as distoFunction, without any call per point
+        for(Eigen::Index i = 0; i < points.cols(); ++i)
+        {
+            const double x = points(0, i);
+            const double y = points(1, i);
+            const double r2 = x * x + y * y;
+            const double r4 = r2 * r2;
+            const double r6 = r4 * r2;
+            const double k_diff = (k1 * r2 + k2 * r4 + k3 * r6);
+            points(0, i) = x + (x * k_diff + (t2 * (r2 + 2 * x * x) + 2 * t1 * x * y));
+            points(1, i) = y + (y * k_diff + (t1 * (r2 + 2 * y * y) + 2 * t2 * x * y));
+        }
+    }
+
+    void removeDistortionFromPoints(Mat2X& points) const override
+    {
+        for(Eigen::Index i = 0; i < points.cols(); ++i)
+        {
+            points.col(i) = DistortionBrown::removeDistortion(points.col(i));
+        }
+    }
+
     // Functor to calculate distortion offset accounting for both radial and tangential distortion
     static Vec2 distoFunction(const std::vector<double>& params, const Vec2& p)
     {
@@ -84,6 +84,27 @@ public:
     return (p * r_coeff);
   }
 
+  void addDistortionToPoints(Mat2X& points) const override
+  {
+    const double k1 = _distortionParams.at(0);
+
+    for(Eigen::Index i = 0; i < points.cols(); ++i)
+    {
+      const double r2 = points(0, i) * points(0, i) + points(1, i) * points(1, i);
+      const double r_coeff = (1. + k1 * r2);
+      points(0, i) *= r_coeff;
+      points(1, i) *= r_coeff;
+    }
+  }
+
+  void removeDistortionFromPoints(Mat2X& points) const override
+  {
+    for(Eigen::Index i = 0; i < points.cols(); ++i)
+    {
+      points.col(i) = DistortionRadialK1::removeDistortion(points.col(i));
+    }
+  }
+
   Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2 & p) const override
   {
 
@@ -244,6 +265,33 @@ public:
     return (p * r_coeff);
   }
 
+  void addDistortionToPoints(Mat2X& points) const override
+  {
+    const double k1 = _distortionParams[0];
+    const double k2 = _distortionParams[1];
+    const double k3 = _distortionParams[2];
+
+    for(Eigen::Index i = 0; i < points.cols(); ++i)
+    {
+      const double r = sqrt(points(0, i) * points(0, i) + points(1, i) * points(1, i));
+
+      const double r2 = r * r;
+      const double r4 = r2 * r2;
+      const double r6 = r4 * r2;
+      const double r_coeff = (1. + k1 * r2 + k2 * r4 + k3 * r6);
+      points(0, i) *= r_coeff;
+      points(1, i) *= r_coeff;
+    }
+  }
+
+  void removeDistortionFromPoints(Mat2X& points) const override
+  {
+    for(Eigen::Index i = 0; i < points.cols(); ++i)
+    {
+      points.col(i) = DistortionRadialK3::removeDistortion(points.col(i));
+    }
+  }
+
   Eigen::Matrix2d getDerivativeAddDistoWrtPt(const Vec2 & p) const override
   {
 
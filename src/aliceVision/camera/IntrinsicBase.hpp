@@ -139,6 +139,40 @@ public:
    */
   virtual Vec2 project(const geometry::Pose3& pose, const Vec4& pt3D, bool applyDistortion = true) const = 0;
 
+  /**
+   * @brief Projection of a batch of 3D points into the camera plane (Apply pose, disto (if any) and Intrinsics)
+   *        Same result as project() on each point, with a single virtual call for the whole batch.
+   * @param[in] pose The pose
+   * @param[in] pts3D The 3d points (one per column)
+   * @param[out] pts2D The 2d projections in the camera plane (one per column)
+   * @param[in] applyDistortion If true apply distrortion if any
+   */
+  virtual void projectPoints(const geometry::Pose3& pose, const Mat3X& pts3D, Mat2X& pts2D, bool applyDistortion = true) const
+  {
+    pts2D.resize(2, pts3D.cols());
+    for(Eigen::Index i = 0; i < pts3D.cols(); ++i)
+    {
+      pts2D.col(i) = project(pose, pts3D.col(i).homogeneous(), applyDistortion);
+    }
+  }
+
+  /**
+   * @brief Back-projection of a batch of 2D points on the unit sphere, in the camera frame
+   *        Same result as backproject() with the identity pose and a unit depth on each point.
+   * @param[in] pts2D The 2d points (one per column)
+   * @param[out] rays The unit bearing vectors (one per column)
+   * @param[in] applyUndistortion If true remove the distortion if any
+   */
+  virtual void backprojectPoints(const Mat2X& pts2D, Mat3X& rays, bool applyUndistortion = true) const
+  {
+    rays.resize(3, pts2D.cols());
+    for(Eigen::Index i = 0; i < pts2D.cols(); ++i)
+    {
+      const Vec2 pt2D_cam = ima2cam(pts2D.col(i));
+      rays.col(i) = toUnitSphere(applyUndistortion ? removeDistortion(pt2D_cam) : pt2D_cam);
+    }
+  }
+
   /**
    * @brief Back-projection of a 2D point at a specific depth into a 3D point
    * @param[in] pt2D The 2d point
@@ -233,13 +267,9 @@ public:
   inline Mat2X residuals(const geometry::Pose3& pose, const Mat3X& X, const Mat2X& x) const
   {
     assert(X.cols() == x.cols());
-    const std::size_t numPts = x.cols();
-    Mat2X residuals = Mat2X::Zero(2, numPts);
-    for(std::size_t i = 0; i < numPts; ++i)
-    {
-      residuals.col(i) = residual(pose, ((const Vec3&)X.col(i)).homogeneous(), x.col(i));
-    }
-    return residuals;
+    Mat2X proj;
+    projectPoints(pose, X, proj);
+    return x - proj;
   }
 
   /**
@@ -417,6 +447,34 @@ public:
    */
   virtual Vec2 get_d_pixel(const Vec2& p) const = 0;
 
+  /**
+   * @brief Get the un-distorted pixels of a batch of distorted pixels (one per column)
+   * @param[in] p The distorted pixels
+   * @param[out] ud The un-distorted pixels
+   */
+  virtual void get_ud_pixels(const Mat2X& p, Mat2X& ud) const
+  {
+    ud.resize(2, p.cols());
+    for(Eigen::Index i = 0; i < p.cols(); ++i)
+    {
+      ud.col(i) = get_ud_pixel(p.col(i));
+    }
+  }
+
+  /**
+   * @brief Get the distorted pixels of a batch of un-distorted pixels (one per column)
+   * @param[in] p The un-distorted pixels
+   * @param[out] d The distorted pixels
+   */
+  virtual void get_d_pixels(const Mat2X& p, Mat2X& d) const
+  {
+    d.resize(2, p.cols());
+    for(Eigen::Index i = 0; i < p.cols(); ++i)
+    {
+      d.col(i) = get_d_pixel(p.col(i));
+    }
+  }
+
   /**
    * @brief Normalize a given unit pixel error to the camera plane
    * @param[in] value Given unit pixel error
@@ -246,6 +246,22 @@ public:
   }
 
 protected:
+  /// cam2ima of this model on a batch of points (one per column), in place
+  void cam2imaPoints(Mat2X& points) const
+  {
+    const Vec2 pp = getPrincipalPoint();
+    points.row(0) = points.row(0).array() * _scale(0) + pp(0);
+    points.row(1) = points.row(1).array() * _scale(1) + pp(1);
+  }
+
+  /// ima2cam of this model on a batch of points (one per column), in place
+  void ima2camPoints(Mat2X& points) const
+  {
+    const Vec2 pp = getPrincipalPoint();
+    points.row(0) = (points.row(0).array() - pp(0)) / _scale(0);
+    points.row(1) = (points.row(1).array() - pp(1)) / _scale(1);
+  }
+
   Vec2 _scale{1.0, 1.0};
   Vec2 _offset{0.0, 0.0};
   Vec2 _initialScale{-1.0, -1.0};
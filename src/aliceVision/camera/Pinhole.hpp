@@ -109,6 +109,47 @@ public:
     return impt;
   }
 
+  void projectPoints(const geometry::Pose3& pose, const Mat3X& pts3D, Mat2X& pts2D, bool applyDistortion = true) const override
+  {
+    const Mat3X X = (pose.rotation() * pts3D).colwise() + pose.translation(); // apply pose
+    pts2D = X.topRows<2>().array().rowwise() / X.row(2).array();
+
+    if(_pDistortion)
+      _pDistortion->addDistortionToPoints(pts2D);
+    cam2imaPoints(pts2D);
+  }
+
+  void backprojectPoints(const Mat2X& pts2D, Mat3X& rays, bool applyUndistortion = true) const override
+  {
+    Mat2X pts = pts2D;
+    ima2camPoints(pts);
+    if(applyUndistortion && _pDistortion)
+      _pDistortion->removeDistortionFromPoints(pts);
+
+    rays.resize(3, pts.cols());
+    rays.topRows<2>() = pts;
+    rays.row(2).setOnes();
+    rays.colwise().normalize();
+  }
+
+  void get_ud_pixels(const Mat2X& p, Mat2X& ud) const override
+  {
+    ud = p;
+    ima2camPoints(ud);
+    if(_pDistortion)
+      _pDistortion->removeDistortionFromPoints(ud);
+    cam2imaPoints(ud);
+  }
+
+  void get_d_pixels(const Mat2X& p, Mat2X& d) const override
+  {
+    d = p;
+    ima2camPoints(d);
+    if(_pDistortion)
+      _pDistortion->addDistortionToPoints(d);
+    cam2imaPoints(d);
+  }
+
   Eigen::Matrix<double, 2, 9> getDerivativeProjectWrtRotation(const geometry::Pose3& pose, const Vec4 & pt)
   {
     const Vec4 X = pose.getHomogeneous() * pt; // apply pose
@@ -0,0 +1,271 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/numeric/numeric.hpp>
+#include <aliceVision/camera/IntrinsicBase.hpp>
+#include <aliceVision/image/io.hpp>
+
+#include <algorithm>
+#include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aliceVision {
+namespace camera {
+
+/**
+ * @brief Remap table from the undistorted image domain to the distorted one.
+ *
+ * The distorted coordinates only depend on the intrinsic and on the output domain,
+ * so the table is computed once and reused for every image sharing the same intrinsic.
+ * With a step greater than 1, only a coarse grid is stored and the coordinates
+ * of the pixels in between are bilinearly interpolated.
+ */
+class UndistortionMap
+{
+public:
+  /**
+   * @brief Compute the remap table
+   * @param[in] intrinsic camera model
+   * @param[in] width of the distorted images
+   * @param[in] height of the distorted images
+   * @param[in] ppCorrection offset added to the undistorted coordinates
+   * @param[in] roi output domain in the undistorted image (whole image if undefined)
+   * @param[in] step spacing in pixels of the stored grid (1 for an exact table)
+   */
+  UndistortionMap(const IntrinsicBase& intrinsic,
+                  int width, int height,
+                  const Vec2& ppCorrection = Vec2(0.0, 0.0),
+                  const oiio::ROI& roi = oiio::ROI(),
+                  int step = 1)
+    : _width(width)
+    , _height(height)
+    , _step(std::max(step, 1))
+  {
+    _widthRoi = width;
+    _heightRoi = height;
+    int xOffset = 0;
+    int yOffset = 0;
+    if(roi.defined())
+    {
+      _widthRoi = roi.width();
+      _heightRoi = roi.height();
+      xOffset = roi.xbegin;
+      yOffset = roi.ybegin;
+    }
+
+    // the grid covers the last pixel, so that the interpolation never extrapolates
+    _gridWidth = (_widthRoi - 1) / _step + 2;
+    _gridHeight = (_heightRoi - 1) / _step + 2;
+    _grid.resize(2 * std::size_t(_gridWidth) * _gridHeight);
+
+    #pragma omp parallel
+    {
+      Mat2X undistoPix(2, _gridWidth);
+      Mat2X distoPix;
+
+      #pragma omp for
+      for(int j = 0; j < _gridHeight; ++j)
+      {
+        for(int i = 0; i < _gridWidth; ++i)
+        {
+          undistoPix.col(i) = Vec2(i * _step + xOffset, j * _step + yOffset) + ppCorrection;
+        }
+
+        intrinsic.get_d_pixels(undistoPix, distoPix);
+
+        float* gridRow = &_grid[2 * std::size_t(j) * _gridWidth];
+        for(int i = 0; i < _gridWidth; ++i)
+        {
+          gridRow[2 * i] = static_cast<float>(distoPix(0, i));
+          gridRow[2 * i + 1] = static_cast<float>(distoPix(1, i));
+        }
+      }
+    }
+  }
+
+  int width() const { return _width; }
+  int height() const { return _height; }
+  int widthRoi() const { return _widthRoi; }
+  int heightRoi() const { return _heightRoi; }
+  int step() const { return _step; }
+
+  /// Memory used by the table in bytes
+  std::size_t memorySize() const { return _grid.size() * sizeof(float); }
+
+  /**
+   * @brief Distorted coordinates of a row of the output domain
+   * @param[in] row in the output domain
+   * @param[out] coordinates interleaved (x, y) distorted coordinates, 2 * widthRoi() values
+   */
+  void getRow(int row, float* coordinates) const
+  {
+    const int gy = row / _step;
+    const float* gridRow = &_grid[2 * std::size_t(gy) * _gridWidth];
+
+    if(_step == 1)
+    {
+      std::copy(gridRow, gridRow + 2 * _widthRoi, coordinates);
+      return;
+    }
+
+    const float* gridNextRow = gridRow + 2 * _gridWidth;
+    const float invStep = 1.0f / _step;
+    const float fy = (row - gy * _step) * invStep;
+
+    for(int gx = 0; gx * _step < _widthRoi; ++gx)
+    {
+      // interpolate vertically the two grid columns around this span
+      const float x0 = gridRow[2 * gx] + fy * (gridNextRow[2 * gx] - gridRow[2 * gx]);
+      const float y0 = gridRow[2 * gx + 1] + fy * (gridNextRow[2 * gx + 1] - gridRow[2 * gx + 1]);
+      const float x1 = gridRow[2 * gx + 2] + fy * (gridNextRow[2 * gx + 2] - gridRow[2 * gx + 2]);
+      const float y1 = gridRow[2 * gx + 3] + fy * (gridNextRow[2 * gx + 3] - gridRow[2 * gx + 3]);
+
+      const int end = std::min(_step, _widthRoi - gx * _step);
+      float* out = coordinates + 2 * gx * _step;
+      for(int k = 0; k < end; ++k)
+      {
+        const float fx = k * invStep;
+        out[2 * k] = x0 + fx * (x1 - x0);
+        out[2 * k + 1] = y0 + fx * (y1 - y0);
+      }
+    }
+  }
+
+private:
+  int _width;
+  int _height;
+  int _widthRoi;
+  int _heightRoi;
+  int _step;
+  int _gridWidth;
+  int _gridHeight;
+  /// Interleaved (x, y) distorted coordinates, row major
+  std::vector<float> _grid;
+};
+
+/**
+ * @brief Thread safe cache of undistortion maps.
+ *
+ * Maps are identified by the intrinsic type, size and parameters, the image size, the principal point correction,
+ * the ROI and the step. The least recently used maps are released when they use more than maxMemorySize bytes.
+ */
+class UndistortionMapCache
+{
+public:
+  explicit UndistortionMapCache(std::size_t maxMemorySize = std::size_t(1024) * 1024 * 1024)
+    : _maxMemorySize(maxMemorySize)
+  {}
+
+  /**
+   * @brief Get the map for the given intrinsic and domain, computing it if needed
+   */
+  std::shared_ptr<const UndistortionMap> get(const IntrinsicBase& intrinsic,
+                                             int width, int height,
+                                             const Vec2& ppCorrection = Vec2(0.0, 0.0),
+                                             const oiio::ROI& roi = oiio::ROI(),
+                                             int step = 1)
+  {
+    Key key;
+    key.type = intrinsic.getType();
+    key.intrinsicWidth = intrinsic.w();
+    key.intrinsicHeight = intrinsic.h();
+    key.params = intrinsic.getParams();
+    key.width = width;
+    key.height = height;
+    key.ppCorrection = {ppCorrection(0), ppCorrection(1)};
+    if(roi.defined())
+      key.roi = {roi.xbegin, roi.xend, roi.ybegin, roi.yend};
+    key.step = step;
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto it = find(key);
+      if(it != _maps.end())
+      {
+        // move to the most recently used position
+        _maps.splice(_maps.begin(), _maps, it);
+        return _maps.front().second;
+      }
+    }
+
+    // compute outside of the lock, other intrinsics remain available meanwhile
+    auto map = std::make_shared<const UndistortionMap>(intrinsic, width, height, ppCorrection, roi, step);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = find(key);
+    if(it != _maps.end())
+    {
+      // computed concurrently by another thread
+      _maps.splice(_maps.begin(), _maps, it);
+      return _maps.front().second;
+    }
+
+    _maps.emplace_front(std::move(key), map);
+    _memorySize += map->memorySize();
+    while(_memorySize > _maxMemorySize && !_maps.empty())
+    {
+      _memorySize -= _maps.back().second->memorySize();
+      _maps.pop_back();
+    }
+
+    return map;
+  }
+
+  std::size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _maps.size();
+  }
+
+  /// Memory used by the cached maps in bytes
+  std::size_t memorySize() const
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _memorySize;
+  }
+
+private:
+  struct Key
+  {
+    EINTRINSIC type;
+    unsigned int intrinsicWidth;
+    unsigned int intrinsicHeight;
+    std::vector<double> params;
+    int width;
+    int height;
+    std::array<double, 2> ppCorrection;
+    /// xbegin, xend, ybegin, yend (empty if the ROI is undefined)
+    std::vector<int> roi;
+    int step;
+
+    bool operator==(const Key& other) const
+    {
+      return type == other.type && intrinsicWidth == other.intrinsicWidth && intrinsicHeight == other.intrinsicHeight &&
+             params == other.params && width == other.width && height == other.height &&
+             ppCorrection == other.ppCorrection && roi == other.roi && step == other.step;
+    }
+  };
+
+  using Entry = std::pair<Key, std::shared_ptr<const UndistortionMap>>;
+
+  std::list<Entry>::iterator find(const Key& key)
+  {
+    return std::find_if(_maps.begin(), _maps.end(), [&key](const Entry& entry) { return entry.first == key; });
+  }
+
+  std::size_t _maxMemorySize;
+  std::size_t _memorySize{0};
+  mutable std::mutex _mutex;
+  std::list<Entry> _maps;
+};
+
+} // namespace camera
+} // namespace aliceVision
@@ -0,0 +1,136 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#define BOOST_TEST_MODULE cameraBatch
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+#include <aliceVision/unitTest.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+
+namespace {
+
+/// Camera models with a non null distortion
+std::vector<std::pair<EINTRINSIC, std::vector<double>>> distortedModels()
+{
+  return {
+    {EINTRINSIC::PINHOLE_CAMERA, {}},
+    {EINTRINSIC::PINHOLE_CAMERA_RADIAL1, {0.1}},
+    {EINTRINSIC::PINHOLE_CAMERA_RADIAL3, {0.1, -0.05, 0.01}},
+    {EINTRINSIC::PINHOLE_CAMERA_BROWN, {0.1, -0.05, 0.01, 0.001, -0.002}},
+    {EINTRINSIC::PINHOLE_CAMERA_FISHEYE, {0.1, -0.05, 0.01, 0.002}},
+    {EINTRINSIC::PINHOLE_CAMERA_FISHEYE1, {0.3}},
+    {EINTRINSIC::EQUIDISTANT_CAMERA, {}},
+    {EINTRINSIC::EQUIDISTANT_CAMERA_RADIAL3, {0.1, -0.05, 0.01}},
+  };
+}
+
+std::shared_ptr<IntrinsicBase> createDistortedIntrinsic(EINTRINSIC type, const std::vector<double>& distortionParams)
+{
+  std::shared_ptr<IntrinsicBase> intrinsic = createIntrinsic(type, 1000, 800, 900.0, 900.0, 10.0, -5.0);
+  if(!distortionParams.empty())
+    std::dynamic_pointer_cast<IntrinsicsScaleOffsetDisto>(intrinsic)->setDistortionParams(distortionParams);
+  return intrinsic;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(cameraBatch_sameAsPerPoint)
+{
+  makeRandomOperationsReproducible();
+
+  const int nbPoints = 500;
+  const geometry::Pose3 pose(geometry::randomPose());
+
+  // pixels inside the image and 3D points in front of the camera
+  const Mat2X pixels = ((Mat2X::Random(2, nbPoints).array() + 1.0).colwise() * Vec2(500.0, 400.0).array()).matrix();
+  Mat3X pts3D(3, nbPoints);
+  for(int i = 0; i < nbPoints; ++i)
+  {
+    const Vec3 ray(pixels(0, i) / 1000.0 - 0.5, pixels(1, i) / 800.0 - 0.5, 1.0);
+    pts3D.col(i) = pose.inverse()(ray * (2.0 + i % 7));
+  }
+
+  for(const auto& model : distortedModels())
+  {
+    BOOST_TEST_CONTEXT(EINTRINSIC_enumToString(model.first))
+    {
+      const std::shared_ptr<IntrinsicBase> intrinsic = createDistortedIntrinsic(model.first, model.second);
+
+      Mat2X projected;
+      intrinsic->projectPoints(pose, pts3D, projected);
+      Mat3X rays;
+      intrinsic->backprojectPoints(pixels, rays);
+      Mat2X distorted, undistorted;
+      intrinsic->get_d_pixels(pixels, distorted);
+      intrinsic->get_ud_pixels(pixels, undistorted);
+
+      BOOST_REQUIRE_EQUAL(projected.cols(), nbPoints);
+      BOOST_REQUIRE_EQUAL(rays.cols(), nbPoints);
+      BOOST_REQUIRE_EQUAL(distorted.cols(), nbPoints);
+      BOOST_REQUIRE_EQUAL(undistorted.cols(), nbPoints);
+
+      for(int i = 0; i < nbPoints; ++i)
+      {
+        EXPECT_MATRIX_NEAR(intrinsic->project(pose, pts3D.col(i).homogeneous()), projected.col(i), 1e-8);
+        EXPECT_MATRIX_NEAR(intrinsic->backproject(pixels.col(i)).normalized(), rays.col(i), 1e-10);
+        EXPECT_MATRIX_NEAR(intrinsic->get_d_pixel(pixels.col(i)), distorted.col(i), 1e-8);
+        EXPECT_MATRIX_NEAR(intrinsic->get_ud_pixel(pixels.col(i)), undistorted.col(i), 1e-8);
+      }
+
+      // residuals is computed with the batch projection
+      const Mat2X residuals = intrinsic->residuals(pose, pts3D, projected);
+      BOOST_CHECK_SMALL(residuals.cwiseAbs().maxCoeff(), 1e-8);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cameraBatch_timing)
+{
+  makeRandomOperationsReproducible();
+
+  const int nbPoints = 200000;
+  const geometry::Pose3 pose(geometry::randomPose());
+  Mat3X pts3D = Mat3X::Random(3, nbPoints);
+  pts3D.row(2).array() += 3.0;
+  for(int i = 0; i < nbPoints; ++i)
+    pts3D.col(i) = pose.inverse()(Vec3(pts3D.col(i)));
+  const Mat2X pixels = ((Mat2X::Random(2, nbPoints).array() + 1.0).colwise() * Vec2(500.0, 400.0).array()).matrix();
+
+  for(const auto& model : distortedModels())
+  {
+    const std::shared_ptr<IntrinsicBase> intrinsic = createDistortedIntrinsic(model.first, model.second);
+    Mat2X projected(2, nbPoints), distorted(2, nbPoints);
+
+    system::Timer timer;
+    for(int i = 0; i < nbPoints; ++i)
+      projected.col(i) = intrinsic->project(pose, pts3D.col(i).homogeneous());
+    const double projectMs = timer.elapsedMs();
+
+    timer.reset();
+    intrinsic->projectPoints(pose, pts3D, projected);
+    const double projectPointsMs = timer.elapsedMs();
+
+    timer.reset();
+    for(int i = 0; i < nbPoints; ++i)
+      distorted.col(i) = intrinsic->get_d_pixel(pixels.col(i));
+    const double distortMs = timer.elapsedMs();
+
+    timer.reset();
+    intrinsic->get_d_pixels(pixels, distorted);
+    const double distortPointsMs = timer.elapsedMs();
+
+    ALICEVISION_LOG_INFO(EINTRINSIC_enumToString(model.first) << ": "
+                         << "project " << projectMs << " ms, projectPoints " << projectPointsMs << " ms, "
+                         << "get_d_pixel " << distortMs << " ms, get_d_pixels " << distortPointsMs << " ms");
+  }
+}
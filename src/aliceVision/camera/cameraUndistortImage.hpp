@@ -14,13 +14,27 @@
 #include <aliceVision/camera/cameraCommon.hpp>
 #include <aliceVision/camera/IntrinsicBase.hpp>
 #include <aliceVision/camera/Pinhole.hpp>
+#include <aliceVision/camera/UndistortionMap.hpp>
 #include <aliceVision/image/io.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace aliceVision {
 namespace camera {
 
+/// Offset of the principal point from the image center, if requested and available
+inline Vec2 getPrincipalPointCorrection(const camera::IntrinsicBase* intrinsicPtr, int width, int height, bool correctPrincipalPoint)
+{
+  if(correctPrincipalPoint && camera::isPinhole(intrinsicPtr->getType()))
+  {
+    const Vec2 center(width * 0.5, height * 0.5);
+    const camera::Pinhole* pinholePtr = dynamic_cast<const camera::Pinhole*>(intrinsicPtr);
+    return pinholePtr->getPrincipalPoint() - center;
+  }
+  return Vec2(0.0, 0.0);
+}
+
 /// Undistort an image according a given camera and its distortion model
 template <typename T>
 void UndistortImage(
@@ -37,18 +51,8 @@ void UndistortImage(
   }
   else // There is distortion
   {
-    const Vec2 center(imageIn.Width() * 0.5, imageIn.Height() * 0.5);
-    Vec2 ppCorrection(0.0, 0.0);
+    const Vec2 ppCorrection = getPrincipalPointCorrection(intrinsicPtr, imageIn.Width(), imageIn.Height(), correctPrincipalPoint);
 
-    if(correctPrincipalPoint)
-    {
-      if(camera::isPinhole(intrinsicPtr->getType()))
-      {
-        const camera::Pinhole* pinholePtr = dynamic_cast<const camera::Pinhole*>(intrinsicPtr);
-        ppCorrection = pinholePtr->getPrincipalPoint() - center;
-      }
-    }
-    
     int widthRoi = imageIn.Width();
     int heightRoi = imageIn.Height();
     int xOffset = 0;
@@ -65,21 +69,96 @@ void UndistortImage(
     const image::Sampler2d<image::SamplerLinear> sampler;
     
     
-    #pragma omp parallel for
-    for(int j = 0; j < heightRoi; ++j)
-        for(int i = 0; i < widthRoi; ++i)
-        {       
-            const Vec2 undisto_pix(i + xOffset, j + yOffset); 
-            // compute coordinates with distortion
-            const Vec2 disto_pix = intrinsicPtr->get_d_pixel(undisto_pix + ppCorrection);
-           
-            // pick pixel if it is in the image domain
-            if(imageIn.Contains(disto_pix(1), disto_pix(0)))
-                image_ud(j, i) = sampler(imageIn, disto_pix(1), disto_pix(0));
+    #pragma omp parallel
+    {
+        Mat2X undisto_pix(2, widthRoi);
+        Mat2X disto_pix;
+
+        #pragma omp for
+        for(int j = 0; j < heightRoi; ++j)
+        {
+            for(int i = 0; i < widthRoi; ++i)
+            {
+                undisto_pix.col(i) = Vec2(i + xOffset, j + yOffset) + ppCorrection;
+            }
+
+            // compute coordinates with distortion, for the whole row at once
+            intrinsicPtr->get_d_pixels(undisto_pix, disto_pix);
+
+            for(int i = 0; i < widthRoi; ++i)
+            {
+                // pick pixel if it is in the image domain
+                if(imageIn.Contains(disto_pix(1, i), disto_pix(0, i)))
+                    image_ud(j, i) = sampler(imageIn, disto_pix(1, i), disto_pix(0, i));
+            }
         }
+    }
   }
 }
 
+/// Undistort an image with a precomputed undistortion map
+template <typename T>
+void UndistortImage(
+  const image::Image<T>& imageIn,
+  const UndistortionMap& map,
+  image::Image<T>& image_ud,
+  T fillcolor)
+{
+  assert(imageIn.Width() == map.width() && imageIn.Height() == map.height());
+
+  const int widthRoi = map.widthRoi();
+  const int heightRoi = map.heightRoi();
+
+  image_ud.resize(widthRoi, heightRoi, true, fillcolor);
+  const image::Sampler2d<image::SamplerLinear> sampler;
+
+  #pragma omp parallel
+  {
+    std::vector<float> disto_pix(2 * widthRoi);
+
+    #pragma omp for
+    for(int j = 0; j < heightRoi; ++j)
+    {
+      map.getRow(j, disto_pix.data());
+
+      for(int i = 0; i < widthRoi; ++i)
+      {
+        const float x = disto_pix[2 * i];
+        const float y = disto_pix[2 * i + 1];
+
+        // pick pixel if it is in the image domain
+        if(imageIn.Contains(y, x))
+          image_ud(j, i) = sampler(imageIn, y, x);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Undistort an image, reusing the undistortion map of the cache
+ *        shared by all the images of the same intrinsic.
+ */
+template <typename T>
+void UndistortImage(
+  const image::Image<T>& imageIn,
+  const camera::IntrinsicBase* intrinsicPtr,
+  UndistortionMapCache& cache,
+  image::Image<T>& image_ud,
+  T fillcolor,
+  bool correctPrincipalPoint = false,
+  const oiio::ROI & roi = oiio::ROI())
+{
+  if (!intrinsicPtr->hasDistortion()) // no distortion, perform a direct copy
+  {
+    image_ud = imageIn;
+    return;
+  }
+
+  const Vec2 ppCorrection = getPrincipalPointCorrection(intrinsicPtr, imageIn.Width(), imageIn.Height(), correctPrincipalPoint);
+  const std::shared_ptr<const UndistortionMap> map = cache.get(*intrinsicPtr, imageIn.Width(), imageIn.Height(), ppCorrection, roi);
+  UndistortImage(imageIn, *map, image_ud, fillcolor);
+}
+
 } // namespace camera
 } // namespace aliceVision
 
@@ -0,0 +1,188 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/camera/camera.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <cmath>
+#include <random>
+
+#define BOOST_TEST_MODULE undistortionMap
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::camera;
+
+namespace {
+
+std::shared_ptr<IntrinsicBase> createBrownIntrinsic(int width, int height, double k1)
+{
+  std::shared_ptr<IntrinsicBase> intrinsic = createIntrinsic(EINTRINSIC::PINHOLE_CAMERA_BROWN, width, height, 0.9 * width, 0.9 * width, 3.0, -2.0);
+  std::dynamic_pointer_cast<IntrinsicsScaleOffsetDisto>(intrinsic)->setDistortionParams({k1, -0.05, 0.01, 0.001, -0.002});
+  return intrinsic;
+}
+
+image::Image<float> randomImage(int width, int height)
+{
+  std::default_random_engine generator;
+  std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+  image::Image<float> image(width, height);
+  for(int y = 0; y < height; ++y)
+    for(int x = 0; x < width; ++x)
+      image(y, x) = distribution(generator);
+  return image;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(undistortionMap_sameAsDirect)
+{
+  const int width = 320;
+  const int height = 240;
+  const std::shared_ptr<IntrinsicBase> intrinsic = createBrownIntrinsic(width, height, 0.1);
+  const image::Image<float> image = randomImage(width, height);
+
+  for(const bool correctPrincipalPoint : {false, true})
+  {
+    for(const oiio::ROI& roi : {oiio::ROI(), oiio::ROI(20, 300, 10, 200)})
+    {
+      image::Image<float> expected;
+      UndistortImage(image, intrinsic.get(), expected, -1.0f, correctPrincipalPoint, roi);
+
+      UndistortionMapCache cache;
+      image::Image<float> undistorted;
+      UndistortImage(image, intrinsic.get(), cache, undistorted, -1.0f, correctPrincipalPoint, roi);
+
+      BOOST_REQUIRE_EQUAL(undistorted.Width(), expected.Width());
+      BOOST_REQUIRE_EQUAL(undistorted.Height(), expected.Height());
+
+      // the map stores the coordinates in float, as the sampler uses them
+      for(int y = 0; y < expected.Height(); ++y)
+        for(int x = 0; x < expected.Width(); ++x)
+          BOOST_CHECK_EQUAL(undistorted(y, x), expected(y, x));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(undistortionMap_coarseGrid)
+{
+  const int width = 320;
+  const int height = 240;
+  const std::shared_ptr<IntrinsicBase> intrinsic = createBrownIntrinsic(width, height, 0.1);
+
+  const UndistortionMap exact(*intrinsic, width, height);
+  const UndistortionMap coarse(*intrinsic, width, height, Vec2(0.0, 0.0), oiio::ROI(), 8);
+
+  BOOST_CHECK(coarse.memorySize() * 32 < exact.memorySize());
+
+  std::vector<float> exactRow(2 * width);
+  std::vector<float> coarseRow(2 * width);
+  float maxError = 0.0f;
+  for(int y = 0; y < height; ++y)
+  {
+    exact.getRow(y, exactRow.data());
+    coarse.getRow(y, coarseRow.data());
+    for(int i = 0; i < 2 * width; ++i)
+      maxError = std::max(maxError, std::abs(exactRow[i] - coarseRow[i]));
+  }
+
+  // the distortion is smooth, the interpolation error stays far below a pixel
+  BOOST_CHECK_SMALL(maxError, 0.05f);
+
+  // grid nodes are exact
+  exact.getRow(16, exactRow.data());
+  coarse.getRow(16, coarseRow.data());
+  for(int x = 0; x < width; x += 8)
+  {
+    BOOST_CHECK_EQUAL(coarseRow[2 * x], exactRow[2 * x]);
+    BOOST_CHECK_EQUAL(coarseRow[2 * x + 1], exactRow[2 * x + 1]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(undistortionMap_cache)
+{
+  const std::shared_ptr<IntrinsicBase> first = createBrownIntrinsic(320, 240, 0.1);
+  const std::shared_ptr<IntrinsicBase> firstCopy = createBrownIntrinsic(320, 240, 0.1);
+  const std::shared_ptr<IntrinsicBase> second = createBrownIntrinsic(320, 240, 0.2);
+  const std::shared_ptr<IntrinsicBase> third = createBrownIntrinsic(320, 240, 0.3);
+
+  // room for two maps of the whole image
+  const std::size_t mapMemorySize = UndistortionMap(*first, 320, 240).memorySize();
+  UndistortionMapCache cache(2 * mapMemorySize);
+
+  // same parameters, same map
+  const auto map = cache.get(*first, 320, 240);
+  BOOST_CHECK(cache.get(*firstCopy, 320, 240) == map);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  BOOST_CHECK_EQUAL(cache.memorySize(), mapMemorySize);
+
+  // another domain or another intrinsic needs another map
+  BOOST_CHECK(cache.get(*first, 320, 240, Vec2(0.0, 0.0), oiio::ROI(0, 100, 0, 100)) != map);
+  BOOST_CHECK(cache.get(*second, 320, 240) != map);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+
+  // the least recently used maps are released, but remain valid for their users
+  cache.get(*third, 320, 240);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK_LE(cache.memorySize(), 2 * mapMemorySize);
+  BOOST_CHECK(cache.get(*first, 320, 240) != map);
+  BOOST_CHECK_EQUAL(map->width(), 320);
+
+  // a map larger than the budget is not kept
+  UndistortionMapCache smallCache(mapMemorySize / 2);
+  BOOST_CHECK(smallCache.get(*first, 320, 240) != nullptr);
+  BOOST_CHECK_EQUAL(smallCache.size(), 0);
+  BOOST_CHECK_EQUAL(smallCache.memorySize(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(undistortionMap_cacheKey)
+{
+  UndistortionMapCache cache;
+
+  // the parameters are compared, not only their hash: the smallest change gives another map
+  const std::shared_ptr<IntrinsicBase> first = createBrownIntrinsic(320, 240, 0.1);
+  const std::shared_ptr<IntrinsicBase> close = createBrownIntrinsic(320, 240, std::nextafter(0.1, 1.0));
+  const auto map = cache.get(*first, 320, 240);
+  BOOST_CHECK(cache.get(*close, 320, 240) != map);
+  BOOST_CHECK(cache.get(*first, 320, 240, Vec2(0.5, 0.0)) != map);
+  BOOST_CHECK(cache.get(*first, 320, 240, Vec2(0.0, 0.0), oiio::ROI(), 8) != map);
+  BOOST_CHECK(cache.get(*first, 320, 240) == map);
+  BOOST_CHECK_EQUAL(cache.size(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(undistortionMap_timing)
+{
+  const int width = 2000;
+  const int height = 1500;
+  const int nbImages = 5;
+  const std::shared_ptr<IntrinsicBase> intrinsic = createBrownIntrinsic(width, height, 0.1);
+  const image::Image<float> image = randomImage(width, height);
+  image::Image<float> undistorted;
+
+  system::Timer timer;
+  for(int i = 0; i < nbImages; ++i)
+    UndistortImage(image, intrinsic.get(), undistorted, 0.0f);
+  const double directMs = timer.elapsedMs();
+
+  UndistortionMapCache cache;
+  timer.reset();
+  for(int i = 0; i < nbImages; ++i)
+    UndistortImage(image, intrinsic.get(), cache, undistorted, 0.0f);
+  const double cachedMs = timer.elapsedMs();
+
+  timer.reset();
+  const UndistortionMap coarse(*intrinsic, width, height, Vec2(0.0, 0.0), oiio::ROI(), 16);
+  for(int i = 0; i < nbImages; ++i)
+    UndistortImage(image, coarse, undistorted, 0.0f);
+  const double coarseMs = timer.elapsedMs();
+
+  ALICEVISION_LOG_INFO(nbImages << " images " << width << "x" << height << ": direct " << directMs << " ms, cached map " << cachedMs
+                                << " ms, coarse map " << coarseMs << " ms");
+}
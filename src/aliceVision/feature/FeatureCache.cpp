@@ -0,0 +1,258 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "FeatureCache.hpp"
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/version.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+namespace aliceVision {
+namespace feature {
+
+namespace {
+
+/**
+ * @brief 64 bits FNV-1a hash, stable across platforms and runs
+ */
+class Fnv1aHash
+{
+public:
+    void update(const char* data, std::size_t size)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            _hash ^= static_cast<unsigned char>(data[i]);
+            _hash *= 0x100000001b3ULL;
+        }
+    }
+
+    void update(const std::string& str)
+    {
+        update(str.data(), str.size());
+        // separator, so that concatenated fields cannot collide
+        update("\0", 1);
+    }
+
+    std::string hex() const
+    {
+        std::ostringstream os;
+        os << std::hex << std::setw(16) << std::setfill('0') << _hash;
+        return os.str();
+    }
+
+private:
+    std::uint64_t _hash = 0xcbf29ce484222325ULL;
+};
+
+} // namespace
+
+FeatureCache::FeatureCache(const std::string& folder, std::uintmax_t maxSize, const std::string& parameters,
+                           std::time_t maxAge)
+    : _folder(folder)
+    , _maxSize(maxSize)
+    , _parameters(parameters)
+    , _maxAge(maxAge)
+{
+    if (!fs::exists(_folder))
+        fs::create_directories(_folder);
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        evict();
+    }
+
+    ALICEVISION_LOG_INFO("Feature cache '" << _folder << "': " << _size / (1024 * 1024) << " MB used, "
+                         << _maxSize / (1024 * 1024) << " MB maximum.");
+}
+
+std::string FeatureCache::hashFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return std::string();
+
+    Fnv1aHash hash;
+    std::vector<char> buffer(1024 * 1024);
+    std::uintmax_t size = 0;
+    while (file)
+    {
+        file.read(buffer.data(), buffer.size());
+        hash.update(buffer.data(), file.gcount());
+        size += file.gcount();
+    }
+    // the size makes collisions between files even less likely
+    hash.update(std::to_string(size));
+
+    return hash.hex();
+}
+
+std::string FeatureCache::getKey(const std::string& imageHash, const std::string& maskHash,
+                                 const ImageDescriber& imageDescriber) const
+{
+    Fnv1aHash hash;
+    hash.update(imageHash);
+    hash.update(maskHash);
+    hash.update(EImageDescriberType_enumToString(imageDescriber.getDescriberType()));
+    // CPU and GPU implementations do not give the same features
+    hash.update(imageDescriber.useCuda() ? "gpu" : "cpu");
+    hash.update(_parameters);
+    hash.update(ALICEVISION_VERSION_STRING);
+    return hash.hex();
+}
+
+std::string FeatureCache::getEntryPath(const std::string& key, const std::string& extension) const
+{
+    return (fs::path(_folder) / (key + extension)).string();
+}
+
+bool FeatureCache::restore(const std::string& key, const std::string& featuresPath, const std::string& descriptorsPath)
+{
+    const std::string cachedFeaturesPath = getEntryPath(key, ".feat");
+    const std::string cachedDescriptorsPath = getEntryPath(key, ".desc");
+
+    boost::system::error_code ec;
+    if (fs::exists(cachedFeaturesPath, ec) && fs::exists(cachedDescriptorsPath, ec))
+    {
+        fs::copy_file(cachedFeaturesPath, featuresPath, fs::copy_options::overwrite_existing, ec);
+        if (!ec)
+            fs::copy_file(cachedDescriptorsPath, descriptorsPath, fs::copy_options::overwrite_existing, ec);
+
+        if (!ec)
+        {
+            // mark the entry as recently used
+            const std::time_t now = std::time(nullptr);
+            fs::last_write_time(cachedFeaturesPath, now, ec);
+            ++_nbHits;
+            return true;
+        }
+
+        // entry removed meanwhile by another process, do not leave a partial output
+        fs::remove(featuresPath, ec);
+        fs::remove(descriptorsPath, ec);
+    }
+
+    ++_nbMisses;
+    return false;
+}
+
+void FeatureCache::store(const std::string& key, const std::string& featuresPath, const std::string& descriptorsPath)
+{
+    boost::system::error_code ec;
+    std::uintmax_t entrySize = 0;
+
+    for (const auto& paths : {std::make_pair(featuresPath, getEntryPath(key, ".feat")),
+                              std::make_pair(descriptorsPath, getEntryPath(key, ".desc"))})
+    {
+        // write under a temporary name, so that other processes never see a partial entry
+        const fs::path tmpPath = fs::path(_folder) / (fs::unique_path().string() + ".tmp");
+        fs::copy_file(paths.first, tmpPath, fs::copy_options::overwrite_existing, ec);
+        if (!ec)
+            fs::rename(tmpPath, paths.second, ec);
+        if (ec)
+        {
+            ALICEVISION_LOG_WARNING("Cannot add '" << paths.first << "' to the feature cache: " << ec.message());
+            fs::remove(tmpPath, ec);
+            return;
+        }
+        const std::uintmax_t fileSize = fs::file_size(paths.second, ec);
+        entrySize += ec ? 0 : fileSize;
+    }
+    ++_nbStored;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _size += entrySize;
+    if (_size > _maxSize)
+        evict();
+}
+
+void FeatureCache::evict()
+{
+    struct Entry
+    {
+        std::string key;
+        std::time_t time;
+        std::uintmax_t size;
+    };
+
+    const std::time_t now = std::time(nullptr);
+
+    // list the folder again, it may be shared with other processes
+    std::vector<Entry> entries;
+    std::uintmax_t size = 0;
+    boost::system::error_code ec;
+    for (const fs::directory_entry& file : fs::directory_iterator(_folder))
+    {
+        if (!fs::is_regular_file(file.status()))
+            continue;
+
+        const std::uintmax_t fileSize = fs::file_size(file.path(), ec);
+        if (ec)
+            continue;
+
+        const fs::path extension = file.path().extension();
+        if (extension == ".tmp" || (extension == ".desc" && !fs::exists(fs::path(file.path()).replace_extension(".feat"), ec)))
+        {
+            // temporary file left by an interrupted process, or descriptors of an entry removed meanwhile
+            const std::time_t time = fs::last_write_time(file.path(), ec);
+            if (!ec && now - time > 3600)
+            {
+                fs::remove(file.path(), ec);
+                if (!ec)
+                    continue;
+            }
+        }
+        size += fileSize;
+
+        if (extension == ".feat")
+        {
+            const std::string key = file.path().stem().string();
+            boost::system::error_code descriptorsError;
+            const std::uintmax_t descriptorsSize = fs::file_size(getEntryPath(key, ".desc"), descriptorsError);
+            entries.push_back({key, fs::last_write_time(file.path(), ec), fileSize + (descriptorsError ? 0 : descriptorsSize)});
+        }
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+
+    // entries of parameters no longer in use are not restored anymore, so they expire after maxAge
+    std::size_t nbEvicted = 0;
+    for (const Entry& entry : entries)
+    {
+        if (size <= _maxSize && now - entry.time <= _maxAge)
+            break;
+        fs::remove(getEntryPath(entry.key, ".feat"), ec);
+        fs::remove(getEntryPath(entry.key, ".desc"), ec);
+        size -= std::min(size, entry.size);
+        ++nbEvicted;
+    }
+    _size = size;
+
+    if (nbEvicted == 0)
+        return;
+
+    ALICEVISION_LOG_INFO("Feature cache: " << nbEvicted << " entries evicted, " << _size / (1024 * 1024) << " MB used.");
+}
+
+void FeatureCache::logStatistics() const
+{
+    const std::size_t nbRequests = _nbHits + _nbMisses;
+    ALICEVISION_LOG_INFO("Feature cache: " << _nbHits << " hits, " << _nbMisses << " misses ("
+                         << (nbRequests > 0 ? 100.0 * _nbHits / nbRequests : 0.0) << "% hit rate), "
+                         << _nbStored << " entries stored.");
+}
+
+} // namespace feature
+} // namespace aliceVision
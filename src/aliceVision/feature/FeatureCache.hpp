@@ -0,0 +1,95 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "ImageDescriber.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+
+namespace aliceVision {
+namespace feature {
+
+/**
+ * @brief Content addressed cache of extracted features.
+ *
+ * An entry is a pair of features and descriptors files named after a key computed from
+ * the content of the image (and of its mask), the describer type and the describer parameters.
+ * So the same photos re-imported in another project, or moved to another folder, reuse their features.
+ *
+ * The cache folder can be shared by several processes: entries are written to a temporary file
+ * and renamed, and the least recently used entries are removed when the folder exceeds its maximal size.
+ * Entries of parameters or versions no longer in use are never restored again: they are removed
+ * once they have not been used for maxAge seconds, even if the folder is below its maximal size.
+ */
+class FeatureCache
+{
+public:
+    /**
+     * @param[in] folder cache folder, created if needed
+     * @param[in] maxSize maximal size of the cache folder in bytes
+     * @param[in] parameters describer parameters, any change invalidates the entries
+     * @param[in] maxAge time in seconds after which an unused entry is removed
+     */
+    FeatureCache(const std::string& folder, std::uintmax_t maxSize, const std::string& parameters,
+                 std::time_t maxAge = 30 * 24 * 3600);
+
+    /**
+     * @brief Hash of the content of a file, as an hexadecimal string
+     * @param[in] path file path
+     * @return empty string if the file cannot be read
+     */
+    static std::string hashFile(const std::string& path);
+
+    /**
+     * @brief Key of the features of an image for a given describer
+     * @param[in] imageHash content hash of the image
+     * @param[in] maskHash content hash of the mask (empty without mask)
+     * @param[in] imageDescriber describer used for the extraction
+     */
+    std::string getKey(const std::string& imageHash, const std::string& maskHash, const ImageDescriber& imageDescriber) const;
+
+    /**
+     * @brief Copy the cached features and descriptors of a key to the given paths
+     * @return false on a cache miss
+     */
+    bool restore(const std::string& key, const std::string& featuresPath, const std::string& descriptorsPath);
+
+    /**
+     * @brief Add the features and descriptors files of a key to the cache
+     */
+    void store(const std::string& key, const std::string& featuresPath, const std::string& descriptorsPath);
+
+    std::size_t getNbHits() const { return _nbHits; }
+    std::size_t getNbMisses() const { return _nbMisses; }
+
+    /// Log the hit rate and the size of the cache
+    void logStatistics() const;
+
+private:
+    std::string getEntryPath(const std::string& key, const std::string& extension) const;
+
+    /// Remove the expired entries, then the least recently used ones until the folder fits in the maximal size
+    void evict();
+
+    const std::string _folder;
+    const std::uintmax_t _maxSize;
+    const std::string _parameters;
+    const std::time_t _maxAge;
+
+    std::mutex _mutex;
+    std::uintmax_t _size = 0;
+    std::atomic<std::size_t> _nbHits{0};
+    std::atomic<std::size_t> _nbMisses{0};
+    std::atomic<std::size_t> _nbStored{0};
+};
+
+} // namespace feature
+} // namespace aliceVision
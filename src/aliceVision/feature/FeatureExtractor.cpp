@@ -7,15 +7,172 @@
 #include "FeatureExtractor.hpp"
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/system/Timer.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 #include <boost/filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <iomanip>
+#include <mutex>
+#include <thread>
 
 namespace fs = boost::filesystem;
 
 namespace aliceVision {
 namespace feature {
 
+namespace {
+
+/**
+ * @brief Blocking FIFO with a maximum size, used to connect two stages of the extraction pipeline.
+ * push() waits while the queue is full, pop() waits while it is empty.
+ * Once closed, push() drops its item and pop() returns false when the queue is drained.
+ */
+template <class T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(std::size_t capacity)
+        : _capacity(std::max(std::size_t(1), capacity))
+    {}
+
+    void push(T item)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notFull.wait(lock, [this] { return _closed || _items.size() < _capacity; });
+        if (_closed)
+            return;
+        _items.push_back(std::move(item));
+        _notEmpty.notify_one();
+    }
+
+    bool pop(T& item)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _notEmpty.wait(lock, [this] { return _closed || !_items.empty(); });
+        if (_items.empty())
+            return false;
+        item = std::move(_items.front());
+        _items.pop_front();
+        _notFull.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+private:
+    const std::size_t _capacity;
+    std::deque<T> _items;
+    bool _closed = false;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+};
+
+/**
+ * @brief Admission controller: a view is decoded only once the memory needed to describe it is reserved.
+ * A view is always admitted when nothing else is in flight, so that a view larger than the budget still runs alone.
+ */
+class MemoryBudget
+{
+public:
+    explicit MemoryBudget(std::size_t budget)
+        : _budget(budget)
+    {}
+
+    void acquire(std::size_t size)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _released.wait(lock, [&] { return _aborted || _used == 0 || _used + size <= _budget; });
+        _used += size;
+    }
+
+    /// Stop waiting for memory, used when the pipeline fails
+    void abort()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _aborted = true;
+        _released.notify_all();
+    }
+
+    void release(std::size_t size)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _used -= size;
+        _released.notify_all();
+    }
+
+private:
+    const std::size_t _budget;
+    std::size_t _used = 0;
+    bool _aborted = false;
+    std::mutex _mutex;
+    std::condition_variable _released;
+};
+
+/**
+ * @brief Throughput of one stage of the pipeline.
+ */
+struct StageStatistics
+{
+    std::string name;
+    std::size_t nbItems = 0;
+    double busyTime = 0.0; // cumulated over the stage threads, in seconds
+    std::mutex mutex;
+
+    explicit StageStatistics(const std::string& stageName)
+        : name(stageName)
+    {}
+
+    void add(double time)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++nbItems;
+        busyTime += time;
+    }
+
+    void log(double wallTime) const
+    {
+        ALICEVISION_LOG_INFO(std::left << std::setw(10) << name << ": " << nbItems << " items, "
+                             << busyTime << " s busy, "
+                             << (wallTime > 0.0 ? nbItems / wallTime : 0.0) << " items/s");
+    }
+};
+
+} // namespace
+
+/**
+ * @brief Decoded inputs of a view, shared by the CPU and GPU describe stages.
+ * The memory reserved for the view is given back when the last stage drops it.
+ */
+struct FeatureExtractor::ViewImages
+{
+    const FeatureExtractorViewJob* job = nullptr;
+    image::Image<float> imageGrayFloat;
+    image::Image<unsigned char> imageGrayUChar;
+    image::Image<unsigned char> mask;
+    std::mutex ucharMutex;
+};
+
+/**
+ * @brief Describer output waiting to be written.
+ */
+struct FeatureExtractor::ViewRegions
+{
+    const FeatureExtractorViewJob* job = nullptr;
+    std::size_t imageDescriberIndex = 0;
+    std::unique_ptr<feature::Regions> regions;
+};
+
 FeatureExtractorViewJob::FeatureExtractorViewJob(const sfmData::View& view,
                                                  const std::string& outputFolder) :
     _view(view),
@@ -49,6 +206,37 @@ void FeatureExtractorViewJob::setImageDescribers(
 }
 
 
+void FeatureExtractorViewJob::restoreFromCache(FeatureCache& cache,
+        const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers,
+        const std::string& maskPath)
+{
+    const std::string imageHash = FeatureCache::hashFile(_view.getImagePath());
+    const std::string maskHash = maskPath.empty() ? std::string() : FeatureCache::hashFile(maskPath);
+    if (imageHash.empty() || (!maskPath.empty() && maskHash.empty()))
+    {
+        ALICEVISION_LOG_WARNING("Cannot read view '" << _view.getImagePath() << "' for the feature cache.");
+        return;
+    }
+
+    _cacheKeys.assign(imageDescribers.size(), std::string());
+
+    const auto restore = [&](std::vector<std::size_t>& indexes) {
+        indexes.erase(std::remove_if(indexes.begin(), indexes.end(), [&](std::size_t i) {
+            const std::shared_ptr<feature::ImageDescriber>& imageDescriber = imageDescribers.at(i);
+            const feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
+
+            _cacheKeys[i] = cache.getKey(imageHash, maskHash, *imageDescriber);
+            if (!cache.restore(_cacheKeys[i], getFeaturesPath(imageDescriberType), getDescriptorPath(imageDescriberType)))
+                return false;
+
+            _memoryConsuption -= imageDescriber->getMemoryConsumption(_view.getWidth(), _view.getHeight());
+            return true;
+        }), indexes.end());
+    };
+    restore(_cpuImageDescriberIndexes);
+    restore(_gpuImageDescriberIndexes);
+}
+
 FeatureExtractor::FeatureExtractor(const sfmData::SfMData& sfmData) :
     _sfmData(sfmData)
 {}
@@ -72,10 +260,7 @@ void FeatureExtractor::process(const HardwareContext & hContext)
         std::advance(itViewEnd, _rangeSize);
     }
 
-    std::size_t jobMaxMemoryConsuption = 0;
-
-    std::vector<FeatureExtractorViewJob> cpuJobs;
-    std::vector<FeatureExtractorViewJob> gpuJobs;
+    std::vector<FeatureExtractorViewJob> jobs;
 
     for (auto it = itViewBegin; it != itViewEnd; ++it)
     {
@@ -83,24 +268,56 @@ void FeatureExtractor::process(const HardwareContext & hContext)
         FeatureExtractorViewJob viewJob(view, _outputFolder);
 
         viewJob.setImageDescribers(_imageDescribers);
-        jobMaxMemoryConsuption = std::max(jobMaxMemoryConsuption, viewJob.memoryConsuption());
 
-        if (viewJob.useCPU())
-            cpuJobs.push_back(viewJob);
+        if (viewJob.useCPU() || viewJob.useGPU())
+            jobs.push_back(viewJob);
+    }
+
+    if (_featureCache)
+    {
+        // hashing the images is I/O bound
+        #pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < jobs.size(); ++i)
+        {
+            jobs[i].restoreFromCache(*_featureCache, _imageDescribers, getMaskPath(jobs[i].view()));
+        }
+
+        std::vector<FeatureExtractorViewJob> remainingJobs;
+        for (const FeatureExtractorViewJob& job : jobs)
+        {
+            if (job.useCPU() || job.useGPU())
+                remainingJobs.push_back(job);
+        }
+        jobs.swap(remainingJobs);
 
-        if (viewJob.useGPU())
-            gpuJobs.push_back(viewJob);
+        _featureCache->logStatistics();
     }
 
-    if (!cpuJobs.empty())
+    if (jobs.empty())
+        return;
+
+    std::size_t jobMaxMemoryConsuption = 0;
+    bool useCPU = false;
+    bool useGPU = false;
+
+    for (const FeatureExtractorViewJob& job : jobs)
     {
-        system::MemoryInfo memoryInformation = system::getMemoryInfo();
-        
+        jobMaxMemoryConsuption = std::max(jobMaxMemoryConsuption, job.memoryConsuption());
+        useCPU = useCPU || job.useCPU();
+        useGPU = useGPU || job.useGPU();
+    }
+
+    system::MemoryInfo memoryInformation = system::getMemoryInfo();
+
+    //Put an upper bound with user specified memory
+    size_t maxMemory = std::min(memoryInformation.availableRam, maxAvailableMemory);
+    size_t maxTotalMemory = std::min(memoryInformation.totalRam, maxAvailableMemory);
 
-        //Put an upper bound with user specified memory
-        size_t maxMemory = std::min(memoryInformation.availableRam, maxAvailableMemory);
-        size_t maxTotalMemory = std::min(memoryInformation.totalRam, maxAvailableMemory);
+    // Number of views described in parallel on the CPU
+    std::size_t nbThreads = 1;
 
+    if (useCPU)
+    {
         ALICEVISION_LOG_INFO("Job max memory consumption for one image: "
                              << jobMaxMemoryConsuption / (1024*1024) << " MB");
         ALICEVISION_LOG_INFO("Memory information: " << std::endl << memoryInformation);
@@ -113,7 +330,7 @@ void FeatureExtractor::process(const HardwareContext & hContext)
         const std::size_t memoryImageCapacity =
                 std::size_t((0.9 * maxMemory) / jobMaxMemoryConsuption);
 
-        std::size_t nbThreads = std::max(std::size_t(1), memoryImageCapacity);
+        nbThreads = std::max(std::size_t(1), memoryImageCapacity);
         ALICEVISION_LOG_INFO("Max number of threads regarding memory usage: " << nbThreads);
         const double oneGB = 1024.0 * 1024.0 * 1024.0;
         if (jobMaxMemoryConsuption > maxMemory)
@@ -153,110 +370,281 @@ void FeatureExtractor::process(const HardwareContext & hContext)
         nbThreads = std::min(static_cast<std::size_t>(maxAvailableCores), nbThreads);
 
         // nbThreads should not be higher than the number of jobs
-        nbThreads = std::min(cpuJobs.size(), nbThreads);
+        nbThreads = std::min(jobs.size(), nbThreads);
 
         ALICEVISION_LOG_INFO("# threads for extraction: " << nbThreads);
-        omp_set_nested(1);
-
-#pragma omp parallel for num_threads(nbThreads)
-        for (int i = 0; i < cpuJobs.size(); ++i)
-            computeViewJob(cpuJobs.at(i), false);
     }
 
-    if (!gpuJobs.empty())
-    {
-        for (const auto& job : gpuJobs)
-            computeViewJob(job, true);
-    }
-}
+    // Views in flight (decoded, waiting or being described) must fit in 90% of the available RAM.
+    // Without memory information, only one view is in flight at a time.
+    MemoryBudget memoryBudget(maxMemory == 0 ? 0 : std::size_t(0.9 * maxMemory));
+
+    // Decoding is mostly I/O bound: a few threads are enough to keep the describers busy
+    const std::size_t nbDecodeThreads = std::max(std::size_t(1), std::min(nbThreads, std::size_t(maxAvailableCores) / 4));
+
+    // Decoded views wait in the queues for an available describer, so keep at most one per describer thread
+    BoundedQueue<std::shared_ptr<ViewImages>> cpuQueue(nbThreads);
+    BoundedQueue<std::shared_ptr<ViewImages>> gpuQueue(1);
+    BoundedQueue<std::shared_ptr<ViewRegions>> writeQueue(2 * (nbThreads + 1));
+
+    StageStatistics decodeStatistics("decode");
+    StageStatistics cpuStatistics("cpu");
+    StageStatistics gpuStatistics("gpu");
+    StageStatistics writeStatistics("write");
+
+    // The first error stops the pipeline, it is rethrown once all the threads are joined
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::atomic<bool> failed(false);
+    const auto setError = [&]() {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+            error = std::current_exception();
+        failed = true;
+        memoryBudget.abort();
+        cpuQueue.close();
+        gpuQueue.close();
+        writeQueue.close();
+    };
+
+    std::atomic<std::size_t> nextJob(0);
+
+    // describers use OpenMP internally
+    omp_set_nested(1);
+
+    const auto decodeStage = [&]() {
+        try
+        {
+            for (std::size_t i = nextJob++; i < jobs.size() && !failed; i = nextJob++)
+            {
+                const FeatureExtractorViewJob& job = jobs.at(i);
+                const std::size_t memoryConsuption = job.memoryConsuption();
+                memoryBudget.acquire(memoryConsuption);
+                if (failed)
+                {
+                    memoryBudget.release(memoryConsuption);
+                    break;
+                }
 
-void FeatureExtractor::computeViewJob(const FeatureExtractorViewJob& job, bool useGPU)
-{
-    image::Image<float> imageGrayFloat;
-    image::Image<unsigned char> imageGrayUChar;
-    image::Image<unsigned char> mask;
+                // Give the reserved memory back when both describe stages are done with the view
+                std::shared_ptr<ViewImages> images(new ViewImages(), [&memoryBudget, memoryConsuption](ViewImages* p) {
+                    delete p;
+                    memoryBudget.release(memoryConsuption);
+                });
+                images->job = &job;
+
+                system::Timer timer;
+                loadViewImages(*images);
+                decodeStatistics.add(timer.elapsed());
+
+                if (job.useCPU())
+                    cpuQueue.push(images);
+                if (job.useGPU())
+                    gpuQueue.push(images);
+            }
+        }
+        catch (...)
+        {
+            setError();
+        }
+    };
 
-    image::readImage(job.view().getImagePath(), imageGrayFloat, image::EImageColorSpace::SRGB);
+    const auto describeStage = [&](BoundedQueue<std::shared_ptr<ViewImages>>& queue, bool gpu, StageStatistics& statistics) {
+        try
+        {
+            std::shared_ptr<ViewImages> images;
+            while (queue.pop(images) && !failed)
+            {
+                for (const auto& imageDescriberIndex : images->job->imageDescriberIndexes(gpu))
+                {
+                    std::shared_ptr<ViewRegions> output = std::make_shared<ViewRegions>();
+                    output->job = images->job;
+                    output->imageDescriberIndex = imageDescriberIndex;
 
-    if (!_masksFolder.empty() && fs::exists(_masksFolder))
-    {
-        const auto masksFolder = fs::path(_masksFolder);
-        const auto idMaskPath = masksFolder /
-                fs::path(std::to_string(job.view().getViewId())).replace_extension("png");
-        const auto nameMaskPath = masksFolder /
-                fs::path(job.view().getImagePath()).filename().replace_extension("png");
+                    system::Timer timer;
+                    describeView(*images, imageDescriberIndex, gpu, output->regions);
+                    statistics.add(timer.elapsed());
+
+                    writeQueue.push(output);
+                }
+                images.reset();
+            }
+        }
+        catch (...)
+        {
+            setError();
+        }
+    };
 
-        if (fs::exists(idMaskPath))
+    const auto writeStage = [&]() {
+        try
         {
-            image::readImage(idMaskPath.string(), mask, image::EImageColorSpace::LINEAR);
+            std::shared_ptr<ViewRegions> output;
+            while (writeQueue.pop(output) && !failed)
+            {
+                system::Timer timer;
+                saveViewRegions(*output);
+                writeStatistics.add(timer.elapsed());
+            }
         }
-        else if (fs::exists(nameMaskPath))
+        catch (...)
         {
-            image::readImage(nameMaskPath.string(), mask, image::EImageColorSpace::LINEAR);
+            setError();
         }
+    };
+
+    system::Timer pipelineTimer;
+
+    std::vector<std::thread> decodeThreads;
+    std::vector<std::thread> describeThreads;
+    for (std::size_t i = 0; i < nbDecodeThreads; ++i)
+        decodeThreads.emplace_back(decodeStage);
+    if (useCPU)
+    {
+        for (std::size_t i = 0; i < nbThreads; ++i)
+            describeThreads.emplace_back(describeStage, std::ref(cpuQueue), false, std::ref(cpuStatistics));
     }
+    // GPU describers run one view at a time, concurrently with the CPU ones
+    if (useGPU)
+        describeThreads.emplace_back(describeStage, std::ref(gpuQueue), true, std::ref(gpuStatistics));
+    std::thread writeThread(writeStage);
+
+    // Each stage is closed once the previous one is done
+    for (std::thread& thread : decodeThreads)
+        thread.join();
+    cpuQueue.close();
+    gpuQueue.close();
+    for (std::thread& thread : describeThreads)
+        thread.join();
+    writeQueue.close();
+    writeThread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+
+    const double wallTime = pipelineTimer.elapsed();
+    ALICEVISION_LOG_INFO("Feature extraction pipeline done in " << wallTime << " s with "
+                         << nbDecodeThreads << " decode thread(s) and " << nbThreads << " cpu describe thread(s).");
+    decodeStatistics.log(wallTime);
+    if (useCPU)
+        cpuStatistics.log(wallTime);
+    if (useGPU)
+        gpuStatistics.log(wallTime);
+    writeStatistics.log(wallTime);
+    if (_featureCache)
+        _featureCache->logStatistics();
+}
 
-    for (const auto & imageDescriberIndex : job.imageDescriberIndexes(useGPU))
+std::string FeatureExtractor::getMaskPath(const sfmData::View& view) const
+{
+    if (_masksFolder.empty() || !fs::exists(_masksFolder))
+        return std::string();
+
+    const auto masksFolder = fs::path(_masksFolder);
+    const auto idMaskPath = masksFolder /
+            fs::path(std::to_string(view.getViewId())).replace_extension("png");
+    const auto nameMaskPath = masksFolder /
+            fs::path(view.getImagePath()).filename().replace_extension("png");
+
+    if (fs::exists(idMaskPath))
+        return idMaskPath.string();
+    if (fs::exists(nameMaskPath))
+        return nameMaskPath.string();
+    return std::string();
+}
+
+void FeatureExtractor::loadViewImages(ViewImages& images) const
+{
+    const FeatureExtractorViewJob& job = *images.job;
+
+    image::readImage(job.view().getImagePath(), images.imageGrayFloat, image::EImageColorSpace::SRGB);
+
+    const std::string maskPath = getMaskPath(job.view());
+    if (!maskPath.empty())
     {
-        const auto& imageDescriber = _imageDescribers.at(imageDescriberIndex);
-        const feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
-        const std::string imageDescriberTypeName =
-                feature::EImageDescriberType_enumToString(imageDescriberType);
+        image::readImage(maskPath, images.mask, image::EImageColorSpace::LINEAR);
+    }
+}
 
-        // Compute features and descriptors and export them to files
-        ALICEVISION_LOG_INFO("Extracting " << imageDescriberTypeName  << " features from view '"
-                             << job.view().getImagePath() << "' " << (useGPU ? "[gpu]" : "[cpu]"));
+void FeatureExtractor::describeView(ViewImages& images, std::size_t imageDescriberIndex, bool useGPU,
+                                    std::unique_ptr<feature::Regions>& regions) const
+{
+    const FeatureExtractorViewJob& job = *images.job;
+    const auto& imageDescriber = _imageDescribers.at(imageDescriberIndex);
+    const std::string imageDescriberTypeName =
+            feature::EImageDescriberType_enumToString(imageDescriber->getDescriberType());
 
-        std::unique_ptr<feature::Regions> regions;
-        if (imageDescriber->useFloatImage())
-        {
-            // image buffer use float image, use the read buffer
-            imageDescriber->describe(imageGrayFloat, regions);
-        }
-        else
+    // Compute features and descriptors
+    ALICEVISION_LOG_INFO("Extracting " << imageDescriberTypeName  << " features from view '"
+                         << job.view().getImagePath() << "' " << (useGPU ? "[gpu]" : "[cpu]"));
+
+    if (imageDescriber->useFloatImage())
+    {
+        // image buffer use float image, use the read buffer
+        imageDescriber->describe(images.imageGrayFloat, regions);
+    }
+    else
+    {
+        // image buffer can't use float image
         {
-            // image buffer can't use float image
-            if (imageGrayUChar.Width() == 0) // the first time, convert the float buffer to uchar
-                imageGrayUChar = (imageGrayFloat.GetMat() * 255.f).cast<unsigned char>();
-            imageDescriber->describe(imageGrayUChar, regions);
+            // the first time, convert the float buffer to uchar (the cpu and gpu stages may share the view)
+            std::lock_guard<std::mutex> lock(images.ucharMutex);
+            if (images.imageGrayUChar.Width() == 0)
+                images.imageGrayUChar = (images.imageGrayFloat.GetMat() * 255.f).cast<unsigned char>();
         }
+        imageDescriber->describe(images.imageGrayUChar, regions);
+    }
 
-        if (mask.Height() > 0)
+    const image::Image<unsigned char>& mask = images.mask;
+    if (mask.Height() > 0)
+    {
+        std::vector<feature::FeatureInImage> selectedIndices;
+        for (size_t i=0, n=regions->RegionCount(); i != n; ++i)
         {
-            std::vector<feature::FeatureInImage> selectedIndices;
-            for (size_t i=0, n=regions->RegionCount(); i != n; ++i)
-            {
-                const Vec2 position = regions->GetRegionPosition(i);
-                const int x = int(position.x());
-                const int y = int(position.y());
-
-                bool masked = false;
-                if (x < mask.Width() && y < mask.Height())
-                {
-                    if (mask(y, x) == 0)
-                    {
-                        masked = true;
-                    }
-                }
+            const Vec2 position = regions->GetRegionPosition(i);
+            const int x = int(position.x());
+            const int y = int(position.y());
 
-                if (!masked)
+            bool masked = false;
+            if (x < mask.Width() && y < mask.Height())
+            {
+                if (mask(y, x) == 0)
                 {
-                    selectedIndices.push_back({IndexT(i), 0});
+                    masked = true;
                 }
             }
 
-            std::vector<IndexT> out_associated3dPoint;
-            std::map<IndexT, IndexT> out_mapFullToLocal;
-            regions = regions->createFilteredRegions(selectedIndices, out_associated3dPoint,
-                                                     out_mapFullToLocal);
+            if (!masked)
+            {
+                selectedIndices.push_back({IndexT(i), 0});
+            }
         }
 
-        imageDescriber->Save(regions.get(), job.getFeaturesPath(imageDescriberType),
-                             job.getDescriptorPath(imageDescriberType));
-        ALICEVISION_LOG_INFO(std::left << std::setw(6) << " " << regions->RegionCount() << " "
-                             << imageDescriberTypeName  << " features extracted from view '"
-                             << job.view().getImagePath() << "'");
+        std::vector<IndexT> out_associated3dPoint;
+        std::map<IndexT, IndexT> out_mapFullToLocal;
+        regions = regions->createFilteredRegions(selectedIndices, out_associated3dPoint,
+                                                 out_mapFullToLocal);
+    }
+}
+
+void FeatureExtractor::saveViewRegions(const ViewRegions& output) const
+{
+    const FeatureExtractorViewJob& job = *output.job;
+    const auto& imageDescriber = _imageDescribers.at(output.imageDescriberIndex);
+    const feature::EImageDescriberType imageDescriberType = imageDescriber->getDescriberType();
+
+    // Export features and descriptors to files
+    imageDescriber->Save(output.regions.get(), job.getFeaturesPath(imageDescriberType),
+                         job.getDescriptorPath(imageDescriberType));
+
+    const std::string& cacheKey = job.cacheKey(output.imageDescriberIndex);
+    if (_featureCache && !cacheKey.empty())
+    {
+        _featureCache->store(cacheKey, job.getFeaturesPath(imageDescriberType), job.getDescriptorPath(imageDescriberType));
     }
+    ALICEVISION_LOG_INFO(std::left << std::setw(6) << " " << output.regions->RegionCount() << " "
+                         << feature::EImageDescriberType_enumToString(imageDescriberType)
+                         << " features extracted from view '" << job.view().getImagePath() << "'");
 }
 
 } // namespace feature
@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "ImageDescriber.hpp"
+#include "FeatureCache.hpp"
 #include <aliceVision/sfmData/SfMData.hpp>
 #include <aliceVision/sfmData/View.hpp>
 #include <aliceVision/system/hardwareContext.hpp>
@@ -42,6 +43,24 @@ public:
     void setImageDescribers(
             const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers);
 
+    /**
+     * @brief Copy the features available in the cache to the output folder
+     *        and remove their describers from the job.
+     * @param[in] cache feature cache
+     * @param[in] imageDescribers all the describers, as given to setImageDescribers
+     * @param[in] maskPath mask of the view (empty without mask)
+     */
+    void restoreFromCache(FeatureCache& cache,
+                          const std::vector<std::shared_ptr<feature::ImageDescriber>>& imageDescribers,
+                          const std::string& maskPath);
+
+    /// Cache key of the features computed by a describer (empty without cache)
+    const std::string& cacheKey(std::size_t imageDescriberIndex) const
+    {
+        static const std::string noKey;
+        return imageDescriberIndex < _cacheKeys.size() ? _cacheKeys[imageDescriberIndex] : noKey;
+    }
+
     const sfmData::View& view() const
     {
         return _view;
@@ -64,6 +83,7 @@ private:
     std::string _outputBasename;
     std::vector<std::size_t> _cpuImageDescriberIndexes;
     std::vector<std::size_t> _gpuImageDescriberIndexes;
+    std::vector<std::string> _cacheKeys;
 };
 
 class FeatureExtractor
@@ -94,16 +114,40 @@ public:
       _imageDescribers.push_back(imageDescriber);
     }
 
+    /**
+     * @brief Reuse the features of the cache for the images already described,
+     *        and add the newly extracted ones to it.
+     */
+    void setFeatureCache(const std::shared_ptr<FeatureCache>& featureCache)
+    {
+      _featureCache = featureCache;
+    }
+
+    /**
+     * @brief Extract and save the features of all the views in the range.
+     *
+     * Views go through a pipeline of three stages connected by bounded queues:
+     * decode (image and mask reading), describe (one stage for CPU describers and one for GPU describers,
+     * running concurrently) and write. A view is decoded only once the memory needed to describe it fits
+     * in the available RAM.
+     */
     void process(const HardwareContext & hcontext);
 
 private:
+    struct ViewImages;
+    struct ViewRegions;
 
-    void computeViewJob(const FeatureExtractorViewJob& job, bool useGPU);
+    std::string getMaskPath(const sfmData::View& view) const;
+    void loadViewImages(ViewImages& images) const;
+    void describeView(ViewImages& images, std::size_t imageDescriberIndex, bool useGPU,
+                      std::unique_ptr<feature::Regions>& regions) const;
+    void saveViewRegions(const ViewRegions& output) const;
 
     const sfmData::SfMData& _sfmData;
     std::vector<std::shared_ptr<feature::ImageDescriber>> _imageDescribers;
     std::string _masksFolder;
     std::string _outputFolder;
+    std::shared_ptr<FeatureCache> _featureCache;
     int _rangeStart = -1;
     int _rangeSize = -1;
 };
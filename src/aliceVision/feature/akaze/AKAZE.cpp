@@ -110,7 +110,7 @@ void computeAKAZESlice(const image::Image<float>& src,
     std::vector<float> tau ;
     image::FEDCycleTimings(total_cycle_time, 0.25f, tau);
     image::ImageFEDCycle(in, diff, tau);
-    Li = in ; // evolution image
+    Li.swap(in); // evolution image
   }
 
   // compute Hessian response
@@ -134,13 +134,17 @@ void computeAKAZESlice(const image::Image<float>& src,
   image::ImageScaledScharrYDerivative(Lx, Lxy, sigmaScale);
   image::ImageScaledScharrYDerivative(Ly, Lyy, sigmaScale);
 
-  Lx *= static_cast<float>(sigmaScale);
-  Ly *= static_cast<float>(sigmaScale);
-
-  // compute Determinant of the Hessian
+  // compute Determinant of the Hessian and scale the first derivatives, in a single pass per row
   Lhess.resize(Li.Width(), Li.Height());
   const float sigmaSizeQuad = Square(sigmaScale) * Square(sigmaScale);
-  Lhess.array() = (Lxx.array() * Lyy.array() - Lxy.array().square()) * sigmaSizeQuad;
+
+  #pragma omp parallel for
+  for(int i = 0; i < Li.Height(); ++i)
+  {
+    Lhess.row(i).array() = (Lxx.row(i).array() * Lyy.row(i).array() - Lxy.row(i).array().square()) * sigmaSizeQuad;
+    Lx.row(i) *= static_cast<float>(sigmaScale);
+    Ly.row(i) *= static_cast<float>(sigmaScale);
+  }
 }
 
 #if DEBUG_OCTAVE
@@ -167,7 +171,10 @@ AKAZE::AKAZE(const image::Image<float>& image, const AKAZEOptions& options):
 void AKAZE::computeScaleSpace()
 {
   float contrastFactor = computeAutomaticContrastFactor( _input, 0.7f);
-  image::Image<float> input = _input;
+
+  // each slice is computed from the previous one, which is read in place (no reallocation of _evolution)
+  _evolution.reserve(_evolution.size() + _options.nbOctaves * _options.nbSlicePerOctave);
+  const image::Image<float>* input = &_input;
 
   // octave computation
   for(int p = 0; p < _options.nbOctaves; ++p)
@@ -180,11 +187,11 @@ void AKAZE::computeScaleSpace()
       TEvolution& evo = _evolution.back();
 
       // compute Slice at (p,q) index
-      computeAKAZESlice(input, p, q, _options.nbSlicePerOctave, _options.sigma0, contrastFactor,
+      computeAKAZESlice(*input, p, q, _options.nbSlicePerOctave, _options.sigma0, contrastFactor,
         evo.cur, evo.Lx, evo.Ly, evo.Lhess);
 
       // Prepare inputs for next slice
-      input = evo.cur;
+      input = &evo.cur;
 
       // DEBUG octave image
 #if DEBUG_OCTAVE
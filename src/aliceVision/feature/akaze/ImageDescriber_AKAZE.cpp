@@ -7,9 +7,37 @@
 
 #include "ImageDescriber_AKAZE.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 namespace aliceVision {
 namespace feature {
 
+namespace {
+
+/// Number of keypoints described by a thread at once
+const int descriptionBatchSize = 32;
+
+/**
+ * @brief Order in which the keypoints are described: grouped by slice then by row,
+ *        so that the keypoints of a batch read the same part of the scale space.
+ *        Descriptors are still stored at the index of their keypoint.
+ */
+std::vector<int> descriptionOrder(const std::vector<AKAZEKeypoint>& keypoints)
+{
+  std::vector<int> order(keypoints.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&keypoints](int a, int b)
+  {
+    if(keypoints[a].class_id != keypoints[b].class_id)
+      return keypoints[a].class_id < keypoints[b].class_id;
+    return keypoints[a].y < keypoints[b].y;
+  });
+  return order;
+}
+
+} // namespace
+
 bool ImageDescriber_AKAZE::describe(const image::Image<float>& image,
                                     std::unique_ptr<Regions>& regions,
                                     const image::Image<unsigned char>* mask)
@@ -31,6 +59,8 @@ bool ImageDescriber_AKAZE::describe(const image::Image<float>& image,
 
   allocate(regions);
 
+  const std::vector<int> order = descriptionOrder(keypoints);
+
   switch(_params.akazeDescriptorType)
   {
     case AKAZE_MSURF:
@@ -40,10 +70,11 @@ bool ImageDescriber_AKAZE::describe(const image::Image<float>& image,
       regionsCasted->Features().resize(keypoints.size());
       regionsCasted->Descriptors().resize(keypoints.size());
 
-#pragma omp parallel for
-      for(int i = 0; i < static_cast<int>(keypoints.size()); ++i)
+#pragma omp parallel for schedule(dynamic, descriptionBatchSize)
+      for(int k = 0; k < static_cast<int>(order.size()); ++k)
       {
-        AKAZEKeypoint point = keypoints.at(i);
+        const int i = order[k];
+        AKAZEKeypoint point = keypoints[i];
 
         // feature masking
         if(mask)
@@ -79,9 +110,10 @@ bool ImageDescriber_AKAZE::describe(const image::Image<float>& image,
       // init LIOP extractor
       DescriptorExtractor_LIOP liop_extractor;
 
-#pragma omp parallel for
-      for(int i = 0; i < static_cast<int>(keypoints.size()); ++i)
+#pragma omp parallel for schedule(dynamic, descriptionBatchSize)
+      for(int k = 0; k < static_cast<int>(order.size()); ++k)
       {
+        const int i = order[k];
         AKAZEKeypoint point = keypoints[i];
 
         // feature masking
@@ -121,9 +153,10 @@ bool ImageDescriber_AKAZE::describe(const image::Image<float>& image,
       regionsCasted->Features().resize(keypoints.size());
       regionsCasted->Descriptors().resize(keypoints.size());
 
-#pragma omp parallel for
-      for (int i = 0; i < static_cast<int>(keypoints.size()); ++i)
+#pragma omp parallel for schedule(dynamic, descriptionBatchSize)
+      for(int k = 0; k < static_cast<int>(order.size()); ++k)
       {
+        const int i = order[k];
         AKAZEKeypoint point = keypoints[i];
 
         // Feature masking
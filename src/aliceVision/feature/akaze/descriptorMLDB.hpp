@@ -15,33 +15,37 @@
 namespace aliceVision {
 namespace feature {
 
+  /// Samples of the MLDB pattern (2 * pattern_size + 1 on each axis), stored on the stack
+  template< typename Real >
+  using MLDBSamples = Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor, 21, 21> ;
+
+  /// Mean values of the MLDB subdivisions (at most 4x4), stored on the stack
+  template< typename Real >
+  using MLDBMeans = Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor, 4, 4> ;
+
   /**
   ** @brief Compute mean values (Li,Lx,Ly) in each subdivisions
   ** @param samples_Li input values on Li
-  ** @param samples_Lx input values on Lx
-  ** @param samples_Ly input values on Ly
+  ** @param samples_Lx input values on Lx (already rotated by the main orientation)
+  ** @param samples_Ly input values on Ly (already rotated by the main orientation)
   ** @param nb_subdiv number of subdivision (on each 2d axis)
   ** @param subdiv_size size of a subdivision (on each 2d axis)
   ** @param pattern_size source size (on each 2d axis)
-  ** @param c cosinus of main orientation (for computing new derivatives values)
-  ** @param s sinus of main orientation (for computing new derivatives values)
   ** @param mean_Li mean of Li in each subdivision
   ** @param mean_Lx mean of Lx in each subdivision
   ** @param mean_Ly mean of Ly in each subdivision
   **/
   template< typename Real>
   inline void ComputeMeanValuesInSubdivisions(
-      const Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> & samples_Li ,
-      const Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> & samples_Lx ,
-      const Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> & samples_Ly ,
+      const MLDBSamples<Real> & samples_Li ,
+      const MLDBSamples<Real> & samples_Lx ,
+      const MLDBSamples<Real> & samples_Ly ,
       const int nb_subdiv ,
       const int subdiv_size ,
       const int pattern_size ,
-      const Real c , // cos( theta )
-      const Real s , // sin( theta )
-      Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> & mean_Li ,
-      Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> & mean_Lx ,
-      Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> & mean_Ly )
+      MLDBMeans<Real> & mean_Li ,
+      MLDBMeans<Real> & mean_Lx ,
+      MLDBMeans<Real> & mean_Ly )
   {
     mean_Li.resize( nb_subdiv , nb_subdiv ) ;
     mean_Lx.resize( nb_subdiv , nb_subdiv ) ;
@@ -69,18 +73,8 @@ namespace feature {
           for( int jj = min_x ; jj < max_x ; ++jj )
           {
             mean_Li( i , j ) += samples_Li( ii , jj ) ;
-
-            const Real dx = samples_Lx( ii , jj ) ;
-            const Real dy = samples_Ly( ii , jj ) ;
-
-            // Rotate derivatives
-            // a is original angle, b is keypoint angle
-            // Cos( a - b ) = cosA cosB + sinA sinB
-            //              = dx * c + dy * s
-            // Sin( a - b ) = sinA cosB - cosA sinB
-            //              = dy * c - dx * s
-            mean_Ly( i , j ) +=   dx * c + dy * s ;
-            mean_Lx( i , j ) +=   dy * c - dx * s ;
+            mean_Lx( i , j ) += samples_Lx( ii , jj ) ;
+            mean_Ly( i , j ) += samples_Ly( ii , jj ) ;
 
             ++nb_elt ;
           }
@@ -104,9 +98,9 @@ namespace feature {
   **/
   template< typename DescriptorType , typename Real>
   inline void ComputeBinaryValues(
-    const Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> & mean_Li ,
-    const Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> & mean_Lx ,
-    const Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> & mean_Ly ,
+    const MLDBMeans<Real> & mean_Li ,
+    const MLDBMeans<Real> & mean_Lx ,
+    const MLDBMeans<Real> & mean_Ly ,
     const int nb_subdiv ,
     size_t & outIndex ,
     DescriptorType & desc )
@@ -158,8 +152,8 @@ namespace feature {
     const Real sigma_scale = MathTrait<Real>::round( ipt.scale() * inv_octave_scale ) ;
 
     // Get every samples inside 2pattern x 2pattern square region
-    // Memory efficient (get samples then work in aligned)
-    Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+    // Memory efficient (get samples then work in aligned, no heap allocation)
+    MLDBSamples<Real>
       samples_Li( 2 * pattern_size + 1 , 2 * pattern_size + 1 ),
       samples_Lx( 2 * pattern_size + 1 , 2 * pattern_size + 1 ),
       samples_Ly( 2 * pattern_size + 1 , 2 * pattern_size + 1 );
@@ -192,8 +186,17 @@ namespace feature {
         const int x = MathTrait<Real>::round( dx ) ;
 
         samples_Li( i + pattern_size , j + pattern_size ) = Li( y , x ) ;
-        samples_Lx( i + pattern_size , j + pattern_size ) = Lx( y , x ) ;
-        samples_Ly( i + pattern_size , j + pattern_size ) = Ly( y , x ) ;
+
+        // Rotate derivatives once here rather than in every grid
+        // a is original angle, b is keypoint angle
+        // Cos( a - b ) = cosA cosB + sinA sinB
+        //              = dx * c + dy * s
+        // Sin( a - b ) = sinA cosB - cosA sinB
+        //              = dy * c - dx * s
+        const Real sample_dx = Lx( y , x ) ;
+        const Real sample_dy = Ly( y , x ) ;
+        samples_Ly( i + pattern_size , j + pattern_size ) = sample_dx * c + sample_dy * s ;
+        samples_Lx( i + pattern_size , j + pattern_size ) = sample_dy * c - sample_dx * s ;
       }
     }
 
@@ -201,18 +204,18 @@ namespace feature {
 
     // Grid 1 : 2x2 subdivision
     int subdiv_size = pattern_size ;
-    Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> sumLi , sumLx , sumLy ;
-    ComputeMeanValuesInSubdivisions( samples_Li , samples_Lx , samples_Ly , 2 , subdiv_size , pattern_size , c , s , sumLi , sumLx , sumLy ) ;
+    MLDBMeans<Real> sumLi , sumLx , sumLy ;
+    ComputeMeanValuesInSubdivisions( samples_Li , samples_Lx , samples_Ly , 2 , subdiv_size , pattern_size , sumLi , sumLx , sumLy ) ;
     ComputeBinaryValues( sumLi , sumLx , sumLy , 2 , outIndex , desc ) ;
 
     // Grid 2 : 3x3 subdivision
     subdiv_size = static_cast<int>( MathTrait<Real>::ceil( static_cast<Real>( 2 * pattern_size ) / static_cast<Real>( 3 ) ) ) ;
-    ComputeMeanValuesInSubdivisions( samples_Li , samples_Lx , samples_Ly , 3 , subdiv_size , pattern_size , c , s , sumLi , sumLx , sumLy ) ;
+    ComputeMeanValuesInSubdivisions( samples_Li , samples_Lx , samples_Ly , 3 , subdiv_size , pattern_size , sumLi , sumLx , sumLy ) ;
     ComputeBinaryValues( sumLi , sumLx , sumLy , 3 , outIndex , desc ) ;
 
     // Grid 3 : 4x4 subdivision
     subdiv_size = pattern_size / 2 ;
-    ComputeMeanValuesInSubdivisions( samples_Li , samples_Lx , samples_Ly , 4 , subdiv_size , pattern_size , c , s , sumLi , sumLx , sumLy ) ;
+    ComputeMeanValuesInSubdivisions( samples_Li , samples_Lx , samples_Ly , 4 , subdiv_size , pattern_size , sumLi , sumLx , sumLy ) ;
     ComputeBinaryValues( sumLi , sumLx , sumLy , 4 , outIndex , desc ) ;
 
     assert( outIndex == 486 ) ; // Just to be sure (and we are sure ! completly sure !)
@@ -0,0 +1,203 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/feature/FeatureCache.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <ctime>
+#include <fstream>
+#include <iterator>
+
+#define BOOST_TEST_MODULE FeatureCache
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::feature;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+/// Describer only used to build cache keys
+class DummyImageDescriber : public ImageDescriber
+{
+public:
+    explicit DummyImageDescriber(EImageDescriberType type)
+        : _type(type)
+    {}
+
+    bool useCuda() const override { return false; }
+    bool useFloatImage() const override { return true; }
+    EImageDescriberType getDescriberType() const override { return _type; }
+    std::size_t getMemoryConsumption(std::size_t width, std::size_t height) const override { return width * height; }
+    void setConfigurationPreset(ConfigurationPreset preset) override {}
+    void allocate(std::unique_ptr<Regions>& regions) const override {}
+
+private:
+    EImageDescriberType _type;
+};
+
+void writeFile(const fs::path& path, const std::string& content)
+{
+    std::ofstream file(path.string(), std::ios::binary);
+    file << content;
+}
+
+std::string readFile(const fs::path& path)
+{
+    std::ifstream file(path.string(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/// Temporary folder removed at the end of the test
+struct TmpFolder
+{
+    TmpFolder()
+        : path(fs::temp_directory_path() / fs::unique_path())
+    {
+        fs::create_directories(path);
+    }
+
+    ~TmpFolder()
+    {
+        fs::remove_all(path);
+    }
+
+    fs::path path;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(FeatureCache_hashFile)
+{
+    TmpFolder tmp;
+    writeFile(tmp.path / "a.jpg", "some image content");
+    fs::create_directories(tmp.path / "moved");
+    writeFile(tmp.path / "moved" / "b.jpg", "some image content");
+    writeFile(tmp.path / "c.jpg", "some other content");
+
+    const std::string hash = FeatureCache::hashFile((tmp.path / "a.jpg").string());
+    BOOST_CHECK(!hash.empty());
+    // the hash only depends on the content
+    BOOST_CHECK_EQUAL(FeatureCache::hashFile((tmp.path / "moved" / "b.jpg").string()), hash);
+    BOOST_CHECK_NE(FeatureCache::hashFile((tmp.path / "c.jpg").string()), hash);
+    BOOST_CHECK(FeatureCache::hashFile((tmp.path / "missing.jpg").string()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(FeatureCache_storeAndRestore)
+{
+    TmpFolder tmp;
+    const DummyImageDescriber sift(EImageDescriberType::SIFT);
+    const DummyImageDescriber akaze(EImageDescriberType::AKAZE);
+
+    FeatureCache cache((tmp.path / "cache").string(), 1024 * 1024, "normal");
+
+    const std::string key = cache.getKey("image", "", sift);
+    BOOST_CHECK_NE(cache.getKey("image", "mask", sift), key);
+    BOOST_CHECK_NE(cache.getKey("image", "", akaze), key);
+    BOOST_CHECK_NE(cache.getKey("other", "", sift), key);
+    BOOST_CHECK_NE(FeatureCache((tmp.path / "cache").string(), 1024 * 1024, "high").getKey("image", "", sift), key);
+
+    const fs::path featuresPath = tmp.path / "1.sift.feat";
+    const fs::path descriptorsPath = tmp.path / "1.sift.desc";
+    const fs::path restoredFeaturesPath = tmp.path / "2.sift.feat";
+    const fs::path restoredDescriptorsPath = tmp.path / "2.sift.desc";
+
+    BOOST_CHECK(!cache.restore(key, restoredFeaturesPath.string(), restoredDescriptorsPath.string()));
+    BOOST_CHECK(!fs::exists(restoredFeaturesPath));
+
+    writeFile(featuresPath, "features");
+    writeFile(descriptorsPath, "descriptors");
+    cache.store(key, featuresPath.string(), descriptorsPath.string());
+
+    BOOST_CHECK(cache.restore(key, restoredFeaturesPath.string(), restoredDescriptorsPath.string()));
+    BOOST_CHECK_EQUAL(readFile(restoredFeaturesPath), "features");
+    BOOST_CHECK_EQUAL(readFile(restoredDescriptorsPath), "descriptors");
+
+    BOOST_CHECK_EQUAL(cache.getNbHits(), 1);
+    BOOST_CHECK_EQUAL(cache.getNbMisses(), 1);
+
+    // entries are kept on disk for the next runs
+    FeatureCache otherRun((tmp.path / "cache").string(), 1024 * 1024, "normal");
+    BOOST_CHECK(otherRun.restore(key, restoredFeaturesPath.string(), restoredDescriptorsPath.string()));
+}
+
+BOOST_AUTO_TEST_CASE(FeatureCache_eviction)
+{
+    TmpFolder tmp;
+    const DummyImageDescriber sift(EImageDescriberType::SIFT);
+    const fs::path cacheFolder = tmp.path / "cache";
+
+    // room for two entries only
+    FeatureCache cache(cacheFolder.string(), 2 * 200, "normal");
+
+    const fs::path featuresPath = tmp.path / "view.feat";
+    const fs::path descriptorsPath = tmp.path / "view.desc";
+    writeFile(featuresPath, std::string(100, 'f'));
+    writeFile(descriptorsPath, std::string(100, 'd'));
+
+    const std::time_t now = std::time(nullptr);
+    const std::vector<std::string> keys = {cache.getKey("a", "", sift), cache.getKey("b", "", sift), cache.getKey("c", "", sift)};
+
+    cache.store(keys[0], featuresPath.string(), descriptorsPath.string());
+    cache.store(keys[1], featuresPath.string(), descriptorsPath.string());
+    fs::last_write_time(cacheFolder / (keys[0] + ".feat"), now - 20);
+    fs::last_write_time(cacheFolder / (keys[1] + ".feat"), now - 30);
+
+    // the first entry is used again, so the second one is the least recently used
+    BOOST_CHECK(cache.restore(keys[0], (tmp.path / "out.feat").string(), (tmp.path / "out.desc").string()));
+    cache.store(keys[2], featuresPath.string(), descriptorsPath.string());
+
+    BOOST_CHECK(fs::exists(cacheFolder / (keys[0] + ".feat")));
+    BOOST_CHECK(!fs::exists(cacheFolder / (keys[1] + ".feat")));
+    BOOST_CHECK(!fs::exists(cacheFolder / (keys[1] + ".desc")));
+    BOOST_CHECK(fs::exists(cacheFolder / (keys[2] + ".feat")));
+    BOOST_CHECK(fs::exists(cacheFolder / (keys[2] + ".desc")));
+}
+
+BOOST_AUTO_TEST_CASE(FeatureCache_expiration)
+{
+    TmpFolder tmp;
+    const DummyImageDescriber sift(EImageDescriberType::SIFT);
+    const fs::path cacheFolder = tmp.path / "cache";
+
+    const fs::path featuresPath = tmp.path / "view.feat";
+    const fs::path descriptorsPath = tmp.path / "view.desc";
+    writeFile(featuresPath, std::string(100, 'f'));
+    writeFile(descriptorsPath, std::string(100, 'd'));
+
+    const std::time_t now = std::time(nullptr);
+    const std::time_t maxAge = 3600;
+    std::string oldKey;
+    std::string recentKey;
+    {
+        // entries of parameters that are not used anymore
+        FeatureCache oldRun(cacheFolder.string(), 1024 * 1024, "low", maxAge);
+        oldKey = oldRun.getKey("a", "", sift);
+        recentKey = oldRun.getKey("b", "", sift);
+        oldRun.store(oldKey, featuresPath.string(), descriptorsPath.string());
+        oldRun.store(recentKey, featuresPath.string(), descriptorsPath.string());
+    }
+    fs::last_write_time(cacheFolder / (oldKey + ".feat"), now - 2 * maxAge);
+    fs::last_write_time(cacheFolder / (recentKey + ".feat"), now - maxAge / 2);
+
+    // leftovers of interrupted processes
+    writeFile(cacheFolder / "interrupted.tmp", "partial");
+    fs::last_write_time(cacheFolder / "interrupted.tmp", now - 2 * 3600);
+    writeFile(cacheFolder / "orphan.desc", "descriptors");
+    fs::last_write_time(cacheFolder / "orphan.desc", now - 2 * 3600);
+
+    // the folder is far below its maximal size, but the expired entries are removed
+    FeatureCache cache(cacheFolder.string(), 1024 * 1024, "normal", maxAge);
+    BOOST_CHECK(!fs::exists(cacheFolder / (oldKey + ".feat")));
+    BOOST_CHECK(!fs::exists(cacheFolder / (oldKey + ".desc")));
+    BOOST_CHECK(fs::exists(cacheFolder / (recentKey + ".feat")));
+    BOOST_CHECK(fs::exists(cacheFolder / (recentKey + ".desc")));
+    BOOST_CHECK(!fs::exists(cacheFolder / "interrupted.tmp"));
+    BOOST_CHECK(!fs::exists(cacheFolder / "orphan.desc"));
+}
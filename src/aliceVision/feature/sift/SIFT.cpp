@@ -6,11 +6,122 @@
 
 #include "SIFT.hpp"
 
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <functional>
+
 namespace aliceVision {
 namespace feature {
 
 int VLFeatInstance::nbInstances = 0;
 
+namespace {
+
+/// Rows (in pixels of the first octave) computed around each band, so that the scale space, the detections
+/// and the descriptors of the rows owned by the band are the same as with the whole image
+const int siftBandHalo = 128;
+
+/// Minimum number of rows (in pixels of the first octave) owned by a band
+const int siftBandMinHeight = 1024;
+
+/**
+ * @brief Number of horizontal bands used to compute the first octave
+ * @param[in] octaveHeight The height of the first octave
+ * @return the number of bands, 1 if the first octave is computed on the whole image
+ */
+int getNbFirstOctaveBands(int octaveHeight)
+{
+    return std::max(1, std::min(omp_get_max_threads(), octaveHeight / siftBandMinHeight));
+}
+
+/**
+ * @brief Horizontal band of the image, with its own SIFT filter for the first octave.
+ */
+struct SiftBand
+{
+    VlSiftFilt* filt = nullptr;
+    /// first image row given to the filter (halo included)
+    int y0 = 0;
+    /// image rows owned by the band: [ownY0, ownY1)
+    int ownY0 = 0;
+    int ownY1 = 0;
+};
+
+/**
+ * @brief Split the image into horizontal bands and compute the first octave of each band in parallel.
+ * @param[in] image The input image
+ * @param[in] nbBands The number of bands
+ * @param[in] numScales The number of scales per octave
+ * @param[in] firstOctave The first octave index
+ * @param[in] setThresholds Configure the filter of a band like the filter of the whole image
+ * @param[out] bands The bands, with their first octave computed and their keypoints detected
+ */
+void processFirstOctaveByBands(const image::Image<float>& image, int nbBands, int numScales, int firstOctave,
+                               const std::function<void(VlSiftFilt*)>& setThresholds, std::vector<SiftBand>& bands)
+{
+    const int w = image.Width();
+    const int h = image.Height();
+
+    // Image rows are subsampled when the first octave is positive, band limits must stay on the sampling grid
+    const int step = 1 << std::max(0, firstOctave);
+    const int halo = VL_SHIFT_LEFT(siftBandHalo, firstOctave);
+
+    bands.resize(nbBands);
+    for(int b = 0; b < nbBands; ++b)
+    {
+        SiftBand& band = bands[b];
+        band.ownY0 = (b == 0) ? 0 : bands[b - 1].ownY1;
+        band.ownY1 = (b == nbBands - 1) ? h : (std::size_t(b + 1) * h / nbBands) / step * step;
+        band.y0 = std::max(0, band.ownY0 - halo);
+    }
+
+#pragma omp parallel for
+    for(int b = 0; b < nbBands; ++b)
+    {
+        SiftBand& band = bands[b];
+        const int y1 = std::min(h, band.ownY1 + halo);
+
+        band.filt = vl_sift_new(w, y1 - band.y0, 1, numScales, firstOctave);
+        setThresholds(band.filt);
+        vl_sift_process_first_octave(band.filt, image.data() + std::size_t(band.y0) * w);
+        vl_sift_detect(band.filt);
+    }
+}
+
+/**
+ * @brief Copy the rows owned by each band of the level used as base of the next octave into the filter of the whole image,
+ *        so that vl_sift_process_next_octave can go on as if the first octave had been computed by this filter.
+ */
+void mergeBandsFirstOctave(const std::vector<SiftBand>& bands, int firstOctave, VlSiftFilt* filt)
+{
+    filt->o_cur = firstOctave;
+    filt->nkeys = 0;
+    filt->octave_width = VL_SHIFT_LEFT(filt->width, -firstOctave);
+    filt->octave_height = VL_SHIFT_LEFT(filt->height, -firstOctave);
+
+    const int w = filt->octave_width;
+    const int s_best = std::min(filt->s_min + filt->S, filt->s_max);
+    vl_sift_pix* dst = vl_sift_get_octave(filt, s_best);
+
+#pragma omp parallel for
+    for(int b = 0; b < int(bands.size()); ++b)
+    {
+        const SiftBand& band = bands[b];
+        const vl_sift_pix* src = vl_sift_get_octave(band.filt, s_best);
+        const int bandOffset = VL_SHIFT_LEFT(band.y0, -firstOctave);
+        const int rowBegin = VL_SHIFT_LEFT(band.ownY0, -firstOctave);
+        const int rowEnd = std::min(VL_SHIFT_LEFT(band.ownY1, -firstOctave), filt->octave_height);
+
+        for(int row = rowBegin; row < rowEnd; ++row)
+        {
+            std::copy(src + std::size_t(row - bandOffset) * w, src + std::size_t(row - bandOffset + 1) * w,
+                      dst + std::size_t(row) * w);
+        }
+    }
+}
+
+} // namespace
+
 void SiftParams::setPreset(ConfigurationPreset preset)
 {
     switch(preset.descPreset)
@@ -116,8 +227,21 @@ std::size_t getMemoryConsumptionVLFeat(std::size_t width, std::size_t height, co
   pyramidMemoryConsuption *= params._numScales * sizeof(float);
 
   const int nbTempPyramids = 4; // Gaussian + DOG + Gradiant + orientation (Note: DOG use 1 layer less, but this is ignored here)
+
+  // The first octave of large images is also computed by bands, each band allocates its own first octave with its halo
+  std::size_t bandsMemoryConsumption = 0;
+  const int octaveHeight = int(height * scaleFactor);
+  const int nbBands = getNbFirstOctaveBands(octaveHeight);
+  if(nbBands > 1)
+  {
+    const std::size_t octaveWidth = width * scaleFactor;
+    const std::size_t bandsImgSize = octaveWidth * (octaveHeight + 2 * siftBandHalo * (nbBands - 1));
+    bandsMemoryConsumption = nbTempPyramids * bandsImgSize * params._numScales * sizeof(float);
+  }
+
   return fullImgSize * 4 * sizeof(float) + // input RGBA image
          nbTempPyramids * pyramidMemoryConsuption + // pyramids
+         bandsMemoryConsumption + // first octave bands
          (params._maxTotalKeypoints * 128 * sizeof(float)); // output keypoints
 }
 
@@ -146,9 +270,8 @@ bool extractSIFT(const image::Image<float>& image, std::unique_ptr<Regions>& reg
     // if image resolution is low, increase resolution for extraction
     const int firstOctave = params.getImageFirstOctave(w, h);
     VlSiftFilt* filt = vl_sift_new(w, h, numOctaves, params._numScales, firstOctave);
-    if(params._edgeThreshold >= 0)
-        vl_sift_set_edge_thresh(filt, params._edgeThreshold);
 
+    float peakThreshold = -1.0f;
     switch(params._contrastFiltering)
     {
         case EFeatureConstrastFiltering::Static:
@@ -156,7 +279,7 @@ bool extractSIFT(const image::Image<float>& image, std::unique_ptr<Regions>& reg
             ALICEVISION_LOG_TRACE("SIFT constrastTreshold Static: " << params._peakThreshold);
             if(params._peakThreshold >= 0)
             {
-                vl_sift_set_peak_thresh(filt, params._peakThreshold / params._numScales);
+                peakThreshold = params._peakThreshold / params._numScales;
             }
             break;
         }
@@ -169,7 +292,7 @@ bool extractSIFT(const image::Image<float>& image, std::unique_ptr<Regions>& reg
                                   << " - relativePeakThreshold: " << relativePeakThreshold << "\n"
                                   << " - medianOfGradiants: " << medianOfGradiants << "\n"
                                   << " - peakTreshold: " << dynPeakTreshold);
-            vl_sift_set_peak_thresh(filt, dynPeakTreshold / params._numScales);
+            peakThreshold = dynPeakTreshold / params._numScales;
             break;
         }
         case EFeatureConstrastFiltering::NoFiltering:
@@ -184,8 +307,28 @@ bool extractSIFT(const image::Image<float>& image, std::unique_ptr<Regions>& reg
         }
     }
 
+    const auto setThresholds = [&](VlSiftFilt* f) {
+        if(params._edgeThreshold >= 0)
+            vl_sift_set_edge_thresh(f, params._edgeThreshold);
+        if(peakThreshold >= 0)
+            vl_sift_set_peak_thresh(f, peakThreshold);
+    };
+    setThresholds(filt);
+
     // Process SIFT computation
-    vl_sift_process_first_octave(filt, image.data());
+    // The first octave holds most of the work: for large images, it is computed by horizontal bands in parallel.
+    // The following octaves are smaller and are computed on the whole image.
+    std::vector<SiftBand> bands;
+    const int nbBands = getNbFirstOctaveBands(VL_SHIFT_LEFT(h, -firstOctave));
+    if(nbBands > 1)
+    {
+        ALICEVISION_LOG_TRACE("SIFT first octave computed by " << nbBands << " bands.");
+        processFirstOctaveByBands(image, nbBands, params._numScales, firstOctave, setThresholds, bands);
+    }
+    else
+    {
+        vl_sift_process_first_octave(filt, image.data());
+    }
 
     using SIFT_Region_T = ScalarRegions<T, 128>;
     SIFT_Region_T* regionsCasted = new SIFT_Region_T();
@@ -201,12 +344,54 @@ bool extractSIFT(const image::Image<float>& image, std::unique_ptr<Regions>& reg
 
     size_t maxOctaveKeypoints = params._maxTotalKeypoints;
 
+    // Keypoints of the current octave in image coordinates,
+    // and the filter describing each of them with the keypoint in the coordinates of this filter
+    std::vector<VlSiftKeypoint> octaveKeys;
+    std::vector<VlSiftFilt*> octaveKeysFilt;
+    std::vector<VlSiftKeypoint> octaveKeysLocal;
+
     while(true)
     {
-        vl_sift_detect(filt);
+        octaveKeys.clear();
+        octaveKeysFilt.clear();
+        octaveKeysLocal.clear();
 
-        VlSiftKeypoint const* keys = vl_sift_get_keypoints(filt);
-        const int nkeys = vl_sift_get_nkeypoints(filt);
+        if(bands.empty())
+        {
+            vl_sift_detect(filt);
+
+            VlSiftKeypoint const* filtKeys = vl_sift_get_keypoints(filt);
+            const int nfiltKeys = vl_sift_get_nkeypoints(filt);
+            octaveKeys.assign(filtKeys, filtKeys + nfiltKeys);
+            octaveKeysLocal.assign(filtKeys, filtKeys + nfiltKeys);
+            octaveKeysFilt.assign(nfiltKeys, filt);
+        }
+        else
+        {
+            // Keep the keypoints detected on the rows owned by each band, the others are detected by a neighbor band.
+            // Ownership uses the integer detection row, which is the same in both bands.
+            for(const SiftBand& band : bands)
+            {
+                VlSiftKeypoint const* bandKeys = vl_sift_get_keypoints(band.filt);
+                const int nbandKeys = vl_sift_get_nkeypoints(band.filt);
+                const int rowBegin = VL_SHIFT_LEFT(band.ownY0, -firstOctave);
+                const int rowEnd = VL_SHIFT_LEFT(band.ownY1, -firstOctave);
+                for(int i = 0; i < nbandKeys; ++i)
+                {
+                    VlSiftKeypoint key = bandKeys[i];
+                    key.y += band.y0;
+                    key.iy += VL_SHIFT_LEFT(band.y0, -firstOctave);
+                    if(key.iy < rowBegin || key.iy >= rowEnd)
+                        continue;
+                    octaveKeys.push_back(key);
+                    octaveKeysFilt.push_back(band.filt);
+                    octaveKeysLocal.push_back(bandKeys[i]);
+                }
+            }
+        }
+
+        VlSiftKeypoint const* keys = octaveKeys.data();
+        const int nkeys = octaveKeys.size();
 
         std::vector<IndexT> filteredKeypointsIndex;
 
@@ -350,7 +535,16 @@ bool extractSIFT(const image::Image<float>& image, std::unique_ptr<Regions>& reg
         }
 
         // Update gradient before launching parallel extraction
-        vl_sift_update_gradient(filt);
+        if(bands.empty())
+        {
+            vl_sift_update_gradient(filt);
+        }
+        else
+        {
+#pragma omp parallel for
+            for(int b = 0; b < int(bands.size()); ++b)
+                vl_sift_update_gradient(bands[b].filt);
+        }
 
         // Feature masking
         if(mask)
@@ -374,12 +568,14 @@ bool extractSIFT(const image::Image<float>& image, std::unique_ptr<Regions>& reg
         for(int ii = 0; ii < filteredKeypointsIndex.size(); ++ii)
         {
             const int i = filteredKeypointsIndex[ii];
+            VlSiftFilt* keyFilt = octaveKeysFilt[i];
+            const VlSiftKeypoint* keyLocal = &octaveKeysLocal[i];
 
             double angles[4] = {0.0, 0.0, 0.0, 0.0};
             int nangles = 1; // by default (1 upright feature)
             if(orientation)
             { // compute from 1 to 4 orientations
-                nangles = vl_sift_calc_keypoint_orientations(filt, angles, keys + i);
+                nangles = vl_sift_calc_keypoint_orientations(keyFilt, angles, keyLocal);
             }
 
             Descriptor<vl_sift_pix, 128> vlFeatDescriptor;
@@ -389,7 +585,7 @@ bool extractSIFT(const image::Image<float>& image, std::unique_ptr<Regions>& reg
             {
                 const PointFeature fp(keys[i].x, keys[i].y, keys[i].sigma, static_cast<float>(angles[q]));
 
-                vl_sift_calc_keypoint_descriptor(filt, &vlFeatDescriptor[0], keys + i, angles[q]);
+                vl_sift_calc_keypoint_descriptor(keyFilt, &vlFeatDescriptor[0], keyLocal, angles[q]);
                 convertSIFT<T>(&vlFeatDescriptor[0], descriptor, params._rootSift);
 
 #pragma omp critical
@@ -401,6 +597,15 @@ bool extractSIFT(const image::Image<float>& image, std::unique_ptr<Regions>& reg
             }
         }
 
+        if(!bands.empty())
+        {
+            // The next octave is computed on the whole image, from the base level gathered from the bands
+            mergeBandsFirstOctave(bands, firstOctave, filt);
+            for(SiftBand& band : bands)
+                vl_sift_delete(band.filt);
+            bands.clear();
+        }
+
         if(vl_sift_process_next_octave(filt))
             break; // Last octave
     }
@@ -0,0 +1,109 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/feature/sift/SIFT.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <cmath>
+#include <random>
+
+#define BOOST_TEST_MODULE FeatureSIFT
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::feature;
+
+namespace {
+
+using SIFTRegions = ScalarRegions<unsigned char, 128>;
+
+void extractWithThreads(const image::Image<float>& image, const SiftParams& params, int nbThreads, std::unique_ptr<Regions>& regions)
+{
+    const int maxThreads = omp_get_max_threads();
+    omp_set_num_threads(nbThreads);
+    extractSIFT<unsigned char>(image, regions, params, true, nullptr);
+    omp_set_num_threads(maxThreads);
+}
+
+float angleDifference(float a, float b)
+{
+    const float d = std::abs(a - b);
+    return std::min(d, float(2.0 * M_PI) - d);
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(SIFT_firstOctaveBands)
+{
+    // Upscaled first octave of 1280x2560 pixels: computed by 2 bands with at least 2 threads
+    const int width = 640;
+    const int height = 1280;
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    image::Image<float> image(width, height);
+    for(int y = 0; y < height; ++y)
+        for(int x = 0; x < width; ++x)
+            image(y, x) = 0.5f + 0.25f * std::sin(x * 0.05f + std::sin(y * 0.031f) * 3.0f) * std::cos(y * 0.043f) + 0.1f * distribution(generator);
+
+    VLFeatInstance::initialize();
+
+    SiftParams params;
+    std::unique_ptr<Regions> wholeRegions;
+    std::unique_ptr<Regions> bandsRegions;
+    extractWithThreads(image, params, 1, wholeRegions);
+    extractWithThreads(image, params, 4, bandsRegions);
+
+    VLFeatInstance::destroy();
+
+    const SIFTRegions& whole = dynamic_cast<const SIFTRegions&>(*wholeRegions);
+    const SIFTRegions& bands = dynamic_cast<const SIFTRegions&>(*bandsRegions);
+
+    BOOST_REQUIRE_GT(whole.RegionCount(), 1000);
+    BOOST_CHECK_EQUAL(whole.RegionCount(), bands.RegionCount());
+
+    // Each keypoint matches a keypoint of the whole image extraction, up to the float rounding of the band offset.
+    // A secondary orientation on the histogram threshold may flip, which is tolerated on a few keypoints.
+    std::size_t nbUnmatched = 0;
+    for(std::size_t i = 0; i < bands.RegionCount(); ++i)
+    {
+        const PointFeature& feature = bands.Features()[i];
+        bool matched = false;
+        for(std::size_t j = 0; j < whole.RegionCount() && !matched; ++j)
+        {
+            const PointFeature& reference = whole.Features()[j];
+            if(std::abs(feature.x() - reference.x()) > 1e-2f || std::abs(feature.y() - reference.y()) > 1e-2f ||
+               std::abs(feature.scale() - reference.scale()) > 1e-2f ||
+               angleDifference(feature.orientation(), reference.orientation()) > 1e-2f)
+                continue;
+
+            int maxDescriptorDifference = 0;
+            for(int k = 0; k < 128; ++k)
+                maxDescriptorDifference = std::max(maxDescriptorDifference,
+                                                   std::abs(int(bands.Descriptors()[i][k]) - int(whole.Descriptors()[j][k])));
+            matched = (maxDescriptorDifference <= 2);
+        }
+        if(!matched)
+            ++nbUnmatched;
+    }
+    BOOST_CHECK_LE(nbUnmatched, bands.RegionCount() / 200);
+}
+
+BOOST_AUTO_TEST_CASE(SIFT_memoryConsumptionBands)
+{
+    // The first octave bands need additional memory
+    SiftParams params;
+    const int maxThreads = omp_get_max_threads();
+
+    omp_set_num_threads(1);
+    const std::size_t wholeMemory = getMemoryConsumptionVLFeat(640, 1280, params);
+    omp_set_num_threads(4);
+    const std::size_t bandsMemory = getMemoryConsumptionVLFeat(640, 1280, params);
+    omp_set_num_threads(maxThreads);
+
+    BOOST_CHECK_GT(bandsMemory, wholeMemory);
+}
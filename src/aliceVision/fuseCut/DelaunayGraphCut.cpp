@@ -8,6 +8,7 @@
 // #define ALICEVISION_DEBUG_VOTE
 
 #include "DelaunayGraphCut.hpp"
+#include "FusedPointsVoxelHash.hpp"
 // #include <aliceVision/fuseCut/MaxFlow_CSR.hpp>
 #include <aliceVision/fuseCut/MaxFlow_AdjList.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
@@ -20,6 +21,7 @@
 #include <aliceVision/mvsUtils/depthSimMapIO.hpp>
 #include <aliceVision/image/imageAlgo.hpp>
 #include <aliceVision/system/ProgressDisplay.hpp>
+#include <aliceVision/system/Timer.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 
 #include "nanoflann.hpp"
@@ -29,7 +31,9 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/operations.hpp>
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <random>
 #include <stdexcept>
 
@@ -269,6 +273,196 @@ void removeInvalidPoints(std::vector<Point3d>& verticesCoordsPrepare, std::vecto
     verticesAttrPrepare.swap(verticesAttrTmp);
 }
 
+/**
+ * @brief Order the cameras along a Z-order curve of their centers, so that consecutive cameras are close in space
+ * @param[in] mp the multi-view parameters
+ * @param[in] cams the camera indexes to order
+ * @return the camera indexes in processing order
+ */
+std::vector<int> getCamerasSpatialOrder(const mvsUtils::MultiViewParams& mp, const StaticVector<int>& cams)
+{
+    Point3d bbMin(std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max());
+    Point3d bbMax(std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest());
+    for(int c : cams)
+    {
+        for(int d = 0; d < 3; ++d)
+        {
+            bbMin.m[d] = std::min(bbMin.m[d], mp.CArr[c].m[d]);
+            bbMax.m[d] = std::max(bbMax.m[d], mp.CArr[c].m[d]);
+        }
+    }
+
+    // interleave the bits of the quantized coordinates
+    std::vector<std::pair<std::uint64_t, int>> codes(cams.size());
+    for(int i = 0; i < cams.size(); ++i)
+    {
+        const int c = cams[i];
+        std::uint64_t code = 0;
+        for(int d = 0; d < 3; ++d)
+        {
+            const double extent = bbMax.m[d] - bbMin.m[d];
+            const std::uint64_t q = (extent > 0.0) ? static_cast<std::uint64_t>((mp.CArr[c].m[d] - bbMin.m[d]) / extent * 1023.0) : 0;
+            for(int b = 0; b < 10; ++b)
+                code |= ((q >> b) & 1) << (3 * b + d);
+        }
+        codes[i] = std::make_pair(code, c);
+    }
+    std::sort(codes.begin(), codes.end());
+
+    std::vector<int> order(cams.size());
+    for(int i = 0; i < cams.size(); ++i)
+        order[i] = codes[i].second;
+    return order;
+}
+
+/**
+ * @brief Read the depth/sim/nmod maps of a camera and select the best depth value per tile of step x step pixels
+ * @param[in] mp the multi-view parameters
+ * @param[in] c the camera index
+ * @param[in] step the tile size
+ * @param[in] voxel the hexahedron of the reconstructed space (nullptr for the whole space)
+ * @param[in] params the fuse parameters
+ * @param[out] out_coords the 3d point of each tile
+ * @param[out] out_pixSize the pixel size of each tile point, -1 for discarded tiles
+ * @param[out] out_simScore the similarity score of each tile point
+ * @return false if the depth map is empty (outputs are left untouched)
+ */
+bool selectDepthMapPoints(mvsUtils::MultiViewParams& mp, int c, int step, const Point3d voxel[8], const FuseParams& params,
+                          Point3d* out_coords, double* out_pixSize, float* out_simScore)
+{
+    image::Image<float> depthMap;
+    image::Image<float> simMap;
+    image::Image<unsigned char> numOfModalsMap;
+
+    const int width = mp.getWidth(c);
+    const int height = mp.getHeight(c);
+
+    {
+        // read depth map
+        mvsUtils::readDepthMap(c, mp, depthMap, 0);
+
+        if(depthMap.size() <= 0)
+        {
+            ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << c << ")");
+            return false;
+        }
+
+        // read similarity map
+        try
+        {
+            mvsUtils::readSimMap(c, mp, simMap, 0);
+                image::Image<float> simMapTmp;
+                imageAlgo::convolveImage(simMap, simMapTmp, "gaussian",
+                                         params.simGaussianSizeInit,
+                                         params.simGaussianSizeInit);
+                simMap.swap(simMapTmp);
+        }
+        catch(const std::exception& e)
+        {
+            ALICEVISION_LOG_WARNING("simMap file can't be found.");
+            simMap.resize(width, height, true, -1);
+        }
+
+        // read nmod map
+        int wTmp, hTmp;
+        const std::string nmodMapFilepath = getFileNameFromIndex(mp, c, mvsUtils::EFileType::nmodMap, 0);
+        // If we have an nModMap in input (from depthmapfilter) use it,
+        // else init with a constant value.
+        if(boost::filesystem::exists(nmodMapFilepath))
+        {
+            image::readImage(nmodMapFilepath, numOfModalsMap,
+                             image::EImageColorSpace::NO_CONVERSION);
+            if (numOfModalsMap.Width() != width || numOfModalsMap.Height() != height)
+                throw std::runtime_error("Wrong nmod map dimensions: " + nmodMapFilepath);
+        }
+        else
+        {
+            ALICEVISION_LOG_WARNING("nModMap file can't be found.");
+            numOfModalsMap.resize(width, height, true, 1);
+        }
+    }
+
+    int syMax = divideRoundUp(height, step);
+    int sxMax = divideRoundUp(width, step);
+    #pragma omp parallel for
+    for(int sy = 0; sy < syMax; ++sy)
+    {
+        for(int sx = 0; sx < sxMax; ++sx)
+        {
+            const int index = sy * sxMax + sx;
+            float bestDepth = std::numeric_limits<float>::max();
+            float bestScore = 0;
+            float bestSimScore = 0;
+            int bestX = 0;
+            int bestY = 0;
+            for(int y = sy * step, ymax = std::min((sy+1) * step, height);
+                y < ymax; ++y)
+            {
+                for(int x = sx * step, xmax = std::min((sx+1) * step, width);
+                    x < xmax; ++x)
+                {
+                    const std::size_t index = y * width + x;
+                    const float depth = depthMap(index);
+                    if(depth <= 0.0f)
+                        continue;
+
+                    int numOfModals = 0;
+                    const int scoreKernelSize = 1;
+                    for(int ly = std::max(y-scoreKernelSize, 0), lyMax = std::min(y+scoreKernelSize, height-1); ly < lyMax; ++ly)
+                    {
+                        for(int lx = std::max(x-scoreKernelSize, 0), lxMax = std::min(x+scoreKernelSize, width-1); lx < lxMax; ++lx)
+                        {
+                            if (depthMap(ly * width + lx) > 0.0f)
+                            {
+                                numOfModals += 10 + int(numOfModalsMap(ly * width + lx));
+                            }
+                        }
+                    }
+                    float sim = simMap(index);
+                    sim = sim < 0.0f ?  0.0f : sim; // clamp values < 0
+                    // remap similarity values from [-1;+1] to [+1;+simScale]
+                    // interpretation is [goodSimilarity;badSimilarity]
+                    const float simScore = 1.0f + sim * params.simFactor;
+
+                    const float score = numOfModals + (1.0f / simScore);
+                    if(score > bestScore)
+                    {
+                        bestDepth = depth;
+                        bestScore = score;
+                        bestSimScore = simScore;
+                        bestX = x;
+                        bestY = y;
+                    }
+                }
+            }
+            if(bestScore < 3*13)
+            {
+                // discard the point
+                out_pixSize[index] = -1.0;
+            }
+            else
+            {
+                Point3d p = mp.CArr[c] + (mp.iCamArr[c] * Point2d((float)bestX, (float)bestY)).normalize() * bestDepth;
+                
+                // TODO: isPointInHexahedron: here or in the previous loop per pixel to not loose point?
+                if(voxel == nullptr || mvsUtils::isPointInHexahedron(p, voxel)) 
+                {
+                    out_coords[index] = p;
+                    out_simScore[index] = bestSimScore;
+                    out_pixSize[index] = mp.getCamPixelSize(p, c);
+                }
+                else
+                {
+                    // discard the point
+                    // out_coords[index] = p;
+                    out_pixSize[index] = -1.0;
+                }
+            }
+        }
+    }
+    return true;
+}
+
 void createVerticesWithVisibilities(const StaticVector<int>& cams, std::vector<Point3d>& verticesCoordsPrepare, std::vector<double>& pixSizePrepare, std::vector<float>& simScorePrepare,
                                     std::vector<GC_vertexInfo>& verticesAttrPrepare, mvsUtils::MultiViewParams& mp, float simFactor, float voteMarginFactor, float contributeMarginFactor, float simGaussianSize)
 {
@@ -292,9 +486,10 @@ void createVerticesWithVisibilities(const StaticVector<int>& cams, std::vector<P
 
     omp_set_nested(1);
     #pragma omp parallel for num_threads(3)
-    for(int c = 0; c < cams.size(); ++c)
+    for(int i = 0; i < cams.size(); ++i)
     {
-        ALICEVISION_LOG_INFO("Create visibilities (" << c << "/" << cams.size() << ")");
+        const int c = cams[i];
+        ALICEVISION_LOG_INFO("Create visibilities (" << i << "/" << cams.size() << ")");
         image::Image<float> depthMap;
         image::Image<float> simMap;
         const int width = mp.getWidth(c);
@@ -475,7 +670,10 @@ std::vector<DelaunayGraphCut::CellIndex> DelaunayGraphCut::getNeighboringCellsBy
     case EGeometryType::Edge:
         return getNeighboringCellsByEdge(g.edge);
     case EGeometryType::Vertex:
-        return getNeighboringCellsByVertexIndex(g.vertexIndex);
+    {
+        const CellsRange cells = getNeighboringCellsByVertexIndex(g.vertexIndex);
+        return std::vector<CellIndex>(cells.begin(), cells.end());
+    }
     case EGeometryType::Facet:
         return getNeighboringCellsByFacet(g.facet);
     case EGeometryType::None:
@@ -498,8 +696,8 @@ std::vector<DelaunayGraphCut::CellIndex> DelaunayGraphCut::getNeighboringCellsBy
 
 std::vector<DelaunayGraphCut::CellIndex> DelaunayGraphCut::getNeighboringCellsByEdge(const Edge& e) const
 {
-    const std::vector<CellIndex>& v0ci = getNeighboringCellsByVertexIndex(e.v0);
-    const std::vector<CellIndex>& v1ci = getNeighboringCellsByVertexIndex(e.v1);
+    const CellsRange v0ci = getNeighboringCellsByVertexIndex(e.v0);
+    const CellsRange v1ci = getNeighboringCellsByVertexIndex(e.v1);
 
     std::vector<CellIndex> neighboringCells;
     std::set_intersection(v0ci.begin(), v0ci.end(), v1ci.begin(), v1ci.end(), std::back_inserter(neighboringCells));
@@ -524,6 +722,53 @@ void DelaunayGraphCut::computeDelaunay()
     ALICEVISION_LOG_DEBUG("computeDelaunay done\n");
 }
 
+void DelaunayGraphCut::updateVertexToCellsCache()
+{
+    const system::Timer timer;
+    const VertexIndex nbVertices = _verticesCoords.size();
+    const CellIndex nbCells = _tetrahedralization->nb_cells();
+
+    // count the cells of each vertex, then fill them in increasing order so the cells of a vertex are sorted
+    std::vector<std::size_t> offsets(nbVertices + 1, 0);
+    int coutInvalidVertices = 0;
+    for(CellIndex ci = 0; ci < nbCells; ++ci)
+    {
+        for(VertexIndex k = 0; k < 4; ++k)
+        {
+            const VertexIndex vi = _tetrahedralization->cell_vertex(ci, k);
+            if(vi == GEO::NO_VERTEX || vi >= nbVertices)
+            {
+                ++coutInvalidVertices;
+                continue;
+            }
+            ++offsets[vi + 1];
+        }
+    }
+    for(VertexIndex vi = 0; vi < nbVertices; ++vi)
+        offsets[vi + 1] += offsets[vi];
+
+    std::vector<CellIndex> cells(offsets.back());
+    std::vector<std::size_t> fillIndex(offsets.begin(), offsets.end() - 1);
+    for(CellIndex ci = 0; ci < nbCells; ++ci)
+    {
+        for(VertexIndex k = 0; k < 4; ++k)
+        {
+            const VertexIndex vi = _tetrahedralization->cell_vertex(ci, k);
+            if(vi == GEO::NO_VERTEX || vi >= nbVertices)
+                continue;
+            cells[fillIndex[vi]++] = ci;
+        }
+    }
+
+    _neighboringCellsOffsets.swap(offsets);
+    _neighboringCells.swap(cells);
+
+    ALICEVISION_LOG_INFO("coutInvalidVertices: " << coutInvalidVertices);
+    ALICEVISION_LOG_INFO("Vertex to cells cache: " << nbVertices << " vertices, " << _neighboringCells.size() << " cells references, "
+                         << (_neighboringCellsOffsets.size() * sizeof(std::size_t) + _neighboringCells.size() * sizeof(CellIndex)) / (1024 * 1024)
+                         << " MB, built in " << timer.elapsedMs() << " ms.");
+}
+
 void DelaunayGraphCut::initCells()
 {
     _cellsAttr.resize(_tetrahedralization->nb_cells()); // or nb_finite_cells() if keeps_infinite()
@@ -937,8 +1182,9 @@ void DelaunayGraphCut::addMaskHelperPoints(const Point3d voxel[8], const StaticV
 
     ALICEVISION_LOG_INFO("Load depth maps and add points.");
     {
-        for(int c = 0; c < cams.size(); c++)
+        for(int i = 0; i < cams.size(); i++)
         {
+            const int c = cams[i];
             image::Image<float> depthMap;
 
             mvsUtils::readDepthMap(c, _mp, depthMap, 0);
@@ -1043,25 +1289,22 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
 
     // unsigned long nbValidDepths = computeNumberOfAllPoints(mp, 0);
     // int stepPts = divideRoundUp(nbValidDepths, maxPoints);
+    // only the cameras of the reconstructed space are loaded
     std::size_t nbPixels = 0;
-    for(const auto& imgParams: _mp.getImagesParams())
+    for(int c : cams)
     {
-        nbPixels += imgParams.size;
+        nbPixels += _mp.getImageParams(c).size;
     }
     int step = std::floor(std::sqrt(double(nbPixels) / double(params.maxInputPoints)));
     step = std::max(step, params.minStep);
-    std::size_t realMaxVertices = 0;
-    std::vector<int> startIndex(_mp.getNbCameras(), 0);
-    for(int i = 0; i < _mp.getNbCameras(); ++i)
-    {
-        const auto& imgParams = _mp.getImageParams(i);
-        startIndex[i] = realMaxVertices;
-        realMaxVertices += divideRoundUp(imgParams.width, step) *
-                           divideRoundUp(imgParams.height, step);
-    }
-    std::vector<Point3d> verticesCoordsPrepare(realMaxVertices);
-    std::vector<double> pixSizePrepare(realMaxVertices);
-    std::vector<float> simScorePrepare(realMaxVertices);
+
+    // the streaming fuse memory does not depend on the number of input points
+    if(params.streamingFuse)
+        step = params.minStep;
+
+    std::vector<Point3d> verticesCoordsPrepare;
+    std::vector<double> pixSizePrepare;
+    std::vector<float> simScorePrepare;
 
     // counter for points filtered based on the number of observations (minVis)
     int minVisCounter = 0;
@@ -1070,145 +1313,73 @@ void DelaunayGraphCut::fuseFromDepthMaps(const StaticVector<int>& cams, const Po
     ALICEVISION_LOG_INFO("nbPixels: " << nbPixels);
     ALICEVISION_LOG_INFO("maxVertices: " << params.maxPoints);
     ALICEVISION_LOG_INFO("step: " << step);
-    ALICEVISION_LOG_INFO("realMaxVertices: " << realMaxVertices);
     ALICEVISION_LOG_INFO("minVis: " << params.minVis);
 
-    ALICEVISION_LOG_INFO("Load depth maps and add points.");
+    if(params.streamingFuse)
     {
-        omp_set_nested(1);
-        #pragma omp parallel for num_threads(3)
-        for(int c = 0; c < cams.size(); c++)
-        {
-            image::Image<float> depthMap;
-            image::Image<float> simMap;
-            image::Image<unsigned char> numOfModalsMap;
+        // only keep a few times the final number of points in memory
+        const std::size_t maxVoxels = std::size_t(params.streamingFuseMaxPointsFactor * params.maxPoints);
+        ALICEVISION_LOG_INFO("Load depth maps and fuse points in a voxel hash of at most " << maxVoxels << " voxels.");
 
-            const int width = _mp.getWidth(c);
-            const int height = _mp.getHeight(c);
+        FusedPointsVoxelHash voxelHash(params.pixSizeMarginInitCoef, maxVoxels);
 
-            {
-                // read depth map
-                mvsUtils::readDepthMap(c, _mp, depthMap, 0);
+        // cameras close in space fill the same voxels
+        const std::vector<int> camsOrder = getCamerasSpatialOrder(_mp, cams);
 
-                if(depthMap.size() <= 0)
-                {
-                    ALICEVISION_LOG_WARNING("Empty depth map (cam id: " << c << ")");
-                    continue;
-                }
+        omp_set_nested(1);
+        #pragma omp parallel for num_threads(3) schedule(dynamic)
+        for(int i = 0; i < camsOrder.size(); i++)
+        {
+            const int c = camsOrder[i];
+            const int nbTiles = divideRoundUp(_mp.getWidth(c), step) * divideRoundUp(_mp.getHeight(c), step);
 
-                // read similarity map
-                try
-                {
-                    mvsUtils::readSimMap(c, _mp, simMap, 0);
-                        image::Image<float> simMapTmp;
-                        imageAlgo::convolveImage(simMap, simMapTmp, "gaussian",
-                                                 params.simGaussianSizeInit,
-                                                 params.simGaussianSizeInit);
-                        simMap.swap(simMapTmp);
-                }
-                catch(const std::exception& e)
-                {
-                    ALICEVISION_LOG_WARNING("simMap file can't be found.");
-                    simMap.resize(width, height, true, -1);
-                }
+            std::vector<Point3d> coords(nbTiles);
+            std::vector<double> pixSize(nbTiles, -1.0);
+            std::vector<float> simScore(nbTiles);
 
-                // read nmod map
-                int wTmp, hTmp;
-                const std::string nmodMapFilepath = getFileNameFromIndex(_mp, c, mvsUtils::EFileType::nmodMap, 0);
-                // If we have an nModMap in input (from depthmapfilter) use it,
-                // else init with a constant value.
-                if(boost::filesystem::exists(nmodMapFilepath))
-                {
-                    image::readImage(nmodMapFilepath, numOfModalsMap,
-                                     image::EImageColorSpace::NO_CONVERSION);
-                    if (numOfModalsMap.Width() != width || numOfModalsMap.Height() != height)
-                        throw std::runtime_error("Wrong nmod map dimensions: " + nmodMapFilepath);
-                }
-                else
-                {
-                    ALICEVISION_LOG_WARNING("nModMap file can't be found.");
-                    numOfModalsMap.resize(width, height, true, 1);
-                }
-            }
+            if(!selectDepthMapPoints(_mp, c, step, voxel, params, coords.data(), pixSize.data(), simScore.data()))
+                continue;
 
-            int syMax = divideRoundUp(height, step);
-            int sxMax = divideRoundUp(width, step);
-            #pragma omp parallel for
-            for(int sy = 0; sy < syMax; ++sy)
+            std::vector<FusedPoint> points;
+            points.reserve(nbTiles);
+            for(int t = 0; t < nbTiles; ++t)
             {
-                for(int sx = 0; sx < sxMax; ++sx)
-                {
-                    int index = startIndex[c] + sy * sxMax + sx;
-                    float bestDepth = std::numeric_limits<float>::max();
-                    float bestScore = 0;
-                    float bestSimScore = 0;
-                    int bestX = 0;
-                    int bestY = 0;
-                    for(int y = sy * step, ymax = std::min((sy+1) * step, height);
-                        y < ymax; ++y)
-                    {
-                        for(int x = sx * step, xmax = std::min((sx+1) * step, width);
-                            x < xmax; ++x)
-                        {
-                            const std::size_t index = y * width + x;
-                            const float depth = depthMap(index);
-                            if(depth <= 0.0f)
-                                continue;
+                if(pixSize[t] != -1.0)
+                    points.push_back({coords[t], pixSize[t], simScore[t]});
+            }
+            voxelHash.add(points);
+        }
+        omp_set_nested(0);
 
-                            int numOfModals = 0;
-                            const int scoreKernelSize = 1;
-                            for(int ly = std::max(y-scoreKernelSize, 0), lyMax = std::min(y+scoreKernelSize, height-1); ly < lyMax; ++ly)
-                            {
-                                for(int lx = std::max(x-scoreKernelSize, 0), lxMax = std::min(x+scoreKernelSize, width-1); lx < lxMax; ++lx)
-                                {
-                                    if (depthMap(ly * width + lx) > 0.0f)
-                                    {
-                                        numOfModals += 10 + int(numOfModalsMap(ly * width + lx));
-                                    }
-                                }
-                            }
-                            float sim = simMap(index);
-                            sim = sim < 0.0f ?  0.0f : sim; // clamp values < 0
-                            // remap similarity values from [-1;+1] to [+1;+simScale]
-                            // interpretation is [goodSimilarity;badSimilarity]
-                            const float simScore = 1.0f + sim * params.simFactor;
+        voxelHash.getPoints(verticesCoordsPrepare, pixSizePrepare, simScorePrepare);
+        ALICEVISION_LOG_INFO("Voxel hash fuse: " << verticesCoordsPrepare.size() << " points ("
+                             << voxelHash.getNbCoarsenings() << " voxel size increases).");
+    }
+    else
+    {
+        // one point per tile of step x step pixels for each camera
+        std::size_t realMaxVertices = 0;
+        std::vector<std::size_t> startIndex(cams.size(), 0);
+        for(int i = 0; i < cams.size(); ++i)
+        {
+            const auto& imgParams = _mp.getImageParams(cams[i]);
+            startIndex[i] = realMaxVertices;
+            realMaxVertices += divideRoundUp(imgParams.width, step) *
+                               divideRoundUp(imgParams.height, step);
+        }
+        ALICEVISION_LOG_INFO("realMaxVertices: " << realMaxVertices);
 
-                            const float score = numOfModals + (1.0f / simScore);
-                            if(score > bestScore)
-                            {
-                                bestDepth = depth;
-                                bestScore = score;
-                                bestSimScore = simScore;
-                                bestX = x;
-                                bestY = y;
-                            }
-                        }
-                    }
-                    if(bestScore < 3*13)
-                    {
-                        // discard the point
-                        pixSizePrepare[index] = -1.0;
-                    }
-                    else
-                    {
-                        Point3d p = _mp.CArr[c] + (_mp.iCamArr[c] * Point2d((float)bestX, (float)bestY)).normalize() * bestDepth;
-                        
-                        // TODO: isPointInHexahedron: here or in the previous loop per pixel to not loose point?
-                        if(voxel == nullptr || mvsUtils::isPointInHexahedron(p, voxel)) 
-                        {
-                            verticesCoordsPrepare[index] = p;
-                            simScorePrepare[index] = bestSimScore;
-                            pixSizePrepare[index] = _mp.getCamPixelSize(p, c);
-                        }
-                        else
-                        {
-                            // discard the point
-                            // verticesCoordsPrepare[index] = p;
-                            pixSizePrepare[index] = -1.0;
-                        }
-                    }
-                }
-            }
+        verticesCoordsPrepare.resize(realMaxVertices);
+        pixSizePrepare.resize(realMaxVertices);
+        simScorePrepare.resize(realMaxVertices);
+
+        ALICEVISION_LOG_INFO("Load depth maps and add points.");
+        omp_set_nested(1);
+        #pragma omp parallel for num_threads(3)
+        for(int c = 0; c < cams.size(); c++)
+        {
+            selectDepthMapPoints(_mp, cams[c], step, voxel, params, &verticesCoordsPrepare[startIndex[c]],
+                                 &pixSizePrepare[startIndex[c]], &simScorePrepare[startIndex[c]]);
         }
         omp_set_nested(0);
     }
@@ -2215,7 +2386,7 @@ void DelaunayGraphCut::fillGraphPartPtRc(
                         //throw std::runtime_error("[error] The firstIteration vote could only happen during for the first cell when we come from the first vertex.");
                     }
                     // the information of first intersected cell can only be found by taking intersection of neighbouring cells for both geometries
-                    const std::vector<CellIndex> previousNeighbouring = getNeighboringCellsByVertexIndex(previousGeometry.vertexIndex);
+                    const CellsRange previousNeighbouring = getNeighboringCellsByVertexIndex(previousGeometry.vertexIndex);
                     const std::vector<CellIndex> currentNeigbouring = getNeighboringCellsByGeometry(geometry);
 
                     std::vector<CellIndex> neighboringCells;
@@ -2543,7 +2714,7 @@ void DelaunayGraphCut::forceTedgesByGradientIJCV(float nPixelSizeBehind)
                                 // throw std::runtime_error("[error] The firstIteration vote could only happen during for the first cell when we come from the first vertex.");
                             }
                             // the information of first intersected cell can only be found by taking intersection of neighbouring cells for both geometries
-                            const std::vector<CellIndex> previousNeighbouring = getNeighboringCellsByVertexIndex(previousGeometry.vertexIndex);
+                            const CellsRange previousNeighbouring = getNeighboringCellsByVertexIndex(previousGeometry.vertexIndex);
                             const std::vector<CellIndex> currentNeigbouring = getNeighboringCellsByGeometry(geometry);
 
                             std::vector<CellIndex> neighboringCells;
@@ -2916,12 +3087,12 @@ void DelaunayGraphCut::cellsStatusFilteringBySolidAngleRatio(int nbSolidAngleFil
         const int nbSurfaceFacets = computeIsOnSurface(vertexIsOnSurface);
 
 #pragma omp parallel for reduction(+ : toInvertCount)
-        for(int vi = 0; vi < _neighboringCellsPerVertex.size(); ++vi)
+        for(int vi = 0; vi < _verticesCoords.size(); ++vi)
         {
             if(!vertexIsOnSurface[vi])
                 continue;
             // ALICEVISION_LOG_INFO("vertex is on surface: " << vi);
-            const std::vector<CellIndex>& neighboringCells = _neighboringCellsPerVertex[vi];
+            const CellsRange neighboringCells = getNeighboringCellsByVertexIndex(vi);
             std::vector<Facet> neighboringFacets;
             neighboringFacets.reserve(neighboringCells.size());
             bool borderCase = false;
@@ -58,6 +58,11 @@ struct FuseParams
     // Weight for helper points from mask. Do not create helper points if zero.
     float maskHelperPointsWeight = 0.0;
     int maskBorderSize = 1;
+    /// Fuse the depth maps points in a voxel hash while loading them, instead of loading all points (maxInputPoints) first.
+    /// The memory then depends on maxPoints only, and minStep is used to load depth values.
+    bool streamingFuse = false;
+    /// With streamingFuse, maximal number of points kept in memory, relative to maxPoints
+    float streamingFuseMaxPointsFactor = 4.0f;
 };
 
 
@@ -67,6 +72,19 @@ public:
     using VertexIndex = GEO::index_t;
     using CellIndex = GEO::index_t;
 
+    /// Contiguous range of cell indexes, valid as long as the vertex to cells cache is not updated
+    struct CellsRange
+    {
+        const CellIndex* first = nullptr;
+        const CellIndex* last = nullptr;
+
+        const CellIndex* begin() const { return first; }
+        const CellIndex* end() const { return last; }
+        std::size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+        CellIndex operator[](std::size_t i) const { return first[i]; }
+    };
+
     struct Facet
     {
         CellIndex cellIndex = GEO::NO_CELL;
@@ -217,7 +235,10 @@ public:
     std::vector<bool> _cellIsFull;
 
     std::vector<int> _camsVertexes;
-    std::vector<std::vector<CellIndex>> _neighboringCellsPerVertex;
+    /// Cells around each vertex in compressed sparse row format: the sorted cells around the vertex vi
+    /// are _neighboringCells[_neighboringCellsOffsets[vi]] to _neighboringCells[_neighboringCellsOffsets[vi + 1] - 1]
+    std::vector<std::size_t> _neighboringCellsOffsets;
+    std::vector<CellIndex> _neighboringCells;
 
     bool saveTemporaryBinFiles;
 
@@ -335,36 +356,10 @@ public:
         return out;
     }
 
-    void updateVertexToCellsCache()
-    {
-        _neighboringCellsPerVertex.clear();
-
-        std::map<VertexIndex, std::set<CellIndex>> neighboringCellsPerVertexTmp;
-        int coutInvalidVertices = 0;
-        for (CellIndex ci = 0; ci < _tetrahedralization->nb_cells(); ++ci)
-        {
-            for(VertexIndex k = 0; k < 4; ++k)
-            {
-                const VertexIndex vi = _tetrahedralization->cell_vertex(ci, k);
-                if(vi == GEO::NO_VERTEX || vi >= _verticesCoords.size())
-                {
-                    ++coutInvalidVertices;
-                    continue;
-                }
-                neighboringCellsPerVertexTmp[vi].insert(ci);
-            }
-        }
-        ALICEVISION_LOG_INFO("coutInvalidVertices: " << coutInvalidVertices);
-        ALICEVISION_LOG_INFO("neighboringCellsPerVertexTmp: " << neighboringCellsPerVertexTmp.size());
-        _neighboringCellsPerVertex.resize(_verticesCoords.size());
-        ALICEVISION_LOG_INFO("verticesCoords: " << _verticesCoords.size());
-        for(const auto& it: neighboringCellsPerVertexTmp)
-        {
-            const std::set<CellIndex>& input = it.second;
-            std::vector<CellIndex>& output = _neighboringCellsPerVertex[it.first];
-            output.assign(input.begin(), input.end());
-        }
-    }
+    /**
+     * @brief Build the cells around each vertex from the tetrahedralization.
+     */
+    void updateVertexToCellsCache();
 
     /**
      * @brief vertexToCells
@@ -377,7 +372,7 @@ public:
      */
     inline CellIndex vertexToCells(VertexIndex vi, int lvi) const
     {
-        const std::vector<CellIndex>& localCells = _neighboringCellsPerVertex.at(vi);
+        const CellsRange localCells = getNeighboringCellsByVertexIndex(vi);
         if(lvi >= localCells.size())
             return GEO::NO_CELL;
         return localCells[lvi];
@@ -404,11 +399,14 @@ public:
      * @brief Retrieves the global indexes of neighboring cells using the global index of a vertex.
      * 
      * @param vi the global vertexIndex
-     * @return a vector of neighboring cell indices
+     * @return the sorted neighboring cell indices
      */
-    inline const std::vector<CellIndex>& getNeighboringCellsByVertexIndex(VertexIndex vi) const
+    inline CellsRange getNeighboringCellsByVertexIndex(VertexIndex vi) const
     {
-        return _neighboringCellsPerVertex.at(vi);
+        CellsRange cells;
+        cells.first = _neighboringCells.data() + _neighboringCellsOffsets.at(vi);
+        cells.last = _neighboringCells.data() + _neighboringCellsOffsets.at(vi + 1);
+        return cells;
     }
 
      /**
@@ -7,11 +7,15 @@
 #include <aliceVision/sfm/sfm.hpp>
 #include <aliceVision/multiview/NViewDataSet.hpp>
 #include <aliceVision/fuseCut/DelaunayGraphCut.hpp>
+#include <aliceVision/fuseCut/Fuser.hpp>
+#include <aliceVision/mvsUtils/depthSimMapIO.hpp>
+#include <aliceVision/system/Timer.hpp>
 
 #include <boost/filesystem.hpp>
 
 #include <boost/math/constants/constants.hpp>
 
+#include <random>
 #include <string>
 
 #define BOOST_TEST_MODULE fuseCut
@@ -109,6 +113,165 @@ BOOST_AUTO_TEST_CASE(fuseCut_delaunayGraphCut)
     ALICEVISION_LOG_TRACE("CreateGraphCut Done.");
 }
 
+BOOST_AUTO_TEST_CASE(fuseCut_fuseFromDepthMapsCamerasSubset)
+{
+    // cameras along the x axis looking in the z direction: the first two see a plane at depth 6, the others at depth 3
+    const int width = 64;
+    const int height = 48;
+    SfMData sfmData;
+    sfmData.intrinsics[0] = camera::createIntrinsic(camera::EINTRINSIC::PINHOLE_CAMERA, width, height, 60.0, 60.0, 0.0, 0.0);
+    for(int i = 0; i < 5; ++i)
+    {
+        sfmData.views[i] = std::make_shared<View>("", i, 0, i, width, height);
+        sfmData.setPose(*sfmData.views.at(i), CameraPose(geometry::Pose3(Mat3::Identity(), Vec3(0.2 * i, 0.0, 0.0))));
+    }
+
+    const boost::filesystem::path tmpFolder = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    boost::filesystem::create_directories(tmpFolder);
+    mvsUtils::MultiViewParams mp(sfmData, "", "", tmpFolder.string(), false);
+
+    for(int c = 0; c < mp.getNbCameras(); ++c)
+    {
+        const image::Image<float> depthMap(width, height, true, (c < 2) ? 6.0f : 3.0f);
+        const image::Image<float> simMap(width, height, true, -1.0f);
+        mvsUtils::writeDepthSimMap(c, mp, depthMap, simMap, 0);
+    }
+
+    // only the cameras of the subset are loaded
+    StaticVector<int> cams;
+    for(int c : {2, 3, 4})
+        cams.push_back(c);
+
+    for(const bool streamingFuse : {false, true})
+    {
+        FuseParams params;
+        params.streamingFuse = streamingFuse;
+
+        DelaunayGraphCut delaunayGC(mp);
+        delaunayGC.fuseFromDepthMaps(cams, nullptr, params);
+
+        BOOST_REQUIRE(!delaunayGC._verticesCoords.empty());
+        for(std::size_t vi = 0; vi < delaunayGC._verticesCoords.size(); ++vi)
+        {
+            BOOST_CHECK_LT(delaunayGC._verticesCoords[vi].z, 4.0);
+            for(int c : delaunayGC._verticesAttr[vi].cams)
+                BOOST_CHECK_GE(cams.indexOf(c), 0);
+        }
+    }
+
+    boost::filesystem::remove_all(tmpFolder);
+}
+
+/**
+ * @brief Per point consistency check of the depth map filtering, used as reference for Fuser::updateConsistencyMap
+ */
+void updateInSurrReference(const mvsUtils::MultiViewParams& mp, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP,
+                           const Point3d& p, int rc, int tc, std::vector<int>& numOfPtsMap,
+                           const image::Image<float>& depthMap, const image::Image<float>& simMap, int scale)
+{
+    const int w = mp.getWidth(rc) / scale;
+    const int h = mp.getHeight(rc) / scale;
+
+    Pixel pix;
+    mp.getPixelFor3DPoint(&pix, p, rc);
+    if(!mp.isPixelInImage(pix, rc))
+        return;
+
+    Pixel cell = pix;
+    cell.x /= scale;
+    cell.y /= scale;
+
+    const float pixDepth = (mp.CArr[rc] - p).size();
+    const int d = (simMap(cell.y, cell.x) >= 1.0f) ? pixSizeBallWSP : pixSizeBall;
+    const float pixSize = pixToleranceFactor * mp.getCamPixelSizePlaneSweepAlpha(p, rc, tc, scale, 1);
+
+    Pixel ncell;
+    for(ncell.x = std::max(0, cell.x - d); ncell.x <= std::min(w - 1, cell.x + d); ncell.x++)
+        for(ncell.y = std::max(0, cell.y - d); ncell.y <= std::min(h - 1, cell.y + d); ncell.y++)
+            if(fabs(pixDepth - depthMap(ncell.y, ncell.x)) < pixSize)
+                numOfPtsMap[ncell.y * w + ncell.x]++;
+}
+
+BOOST_AUTO_TEST_CASE(fuseCut_fuserConsistencyMap)
+{
+    const NViewDatasetConfigurator config(1000, 1000, 500, 500, 1, 0);
+    const SfMData sfmData = generateSfm(config, 6);
+    const mvsUtils::MultiViewParams mp(sfmData, "", "", "", false);
+    const Fuser fuser(mp);
+
+    const int rc = 0;
+    const int tc = 1;
+    const int w = mp.getWidth(rc);
+    const int h = mp.getHeight(rc);
+    const double sceneDepth = (mp.CArr[rc] - Point3d(0.0, 0.0, 0.0)).size();
+
+    // synthetic rc depth/sim maps: noisy constant depth, with some weakly supported and invalid pixels
+    std::mt19937 generator(42);
+    std::normal_distribution<float> depthNoise(0.0f, 0.0005f * sceneDepth);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+    image::Image<float> depthMap(w, h);
+    image::Image<float> simMap(w, h);
+    for(int i = 0; i < w * h; ++i)
+    {
+        const float u = uniform(generator);
+        depthMap(i) = (u < 0.1f) ? -1.0f : static_cast<float>(sceneDepth) + depthNoise(generator);
+        simMap(i) = (u < 0.3f) ? 1.5f : -0.5f;
+    }
+
+    // synthetic tc points seeing the same surface as rc (one per pixel), with some outliers anywhere in the scene
+    std::vector<std::vector<Point3d>> tcPointsList(2);
+    for(std::vector<Point3d>& tcPoints : tcPointsList)
+    {
+        for(int y = 0; y < h; ++y)
+        {
+            for(int x = 0; x < w; ++x)
+            {
+                const Point2d pix(x + uniform(generator), y + uniform(generator));
+                const double depth = (uniform(generator) < 0.8f) ? sceneDepth + depthNoise(generator) : sceneDepth * (0.5 + uniform(generator));
+                tcPoints.push_back(mp.CArr[rc] + (mp.iCamArr[rc] * pix).normalize() * depth);
+            }
+        }
+    }
+    const int nbPoints = tcPointsList.front().size();
+
+    for(const int pixSizeBall : {0, 1})
+    {
+        const int pixSizeBallWSP = 2 * pixSizeBall;
+
+        std::vector<int> numOfPtsMap(w * h, 0);
+        image::Image<unsigned char> consistencyMap(w, h, true, 0);
+        double referenceMs = 0.0;
+        double batchedMs = 0.0;
+
+        // marks are kept from a tc depth map to the next one
+        for(const std::vector<Point3d>& tcPoints : tcPointsList)
+        {
+            system::Timer timer;
+            for(const Point3d& p : tcPoints)
+                updateInSurrReference(mp, 2.0f, pixSizeBall, pixSizeBallWSP, p, rc, tc, numOfPtsMap, depthMap, simMap, 1);
+            referenceMs += timer.elapsedMs();
+
+            timer.reset();
+            fuser.updateConsistencyMap(2.0f, pixSizeBall, pixSizeBallWSP, rc, tc, tcPoints, depthMap, simMap, consistencyMap, 1);
+            batchedMs += timer.elapsedMs();
+
+            int nbConsistent = 0;
+            int nbDifferences = 0;
+            for(int i = 0; i < w * h; ++i)
+            {
+                nbConsistent += consistencyMap(i);
+                nbDifferences += static_cast<int>(consistencyMap(i) != static_cast<unsigned char>(numOfPtsMap[i] > 0));
+            }
+            BOOST_CHECK_GT(nbConsistent, 0);
+            BOOST_CHECK_EQUAL(nbDifferences, 0);
+        }
+
+        ALICEVISION_LOG_INFO("Consistency map (pixSizeBall: " << pixSizeBall << ", " << 2 * nbPoints << " points): per point "
+                             << referenceMs << " ms, batched " << batchedMs << " ms.");
+    }
+}
+
 /**
  * @brief Generate syntesize dataset with succesion of n(size) alignaed regular thetraedron and two camera on the last thetrahedron.
  * 
@@ -0,0 +1,186 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "DepthMapPointsCache.hpp"
+#include <aliceVision/mvsData/Point2d.hpp>
+#include <aliceVision/mvsUtils/depthSimMapIO.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <deque>
+
+namespace aliceVision {
+namespace fuseCut {
+
+DepthMapPointsCache::DepthMapPointsCache(const mvsUtils::MultiViewParams& mp, std::size_t maxSize, int scale)
+  : _mp(mp)
+  , _maxSize(maxSize)
+  , _scale(scale)
+{}
+
+DepthMapPointsCache::DepthMapPtr DepthMapPointsCache::getDepthMap(int cam)
+{
+    std::promise<DepthMapPtr> promise;
+    std::shared_future<DepthMapPtr> depthMap;
+    bool compute = false;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(cam);
+        if(it != _entries.end())
+        {
+            // move to the most recently used position
+            _lru.splice(_lru.begin(), _lru, it->second.lruIt);
+            depthMap = it->second.depthMap;
+            ++_nbHits;
+        }
+        else
+        {
+            // other threads requesting this camera meanwhile wait for this computation
+            _lru.push_front(cam);
+            Entry& entry = _entries[cam];
+            entry.depthMap = promise.get_future().share();
+            entry.lruIt = _lru.begin();
+            depthMap = entry.depthMap;
+            compute = true;
+            ++_nbMisses;
+        }
+    }
+
+    if(compute)
+    {
+        DepthMapPtr readMap;
+        try
+        {
+            readMap = readDepthMap(cam);
+        }
+        catch(...)
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                auto it = _entries.find(cam);
+                _lru.erase(it->second.lruIt);
+                _entries.erase(it);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+        promise.set_value(readMap);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        Entry& entry = _entries.at(cam);
+        entry.size = (readMap == nullptr) ? 0 : readMap->size() * sizeof(float);
+        entry.computed = true;
+        _size += entry.size;
+        if(_size > _maxSize)
+            evict();
+    }
+
+    return depthMap.get();
+}
+
+bool DepthMapPointsCache::getPoints(int cam, std::vector<Point3d>& out_points)
+{
+    out_points.clear();
+
+    const DepthMapPtr depthMap = getDepthMap(cam);
+    if(depthMap == nullptr)
+        return false;
+
+    for(int y = 0; y < depthMap->Height(); ++y)
+    {
+        for(int x = 0; x < depthMap->Width(); ++x)
+        {
+            const float depth = (*depthMap)(y, x);
+
+            if(depth > 0.0f)
+                out_points.push_back(_mp.CArr[cam] + (_mp.iCamArr[cam] * Point2d((float)x, (float)y)).normalize() * depth);
+        }
+    }
+
+    return true;
+}
+
+DepthMapPointsCache::DepthMapPtr DepthMapPointsCache::readDepthMap(int cam) const
+{
+    auto depthMap = std::make_shared<image::Image<float>>();
+    mvsUtils::readDepthMap(cam, _mp, *depthMap, _scale);
+
+    if(depthMap->Height() <= 0 || depthMap->Width() <= 0)
+        return nullptr;
+
+    return depthMap;
+}
+
+void DepthMapPointsCache::evict()
+{
+    // the most recently used entry is always kept, in use depth maps remain valid for their users
+    auto it = std::prev(_lru.end());
+    while(_size > _maxSize && it != _lru.begin())
+    {
+        const auto entryIt = _entries.find(*it);
+        --it;
+
+        // still computed by another thread
+        if(!entryIt->second.computed)
+            continue;
+
+        _size -= entryIt->second.size;
+        _lru.erase(entryIt->second.lruIt);
+        _entries.erase(entryIt);
+    }
+}
+
+void DepthMapPointsCache::logStatistics() const
+{
+    const std::size_t nbRequests = _nbHits + _nbMisses;
+    ALICEVISION_LOG_INFO("Depth map points cache: " << _nbHits << " hits, " << _nbMisses << " misses ("
+                         << (nbRequests > 0 ? 100.0 * _nbHits / nbRequests : 0.0) << "% hit rate).");
+}
+
+std::vector<int> orderCamerasByNeighbourhood(const std::vector<int>& cams, const std::vector<StaticVector<int>>& neighbours)
+{
+    // index in cams of each camera
+    std::map<int, int> camIndexes;
+    for(int i = 0; i < cams.size(); ++i)
+        camIndexes.emplace(cams[i], i);
+
+    std::vector<int> order;
+    order.reserve(cams.size());
+    std::vector<bool> visited(cams.size(), false);
+    std::deque<int> toVisit;
+
+    // breadth first walk, so that the neighbours of a camera are processed together
+    for(int seed = 0; seed < cams.size(); ++seed)
+    {
+        if(visited[seed])
+            continue;
+
+        visited[seed] = true;
+        toVisit.push_back(seed);
+
+        while(!toVisit.empty())
+        {
+            const int i = toVisit.front();
+            toVisit.pop_front();
+            order.push_back(i);
+
+            for(int c = 0; c < neighbours[i].size(); ++c)
+            {
+                const auto it = camIndexes.find(neighbours[i][c]);
+                if(it == camIndexes.end() || visited[it->second])
+                    continue;
+
+                visited[it->second] = true;
+                toVisit.push_back(it->second);
+            }
+        }
+    }
+
+    return order;
+}
+
+} // namespace fuseCut
+} // namespace aliceVision
@@ -0,0 +1,105 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/Point3d.hpp>
+#include <aliceVision/mvsData/StaticVector.hpp>
+#include <aliceVision/mvsUtils/MultiViewParams.hpp>
+#include <aliceVision/image/Image.hpp>
+
+#include <atomic>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Thread safe cache of the depth maps, giving their 3d points.
+ *
+ * Each depth map is read once, then shared by all the views using it as a neighbour.
+ * Only the float depths are kept, the 3d points are back-projected on request into a buffer of the caller,
+ * so that the cache is not several times larger than the depth maps.
+ * The least recently used depth maps are released when the cache exceeds its maximal size.
+ */
+class DepthMapPointsCache
+{
+public:
+    /// Depth map of a camera, nullptr if the depth map is empty
+    using DepthMapPtr = std::shared_ptr<const image::Image<float>>;
+
+    /**
+     * @param[in] mp the multi-view parameters
+     * @param[in] maxSize the maximal size of the cached depth maps in bytes
+     * @param[in] scale the depth map downscale factor
+     */
+    DepthMapPointsCache(const mvsUtils::MultiViewParams& mp, std::size_t maxSize, int scale = 1);
+
+    /**
+     * @brief Get the depth map of a camera, reading it if needed
+     * @param[in] cam the camera index
+     */
+    DepthMapPtr getDepthMap(int cam);
+
+    /**
+     * @brief Get the 3d points of the valid depth values of a camera, reading its depth map if needed
+     * @param[in] cam the camera index
+     * @param[out] out_points the 3d points, row major order of the depth map pixels
+     * @return false if the depth map is empty
+     */
+    bool getPoints(int cam, std::vector<Point3d>& out_points);
+
+    std::size_t getNbHits() const { return _nbHits; }
+    std::size_t getNbMisses() const { return _nbMisses; }
+
+    /// Log the hit rate of the cache
+    void logStatistics() const;
+
+private:
+    struct Entry
+    {
+        std::shared_future<DepthMapPtr> depthMap;
+        std::size_t size = 0;
+        bool computed = false;
+        std::list<int>::iterator lruIt;
+    };
+
+    DepthMapPtr readDepthMap(int cam) const;
+
+    /// Release the least recently used depth maps until the cache fits in its maximal size
+    void evict();
+
+    const mvsUtils::MultiViewParams& _mp;
+    const std::size_t _maxSize;
+    const int _scale;
+
+    std::mutex _mutex;
+    std::map<int, Entry> _entries;
+    /// camera indexes, most recently used first
+    std::list<int> _lru;
+    std::size_t _size = 0;
+    std::atomic<std::size_t> _nbHits{0};
+    std::atomic<std::size_t> _nbMisses{0};
+};
+
+/**
+ * @brief Order the cameras so that consecutive cameras share their neighbours.
+ *
+ * Walk the neighbourhood graph, each next camera being an unvisited neighbour of the last visited cameras.
+ * Processed in this order, the neighbour depth maps are mostly still in a DepthMapPointsCache when used again.
+ * @param[in] cams the cameras to order
+ * @param[in] neighbours the neighbour cameras of each camera of cams
+ * @return the indexes in cams in processing order
+ */
+std::vector<int> orderCamerasByNeighbourhood(const std::vector<int>& cams, const std::vector<StaticVector<int>>& neighbours);
+
+} // namespace fuseCut
+} // namespace aliceVision
@@ -0,0 +1,181 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/DepthMapPointsCache.hpp>
+#include <aliceVision/mvsUtils/depthSimMapIO.hpp>
+#include <aliceVision/mvsData/Point2d.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/camera/camera.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <random>
+
+#define BOOST_TEST_MODULE depthMapPointsCache
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const int imageWidth = 64;
+const int imageHeight = 48;
+
+/// Cameras along the x axis, looking in the z direction
+sfmData::SfMData createSfmData(int nbCameras)
+{
+    sfmData::SfMData sfmData;
+    sfmData.intrinsics[0] = camera::createIntrinsic(camera::EINTRINSIC::PINHOLE_CAMERA, imageWidth, imageHeight, 60.0, 60.0, 0.0, 0.0);
+    for(int i = 0; i < nbCameras; ++i)
+    {
+        sfmData.views[i] = std::make_shared<sfmData::View>("", i, 0, i, imageWidth, imageHeight);
+        sfmData.setPose(*sfmData.views.at(i), sfmData::CameraPose(geometry::Pose3(Mat3::Identity(), Vec3(0.1 * i, 0.0, 0.0))));
+    }
+    return sfmData;
+}
+
+/// Temporary depth maps folder removed at the end of the test
+struct TmpFolder
+{
+    TmpFolder()
+        : path(fs::temp_directory_path() / fs::unique_path())
+    {
+        fs::create_directories(path);
+    }
+
+    ~TmpFolder()
+    {
+        fs::remove_all(path);
+    }
+
+    fs::path path;
+};
+
+/// Write a random depth map with some invalid depths for each camera
+void writeDepthMaps(const mvsUtils::MultiViewParams& mp)
+{
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> depthDistribution(2.0f, 5.0f);
+    std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+
+    for(int c = 0; c < mp.getNbCameras(); ++c)
+    {
+        image::Image<float> depthMap(imageWidth, imageHeight);
+        for(int i = 0; i < depthMap.size(); ++i)
+            depthMap(i) = (uniform(generator) < 0.2f) ? -1.0f : depthDistribution(generator);
+        mvsUtils::writeDepthMap(c, mp, depthMap);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(depthMapPointsCache_points)
+{
+    TmpFolder tmp;
+    const sfmData::SfMData sfmData = createSfmData(3);
+    const mvsUtils::MultiViewParams mp(sfmData, "", tmp.path.string(), "", false);
+    writeDepthMaps(mp);
+
+    DepthMapPointsCache cache(mp, std::size_t(1024) * 1024);
+    std::vector<Point3d> points;
+
+    for(int c = 0; c < mp.getNbCameras(); ++c)
+    {
+        // the cached depths give the same points as the back-projection of the depth map
+        image::Image<float> depthMap;
+        mvsUtils::readDepthMap(c, mp, depthMap);
+
+        std::vector<Point3d> expectedPoints;
+        for(int y = 0; y < depthMap.Height(); ++y)
+            for(int x = 0; x < depthMap.Width(); ++x)
+                if(depthMap(y, x) > 0.0f)
+                    expectedPoints.push_back(mp.backproject(c, Point2d(x, y), depthMap(y, x)));
+
+        BOOST_REQUIRE(cache.getPoints(c, points));
+        BOOST_REQUIRE_EQUAL(points.size(), expectedPoints.size());
+        for(std::size_t i = 0; i < points.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(points[i].x, expectedPoints[i].x);
+            BOOST_CHECK_EQUAL(points[i].y, expectedPoints[i].y);
+            BOOST_CHECK_EQUAL(points[i].z, expectedPoints[i].z);
+        }
+
+        // only the float depths are kept
+        BOOST_CHECK_EQUAL(cache.getDepthMap(c)->size(), imageWidth * imageHeight);
+    }
+
+    BOOST_CHECK_EQUAL(cache.getNbMisses(), mp.getNbCameras());
+    BOOST_CHECK_EQUAL(cache.getNbHits(), mp.getNbCameras());
+}
+
+BOOST_AUTO_TEST_CASE(depthMapPointsCache_eviction)
+{
+    TmpFolder tmp;
+    const sfmData::SfMData sfmData = createSfmData(3);
+    const mvsUtils::MultiViewParams mp(sfmData, "", tmp.path.string(), "", false);
+    writeDepthMaps(mp);
+
+    // room for two depth maps
+    DepthMapPointsCache cache(mp, 2 * imageWidth * imageHeight * sizeof(float));
+
+    const DepthMapPointsCache::DepthMapPtr first = cache.getDepthMap(0);
+    BOOST_CHECK(cache.getDepthMap(0) == first);
+    cache.getDepthMap(1);
+    cache.getDepthMap(2);
+    BOOST_CHECK_EQUAL(cache.getNbHits(), 1);
+    BOOST_CHECK_EQUAL(cache.getNbMisses(), 3);
+
+    // the least recently used depth map is released, but remains valid for its users
+    BOOST_CHECK(cache.getDepthMap(0) != first);
+    BOOST_CHECK_EQUAL(cache.getNbMisses(), 4);
+    BOOST_CHECK_EQUAL(first->Width(), imageWidth);
+
+    // concurrent requests read each depth map once
+    DepthMapPointsCache sharedCache(mp, std::size_t(1024) * 1024);
+#pragma omp parallel for
+    for(int i = 0; i < 30; ++i)
+    {
+        std::vector<Point3d> points;
+        sharedCache.getPoints(i % 3, points);
+    }
+    BOOST_CHECK_EQUAL(sharedCache.getNbMisses(), 3);
+    BOOST_CHECK_EQUAL(sharedCache.getNbHits(), 27);
+}
+
+BOOST_AUTO_TEST_CASE(depthMapPointsCache_orderCamerasByNeighbourhood)
+{
+    // two groups of cameras, 12 and 15 also see cameras out of the list
+    const std::vector<int> cams = {10, 11, 12, 13, 14, 15};
+    std::vector<StaticVector<int>> neighbours(cams.size());
+    for(int n : {13, 14})
+        neighbours[0].push_back(n);
+    for(int n : {15})
+        neighbours[1].push_back(n);
+    for(int n : {3, 14})
+        neighbours[2].push_back(n);
+    for(int n : {10})
+        neighbours[3].push_back(n);
+    for(int n : {12, 10})
+        neighbours[4].push_back(n);
+    for(int n : {11, 20})
+        neighbours[5].push_back(n);
+
+    const std::vector<int> order = orderCamerasByNeighbourhood(cams, neighbours);
+
+    // breadth first: the neighbours of a camera follow it
+    const std::vector<int> expectedOrder = {0, 3, 4, 2, 1, 5};
+    BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expectedOrder.begin(), expectedOrder.end());
+
+    // no neighbours, the input order is kept
+    const std::vector<int> isolatedOrder = orderCamerasByNeighbourhood(cams, std::vector<StaticVector<int>>(cams.size()));
+    for(int i = 0; i < cams.size(); ++i)
+        BOOST_CHECK_EQUAL(isolatedOrder[i], i);
+}
@@ -0,0 +1,145 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "FusedPointsVoxelHash.hpp"
+#include <aliceVision/stl/hash.hpp>
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace aliceVision {
+namespace fuseCut {
+
+std::size_t FusedPointsVoxelHash::VoxelKeyHash::operator()(const VoxelKey& key) const
+{
+    std::size_t seed = std::hash<int>()(key.level);
+    stl::hash_combine(seed, key.x);
+    stl::hash_combine(seed, key.y);
+    stl::hash_combine(seed, key.z);
+    return seed;
+}
+
+FusedPointsVoxelHash::FusedPointsVoxelHash(double pixSizeMarginCoef, std::size_t maxNbPoints)
+  : _pixSizeMarginCoef(pixSizeMarginCoef)
+  , _maxNbPoints(std::max(maxNbPoints, std::size_t(1)))
+{}
+
+FusedPointsVoxelHash::VoxelKey FusedPointsVoxelHash::getKey(const FusedPoint& point) const
+{
+    const double radius = std::sqrt(_pixSizeMarginCoef * point.simScore) * point.pixSize;
+    const int level = static_cast<int>(std::ceil(std::log2(radius))) + _nbCoarsenings;
+    const double invVoxelSize = std::ldexp(1.0, -level);
+
+    VoxelKey key;
+    key.level = level;
+    key.x = static_cast<int>(std::floor(point.coords.x * invVoxelSize));
+    key.y = static_cast<int>(std::floor(point.coords.y * invVoxelSize));
+    key.z = static_cast<int>(std::floor(point.coords.z * invVoxelSize));
+    return key;
+}
+
+bool FusedPointsVoxelHash::isBetter(const FusedPoint& a, const FusedPoint& b)
+{
+    const double scoreA = a.simScore * a.pixSize * a.pixSize;
+    const double scoreB = b.simScore * b.pixSize * b.pixSize;
+    if(scoreA != scoreB)
+        return scoreA < scoreB;
+
+    // deterministic choice between equivalent points
+    if(a.coords.x != b.coords.x)
+        return a.coords.x < b.coords.x;
+    if(a.coords.y != b.coords.y)
+        return a.coords.y < b.coords.y;
+    return a.coords.z < b.coords.z;
+}
+
+bool FusedPointsVoxelHash::isCoarsest(const VoxelKey& key)
+{
+    return key.x >= -1 && key.x <= 0 && key.y >= -1 && key.y <= 0 && key.z >= -1 && key.z <= 0;
+}
+
+bool FusedPointsVoxelHash::insert(const VoxelKey& key, const FusedPoint& point)
+{
+    const auto result = _voxels.emplace(key, point);
+    if(!result.second && isBetter(point, result.first->second))
+        result.first->second = point;
+    return result.second;
+}
+
+void FusedPointsVoxelHash::add(const std::vector<FusedPoint>& points)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const int nbCoarsenings = _nbCoarsenings;
+
+    for(const FusedPoint& point : points)
+    {
+        // same validity criteria as the pixel size filtering
+        if(point.pixSize < 0.0 ||
+           _pixSizeMarginCoef * point.simScore * point.pixSize * point.pixSize < std::numeric_limits<double>::epsilon())
+            continue;
+
+        // a new voxel may be merged by the next coarsenings, even if the previous ones could not
+        const VoxelKey key = getKey(point);
+        if(insert(key, point) && !isCoarsest(key))
+            _fullyCoarsened = false;
+
+        // sparse points (e.g. outliers) may only be merged by much larger voxels
+        while(_voxels.size() > _maxNbPoints && !_fullyCoarsened)
+        {
+            coarsen();
+            _fullyCoarsened = std::all_of(_voxels.begin(), _voxels.end(),
+                                          [](const std::pair<const VoxelKey, FusedPoint>& voxel) { return isCoarsest(voxel.first); });
+            if(_fullyCoarsened && _voxels.size() > _maxNbPoints)
+            {
+                ALICEVISION_LOG_WARNING("Fused points voxel hash: " << _voxels.size() << " voxels cannot be merged into "
+                                        << _maxNbPoints << " voxels.");
+            }
+        }
+    }
+
+    if(_nbCoarsenings != nbCoarsenings)
+    {
+        ALICEVISION_LOG_INFO("Fused points voxel hash: voxel size increased " << _nbCoarsenings << " times, "
+                             << _voxels.size() << " voxels.");
+    }
+}
+
+void FusedPointsVoxelHash::coarsen()
+{
+    std::unordered_map<VoxelKey, FusedPoint, VoxelKeyHash> voxels;
+    voxels.swap(_voxels);
+    ++_nbCoarsenings;
+
+    _voxels.reserve(voxels.size() / 2);
+    for(const auto& voxel : voxels)
+        insert(getKey(voxel.second), voxel.second);
+}
+
+void FusedPointsVoxelHash::getPoints(std::vector<Point3d>& out_coords, std::vector<double>& out_pixSize, std::vector<float>& out_simScore) const
+{
+    std::vector<std::pair<VoxelKey, const FusedPoint*>> sortedVoxels;
+    sortedVoxels.reserve(_voxels.size());
+    for(const auto& voxel : _voxels)
+        sortedVoxels.emplace_back(voxel.first, &voxel.second);
+
+    std::sort(sortedVoxels.begin(), sortedVoxels.end(),
+              [](const std::pair<VoxelKey, const FusedPoint*>& a, const std::pair<VoxelKey, const FusedPoint*>& b) { return a.first < b.first; });
+
+    out_coords.resize(sortedVoxels.size());
+    out_pixSize.resize(sortedVoxels.size());
+    out_simScore.resize(sortedVoxels.size());
+    for(std::size_t i = 0; i < sortedVoxels.size(); ++i)
+    {
+        out_coords[i] = sortedVoxels[i].second->coords;
+        out_pixSize[i] = sortedVoxels[i].second->pixSize;
+        out_simScore[i] = sortedVoxels[i].second->simScore;
+    }
+}
+
+} // namespace fuseCut
+} // namespace aliceVision
@@ -0,0 +1,125 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/Point3d.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Candidate point of the depth maps fusion
+ */
+struct FusedPoint
+{
+    Point3d coords;
+    double pixSize = -1.0;
+    float simScore = 0.0f;
+};
+
+/**
+ * @brief Voxel hash accumulator of the depth maps points, keeping the best point per voxel.
+ *
+ * The voxel size of a point is its fusion radius (sqrt(pixSizeMarginCoef * simScore) * pixSize, as in the
+ * pixel size filtering) rounded to a power of 2, so points of different resolutions do not compete.
+ * The best point of a voxel has the smallest simScore * pixSize^2.
+ *
+ * Depth maps are added one after the other and the memory only depends on the number of voxels:
+ * as long as there are more than maxNbPoints voxels, all voxel sizes are doubled
+ * (unless no voxels can be merged anymore: one voxel per level and per octant).
+ * The result does not depend on the order of the points.
+ */
+class FusedPointsVoxelHash
+{
+public:
+    /**
+     * @param[in] pixSizeMarginCoef the pixel size margin coefficient of the fusion radius
+     * @param[in] maxNbPoints the maximal number of voxels
+     */
+    FusedPointsVoxelHash(double pixSizeMarginCoef, std::size_t maxNbPoints);
+
+    /**
+     * @brief Add points to the accumulator, thread safe
+     * @note points with a negative pixSize are ignored
+     */
+    void add(const std::vector<FusedPoint>& points);
+
+    /// Number of voxels
+    std::size_t size() const { return _voxels.size(); }
+
+    /// Number of times the voxel sizes have been doubled to fit in maxNbPoints
+    int getNbCoarsenings() const { return _nbCoarsenings; }
+
+    /**
+     * @brief Get the best point of each voxel, in a deterministic order
+     */
+    void getPoints(std::vector<Point3d>& out_coords, std::vector<double>& out_pixSize, std::vector<float>& out_simScore) const;
+
+private:
+    struct VoxelKey
+    {
+        int level;
+        int x;
+        int y;
+        int z;
+
+        bool operator==(const VoxelKey& other) const
+        {
+            return level == other.level && x == other.x && y == other.y && z == other.z;
+        }
+
+        bool operator<(const VoxelKey& other) const
+        {
+            if(level != other.level)
+                return level < other.level;
+            if(x != other.x)
+                return x < other.x;
+            if(y != other.y)
+                return y < other.y;
+            return z < other.z;
+        }
+    };
+
+    struct VoxelKeyHash
+    {
+        std::size_t operator()(const VoxelKey& key) const;
+    };
+
+    VoxelKey getKey(const FusedPoint& point) const;
+
+    /// True if a is kept instead of b in a voxel
+    static bool isBetter(const FusedPoint& a, const FusedPoint& b);
+
+    /// True if doubling the voxel sizes cannot merge the voxel with another one (one voxel per level and per octant)
+    static bool isCoarsest(const VoxelKey& key);
+
+    /**
+     * @brief Insert a point in its voxel
+     * @return true if a new voxel was created
+     */
+    bool insert(const VoxelKey& key, const FusedPoint& point);
+
+    /// Double the voxel sizes and merge the voxels
+    void coarsen();
+
+    const double _pixSizeMarginCoef;
+    const std::size_t _maxNbPoints;
+    int _nbCoarsenings = 0;
+    /// True if the voxels cannot be merged anymore, until a new voxel which can be merged is created
+    bool _fullyCoarsened = false;
+
+    std::mutex _mutex;
+    std::unordered_map<VoxelKey, FusedPoint, VoxelKeyHash> _voxels;
+};
+
+} // namespace fuseCut
+} // namespace aliceVision
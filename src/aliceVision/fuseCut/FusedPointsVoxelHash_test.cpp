@@ -0,0 +1,196 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/FusedPointsVoxelHash.hpp>
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+
+#include <algorithm>
+#include <random>
+
+#define BOOST_TEST_MODULE fusedPointsVoxelHash
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+namespace {
+
+/// Points of a noisy plane seen from several distances (so with several pixel sizes)
+std::vector<FusedPoint> generatePoints(int nbPoints, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::normal_distribution<double> noise(0.0, 0.0005);
+
+    std::vector<FusedPoint> points(nbPoints);
+    for(FusedPoint& point : points)
+    {
+        point.coords = Point3d(uniform(generator), uniform(generator), noise(generator));
+        point.pixSize = 0.001 * (1.0 + 3.0 * uniform(generator));
+        point.simScore = 1.0f + 15.0f * static_cast<float>(uniform(generator));
+    }
+    return points;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(fusedPointsVoxelHash_bestPoint)
+{
+    FusedPointsVoxelHash voxelHash(2.0, 100);
+
+    FusedPoint a;
+    a.coords = Point3d(0.1, 0.1, 0.1);
+    a.pixSize = 0.01;
+    a.simScore = 2.0f;
+
+    // same voxel, better score
+    FusedPoint b = a;
+    b.coords = Point3d(0.1001, 0.1, 0.1);
+    b.pixSize = 0.009;
+
+    // invalid point
+    FusedPoint c = a;
+    c.pixSize = -1.0;
+
+    voxelHash.add({a, b, c});
+
+    std::vector<Point3d> coords;
+    std::vector<double> pixSize;
+    std::vector<float> simScore;
+    voxelHash.getPoints(coords, pixSize, simScore);
+
+    BOOST_REQUIRE_EQUAL(coords.size(), 1);
+    BOOST_CHECK_EQUAL(coords[0].x, b.coords.x);
+    BOOST_CHECK_EQUAL(pixSize[0], b.pixSize);
+}
+
+BOOST_AUTO_TEST_CASE(fusedPointsVoxelHash_orderIndependent)
+{
+    std::vector<FusedPoint> points = generatePoints(100000, 42);
+
+    for(const std::size_t maxNbPoints : {std::size_t(1000000), std::size_t(5000)})
+    {
+        FusedPointsVoxelHash voxelHash(2.0, maxNbPoints);
+        voxelHash.add(points);
+
+        // another order, in several batches
+        FusedPointsVoxelHash shuffledVoxelHash(2.0, maxNbPoints);
+        std::vector<FusedPoint> shuffledPoints = points;
+        std::shuffle(shuffledPoints.begin(), shuffledPoints.end(), std::mt19937(7));
+        for(std::size_t begin = 0; begin < shuffledPoints.size(); begin += 7000)
+        {
+            const std::size_t end = std::min(begin + 7000, shuffledPoints.size());
+            shuffledVoxelHash.add(std::vector<FusedPoint>(shuffledPoints.begin() + begin, shuffledPoints.begin() + end));
+        }
+
+        BOOST_CHECK_LE(voxelHash.size(), maxNbPoints);
+        BOOST_CHECK_LT(voxelHash.size(), points.size());
+        BOOST_CHECK_EQUAL(voxelHash.getNbCoarsenings(), shuffledVoxelHash.getNbCoarsenings());
+
+        std::vector<Point3d> coords, shuffledCoords;
+        std::vector<double> pixSize, shuffledPixSize;
+        std::vector<float> simScore, shuffledSimScore;
+        voxelHash.getPoints(coords, pixSize, simScore);
+        shuffledVoxelHash.getPoints(shuffledCoords, shuffledPixSize, shuffledSimScore);
+
+        BOOST_REQUIRE_EQUAL(coords.size(), shuffledCoords.size());
+        for(std::size_t i = 0; i < coords.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(coords[i].x, shuffledCoords[i].x);
+            BOOST_CHECK_EQUAL(coords[i].y, shuffledCoords[i].y);
+            BOOST_CHECK_EQUAL(coords[i].z, shuffledCoords[i].z);
+            BOOST_CHECK_EQUAL(pixSize[i], shuffledPixSize[i]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(fusedPointsVoxelHash_boundedMemory)
+{
+    // many depth maps of the same surface: the number of voxels stays bounded
+    const std::size_t maxNbPoints = 50000;
+    const int nbDepthMaps = 40;
+    FusedPointsVoxelHash voxelHash(2.0, maxNbPoints);
+
+    system::Timer timer;
+    for(int i = 0; i < nbDepthMaps; ++i)
+    {
+        voxelHash.add(generatePoints(100000, i));
+        BOOST_CHECK_LE(voxelHash.size(), maxNbPoints);
+    }
+
+    ALICEVISION_LOG_INFO(nbDepthMaps * 100000 << " points fused into " << voxelHash.size() << " voxels ("
+                         << voxelHash.getNbCoarsenings() << " coarsenings) in " << timer.elapsedMs() << " ms.");
+}
+
+BOOST_AUTO_TEST_CASE(fusedPointsVoxelHash_sparsePoints)
+{
+    // outliers far from each other: a single coarsening does not merge any voxel
+    const std::size_t maxNbPoints = 10;
+    FusedPointsVoxelHash voxelHash(2.0, maxNbPoints);
+
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> uniform(-1000.0, 1000.0);
+
+    std::vector<FusedPoint> points(20);
+    for(FusedPoint& point : points)
+    {
+        point.coords = Point3d(uniform(generator), uniform(generator), uniform(generator));
+        point.pixSize = 0.001;
+        point.simScore = 1.0f;
+    }
+
+    voxelHash.add(points);
+    BOOST_CHECK_LE(voxelHash.size(), maxNbPoints);
+    BOOST_CHECK_GT(voxelHash.getNbCoarsenings(), 1);
+
+    // one point at each end of the pixel size range: the voxels of different levels are never merged
+    FusedPointsVoxelHash levelsVoxelHash(2.0, 1);
+    FusedPoint small = points[0];
+    FusedPoint large = points[1];
+    large.pixSize = 1000.0;
+    levelsVoxelHash.add({small, large});
+    BOOST_CHECK_EQUAL(levelsVoxelHash.size(), 2);
+    const int nbCoarsenings = levelsVoxelHash.getNbCoarsenings();
+    levelsVoxelHash.add({points[2]});
+    BOOST_CHECK_EQUAL(levelsVoxelHash.getNbCoarsenings(), nbCoarsenings);
+}
+
+BOOST_AUTO_TEST_CASE(fusedPointsVoxelHash_sparseThenDensePoints)
+{
+    // sparse points in different octants: their voxels are never merged
+    const std::size_t maxNbPoints = 2;
+    FusedPointsVoxelHash voxelHash(2.0, maxNbPoints);
+
+    std::vector<FusedPoint> sparsePoints(3);
+    for(int i = 0; i < 3; ++i)
+    {
+        sparsePoints[i].coords = Point3d(i == 0 ? -1.0 : 1.0, i == 1 ? -1.0 : 1.0, i == 2 ? -1.0 : 1.0);
+        sparsePoints[i].pixSize = 0.001;
+        sparsePoints[i].simScore = 1.0f;
+    }
+    voxelHash.add(sparsePoints);
+    BOOST_CHECK_EQUAL(voxelHash.size(), 3);
+
+    // dense points of a finer resolution arriving later are still coarsened
+    const int nbCoarsenings = voxelHash.getNbCoarsenings();
+    for(int i = 0; i < 3; ++i)
+    {
+        std::vector<FusedPoint> densePoints = generatePoints(1000, i);
+        for(FusedPoint& point : densePoints)
+        {
+            point.coords.z = 0.5;
+            point.pixSize = 1e-6;
+            point.simScore = 1.0f;
+        }
+        voxelHash.add(densePoints);
+
+        // the sparse voxels and a single voxel of the dense points
+        BOOST_CHECK_EQUAL(voxelHash.size(), 4);
+    }
+    BOOST_CHECK_GT(voxelHash.getNbCoarsenings(), nbCoarsenings);
+}
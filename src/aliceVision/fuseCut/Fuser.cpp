@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "Fuser.hpp"
+#include "DepthMapPointsCache.hpp"
 #include <aliceVision/image/io.hpp>
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/sfmData/SfMData.hpp>
@@ -51,88 +52,124 @@ Fuser::~Fuser()
 }
 
 
-/**
- * @brief 
- * 
- * @param[in] pixSizeFactor: pixSize tolerance factor
- * @param[in]
- * @param[in] p: 3d point back projected from tc camera
- * @param[in]
- * @param[in]
- * @param[out] numOfPtsMap
- * @param[in] depthMap
- * @param[in] simMap
- * @param[in] scale
- */
-bool Fuser::updateInSurr(float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, Point3d& p, int rc, int tc,
-                         StaticVector<int>* numOfPtsMap,
-                         const image::Image<float>& depthMap, const image::Image<float>& simMap,
-                           int scale)
+void Fuser::updateConsistencyMap(float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int rc, int tc,
+                                 const std::vector<Point3d>& tcPoints,
+                                 const image::Image<float>& depthMap, const image::Image<float>& simMap,
+                                 image::Image<unsigned char>& inout_consistencyMap, int scale) const
 {
-    int w =_mp.getWidth(rc) / scale;
-    int h =_mp.getHeight(rc) / scale;
-
-    Pixel pix;
-   _mp.getPixelFor3DPoint(&pix, p, rc);
-    if(!_mp.isPixelInImage(pix, rc))
+    const int w = _mp.getWidth(rc) / scale;
+    const int h = _mp.getHeight(rc) / scale;
+    const int border = _mp.g_border;
+    const Matrix3x4& P = _mp.camArr[rc];
+    const Point3d& C = _mp.CArr[rc];
+
+    // points are projected by batches, only the ones inside the rc image are kept (SoA)
+    constexpr int batchSize = 1024;
+    int batchPointIndex[batchSize];
+    int batchCellX[batchSize];
+    int batchCellY[batchSize];
+
+    for(int batchBegin = 0; batchBegin < tcPoints.size(); batchBegin += batchSize)
     {
-        return false;
-    }
+        const int batchEnd = std::min(batchBegin + batchSize, static_cast<int>(tcPoints.size()));
+        int nbInside = 0;
 
-    Pixel cell = pix;
-    cell.x /= scale;
-    cell.y /= scale;
+        // same computation as MultiViewParams::getPixelFor3DPoint and isPixelInImage
+        for(int i = batchBegin; i < batchEnd; ++i)
+        {
+            const Point3d XT = P * tcPoints[i];
+            if(XT.z <= 0)
+                continue;
 
-    float pixDepth = (_mp.CArr[rc] - p).size();
+            // +0.5 is IMPORTANT
+            const int x = (int)floor(XT.x / XT.z + 0.5);
+            const int y = (int)floor(XT.y / XT.z + 0.5);
 
-    int d = pixSizeBall;
+            if((x >= border) && (x < _mp.getWidth(rc) - border) && (y >= border) && (y < _mp.getHeight(rc) - border))
+            {
+                batchPointIndex[nbInside] = i;
+                batchCellX[nbInside] = x / scale;
+                batchCellY[nbInside] = y / scale;
+                ++nbInside;
+            }
+        }
 
-    const float sim = simMap(cell.y, cell.x);
-    if(sim >= 1.0f)
-    {
-        d = pixSizeBallWSP;
-    }
+        for(int b = 0; b < nbInside; ++b)
+        {
+            const int cellX = batchCellX[b];
+            const int cellY = batchCellY[b];
+            const int d = (simMap(cellY, cellX) >= 1.0f) ? pixSizeBallWSP : pixSizeBall;
 
-    // float pixSize = 2.0f*(float)std::max(d,1)*_mp.getCamPixelSize(p,cam);
-    float pixSize = pixToleranceFactor *_mp.getCamPixelSizePlaneSweepAlpha(p, rc, tc, scale, 1);
+            const int xBegin = std::max(0, cellX - d);
+            const int xEnd = std::min(w - 1, cellX + d);
+            const int yBegin = std::max(0, cellY - d);
+            const int yEnd = std::min(h - 1, cellY + d);
 
-    Pixel ncell;
-    for(ncell.x = std::max(0, cell.x - d); ncell.x <= std::min(w - 1, cell.x + d); ncell.x++)
-    {
-        for(ncell.y = std::max(0, cell.y - d); ncell.y <= std::min(h - 1, cell.y + d); ncell.y++)
-        {
-            // printf("%i %i %i %i %i %i %i %i\n",ncell.x,ncell.y,w,h,w*h,depthMap->size(),cam,scale);
-            const float depth = depthMap(ncell.y, ncell.x);
-            // Point3d p1 = _mp.CArr[rc] +
-            // (_mp.iCamArr[rc]*Point2d((float)ncell.x*(float)scale,(float)ncell.y*(float)scale)).normalize()*depth;
-            // if ( (p1-p).size() < pixSize ) {
-            if(fabs(pixDepth - depth) < pixSize)
+            // the pixel size is expensive, only compute it if a pixel of the window can still change
+            bool allConsistent = true;
+            for(int y = yBegin; y <= yEnd && allConsistent; ++y)
+                for(int x = xBegin; x <= xEnd && allConsistent; ++x)
+                    allConsistent = (inout_consistencyMap(y, x) != 0);
+
+            if(allConsistent)
+                continue;
+
+            const Point3d& p = tcPoints[batchPointIndex[b]];
+            const float pixDepth = (C - p).size();
+            const float pixSize = pixToleranceFactor * _mp.getCamPixelSizePlaneSweepAlpha(p, rc, tc, scale, 1);
+
+            for(int y = yBegin; y <= yEnd; ++y)
             {
-                (*numOfPtsMap)[ncell.y * w + ncell.x]++;
+                for(int x = xBegin; x <= xEnd; ++x)
+                {
+                    if(fabs(pixDepth - depthMap(y, x)) < pixSize)
+                        inout_consistencyMap(y, x) = 1;
+                }
             }
         }
     }
-
-    return true;
 }
 
 // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
-void Fuser::filterGroups(const std::vector<int>& cams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams)
+void Fuser::filterGroups(const std::vector<int>& cams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams,
+                         std::size_t cacheMaxSize)
 {
     ALICEVISION_LOG_INFO("Precomputing groups.");
     long t1 = clock();
+
+    std::vector<StaticVector<int>> tcamsPerCam(cams.size());
 #pragma omp parallel for
     for(int c = 0; c < cams.size(); c++)
     {
-        int rc = cams[c];
-        filterGroupsRC(rc, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, nNearestCams);
+        tcamsPerCam[c] = _mp.findNearestCamsFromLandmarks(cams[c], nNearestCams);
+    }
+
+    // each depth map is read and back-projected once for all the cameras using it as a neighbour,
+    // as long as the cameras sharing neighbours are processed close in time
+    DepthMapPointsCache cache(_mp, cacheMaxSize);
+    const std::vector<int> order = orderCamerasByNeighbourhood(cams, tcamsPerCam);
+
+#pragma omp parallel for schedule(dynamic)
+    for(int i = 0; i < order.size(); i++)
+    {
+        const int c = order[i];
+        filterGroupsRC(cams[c], pixToleranceFactor, pixSizeBall, pixSizeBallWSP, tcamsPerCam[c], cache);
     }
 
+    cache.logStatistics();
     mvsUtils::printfElapsedTime(t1);
 }
 
 // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,...
 bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams)
+{
+    // no reuse of the neighbour depth maps for a single camera
+    DepthMapPointsCache cache(_mp, 0);
+    return filterGroupsRC(rc, pixToleranceFactor, pixSizeBall, pixSizeBallWSP, _mp.findNearestCamsFromLandmarks(rc, nNearestCams), cache);
+}
+
+bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, const StaticVector<int>& tcams,
+                           DepthMapPointsCache& cache)
 {
     if (bfs::exists(getFileNameFromIndex(_mp, rc, mvsUtils::EFileType::nmodMap)))
     {
@@ -158,40 +195,23 @@ bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, in
        throw std::runtime_error(s.str());
     }
 
-    StaticVector<int>* numOfPtsMap = new StaticVector<int>();
-    numOfPtsMap->reserve(w * h);
-    numOfPtsMap->resize_with(w * h, 0);
+    // pixels consistent with a tc depth map, kept from a tc camera to the next one
+    image::Image<unsigned char> consistencyMap(w, h, true, 0);
 
-    StaticVector<int> tcams = _mp.findNearestCamsFromLandmarks(rc, nNearestCams);
+    // 3d points of the valid depth values of a tc depth map, buffer reused for all the tc cameras
+    std::vector<Point3d> tcPoints;
 
     for(int c = 0; c < tcams.size(); c++)
     {
-        numOfPtsMap->resize_with(w * h, 0);
         int tc = tcams[c];
 
-        image::Image<float> tcdepthMap;
-
-        mvsUtils::readDepthMap(tc, _mp, tcdepthMap, 1);
-
-        if (tcdepthMap.Height() > 0 && tcdepthMap.Width() > 0)
+        if (cache.getPoints(tc, tcPoints))
         {
-            for(int y = 0; y < tcdepthMap.Height(); ++y)
-            {
-                for(int x = 0; x < tcdepthMap.Width(); ++x)
-                {
-                    float depth = tcdepthMap(y, x);
-
-                    if(depth > 0.0f)
-                    {
-                      Point3d p = _mp.CArr[tc] + (_mp.iCamArr[tc] * Point2d((float)x, (float)y)).normalize() * depth;
-                      updateInSurr(pixToleranceFactor, pixSizeBall, pixSizeBallWSP, p, rc, tc, numOfPtsMap, depthMap, simMap, 1);
-                    }
-                }
-            }
+            updateConsistencyMap(pixToleranceFactor, pixSizeBall, pixSizeBallWSP, rc, tc, tcPoints, depthMap, simMap, consistencyMap, 1);
 
             for(int i = 0; i < w * h; i++)
             {
-                numOfModalsMap(i) += static_cast<int>((*numOfPtsMap)[i] > 0);
+                numOfModalsMap(i) += consistencyMap(i);
             }
         }
     }
@@ -201,8 +221,6 @@ bool Fuser::filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, in
                                image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::LINEAR)
                                                          .storageDataType(image::EStorageDataType::Float));
 
-    delete numOfPtsMap;
-
     ALICEVISION_LOG_DEBUG(rc << " solved.");
     mvsUtils::printfElapsedTime(t1);
 
@@ -21,6 +21,8 @@ class SfMData;
 
 namespace fuseCut {
 
+class DepthMapPointsCache;
+
 class Fuser
 {
 public:
@@ -31,8 +33,29 @@ public:
 
     // minNumOfModals number of other cams including this cam ... minNumOfModals /in 2,3,... default 3
     // pixSizeBall = default 2
-    void filterGroups(const std::vector<int>& cams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams);
+    // cacheMaxSize = maximal size in bytes of the neighbour depth maps kept in memory
+    void filterGroups(const std::vector<int>& cams, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams,
+                      std::size_t cacheMaxSize = std::size_t(4096) * 1024 * 1024);
     bool filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int nNearestCams);
+
+    /**
+     * @brief Mark the pixels of the rc depth map consistent with the 3d points of a tc depth map
+     * @param[in] pixToleranceFactor the depth tolerance, in pixel size
+     * @param[in] pixSizeBall the radius of the window around the projected point
+     * @param[in] pixSizeBallWSP the radius of the window for weakly supported pixels
+     * @param[in] rc the reference camera index
+     * @param[in] tc the target camera index
+     * @param[in] tcPoints the 3d points of the tc depth map
+     * @param[in] depthMap the rc depth map at scale
+     * @param[in] simMap the rc similarity map at scale
+     * @param[in,out] inout_consistencyMap set to 1 for the consistent pixels, never reset to 0
+     * @param[in] scale the rc depth/sim map downscale factor
+     */
+    void updateConsistencyMap(float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, int rc, int tc,
+                              const std::vector<Point3d>& tcPoints,
+                              const image::Image<float>& depthMap, const image::Image<float>& simMap,
+                              image::Image<unsigned char>& inout_consistencyMap, int scale) const;
+
     void filterDepthMaps(const std::vector<int>& cams, int minNumOfModals, int minNumOfModalsWSP2SSP);
     bool filterDepthMapsRC(int rc, int minNumOfModals, int minNumOfModalsWSP2SSP);
 
@@ -46,8 +69,8 @@ public:
     Voxel estimateDimensions(Point3d* vox, Point3d* newSpace, int scale, int maxOcTreeDim, const sfmData::SfMData* sfmData = nullptr);
 
 private:
-    bool updateInSurr(float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, Point3d& p, int rc, int tc, StaticVector<int>* numOfPtsMap,
-                      const image::Image<float>& depthMap, const image::Image<float>& simMap, int scale);
+    bool filterGroupsRC(int rc, float pixToleranceFactor, int pixSizeBall, int pixSizeBallWSP, const StaticVector<int>& tcams,
+                        DepthMapPointsCache& cache);
 };
 
 unsigned long computeNumberOfAllPoints(const mvsUtils::MultiViewParams& mp, int scale);
@@ -0,0 +1,820 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "PartitionedMeshing.hpp"
+#include <aliceVision/system/Logger.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <utility>
+
+namespace aliceVision {
+namespace fuseCut {
+
+HexahedronPartitioning::HexahedronPartitioning(const Point3d hexah[8], int nbPartitions, double overlap)
+  : _origin(hexah[0])
+  , _vx(hexah[1] - hexah[0])
+  , _vy(hexah[3] - hexah[0])
+  , _vz(hexah[4] - hexah[0])
+  , _dimensions(1, 1, 1)
+  , _overlap(std::max(overlap, 0.0))
+{
+    const double det = dot(_vx, cross(_vy, _vz));
+    _dualX = cross(_vy, _vz) / det;
+    _dualY = cross(_vz, _vx) / det;
+    _dualZ = cross(_vx, _vy) / det;
+
+    // split the direction with the longest cells, to keep the cells as cubic as possible
+    const double sx = _vx.size();
+    const double sy = _vy.size();
+    const double sz = _vz.size();
+    while(getNbPartitions() < nbPartitions)
+    {
+        const double cx = sx / _dimensions.x;
+        const double cy = sy / _dimensions.y;
+        const double cz = sz / _dimensions.z;
+
+        if(cx >= cy && cx >= cz)
+            ++_dimensions.x;
+        else if(cy >= cz)
+            ++_dimensions.y;
+        else
+            ++_dimensions.z;
+    }
+}
+
+Point3d HexahedronPartitioning::getPoint(double u, double v, double w) const
+{
+    return _origin + _vx * u + _vy * v + _vz * w;
+}
+
+void HexahedronPartitioning::getPartitionHexahedron(int partition, Point3d out_hexah[8]) const
+{
+    const int x = partition % _dimensions.x;
+    const int y = (partition / _dimensions.x) % _dimensions.y;
+    const int z = partition / (_dimensions.x * _dimensions.y);
+
+    const double u0 = std::max(0.0, (x - _overlap) / _dimensions.x);
+    const double u1 = std::min(1.0, (x + 1 + _overlap) / _dimensions.x);
+    const double v0 = std::max(0.0, (y - _overlap) / _dimensions.y);
+    const double v1 = std::min(1.0, (y + 1 + _overlap) / _dimensions.y);
+    const double w0 = std::max(0.0, (z - _overlap) / _dimensions.z);
+    const double w1 = std::min(1.0, (z + 1 + _overlap) / _dimensions.z);
+
+    // same vertices order as the input hexahedron
+    out_hexah[0] = getPoint(u0, v0, w0);
+    out_hexah[1] = getPoint(u1, v0, w0);
+    out_hexah[2] = getPoint(u1, v1, w0);
+    out_hexah[3] = getPoint(u0, v1, w0);
+    out_hexah[4] = getPoint(u0, v0, w1);
+    out_hexah[5] = getPoint(u1, v0, w1);
+    out_hexah[6] = getPoint(u1, v1, w1);
+    out_hexah[7] = getPoint(u0, v1, w1);
+}
+
+int HexahedronPartitioning::getPartition(const Point3d& p) const
+{
+    const Point3d d = p - _origin;
+    const double u = dot(d, _dualX);
+    const double v = dot(d, _dualY);
+    const double w = dot(d, _dualZ);
+
+    if(u < 0.0 || u > 1.0 || v < 0.0 || v > 1.0 || w < 0.0 || w > 1.0)
+        return -1;
+
+    const int x = std::min(static_cast<int>(u * _dimensions.x), _dimensions.x - 1);
+    const int y = std::min(static_cast<int>(v * _dimensions.y), _dimensions.y - 1);
+    const int z = std::min(static_cast<int>(w * _dimensions.z), _dimensions.z - 1);
+
+    return (z * _dimensions.y + y) * _dimensions.x + x;
+}
+
+namespace {
+
+void mergePtCams(StaticVector<int>& inout_ptCams, const StaticVector<int>& ptCams)
+{
+    for(int cam : ptCams)
+    {
+        if(std::find(inout_ptCams.begin(), inout_ptCams.end(), cam) == inout_ptCams.end())
+            inout_ptCams.push_back(cam);
+    }
+}
+
+/**
+ * @brief Get the partition owning each triangle of a partition mesh
+ * The triangles crossing the border of the partition belong to the partition across the border, where they cross it too:
+ * the meshes of two partitions never overlap, and the gap between them is closed by the seams.
+ * @return for each triangle the partition owning it, -1 if it is outside of the partitioning
+ */
+std::vector<int> getTrianglesPartition(const HexahedronPartitioning& partitioning, const mesh::Mesh& mesh, int partition)
+{
+    std::vector<int> trisPartition(mesh.tris.size(), -1);
+
+    #pragma omp parallel for
+    for(int i = 0; i < mesh.tris.size(); ++i)
+    {
+        const mesh::Mesh::triangle& t = mesh.tris[i];
+        const Point3d cg = (mesh.pts[t.v[0]] + mesh.pts[t.v[1]] + mesh.pts[t.v[2]]) / 3.0;
+
+        trisPartition[i] = partitioning.getPartition(cg);
+        for(int k = 0; k < 3 && trisPartition[i] == partition; ++k)
+        {
+            const int ptPartition = partitioning.getPartition(mesh.pts[t.v[k]]);
+            if(ptPartition != -1)
+                trisPartition[i] = ptPartition;
+        }
+    }
+
+    return trisPartition;
+}
+
+/**
+ * @brief Get the directed edges of the triangles of a mesh, grouped by pair of vertices
+ * @return (min vertex, max vertex, from vertex, to vertex, triangle) of each triangle edge
+ */
+std::vector<std::tuple<int, int, int, int, int>> getSortedEdges(const mesh::Mesh& mesh)
+{
+    std::vector<std::tuple<int, int, int, int, int>> edges;
+    edges.reserve(mesh.tris.size() * 3);
+    for(int i = 0; i < mesh.tris.size(); ++i)
+    {
+        for(int k = 0; k < 3; ++k)
+        {
+            const int a = mesh.tris[i].v[k];
+            const int b = mesh.tris[i].v[(k + 1) % 3];
+            edges.emplace_back(std::min(a, b), std::max(a, b), a, b, i);
+        }
+    }
+    std::sort(edges.begin(), edges.end());
+    return edges;
+}
+
+/**
+ * @brief Boundary of a mesh, as the holes see it
+ */
+struct MeshBoundary
+{
+    /// next vertex along the boundary of the hole, in the orientation of the triangles filling it
+    /// (-1 if not a boundary vertex, -2 if the vertex is on several boundaries)
+    std::vector<int> holeNext;
+    /// previous vertex along the boundary of the hole (same special values)
+    std::vector<int> holePrev;
+    /// average length of the boundary edges of each vertex (0 if not a boundary vertex)
+    std::vector<double> edgeLength;
+    /// normal of the triangle of the boundary edge from each vertex to its next vertex
+    std::vector<Point3d> edgeNormal;
+};
+
+void buildMeshBoundary(const mesh::Mesh& mesh, MeshBoundary& out_boundary)
+{
+    // boundary edges are only used by one triangle, with the orientation of this triangle
+    const std::vector<std::tuple<int, int, int, int, int>> edges = getSortedEdges(mesh);
+
+    out_boundary.holeNext.assign(mesh.pts.size(), -1);
+    out_boundary.holePrev.assign(mesh.pts.size(), -1);
+    out_boundary.edgeLength.assign(mesh.pts.size(), 0.0);
+    out_boundary.edgeNormal.assign(mesh.pts.size(), Point3d());
+    std::vector<int> nbBoundaryEdges(mesh.pts.size(), 0);
+
+    const auto link = [](std::vector<int>& links, int from, int to) {
+        links[from] = (links[from] == -1) ? to : -2;
+    };
+
+    for(std::size_t i = 0; i < edges.size();)
+    {
+        std::size_t j = i + 1;
+        while(j < edges.size() && std::get<0>(edges[j]) == std::get<0>(edges[i]) && std::get<1>(edges[j]) == std::get<1>(edges[i]))
+            ++j;
+
+        if(j - i == 1)
+        {
+            // the triangle filling the hole uses the edge in the opposite direction
+            const int a = std::get<2>(edges[i]);
+            const int b = std::get<3>(edges[i]);
+            link(out_boundary.holeNext, b, a);
+            link(out_boundary.holePrev, a, b);
+
+            const mesh::Mesh::triangle& t = mesh.tris[std::get<4>(edges[i])];
+            out_boundary.edgeNormal[b] = cross(mesh.pts[t.v[1]] - mesh.pts[t.v[0]], mesh.pts[t.v[2]] - mesh.pts[t.v[0]]).normalize();
+
+            const double length = dist(mesh.pts[a], mesh.pts[b]);
+            out_boundary.edgeLength[a] += length;
+            out_boundary.edgeLength[b] += length;
+            ++nbBoundaryEdges[a];
+            ++nbBoundaryEdges[b];
+        }
+        i = j;
+    }
+
+    for(int i = 0; i < mesh.pts.size(); ++i)
+    {
+        if(nbBoundaryEdges[i] > 0)
+            out_boundary.edgeLength[i] /= nbBoundaryEdges[i];
+
+        // a vertex on several boundaries is left out of the seams
+        if(out_boundary.holeNext[i] == -2 || out_boundary.holePrev[i] == -2)
+        {
+            out_boundary.holeNext[i] = -2;
+            out_boundary.holePrev[i] = -2;
+        }
+    }
+}
+
+/**
+ * @brief Part of a boundary of a partition mesh left by the triangles of another partition
+ */
+struct SeamRun
+{
+    /// vertices in the hole orientation
+    std::vector<int> pts;
+    int partition;
+    int facingPartition;
+    /// the run is a whole boundary loop
+    bool closed;
+};
+
+/**
+ * @brief Split the boundaries of the mesh in runs of consecutive edges facing the same other partition
+ * @param[in] ptsSeamFacing the partition faced by the boundary edge from each vertex to its next vertex (-1 if none)
+ */
+void getSeamRuns(const MeshBoundary& boundary, const std::vector<int>& ptsPartition, const std::vector<int>& ptsSeamFacing,
+                 std::vector<SeamRun>& out_runs)
+{
+    const int nbPts = boundary.holeNext.size();
+
+    // walk each boundary once, from its first vertex if it is not a loop
+    std::vector<bool> visited(nbPts, false);
+    std::vector<int> chain;
+    std::vector<int> chainFacing;
+    for(int pass = 0; pass < 2; ++pass)
+    {
+        for(int start = 0; start < nbPts; ++start)
+        {
+            if(visited[start] || boundary.holeNext[start] < 0 || (pass == 0 && boundary.holePrev[start] >= 0))
+                continue;
+
+            chain.clear();
+            bool loop = false;
+            for(int i = start; i >= 0 && !visited[i]; i = boundary.holeNext[i])
+            {
+                visited[i] = true;
+                chain.push_back(i);
+                loop = (boundary.holeNext[i] == start);
+            }
+
+            // partition faced by the edge from each vertex of the chain
+            chainFacing.clear();
+            for(std::size_t i = 0; i < chain.size(); ++i)
+                chainFacing.push_back((loop || i + 1 < chain.size()) ? ptsSeamFacing[chain[i]] : -1);
+
+            // a loop starts at the beginning of a run if it has several runs
+            if(loop)
+            {
+                std::size_t first = 0;
+                while(first < chain.size() && chainFacing[first] == chainFacing.back())
+                    ++first;
+                if(first == chain.size())
+                {
+                    if(chainFacing.front() >= 0)
+                        out_runs.push_back(SeamRun{chain, ptsPartition[chain.front()], chainFacing.front(), true});
+                    continue;
+                }
+                std::rotate(chain.begin(), chain.begin() + first, chain.end());
+                std::rotate(chainFacing.begin(), chainFacing.begin() + first, chainFacing.end());
+                chain.push_back(chain.front());
+                chainFacing.push_back(-1);
+            }
+
+            for(std::size_t i = 0; i < chain.size();)
+            {
+                std::size_t j = i + 1;
+                while(j < chain.size() && chainFacing[j] == chainFacing[i])
+                    ++j;
+
+                // the run ends with the last vertex of its last edge
+                if(chainFacing[i] >= 0)
+                    out_runs.push_back(SeamRun{std::vector<int>(chain.begin() + i, chain.begin() + j + 1), ptsPartition[chain[i]], chainFacing[i], false});
+                i = j;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Get the index of the vertex of a run closest to a point
+ */
+std::size_t getClosestInRun(const mesh::Mesh& mesh, const std::vector<int>& run, const Point3d& p)
+{
+    std::size_t best = 0;
+    for(std::size_t i = 1; i < run.size(); ++i)
+    {
+        if(dist(mesh.pts[run[i]], p) < dist(mesh.pts[run[best]], p))
+            best = i;
+    }
+    return best;
+}
+
+/// Maximal number of edges of a run in a notch cut without joining the facing run
+constexpr int maxNotchSize = 4;
+
+/**
+ * @brief Triangulate the strip between two facing runs
+ * The runs are walked in opposite directions: a forward, b backward. Each step of the walk adds the triangle
+ * of the next edge of one of the runs, and the walk minimizes the number of triangles flipped compared to
+ * the boundary triangles, then the length of the edges joining the runs.
+ * The search is restricted to a band around the vertices at the same position along the runs.
+ * @param[out] out_bridges the edges joining the two runs
+ * @return the number of added triangles
+ */
+int zipRuns(mesh::Mesh& mesh, const MeshBoundary& boundary, const std::vector<int>& a, const std::vector<int>& b,
+            std::vector<std::pair<int, int>>& out_bridges)
+{
+    const auto getBoundaryNormal = [&](int v) {
+        const int prev = boundary.holePrev[v];
+        return (prev >= 0) ? boundary.edgeNormal[v] + boundary.edgeNormal[prev] : boundary.edgeNormal[v];
+    };
+    // v0 -> v1 is a boundary edge
+    const auto isFlipped = [&](int v0, int v1, int v2) {
+        const Point3d n = cross(mesh.pts[v1] - mesh.pts[v0], mesh.pts[v2] - mesh.pts[v0]);
+        return dot(n, boundary.edgeNormal[v0]) <= 0.0 || dot(n, getBoundaryNormal(v2)) <= 0.0;
+    };
+
+    // j is the number of vertices of b already walked
+    const std::size_t n = a.size() - 1;
+    const std::size_t m = b.size() - 1;
+    const auto getB = [&](std::size_t j) { return b[m - j]; };
+
+    // position of each vertex along its run, from 0 to 1 in the walk direction
+    const auto getRunPositions = [&](const std::function<int(std::size_t)>& getPt, std::size_t size) {
+        std::vector<double> positions(size + 1, 0.0);
+        for(std::size_t k = 1; k <= size; ++k)
+            positions[k] = positions[k - 1] + dist(mesh.pts[getPt(k - 1)], mesh.pts[getPt(k)]);
+        for(double& position : positions)
+            position = (positions.back() > 0.0) ? position / positions.back() : 0.0;
+        return positions;
+    };
+    const std::vector<double> aPositions = getRunPositions([&](std::size_t i) { return a[i]; }, n);
+    const std::vector<double> bPositions = getRunPositions(getB, m);
+
+    // range of j for each i, joining the bands of i and i + 1
+    const std::size_t bandWidth = std::max<std::size_t>(16, m / 32);
+    std::vector<std::size_t> matchingJ(n + 2, m);
+    for(std::size_t i = 0; i <= n; ++i)
+        matchingJ[i] = std::lower_bound(bPositions.begin(), bPositions.end(), aPositions[i]) - bPositions.begin();
+    std::vector<std::size_t> jMin(n + 1);
+    std::vector<std::size_t> jMax(n + 1);
+    for(std::size_t i = 0; i <= n; ++i)
+    {
+        jMin[i] = (i == 0) ? 0 : matchingJ[i] - std::min(matchingJ[i], bandWidth);
+        jMax[i] = (i == n) ? m : std::min(m, std::max(matchingJ[i], matchingJ[i + 1]) + bandWidth);
+    }
+
+    // number of flipped triangles and length of the joining edges to reach each (i, j),
+    // only kept for the rows reachable by a step
+    using Cost = std::pair<int, double>;
+    const Cost unreachable(std::numeric_limits<int>::max(), 0.0);
+    std::vector<std::vector<Cost>> costsRows(maxNotchSize + 1);
+    const auto getCosts = [&](std::size_t i) -> std::vector<Cost>& { return costsRows[i % costsRows.size()]; };
+    // step reaching each (i, j): the number of vertices of a walked (positive) or of b walked (negative)
+    std::vector<std::vector<signed char>> steps(n + 1);
+    const auto isInBand = [&](std::size_t i, std::size_t j) { return j >= jMin[i] && j <= jMax[i] && getCosts(i)[j - jMin[i]] != unreachable; };
+
+    for(std::size_t i = 0; i <= n; ++i)
+    {
+        std::vector<Cost>& costs = getCosts(i);
+        costs.assign(jMax[i] - jMin[i] + 1, unreachable);
+        steps[i].assign(jMax[i] - jMin[i] + 1, 0);
+        for(std::size_t j = jMin[i]; j <= jMax[i]; ++j)
+        {
+            const double length = dist(mesh.pts[a[i]], mesh.pts[getB(j)]);
+            Cost& cost = costs[j - jMin[i]];
+            if(i == 0 && j == 0)
+                cost = Cost(0, length);
+
+            // a step adds the triangle of the next edge of a run, or the fan of a notch of a run and the triangle closing it
+            for(int k = 1; k <= maxNotchSize; ++k)
+            {
+                if(i >= k && isInBand(i - k, j))
+                {
+                    const Cost& prev = getCosts(i - k)[j - jMin[i - k]];
+                    int nbFlipped = prev.first + isFlipped(a[i - k], a[i], getB(j));
+                    for(int t = 1; t < k; ++t)
+                        nbFlipped += isFlipped(a[i - k + t], a[i - k + t + 1], a[i - k]);
+                    if(Cost(nbFlipped, prev.second + length) < cost)
+                    {
+                        cost = Cost(nbFlipped, prev.second + length);
+                        steps[i][j - jMin[i]] = k;
+                    }
+                }
+                if(j >= jMin[i] + k && costs[j - k - jMin[i]] != unreachable)
+                {
+                    const Cost& prev = costs[j - k - jMin[i]];
+                    int nbFlipped = prev.first + isFlipped(getB(j), getB(j - k), a[i]);
+                    for(int t = 0; t < k - 1; ++t)
+                        nbFlipped += isFlipped(getB(j - t), getB(j - t - 1), getB(j - k));
+                    if(Cost(nbFlipped, prev.second + length) < cost)
+                    {
+                        cost = Cost(nbFlipped, prev.second + length);
+                        steps[i][j - jMin[i]] = -k;
+                    }
+                }
+            }
+        }
+    }
+
+    // walk back from the end of both runs
+    std::vector<signed char> path;
+    for(std::size_t i = n, j = m; i > 0 || j > 0;)
+    {
+        path.push_back(steps[i][j - jMin[i]]);
+        if(path.back() > 0)
+            i -= path.back();
+        else
+            j += path.back();
+    }
+
+    const std::size_t nbTris = mesh.tris.size();
+    std::size_t i = 0;
+    std::size_t j = 0;
+    out_bridges.emplace_back(a[i], getB(j));
+    for(auto it = path.rbegin(); it != path.rend(); ++it)
+    {
+        if(*it > 0)
+        {
+            const std::size_t k = *it;
+            for(std::size_t t = 1; t < k; ++t)
+                mesh.tris.push_back(mesh::Mesh::triangle(a[i + t], a[i + t + 1], a[i]));
+            mesh.tris.push_back(mesh::Mesh::triangle(a[i], a[i + k], getB(j)));
+            i += k;
+        }
+        else
+        {
+            const std::size_t k = -*it;
+            for(std::size_t t = 0; t + 1 < k; ++t)
+                mesh.tris.push_back(mesh::Mesh::triangle(getB(j + k - t), getB(j + k - t - 1), getB(j)));
+            mesh.tris.push_back(mesh::Mesh::triangle(getB(j + k), getB(j), a[i]));
+            j += k;
+        }
+        out_bridges.emplace_back(a[i], getB(j));
+    }
+    return mesh.tris.size() - nbTris;
+}
+
+/**
+ * @brief Close the gaps between the meshes of the partitions with triangles joining their facing runs
+ * @param[out] out_bridges the edges joining the facing runs
+ * @return the number of added triangles
+ */
+int zipPartitionsSeams(mesh::Mesh& mesh, const MeshBoundary& boundary, const std::vector<int>& ptsPartition,
+                       const std::vector<int>& ptsSeamFacing, std::vector<std::pair<int, int>>& out_bridges)
+{
+    std::vector<SeamRun> runs;
+    getSeamRuns(boundary, ptsPartition, ptsSeamFacing, runs);
+
+    int nbTris = 0;
+    std::vector<bool> zipped(runs.size(), false);
+    for(std::size_t r = 0; r < runs.size(); ++r)
+    {
+        // each seam is zipped from the run of its first partition
+        const SeamRun& runA = runs[r];
+        if(runA.partition > runA.facingPartition)
+            continue;
+        const std::vector<int>& a = runA.pts;
+
+        // the facing run starts where this one ends, as their holes have opposite orientations
+        int s = -1;
+        double bestDistance = std::numeric_limits<double>::max();
+        for(std::size_t i = 0; i < runs.size(); ++i)
+        {
+            const SeamRun& run = runs[i];
+            if(zipped[i] || run.partition != runA.facingPartition || run.facingPartition != runA.partition || run.closed != runA.closed)
+                continue;
+
+            const double d = runA.closed ? dist(mesh.pts[a.front()], mesh.pts[run.pts[getClosestInRun(mesh, run.pts, mesh.pts[a.front()])]])
+                                         : dist(mesh.pts[a.front()], mesh.pts[run.pts.back()]) + dist(mesh.pts[a.back()], mesh.pts[run.pts.front()]);
+            if(d < bestDistance)
+            {
+                bestDistance = d;
+                s = i;
+            }
+        }
+        if(s < 0)
+            continue;
+        zipped[s] = true;
+
+        if(runA.closed)
+        {
+            // both loops from their closest vertices, back to them
+            const std::vector<int>& b = runs[s].pts;
+            const std::size_t bStart = getClosestInRun(mesh, b, mesh.pts[a.front()]);
+            std::vector<int> aLoop(a);
+            aLoop.push_back(a.front());
+            std::vector<int> bLoop(b.begin() + bStart, b.end());
+            bLoop.insert(bLoop.end(), b.begin(), b.begin() + bStart + 1);
+
+            nbTris += zipRuns(mesh, boundary, aLoop, bLoop, out_bridges);
+        }
+        else
+        {
+            nbTris += zipRuns(mesh, boundary, a, runs[s].pts, out_bridges);
+        }
+    }
+
+    mesh.invalidateAdjacency();
+    return nbTris;
+}
+
+/**
+ * @brief Weld the vertices joined by the shortest bridges of the seams
+ * A bridge is welded if it is shorter than weldDistanceFactor times the boundary edges length of its vertices,
+ * and if moving its vertices to its middle flips none of their triangles.
+ * The vertices at the ends of the seams stay on the boundary of the mesh: the other vertex is moved to them.
+ * @param[out] out_ptIdToWeldedPtId the vertex replacing each vertex
+ * @return the number of welded vertices
+ */
+int weldSeamsBridges(mesh::Mesh& mesh, StaticVector<StaticVector<int>>& ptsCams, const MeshBoundary& boundary,
+                     const std::vector<int>& ptsSeamFacing, std::vector<std::pair<int, int>>& bridges,
+                     double weldDistanceFactor, std::vector<int>& out_ptIdToWeldedPtId)
+{
+    const auto isSeamEnd = [&](int v) {
+        return boundary.holeNext[v] < 0 || boundary.holePrev[v] < 0 || ptsSeamFacing[v] < 0 || ptsSeamFacing[boundary.holePrev[v]] < 0;
+    };
+
+    out_ptIdToWeldedPtId.resize(mesh.pts.size());
+    for(int i = 0; i < mesh.pts.size(); ++i)
+        out_ptIdToWeldedPtId[i] = i;
+
+    std::sort(bridges.begin(), bridges.end(), [&](const std::pair<int, int>& x, const std::pair<int, int>& y) {
+        return dist(mesh.pts[x.first], mesh.pts[x.second]) < dist(mesh.pts[y.first], mesh.pts[y.second]);
+    });
+
+    const mesh::Mesh::VertexTrianglesAdjacency& adjacency = mesh.getVertexTrianglesAdjacency();
+
+    // the neighbours of a welded vertex are not moved anymore, so that the checked triangles stay valid
+    std::vector<bool> locked(mesh.pts.size(), false);
+    int nbWelded = 0;
+    for(const std::pair<int, int>& bridge : bridges)
+    {
+        const int i = bridge.first;
+        const int j = bridge.second;
+        if(locked[i] || locked[j])
+            continue;
+
+        const double weldDistance = weldDistanceFactor * std::min(boundary.edgeLength[i], boundary.edgeLength[j]);
+        if(dist(mesh.pts[i], mesh.pts[j]) >= weldDistance)
+            continue;
+
+        // the vertices of both i and j triangles are the ones of the bridge triangles,
+        // otherwise the weld would create duplicated triangles
+        std::vector<int> neighbours[2];
+        std::vector<int> bridgeNeighbours;
+        for(int v = 0; v < 2; ++v)
+        {
+            for(int t : adjacency.getTriangles(v == 0 ? i : j))
+            {
+                const mesh::Mesh::triangle& tri = mesh.tris[t];
+                const bool isBridgeTri = std::count(tri.v, tri.v + 3, i) + std::count(tri.v, tri.v + 3, j) > 1;
+                for(int k = 0; k < 3; ++k)
+                {
+                    if(tri.v[k] == i || tri.v[k] == j)
+                        continue;
+                    neighbours[v].push_back(tri.v[k]);
+                    if(isBridgeTri)
+                        bridgeNeighbours.push_back(tri.v[k]);
+                }
+            }
+        }
+        for(std::vector<int>& ptIds : {std::ref(neighbours[0]), std::ref(neighbours[1]), std::ref(bridgeNeighbours)})
+        {
+            std::sort(ptIds.begin(), ptIds.end());
+            ptIds.erase(std::unique(ptIds.begin(), ptIds.end()), ptIds.end());
+        }
+        std::vector<int> commonNeighbours;
+        std::set_intersection(neighbours[0].begin(), neighbours[0].end(), neighbours[1].begin(), neighbours[1].end(),
+                              std::back_inserter(commonNeighbours));
+        if(commonNeighbours != bridgeNeighbours)
+            continue;
+
+        if(isSeamEnd(i) && isSeamEnd(j))
+            continue;
+        const Point3d weldedPt = isSeamEnd(i) ? mesh.pts[i] : (isSeamEnd(j) ? mesh.pts[j] : (mesh.pts[i] + mesh.pts[j]) / 2.0);
+        bool flips = false;
+        for(int v : {i, j})
+        {
+            for(int t : adjacency.getTriangles(v))
+            {
+                Point3d before[3];
+                Point3d after[3];
+                int nbWeldedPts = 0;
+                for(int k = 0; k < 3; ++k)
+                {
+                    const int ptId = mesh.tris[t].v[k];
+                    const bool welded = (ptId == i || ptId == j);
+                    before[k] = mesh.pts[ptId];
+                    after[k] = welded ? weldedPt : before[k];
+                    nbWeldedPts += welded;
+                }
+
+                // the triangles of the bridge collapse
+                if(nbWeldedPts > 1)
+                    continue;
+                flips |= dot(cross(before[1] - before[0], before[2] - before[0]), cross(after[1] - after[0], after[2] - after[0])) <= 0.0;
+            }
+        }
+        if(flips)
+            continue;
+
+        for(int v : {i, j})
+        {
+            for(int t : adjacency.getTriangles(v))
+            {
+                for(int k = 0; k < 3; ++k)
+                    locked[mesh.tris[t].v[k]] = true;
+            }
+        }
+
+        out_ptIdToWeldedPtId[j] = i;
+        mesh.pts[i] = weldedPt;
+        mergePtCams(ptsCams[i], ptsCams[j]);
+        ++nbWelded;
+    }
+
+    return nbWelded;
+}
+
+/**
+ * @brief Replace the welded vertices in the triangles
+ * The triangles collapsed by the weld are removed, as well as the pairs of opposite triangles it creates.
+ */
+void applyWelds(mesh::Mesh& mesh, const std::vector<int>& ptIdToWeldedPtId)
+{
+    StaticVector<mesh::Mesh::triangle> tris;
+    tris.reserve(mesh.tris.size());
+    std::map<std::tuple<int, int, int>, std::size_t> trisPerVertices;
+    std::vector<bool> removed;
+    for(int i = 0; i < mesh.tris.size(); ++i)
+    {
+        mesh::Mesh::triangle t = mesh.tris[i];
+        for(int k = 0; k < 3; ++k)
+            t.v[k] = ptIdToWeldedPtId[t.v[k]];
+
+        if(t.v[0] == t.v[1] || t.v[1] == t.v[2] || t.v[2] == t.v[0])
+            continue;
+
+        // same vertices: a duplicate, or a fold of two opposite triangles
+        std::array<int, 3> sorted = {t.v[0], t.v[1], t.v[2]};
+        std::sort(sorted.begin(), sorted.end());
+        const auto result = trisPerVertices.emplace(std::make_tuple(sorted[0], sorted[1], sorted[2]), tris.size());
+        if(!result.second)
+        {
+            const mesh::Mesh::triangle& other = tris[result.first->second];
+            const int k = std::find(other.v, other.v + 3, t.v[0]) - other.v;
+            if(other.v[(k + 1) % 3] != t.v[1])
+                removed[result.first->second] = true;
+            continue;
+        }
+
+        tris.push_back(t);
+        removed.push_back(false);
+    }
+
+    mesh.tris.clear();
+    for(int i = 0; i < tris.size(); ++i)
+    {
+        if(!removed[i])
+            mesh.tris.push_back(tris[i]);
+    }
+    mesh.invalidateAdjacency();
+}
+
+} // namespace
+
+mesh::Mesh* stitchPartitionsMeshes(const HexahedronPartitioning& partitioning,
+                                   const std::vector<mesh::Mesh*>& partitionsMeshes,
+                                   const std::vector<StaticVector<StaticVector<int>>>& partitionsPtsCams,
+                                   double weldDistanceFactor,
+                                   StaticVector<StaticVector<int>>& out_ptsCams)
+{
+    ALICEVISION_LOG_INFO("Stitch the meshes of " << partitionsMeshes.size() << " partitions.");
+
+    mesh::Mesh* stitchedMesh = new mesh::Mesh();
+    StaticVector<StaticVector<int>> ptsCams;
+    std::vector<int> ptsPartition;
+    // partition faced by the seam edge from each vertex along the boundary of its hole (-1 if none)
+    std::vector<int> ptsSeamFacing;
+
+    for(int p = 0; p < partitionsMeshes.size(); ++p)
+    {
+        if(partitionsMeshes[p] == nullptr)
+            continue;
+
+        const mesh::Mesh& partitionMesh = *partitionsMeshes[p];
+        const StaticVector<StaticVector<int>>& partitionPtsCams = partitionsPtsCams[p];
+        std::vector<int> ptIdToNewPtId(partitionMesh.pts.size(), -1);
+
+        // the other partitions keep the triangles of the overlap they own
+        const std::vector<int> trisPartition = getTrianglesPartition(partitioning, partitionMesh, p);
+        for(int i = 0; i < partitionMesh.tris.size(); ++i)
+        {
+            if(trisPartition[i] != p)
+                continue;
+
+            const mesh::Mesh::triangle& t = partitionMesh.tris[i];
+            mesh::Mesh::triangle newTri;
+            for(int k = 0; k < 3; ++k)
+            {
+                int& newPtId = ptIdToNewPtId[t.v[k]];
+                if(newPtId == -1)
+                {
+                    newPtId = stitchedMesh->pts.size();
+                    stitchedMesh->pts.push_back(partitionMesh.pts[t.v[k]]);
+                    ptsCams.push_back(t.v[k] < partitionPtsCams.size() ? partitionPtsCams[t.v[k]] : StaticVector<int>());
+                    ptsPartition.push_back(p);
+                    ptsSeamFacing.push_back(-1);
+                }
+                newTri.v[k] = newPtId;
+            }
+            stitchedMesh->tris.push_back(newTri);
+        }
+
+        // the seams are the edges between a kept triangle and a triangle left to another partition
+        const std::vector<std::tuple<int, int, int, int, int>> edges = getSortedEdges(partitionMesh);
+        for(std::size_t i = 0; i + 1 < edges.size(); ++i)
+        {
+            const auto isSameEdge = [&](std::size_t j) {
+                return j < edges.size() && std::get<0>(edges[j]) == std::get<0>(edges[i]) && std::get<1>(edges[j]) == std::get<1>(edges[i]);
+            };
+            if(!isSameEdge(i + 1) || isSameEdge(i + 2) || (i > 0 && isSameEdge(i - 1)))
+                continue;
+
+            for(int k = 0; k < 2; ++k)
+            {
+                const auto& kept = edges[i + k];
+                const int otherPartition = trisPartition[std::get<4>(edges[i + 1 - k])];
+                if(trisPartition[std::get<4>(kept)] == p && otherPartition != p && otherPartition != -1)
+                {
+                    // the hole uses the edge in the opposite direction
+                    ptsSeamFacing[ptIdToNewPtId[std::get<3>(kept)]] = otherPartition;
+                }
+            }
+        }
+    }
+
+    // close the gaps between the partitions, then weld the vertices the seams bring together
+    MeshBoundary boundary;
+    buildMeshBoundary(*stitchedMesh, boundary);
+
+    std::vector<std::pair<int, int>> bridges;
+    const int nbZipTris = zipPartitionsSeams(*stitchedMesh, boundary, ptsPartition, ptsSeamFacing, bridges);
+
+    std::vector<int> ptIdToWeldedPtId;
+    const int nbWelded = weldSeamsBridges(*stitchedMesh, ptsCams, boundary, ptsSeamFacing, bridges, weldDistanceFactor, ptIdToWeldedPtId);
+    applyWelds(*stitchedMesh, ptIdToWeldedPtId);
+
+    // remove the welded vertices
+    std::vector<int> ptIdToNewPtId(stitchedMesh->pts.size(), -1);
+    for(int i = 0; i < stitchedMesh->tris.size(); ++i)
+    {
+        for(int k = 0; k < 3; ++k)
+            ptIdToNewPtId[stitchedMesh->tris[i].v[k]] = 0;
+    }
+
+    StaticVector<Point3d> pts;
+    pts.reserve(stitchedMesh->pts.size() - nbWelded);
+    out_ptsCams.clear();
+    out_ptsCams.reserve(stitchedMesh->pts.size() - nbWelded);
+    for(int i = 0; i < stitchedMesh->pts.size(); ++i)
+    {
+        if(ptIdToNewPtId[i] == -1)
+            continue;
+
+        ptIdToNewPtId[i] = pts.size();
+        pts.push_back(stitchedMesh->pts[i]);
+        out_ptsCams.push_back(ptsCams[i]);
+    }
+    stitchedMesh->pts.swap(pts);
+
+    for(int i = 0; i < stitchedMesh->tris.size(); ++i)
+    {
+        for(int k = 0; k < 3; ++k)
+            stitchedMesh->tris[i].v[k] = ptIdToNewPtId[stitchedMesh->tris[i].v[k]];
+    }
+    stitchedMesh->invalidateAdjacency();
+
+    ALICEVISION_LOG_INFO("Stitched mesh: " << stitchedMesh->pts.size() << " vertices, " << stitchedMesh->tris.size()
+                         << " triangles, " << nbZipTris << " triangles added and " << nbWelded << " vertices welded along the seams.");
+
+    return stitchedMesh;
+}
+
+} // namespace fuseCut
+} // namespace aliceVision
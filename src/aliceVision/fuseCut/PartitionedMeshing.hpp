@@ -0,0 +1,91 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mvsData/Point3d.hpp>
+#include <aliceVision/mvsData/StaticVector.hpp>
+#include <aliceVision/mvsData/Voxel.hpp>
+#include <aliceVision/mesh/Mesh.hpp>
+
+#include <vector>
+
+namespace aliceVision {
+namespace fuseCut {
+
+/**
+ * @brief Regular partitioning of a hexahedron in overlapping sub-hexahedrons, to mesh a large scene part by part.
+ *
+ * The hexahedron is split in a grid of cells. The hexahedron of a partition is its cell inflated by the overlap
+ * (clamped to the input hexahedron), so that the surface around the seams is reconstructed by the two sides.
+ * Each point of the input hexahedron is owned by exactly one cell, which decides the partition keeping a triangle.
+ */
+class HexahedronPartitioning
+{
+public:
+    /**
+     * @param[in] hexah the hexahedron to partition
+     * @param[in] nbPartitions the minimal number of partitions
+     * @param[in] overlap the overlap added on each side of a cell, relative to the cell size
+     */
+    HexahedronPartitioning(const Point3d hexah[8], int nbPartitions, double overlap);
+
+    /// Number of partitions in each direction of the hexahedron
+    const Voxel& getDimensions() const { return _dimensions; }
+
+    int getNbPartitions() const { return _dimensions.x * _dimensions.y * _dimensions.z; }
+
+    /**
+     * @brief Get the hexahedron to reconstruct for a partition, including the overlap
+     * @param[in] partition the partition index
+     * @param[out] out_hexah the partition hexahedron
+     */
+    void getPartitionHexahedron(int partition, Point3d out_hexah[8]) const;
+
+    /**
+     * @brief Get the partition owning a point
+     * @return the partition index, -1 if the point is outside the hexahedron
+     */
+    int getPartition(const Point3d& p) const;
+
+private:
+    /// Point from its coordinates in the hexahedron basis, in [0, 1]
+    Point3d getPoint(double u, double v, double w) const;
+
+    Point3d _origin;
+    Point3d _vx;
+    Point3d _vy;
+    Point3d _vz;
+    /// dual basis, to get the coordinates of a point in the hexahedron basis
+    Point3d _dualX;
+    Point3d _dualY;
+    Point3d _dualZ;
+    Voxel _dimensions;
+    double _overlap;
+};
+
+/**
+ * @brief Stitch the meshes of the partitions along their seams.
+ *
+ * Each partition only keeps the triangles with a center of gravity and vertices it owns, so the overlaps are not duplicated
+ * and the meshes of two partitions never overlap. The gap left along each seam between their boundaries is zipped
+ * with triangles joining the two boundaries, whatever their vertices. Then the vertices joined by a seam edge
+ * shorter than weldDistanceFactor times their average boundary edge length are welded, unless it flips a triangle.
+ * @param[in] partitioning the partitioning of the reconstructed space
+ * @param[in] partitionsMeshes the mesh of each partition (nullptr if none)
+ * @param[in] partitionsPtsCams the visibilities of the vertices of each partition mesh
+ * @param[in] weldDistanceFactor the maximal distance between welded vertices, relative to their boundary edges length
+ * @param[out] out_ptsCams the visibilities of the stitched mesh vertices
+ * @return the stitched mesh
+ */
+mesh::Mesh* stitchPartitionsMeshes(const HexahedronPartitioning& partitioning,
+                                   const std::vector<mesh::Mesh*>& partitionsMeshes,
+                                   const std::vector<StaticVector<StaticVector<int>>>& partitionsPtsCams,
+                                   double weldDistanceFactor,
+                                   StaticVector<StaticVector<int>>& out_ptsCams);
+
+} // namespace fuseCut
+} // namespace aliceVision
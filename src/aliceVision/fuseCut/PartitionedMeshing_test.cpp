@@ -0,0 +1,203 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/fuseCut/PartitionedMeshing.hpp>
+#include <aliceVision/mesh/meshTestCommon.hpp>
+#include <aliceVision/mvsUtils/common.hpp>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <utility>
+
+#define BOOST_TEST_MODULE partitionedMeshing
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::fuseCut;
+
+namespace {
+
+void getBox(const Point3d& min, const Point3d& max, Point3d out_hexah[8])
+{
+    out_hexah[0] = Point3d(min.x, min.y, min.z);
+    out_hexah[1] = Point3d(max.x, min.y, min.z);
+    out_hexah[2] = Point3d(max.x, max.y, min.z);
+    out_hexah[3] = Point3d(min.x, max.y, min.z);
+    out_hexah[4] = Point3d(min.x, min.y, max.z);
+    out_hexah[5] = Point3d(max.x, min.y, max.z);
+    out_hexah[6] = Point3d(max.x, max.y, max.z);
+    out_hexah[7] = Point3d(min.x, max.y, max.z);
+}
+
+/// Regular triangulation of the plane z = 0 for x in [minX, maxX], y in [0, 1] with nx * ny cells, vertices seen by camera cam
+/// The noise moves the vertices along the plane, except on its border.
+void createPlaneMesh(double minX, double maxX, int nx, int ny, double noise, int cam, mesh::Mesh& out_mesh, StaticVector<StaticVector<int>>& out_ptsCams)
+{
+    std::mt19937 generator(cam);
+    std::uniform_real_distribution<double> uniform(-noise, noise);
+
+    const double stepX = (maxX - minX) / nx;
+    const double stepY = 1.0 / ny;
+    mesh::test::createGridMesh(
+      nx, ny,
+      [&](int x, int y) {
+          const double noiseX = (x == 0 || x == nx) ? 0.0 : uniform(generator);
+          const double noiseY = (y == 0 || y == ny) ? 0.0 : uniform(generator);
+          return Point3d(minX + x * stepX + noiseX, y * stepY + noiseY, 0.0);
+      },
+      nullptr, out_mesh);
+
+    for(int i = 0; i < out_mesh.pts.size(); ++i)
+    {
+        out_ptsCams.push_back(StaticVector<int>());
+        out_ptsCams[out_ptsCams.size() - 1].push_back(cam);
+    }
+}
+
+/// Check that a mesh covers the plane z = 0 for x in [0, 2], y in [0, 1] once, without crack
+void checkStitchedPlane(const mesh::Mesh& mesh)
+{
+    // no crack along the seams: the only boundary edges are on the border of the plane
+    std::map<std::pair<int, int>, int> edges;
+    for(int i = 0; i < mesh.tris.size(); ++i)
+    {
+        for(int k = 0; k < 3; ++k)
+        {
+            const int a = mesh.tris[i].v[k];
+            const int b = mesh.tris[i].v[(k + 1) % 3];
+            ++edges[std::make_pair(std::min(a, b), std::max(a, b))];
+        }
+    }
+    const auto isOnBorder = [](const Point3d& p) {
+        const double eps = 1e-9;
+        return p.x < eps || p.x > 2.0 - eps || p.y < eps || p.y > 1.0 - eps;
+    };
+    for(const auto& edge : edges)
+    {
+        // manifold
+        BOOST_CHECK_LE(edge.second, 2);
+        if(edge.second == 1)
+        {
+            BOOST_CHECK(isOnBorder(mesh.pts[edge.first.first]));
+            BOOST_CHECK(isOnBorder(mesh.pts[edge.first.second]));
+        }
+    }
+
+    // no overlap and no fold: the triangles cover the plane once, with the same orientation
+    double area = 0.0;
+    for(int i = 0; i < mesh.tris.size(); ++i)
+    {
+        const mesh::Mesh::triangle& t = mesh.tris[i];
+        const Point3d n = cross(mesh.pts[t.v[1]] - mesh.pts[t.v[0]], mesh.pts[t.v[2]] - mesh.pts[t.v[0]]);
+        BOOST_CHECK_GT(n.z, 0.0);
+        area += n.z / 2.0;
+    }
+    BOOST_CHECK_CLOSE(area, 2.0, 1e-6);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(partitionedMeshing_hexahedronPartitioning)
+{
+    Point3d hexah[8];
+    getBox(Point3d(-1.0, 0.0, 0.0), Point3d(3.0, 2.0, 1.0), hexah);
+
+    const HexahedronPartitioning partitioning(hexah, 6, 0.1);
+    BOOST_CHECK_GE(partitioning.getNbPartitions(), 6);
+    // cells as cubic as possible
+    BOOST_CHECK_GE(partitioning.getDimensions().x, partitioning.getDimensions().y);
+    BOOST_CHECK_GE(partitioning.getDimensions().y, partitioning.getDimensions().z);
+
+    std::vector<std::array<Point3d, 8>> partitionsHexah(partitioning.getNbPartitions());
+    for(int p = 0; p < partitioning.getNbPartitions(); ++p)
+        partitioning.getPartitionHexahedron(p, &partitionsHexah[p][0]);
+
+    std::mt19937 generator(0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for(int i = 0; i < 10000; ++i)
+    {
+        const Point3d p(-1.0 + 4.0 * uniform(generator), 2.0 * uniform(generator), uniform(generator));
+
+        // each point is owned by one partition, reconstructed with it
+        const int partition = partitioning.getPartition(p);
+        BOOST_REQUIRE(partition >= 0 && partition < partitioning.getNbPartitions());
+        BOOST_CHECK(mvsUtils::isPointInHexahedron(p, &partitionsHexah[partition][0]));
+    }
+
+    BOOST_CHECK_EQUAL(partitioning.getPartition(Point3d(3.5, 1.0, 0.5)), -1);
+    BOOST_CHECK_EQUAL(partitioning.getPartition(Point3d(0.0, 1.0, -0.1)), -1);
+
+    // partitions do not exceed the input hexahedron
+    Point3d hexahInflated[8];
+    mvsUtils::inflateHexahedron(hexah, hexahInflated, 1.001);
+    for(const auto& partitionHexah : partitionsHexah)
+        for(const Point3d& p : partitionHexah)
+            BOOST_CHECK(mvsUtils::isPointInHexahedron(p, hexahInflated));
+}
+
+BOOST_AUTO_TEST_CASE(partitionedMeshing_stitch)
+{
+    Point3d hexah[8];
+    getBox(Point3d(0.0, -0.1, -0.5), Point3d(2.0, 1.1, 0.5), hexah);
+    const HexahedronPartitioning partitioning(hexah, 2, 0.1);
+    BOOST_REQUIRE_EQUAL(partitioning.getNbPartitions(), 2);
+
+    // the two partitions reconstruct the overlap [0.8, 1.2] with slightly different vertices
+    const double step = 0.05;
+    std::vector<mesh::Mesh*> meshes = {new mesh::Mesh(), new mesh::Mesh()};
+    std::vector<StaticVector<StaticVector<int>>> ptsCams(2);
+    createPlaneMesh(0.0, 1.2, 24, 20, 0.1 * step, 0, *meshes[0], ptsCams[0]);
+    createPlaneMesh(0.8, 2.0, 24, 20, 0.0, 1, *meshes[1], ptsCams[1]);
+
+    StaticVector<StaticVector<int>> stitchedPtsCams;
+    mesh::Mesh* stitchedMesh = stitchPartitionsMeshes(partitioning, meshes, ptsCams, 0.5, stitchedPtsCams);
+    BOOST_REQUIRE_EQUAL(stitchedPtsCams.size(), stitchedMesh->pts.size());
+
+    checkStitchedPlane(*stitchedMesh);
+
+    // welded vertices are seen by both partitions cameras
+    int nbSeamPts = 0;
+    for(int i = 0; i < stitchedPtsCams.size(); ++i)
+    {
+        if(stitchedPtsCams[i].size() == 2)
+        {
+            ++nbSeamPts;
+            BOOST_CHECK_SMALL(stitchedMesh->pts[i].x - 1.0, 0.1 * step);
+        }
+    }
+    BOOST_CHECK_GT(nbSeamPts, 0);
+
+    delete stitchedMesh;
+    for(mesh::Mesh* mesh : meshes)
+        delete mesh;
+}
+
+BOOST_AUTO_TEST_CASE(partitionedMeshing_stitchDifferentVertices)
+{
+    Point3d hexah[8];
+    getBox(Point3d(0.0, -0.1, -0.5), Point3d(2.0, 1.1, 0.5), hexah);
+    const HexahedronPartitioning partitioning(hexah, 2, 0.1);
+    BOOST_REQUIRE_EQUAL(partitioning.getNbPartitions(), 2);
+
+    // the two partitions reconstruct the overlap [0.8, 1.2] with unrelated vertices
+    std::vector<mesh::Mesh*> meshes = {new mesh::Mesh(), new mesh::Mesh()};
+    std::vector<StaticVector<StaticVector<int>>> ptsCams(2);
+    createPlaneMesh(0.0, 1.2, 24, 20, 0.01, 0, *meshes[0], ptsCams[0]);
+    createPlaneMesh(0.8, 2.0, 17, 13, 0.015, 1, *meshes[1], ptsCams[1]);
+
+    StaticVector<StaticVector<int>> stitchedPtsCams;
+    mesh::Mesh* stitchedMesh = stitchPartitionsMeshes(partitioning, meshes, ptsCams, 0.5, stitchedPtsCams);
+    BOOST_REQUIRE_EQUAL(stitchedPtsCams.size(), stitchedMesh->pts.size());
+
+    checkStitchedPlane(*stitchedMesh);
+
+    delete stitchedMesh;
+    for(mesh::Mesh* mesh : meshes)
+        delete mesh;
+}
@@ -14,6 +14,8 @@
 
 #include <OpenImageIO/imagebufalgo.h>
 
+#include <Eigen/SparseLU>
+
 #include <iostream>
 #include <fstream>
 #include <cassert>
@@ -45,23 +47,19 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
     // Initialize response
     response = rgbCurve(channelQuantization);
 
-    // Store intermediate data for all three channels
+    // Each sample only observes a few quantized values: all matrices coupling the samples are very sparse
+    bool success = true;
 
-    // Initialize intermediate buffers
-    for(unsigned int channel = 0; channel < channelsCount; ++channel)
+    #pragma omp parallel for
+    for(int channel = 0; channel < int(channelsCount); ++channel)
     {
-        Eigen::MatrixXd A(channelQuantization, channelQuantization);
-        Eigen::MatrixXd B(channelQuantization, totalPoints);
-        Eigen::DiagonalMatrix<double, Eigen::Dynamic> Dinv(totalPoints);
-        Eigen::VectorXd h1(channelQuantization);
-        Eigen::VectorXd h2(totalPoints);
-
-        // Initialize
-        A.fill(0);
-        B.fill(0);
-        h1.fill(0);
-        h2.fill(0);
-        Dinv.setZero();
+        std::vector<Eigen::Triplet<double>> tripletsA;
+        std::vector<Eigen::Triplet<double>> tripletsB;
+        Eigen::VectorXd Dinv = Eigen::VectorXd::Zero(totalPoints);
+        Eigen::VectorXd h1 = Eigen::VectorXd::Zero(channelQuantization);
+        Eigen::VectorXd h2 = Eigen::VectorXd::Zero(totalPoints);
+
+        tripletsA.reserve(9 * channelQuantization);
 
         size_t countPoints = 0;
         for(size_t groupId = 0; groupId < ldrSamples.size(); groupId++)
@@ -89,9 +87,10 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
                     const double w_ij_2 = w_ij * w_ij;
                     const double w_ij2_time = w_ij_2 * time;
 
-                    Dinv.diagonal()[pospoint] += w_ij_2;
-                    A(index, index) += w_ij_2;
-                    B(index, pospoint) -= w_ij_2;
+                    // Duplicated entries are summed when building the sparse matrices
+                    Dinv[pospoint] += w_ij_2;
+                    tripletsA.emplace_back(index, index, w_ij_2);
+                    tripletsB.emplace_back(index, pospoint, -w_ij_2);
                     h1(index) += w_ij2_time;
                     h2(pospoint) += -w_ij2_time;
                 }
@@ -108,21 +107,15 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
             // f''(x) = f(x + 1) - 2 * f(x) + f(x - 1)
             const float w = weight.getValue(k + 1, channel);
 
-            const double v1 = lambda * w;
-            const double v2 = -2.0f * lambda * w;
-            const double v3 = lambda * w;
-
-            A(k, k) += v1 * v1;
-            A(k, k + 1) += v1 * v2;
-            A(k, k + 2) += v1 * v3;
-
-            A(k + 1, k) += v2 * v1;
-            A(k + 1, k + 1) += v2 * v2;
-            A(k + 1, k + 2) += v2 * v3;
+            const double v[3] = {lambda * w, -2.0f * lambda * w, lambda * w};
 
-            A(k + 2, k) += v3 * v1;
-            A(k + 2, k + 1) += v3 * v2;
-            A(k + 2, k + 2) += v3 * v3;
+            for(std::size_t i = 0; i < 3; ++i)
+            {
+                for(std::size_t j = 0; j < 3; ++j)
+                {
+                    tripletsA.emplace_back(k + i, k + j, v[i] * v[j]);
+                }
+            }
         }
 
         //
@@ -130,7 +123,12 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
         // Enforce f(0.5) = 0.0
         //
         const size_t pos_middle = std::floor(channelQuantization / 2);
-        A(pos_middle, pos_middle) += 1.0f;
+        tripletsA.emplace_back(pos_middle, pos_middle, 1.0f);
+
+        Eigen::SparseMatrix<double> A(channelQuantization, channelQuantization);
+        A.setFromTriplets(tripletsA.begin(), tripletsA.end());
+        Eigen::SparseMatrix<double> B(channelQuantization, totalPoints);
+        B.setFromTriplets(tripletsB.begin(), tripletsB.end());
 
         // M is
         //
@@ -144,18 +142,28 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
         // [C D]   [0     Abr^T][Abl Abr]   [Abr^TAbl            Abr^TAbr]
         // [h1] = [Atl^T bh + Abl^T bb] = [Abl^T bb]
         // [h2]   [Atr^T bh + Abr^T bb]   [Abr^T bb]
-        const Eigen::MatrixXd C = B.transpose();
-
-        for(int i = 0; i < Dinv.rows(); i++)
+        // with C = B^T and D diagonal, the unknowns of the samples are eliminated with the Schur complement.
+        for(int i = 0; i < Dinv.size(); i++)
         {
-            Dinv.diagonal()[i] = 1.0 / Dinv.diagonal()[i];
+            Dinv[i] = 1.0 / Dinv[i];
         }
 
-        const Eigen::MatrixXd Bdinv = B * Dinv;
-        const Eigen::MatrixXd left = A - Bdinv * C;
+        const Eigen::SparseMatrix<double> Bdinv = B * Dinv.asDiagonal();
+        Eigen::SparseMatrix<double> left = A - Bdinv * Eigen::SparseMatrix<double>(B.transpose());
         const Eigen::VectorXd right = h1 - Bdinv * h2;
 
-        const Eigen::VectorXd x = left.lu().solve(right);
+        left.makeCompressed();
+        Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
+        solver.compute(left);
+        if(solver.info() != Eigen::Success)
+        {
+            ALICEVISION_LOG_ERROR("Debevec calibration: failed to factorize the system for channel " << channel << ".");
+            #pragma omp critical
+            success = false;
+            continue;
+        }
+
+        const Eigen::VectorXd x = solver.solve(right);
 
         // Copy the result to the response curve
         for(std::size_t k = 0; k < channelQuantization; ++k)
@@ -164,6 +172,11 @@ bool DebevecCalibrate::process(const std::vector<std::vector<ImageSample>>& ldrS
         }
     }
 
+    if(!success)
+    {
+        return false;
+    }
+
     return true;
 }
 
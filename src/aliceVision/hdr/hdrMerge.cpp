@@ -5,6 +5,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "hdrMerge.hpp"
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <limits>
@@ -42,131 +43,190 @@ inline float sigmoidInv(float zeroVal, float endVal, float sigwidth, float sigMi
     return zeroVal + (endVal - zeroVal) * (1.0f / (1.0f + expf(10.0f * ((sigMid - xval) / sigwidth))));
 }
 
-void hdrMerge::process(const std::vector< image::Image<image::RGBfColor> > &images,
-                        const std::vector<double> &times,
-                        const rgbCurve &weight,
-                        const rgbCurve &response,
-                        image::Image<image::RGBfColor> &radiance,
-                        float targetCameraExposure)
+namespace {
+
+/**
+ * @brief Sample a curve padded with its last value.
+ *        The index is clamped and the last sample gets a null fractional part, so no branch is needed.
+ */
+inline float lookupCurve(const float* lut, float scale, float sample)
 {
-  //checks
-  assert(!response.isEmpty());
-  assert(!images.empty());
-  assert(images.size() == times.size());
+    const float valueScaled = std::max(0.f, std::min(1.f, sample)) * scale;
+    const float infIndex = std::floor(valueScaled);
+    const float fractionalPart = valueScaled - infIndex;
+    const std::size_t index = std::size_t(infIndex);
 
-  // get images width, height
-  const std::size_t width = images.front().Width();
-  const std::size_t height = images.front().Height();
+    return (1.0f - fractionalPart) * lut[index] + fractionalPart * lut[index + 1];
+}
 
-  // resize and reset radiance image to 0.0
-  radiance.resize(width, height, true, image::RGBfColor(0.f, 0.f, 0.f));
+void buildLut(const std::vector<float>& curve, std::vector<float>& lut)
+{
+    lut.resize(curve.size() + 1);
+    std::copy(curve.begin(), curve.end(), lut.begin());
+    lut.back() = curve.back();
+}
 
-  ALICEVISION_LOG_TRACE("[hdrMerge] Images to fuse:");
-  for(int i = 0; i < images.size(); ++i)
-  {
-    ALICEVISION_LOG_TRACE(images[i].Width() << "x" << images[i].Height() << ", time: " << times[i]);
-  }
+} // namespace
+
+void hdrMerge::init(std::size_t width, std::size_t height, std::size_t nbImages,
+                    const rgbCurve &weight,
+                    const rgbCurve &response)
+{
+  assert(!response.isEmpty());
+  assert(nbImages > 0);
+  assert(weight.getSize() == response.getSize());
+
+  _nbImages = nbImages;
+  _lutScale = float(response.getSize()) - 1.0f;
 
   rgbCurve weightShortestExposure = weight;
   weightShortestExposure.freezeSecondPartValues();
   rgbCurve weightLongestExposure = weight;
   weightLongestExposure.freezeFirstPartValues();
 
+  for(std::size_t channel = 0; channel < 3; ++channel)
+  {
+    //
+    // weightShortestExposure:          _______
+    //                          _______/
+    //                                0      1
+    buildLut(weightShortestExposure.getCurve(channel), _weightLut[SHORTEST][channel]);
+    //
+    // weight:          ____
+    //          _______/    \________
+    //                0      1
+    buildLut(weight.getCurve(channel), _weightLut[INTERMEDIATE][channel]);
+    //
+    // weightLongestExposure:  ____________
+    //                                      \_______
+    //                                0      1
+    buildLut(weightLongestExposure.getCurve(channel), _weightLut[LONGEST][channel]);
+
+    buildLut(response.getCurve(channel), _responseLut[channel]);
+  }
+
+  _weightedSum.resize(width, height, true, image::RGBfColor(0.f, 0.f, 0.f));
+  _weightSum.resize(width, height, true, image::RGBfColor(0.f, 0.f, 0.f));
+}
+
+bool hdrMerge::accumulate(const image::Image<image::RGBfColor> &image, std::size_t index, double time)
+{
+  assert(index < _nbImages);
+
+  if(image.Width() != _weightedSum.Width() || image.Height() != _weightedSum.Height())
+  {
+    ALICEVISION_LOG_ERROR("[hdrMerge] Bracket " << index << " has size " << image.Width() << "x" << image.Height()
+                          << ", expected " << _weightedSum.Width() << "x" << _weightedSum.Height() << ".");
+    return false;
+  }
+
+  ALICEVISION_LOG_TRACE("[hdrMerge] Accumulate bracket " << index << ", time: " << time);
+
+  const float invTime = float(1.0 / time);
+
+  // With a single bracket, it is both the shortest and the longest exposure
+  if(index == 0)
+  {
+    accumulateRows(image, SHORTEST, invTime);
+  }
+  if(index == _nbImages - 1)
+  {
+    accumulateRows(image, LONGEST, invTime);
+  }
+  if(index != 0 && index != _nbImages - 1)
+  {
+    accumulateRows(image, INTERMEDIATE, invTime);
+  }
+
+  return true;
+}
+
+void hdrMerge::accumulateRows(const image::Image<image::RGBfColor> &image, EWeightType weightType, float invTime)
+{
+  const int width = image.Width();
+  const int height = image.Height();
+  const float scale = _lutScale;
+
+  const float* weightLut[3] = {_weightLut[weightType][0].data(), _weightLut[weightType][1].data(), _weightLut[weightType][2].data()};
+  const float* responseLut[3] = {_responseLut[0].data(), _responseLut[1].data(), _responseLut[2].data()};
+
   #pragma omp parallel for
   for(int y = 0; y < height; ++y)
   {
+    // Pixels are stored as contiguous rgb triplets
+    const float* values = image(y, 0).data();
+    float* weightedSum = _weightedSum(y, 0).data();
+    float* weightSum = _weightSum(y, 0).data();
+
     for(int x = 0; x < width; ++x)
     {
-      //for each pixels
-      image::RGBfColor &radianceColor = radiance(y, x);
-
-      for(std::size_t channel = 0; channel < 3; ++channel)
+      for(int channel = 0; channel < 3; ++channel)
       {
-        double wsum = 0.0;
-        double wdiv = 0.0;
-
-        // Merge shortest exposure
-        {
-            int exposureIndex = 0;
+        const int idx = 3 * x + channel;
+        const float value = values[idx];
 
-            // for each image
-            const double value = images[exposureIndex](y, x)(channel);
-            const double time = times[exposureIndex];
-            //
-            // weightShortestExposure:          _______
-            //                          _______/
-            //                                0      1
-            double w = std::max(0.001f, weightShortestExposure(value, channel));
+        const float w = std::max(0.001f, lookupCurve(weightLut[channel], scale, value));
+        const float r = lookupCurve(responseLut[channel], scale, value);
 
-            const double r = response(value, channel);
+        weightedSum[idx] += w * r * invTime;
+        weightSum[idx] += w;
+      }
+    }
+  }
+}
 
-            wsum += w * r / time;
-            wdiv += w;
-        }
-        // Merge intermediate exposures
-        for(std::size_t i = 1; i < images.size() - 1; ++i)
-        {
-          // for each image
-          const double value = images[i](y, x)(channel);
-          const double time = times[i];
-          //
-          // weight:          ____
-          //          _______/    \________
-          //                0      1
-          double w = std::max(0.001f, weight(value, channel));
-
-          const double r = response(value, channel);
-          wsum += w * r / time;
-          wdiv += w;
-        }
-        // Merge longest exposure
-        {
-            int exposureIndex = images.size() - 1;
+void hdrMerge::finalize(image::Image<image::RGBfColor> &radiance, float targetCameraExposure)
+{
+  const int width = _weightedSum.Width();
+  const int height = _weightedSum.Height();
 
-            // for each image
-            const double value = images[exposureIndex](y, x)(channel);
-            const double time = times[exposureIndex];
-            //
-            // weightLongestExposure:  ____________
-            //                                      \_______
-            //                                0      1
-            double w = std::max(0.001f, weightLongestExposure(value, channel));
+  // Normalize in place to avoid another full size buffer
+  std::swap(radiance, _weightedSum);
 
-            const double r = response(value, channel);
+  #pragma omp parallel for
+  for(int y = 0; y < height; ++y)
+  {
+    float* values = radiance(y, 0).data();
+    const float* weightSum = _weightSum(y, 0).data();
 
-            wsum += w * r / time;
-            wdiv += w;
-        }
-        radianceColor(channel) = wsum / std::max(0.001, wdiv) * targetCameraExposure;
-      }
+    for(int idx = 0; idx < 3 * width; ++idx)
+    {
+      values[idx] = values[idx] / std::max(0.001f, weightSum[idx]) * targetCameraExposure;
     }
   }
+
+  _weightedSum = image::Image<image::RGBfColor>();
+  _weightSum = image::Image<image::RGBfColor>();
 }
 
-void hdrMerge::postProcessHighlight(const std::vector< image::Image<image::RGBfColor> > &images,
-    const std::vector<double> &times,
-    const rgbCurve &weight,
-    const rgbCurve &response,
-    image::Image<image::RGBfColor> &radiance,
-    float targetCameraExposure,
-    float highlightCorrectionFactor,
-    float highlightTargetLux)
+void hdrMerge::process(const std::vector< image::Image<image::RGBfColor> > &images,
+                        const std::vector<double> &times,
+                        const rgbCurve &weight,
+                        const rgbCurve &response,
+                        image::Image<image::RGBfColor> &radiance,
+                        float targetCameraExposure)
 {
-    //checks
-    assert(!response.isEmpty());
-    assert(!images.empty());
-    assert(images.size() == times.size());
+  //checks
+  assert(!response.isEmpty());
+  assert(!images.empty());
+  assert(images.size() == times.size());
 
-    if (highlightCorrectionFactor == 0.0f)
-        return;
+  init(images.front().Width(), images.front().Height(), images.size(), weight, response);
 
-    const image::Image<image::RGBfColor>& inputImage = images.front();
-    // Target Camera Exposure = 1 for EV-0 (iso=100, shutter=1, fnumber=1) => 2.5 lux
-    float highlightTarget = highlightTargetLux * targetCameraExposure * 2.5;
+  for(std::size_t i = 0; i < images.size(); ++i)
+  {
+    accumulate(images[i], i, times[i]);
+  }
 
+  finalize(radiance, targetCameraExposure);
+}
+
+void hdrMerge::computeClampedMask(const image::Image<image::RGBfColor> &shortestExposure,
+                                  image::Image<float> &clampedMask)
+{
     // get images width, height
-    const std::size_t width = inputImage.Width();
-    const std::size_t height = inputImage.Height();
+    const std::size_t width = shortestExposure.Width();
+    const std::size_t height = shortestExposure.Height();
 
     image::Image<float> isPixelClamped(width, height);
 
@@ -175,15 +235,12 @@ void hdrMerge::postProcessHighlight(const std::vector< image::Image<image::RGBfC
     {
         for (int x = 0; x < width; ++x)
         {
-            //for each pixels
-            image::RGBfColor &radianceColor = radiance(y, x);
-
             float& isClamped = isPixelClamped(y, x);
             isClamped = 0.0f;
 
             for (std::size_t channel = 0; channel < 3; ++channel)
             {
-                const float value = inputImage(y, x)(channel);
+                const float value = shortestExposure(y, x)(channel);
 
                 // https://www.desmos.com/calculator/vpvzmidy1a
                 //                       ____
@@ -196,8 +253,25 @@ void hdrMerge::postProcessHighlight(const std::vector< image::Image<image::RGBfC
         }
     }
 
-    image::Image<float> isPixelClamped_g(width, height);
-    image::ImageGaussianFilter(isPixelClamped, 1.0f, isPixelClamped_g, 3, 3);
+    clampedMask.resize(width, height);
+    image::ImageGaussianFilter(isPixelClamped, 1.0f, clampedMask, 3, 3);
+}
+
+void hdrMerge::postProcessHighlight(const image::Image<float> &clampedMask,
+    image::Image<image::RGBfColor> &radiance,
+    float targetCameraExposure,
+    float highlightCorrectionFactor,
+    float highlightTargetLux)
+{
+    if (highlightCorrectionFactor == 0.0f)
+        return;
+
+    // Target Camera Exposure = 1 for EV-0 (iso=100, shutter=1, fnumber=1) => 2.5 lux
+    float highlightTarget = highlightTargetLux * targetCameraExposure * 2.5;
+
+    const std::size_t width = radiance.Width();
+    const std::size_t height = radiance.Height();
+    assert(clampedMask.Width() == width && clampedMask.Height() == height);
 
 #pragma omp parallel for
     for (int y = 0; y < height; ++y)
@@ -206,7 +280,7 @@ void hdrMerge::postProcessHighlight(const std::vector< image::Image<image::RGBfC
         {
             image::RGBfColor& radianceColor = radiance(y, x);
 
-            double clampingCompensation = highlightCorrectionFactor * isPixelClamped_g(y, x);
+            double clampingCompensation = highlightCorrectionFactor * clampedMask(y, x);
             double clampingCompensationInv = (1.0 - clampingCompensation);
             assert(clampingCompensation <= 1.0);
 
@@ -221,5 +295,27 @@ void hdrMerge::postProcessHighlight(const std::vector< image::Image<image::RGBfC
     }
 }
 
+void hdrMerge::postProcessHighlight(const std::vector< image::Image<image::RGBfColor> > &images,
+    const std::vector<double> &times,
+    const rgbCurve &weight,
+    const rgbCurve &response,
+    image::Image<image::RGBfColor> &radiance,
+    float targetCameraExposure,
+    float highlightCorrectionFactor,
+    float highlightTargetLux)
+{
+    //checks
+    assert(!response.isEmpty());
+    assert(!images.empty());
+    assert(images.size() == times.size());
+
+    if (highlightCorrectionFactor == 0.0f)
+        return;
+
+    image::Image<float> clampedMask;
+    computeClampedMask(images.front(), clampedMask);
+    postProcessHighlight(clampedMask, radiance, targetCameraExposure, highlightCorrectionFactor, highlightTargetLux);
+}
+
 } // namespace hdr
 } // namespace aliceVision
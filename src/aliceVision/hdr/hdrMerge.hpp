@@ -7,22 +7,61 @@
 #pragma once
 #include "rgbCurve.hpp"
 #include <aliceVision/image/all.hpp>
+#include <array>
 #include <cmath>
+#include <vector>
 
 
 namespace aliceVision {
 namespace hdr {
- 
+
+/**
+ * @brief Merge LDR brackets into a radiance image.
+ *
+ * The merge can be streamed: after init(), brackets are added one at a time with accumulate()
+ * and only the weighted sums are kept in memory, so a group never needs all its brackets loaded at once.
+ * finalize() then normalizes the sums into the radiance image.
+ */
 class hdrMerge {
 public:
 
   /**
-   * @brief
-   * @param images
-   * @param radiance
-   * @param times
+   * @brief Prepare a streaming merge.
+   *        Allocate the accumulation buffers and sample the weight and response curves into lookup tables.
+   * @param[in] width of the brackets
+   * @param[in] height of the brackets
+   * @param[in] nbImages number of brackets in the group (sorted from shortest to longest exposure)
+   * @param[in] weight fusion weight curve
+   * @param[in] response camera response curve
+   */
+  void init(std::size_t width, std::size_t height, std::size_t nbImages,
+            const rgbCurve &weight,
+            const rgbCurve &response);
+
+  /**
+   * @brief Add the contribution of one bracket to the merge.
+   * @param[in] image bracket
+   * @param[in] index of the bracket in the group, used to select the weight curve
+   * @param[in] time exposure of the bracket
+   * @return false if the bracket does not match the initialized size
+   */
+  bool accumulate(const image::Image<image::RGBfColor> &image, std::size_t index, double time);
+
+  /**
+   * @brief Normalize the accumulated contributions and release the accumulation buffers.
+   * @param[out] radiance
+   * @param[in] targetCameraExposure
+   */
+  void finalize(image::Image<image::RGBfColor> &radiance, float targetCameraExposure);
+
+  /**
+   * @brief Merge a group of brackets held in memory.
+   * @param images brackets sorted from shortest to longest exposure
+   * @param times exposure of each bracket
+   * @param weight fusion weight curve
+   * @param response camera response curve
+   * @param radiance output merged image
    * @param targetCameraExposure
-   * @param response
    */
   void process(const std::vector< image::Image<image::RGBfColor> > &images,
                 const std::vector<double> &times,
@@ -31,15 +70,56 @@ public:
                 image::Image<image::RGBfColor> &radiance,
                 float targetCameraExposure);
 
+  /**
+   * @brief Estimate how much each pixel of the shortest exposure is clamped, smoothed over its neighborhood.
+   * @param[in] shortestExposure first bracket of the group
+   * @param[out] clampedMask values between 0 (not clamped) and 1 (clamped)
+   */
+  static void computeClampedMask(const image::Image<image::RGBfColor> &shortestExposure,
+                                 image::Image<float> &clampedMask);
+
+  /**
+   * @brief Push clamped highlights toward a target luminance.
+   * @param[in] clampedMask computed with computeClampedMask on the shortest exposure
+   * @param[in,out] radiance merged image
+   * @param[in] targetCameraExposure
+   * @param[in] highlightCorrectionFactor between 0 (no correction) and 1
+   * @param[in] highlightTargetLux
+   */
+  static void postProcessHighlight(const image::Image<float> &clampedMask,
+      image::Image<image::RGBfColor> &radiance,
+      float targetCameraExposure,
+      float highlightCorrectionFactor,
+      float highlightTargetLux);
+
   void postProcessHighlight(const std::vector< image::Image<image::RGBfColor> > &images,
       const std::vector<double> &times,
       const rgbCurve &weight,
       const rgbCurve &response,
       image::Image<image::RGBfColor> &radiance,
-      float clampedValueCorrection,
       float targetCameraExposure,
-      float highlightMaxLumimance);
+      float highlightCorrectionFactor,
+      float highlightTargetLux);
+
+private:
+  enum EWeightType
+  {
+    SHORTEST = 0,
+    INTERMEDIATE = 1,
+    LONGEST = 2
+  };
+
+  void accumulateRows(const image::Image<image::RGBfColor> &image, EWeightType weightType, float invTime);
+
+  std::size_t _nbImages = 0;
+  float _lutScale = 0.0f;
+
+  /// Curves padded with their last value, so that the interpolation needs no bound check
+  std::array<std::array<std::vector<float>, 3>, 3> _weightLut;
+  std::array<std::vector<float>, 3> _responseLut;
 
+  image::Image<image::RGBfColor> _weightedSum;
+  image::Image<image::RGBfColor> _weightSum;
 };
 
 } // namespace hdr
@@ -0,0 +1,123 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#define BOOST_TEST_MODULE hdr_merge
+
+#include "hdrMerge.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+using namespace aliceVision;
+
+namespace {
+
+/**
+ * @brief Per pixel merge in double precision, as a reference for the streamed merge
+ */
+void referenceMerge(const std::vector<image::Image<image::RGBfColor>>& images,
+                    const std::vector<double>& times,
+                    const hdr::rgbCurve& weight,
+                    const hdr::rgbCurve& response,
+                    image::Image<image::RGBfColor>& radiance,
+                    float targetCameraExposure)
+{
+    hdr::rgbCurve weightShortestExposure = weight;
+    weightShortestExposure.freezeSecondPartValues();
+    hdr::rgbCurve weightLongestExposure = weight;
+    weightLongestExposure.freezeFirstPartValues();
+
+    radiance.resize(images.front().Width(), images.front().Height());
+
+    for(int y = 0; y < radiance.Height(); ++y)
+    {
+        for(int x = 0; x < radiance.Width(); ++x)
+        {
+            for(std::size_t channel = 0; channel < 3; ++channel)
+            {
+                double wsum = 0.0;
+                double wdiv = 0.0;
+                for(std::size_t i = 0; i < images.size(); ++i)
+                {
+                    const hdr::rgbCurve& w = (i == 0) ? weightShortestExposure : (i == images.size() - 1) ? weightLongestExposure : weight;
+                    const double value = images[i](y, x)(channel);
+                    const double wi = std::max(0.001f, w(value, channel));
+                    wsum += wi * response(value, channel) / times[i];
+                    wdiv += wi;
+                }
+                radiance(y, x)(channel) = wsum / std::max(0.001, wdiv) * targetCameraExposure;
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(hdr_merge_streamed)
+{
+    const std::size_t quantization = 1024;
+    const int width = 67;
+    const int height = 31;
+    const std::vector<double> times = {0.05, 0.2, 0.8, 3.2};
+
+    hdr::rgbCurve weight(quantization);
+    weight.setFunction(hdr::EFunctionType::GAUSSIAN);
+
+    hdr::rgbCurve response(quantization);
+    response.setLinear();
+    for(std::size_t channel = 0; channel < 3; ++channel)
+    {
+        for(float& v : response.getCurve(channel))
+        {
+            v = std::pow(v, 2.2f - 0.1f * channel);
+        }
+    }
+
+    // Random scene, including values out of [0, 1] which must be clamped by the lookup
+    std::default_random_engine generator;
+    std::uniform_real_distribution<float> distribution(-0.1f, 1.5f);
+    image::Image<image::RGBfColor> scene(width, height);
+    for(int y = 0; y < height; ++y)
+        for(int x = 0; x < width; ++x)
+            scene(y, x) = image::RGBfColor(distribution(generator), distribution(generator), distribution(generator));
+
+    std::vector<image::Image<image::RGBfColor>> images;
+    for(double time : times)
+    {
+        image::Image<image::RGBfColor> bracket(width, height);
+        for(int y = 0; y < height; ++y)
+            for(int x = 0; x < width; ++x)
+                for(int channel = 0; channel < 3; ++channel)
+                    bracket(y, x)(channel) = std::min(1.5f, float(scene(y, x)(channel) * time * 2.0));
+        images.push_back(bracket);
+    }
+
+    image::Image<image::RGBfColor> expected;
+    referenceMerge(images, times, weight, response, expected, 1.0f);
+
+    // Stream the brackets in reverse order, the result must not depend on it
+    hdr::hdrMerge merge;
+    merge.init(width, height, images.size(), weight, response);
+    for(int i = images.size() - 1; i >= 0; --i)
+    {
+        BOOST_CHECK(merge.accumulate(images[i], i, times[i]));
+    }
+    image::Image<image::RGBfColor> radiance;
+    merge.finalize(radiance, 1.0f);
+
+    BOOST_REQUIRE_EQUAL(radiance.Width(), width);
+    BOOST_REQUIRE_EQUAL(radiance.Height(), height);
+
+    for(int y = 0; y < height; ++y)
+        for(int x = 0; x < width; ++x)
+            for(int channel = 0; channel < 3; ++channel)
+                BOOST_CHECK_CLOSE(radiance(y, x)(channel), expected(y, x)(channel), 1e-3);
+
+    // A bracket with another size is rejected
+    merge.init(width, height, images.size(), weight, response);
+    BOOST_CHECK(!merge.accumulate(image::Image<image::RGBfColor>(width + 1, height), 0, times[0]));
+}
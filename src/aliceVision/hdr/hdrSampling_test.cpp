@@ -0,0 +1,101 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#define BOOST_TEST_MODULE hdr_sampling
+
+#include "sampling.hpp"
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+
+using namespace aliceVision;
+
+namespace {
+
+std::vector<hdr::ImageSample> buildSamples()
+{
+    std::vector<hdr::ImageSample> samples(17);
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        samples[i].x = 3 * i;
+        samples[i].y = 1000 + i;
+        samples[i].descriptions.resize(i % 4);
+        for (std::size_t k = 0; k < samples[i].descriptions.size(); ++k)
+        {
+            hdr::PixelDescription& p = samples[i].descriptions[k];
+            p.srcId = IndexT(10 * i + k);
+            p.exposure = 0.1f * (k + 1);
+            p.mean = image::Rgb<float>(0.1f * k, 0.2f * k, 0.3f * k);
+            p.variance = image::Rgb<float>(0.01f * i, 0.02f * i, 0.03f * i);
+        }
+    }
+    return samples;
+}
+
+void checkSamples(const std::vector<hdr::ImageSample>& expected, const std::vector<hdr::ImageSample>& samples)
+{
+    BOOST_REQUIRE_EQUAL(expected.size(), samples.size());
+    for (std::size_t i = 0; i < samples.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(expected[i].x, samples[i].x);
+        BOOST_CHECK_EQUAL(expected[i].y, samples[i].y);
+        BOOST_REQUIRE_EQUAL(expected[i].descriptions.size(), samples[i].descriptions.size());
+        for (std::size_t k = 0; k < samples[i].descriptions.size(); ++k)
+        {
+            const hdr::PixelDescription& a = expected[i].descriptions[k];
+            const hdr::PixelDescription& b = samples[i].descriptions[k];
+            BOOST_CHECK_EQUAL(a.srcId, b.srcId);
+            BOOST_CHECK_EQUAL(a.exposure, b.exposure);
+            BOOST_CHECK(a.mean == b.mean);
+            BOOST_CHECK(a.variance == b.variance);
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(hdr_sampling_io)
+{
+    const std::vector<hdr::ImageSample> expected = buildSamples();
+    const std::string filepath = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string() + "_samples.dat";
+
+    BOOST_REQUIRE(hdr::writeSamples(filepath, expected));
+
+    std::vector<hdr::ImageSample> samples;
+    BOOST_REQUIRE(hdr::readSamples(filepath, samples));
+    checkSamples(expected, samples);
+
+    // Truncated file
+    boost::filesystem::resize_file(filepath, boost::filesystem::file_size(filepath) - 5);
+    BOOST_CHECK(!hdr::readSamples(filepath, samples));
+
+    boost::filesystem::remove(filepath);
+}
+
+BOOST_AUTO_TEST_CASE(hdr_sampling_io_legacy)
+{
+    const std::vector<hdr::ImageSample> expected = buildSamples();
+    const std::string filepath = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string() + "_samples.dat";
+
+    // Files written without header
+    {
+        std::ofstream file(filepath, std::ios::binary);
+        const std::size_t size = expected.size();
+        file.write((const char*)&size, sizeof(size));
+        for (const hdr::ImageSample& sample : expected)
+        {
+            file << sample;
+        }
+    }
+
+    std::vector<hdr::ImageSample> samples;
+    BOOST_REQUIRE(hdr::readSamples(filepath, samples));
+    checkSamples(expected, samples);
+
+    boost::filesystem::remove(filepath);
+}
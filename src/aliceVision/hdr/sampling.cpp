@@ -10,6 +10,10 @@
 #include <aliceVision/system/Logger.hpp>
 
 #include <OpenImageIO/imagebufalgo.h>
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <random>
 
 
@@ -91,6 +95,168 @@ std::istream & operator>>(std::istream& is, PixelDescription & p)
     return is;
 }
 
+namespace {
+
+// "HDRS", to distinguish from the files without header which start with the samples count
+const std::uint32_t samplesFileMagic = 0x53524448;
+const std::uint32_t samplesFileVersion = 1;
+
+template <class T>
+void appendValue(std::vector<char>& buffer, const T& value)
+{
+    const char* data = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), data, data + sizeof(T));
+}
+
+template <class T>
+bool extractValue(const std::vector<char>& buffer, std::size_t& pos, T& value)
+{
+    if (pos + sizeof(T) > buffer.size())
+    {
+        return false;
+    }
+
+    std::memcpy(&value, buffer.data() + pos, sizeof(T));
+    pos += sizeof(T);
+
+    return true;
+}
+
+} // namespace
+
+bool writeSamples(const std::string& filepath, const std::vector<ImageSample>& samples)
+{
+    // Pack everything in memory to write the file at once
+    std::size_t countDescriptions = 0;
+    for (const ImageSample& sample : samples)
+    {
+        countDescriptions += sample.descriptions.size();
+    }
+
+    const std::size_t descriptionSize = sizeof(IndexT) + 7 * sizeof(float);
+    std::vector<char> buffer;
+    buffer.reserve(2 * sizeof(std::uint32_t) + sizeof(std::uint64_t) + samples.size() * 3 * sizeof(std::uint32_t) + countDescriptions * descriptionSize);
+
+    appendValue(buffer, samplesFileMagic);
+    appendValue(buffer, samplesFileVersion);
+    appendValue(buffer, std::uint64_t(samples.size()));
+
+    for (const ImageSample& sample : samples)
+    {
+        appendValue(buffer, std::uint32_t(sample.x));
+        appendValue(buffer, std::uint32_t(sample.y));
+        appendValue(buffer, std::uint32_t(sample.descriptions.size()));
+
+        for (const PixelDescription& p : sample.descriptions)
+        {
+            appendValue(buffer, p.srcId);
+            appendValue(buffer, p.exposure);
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                appendValue(buffer, p.mean(channel));
+            }
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                appendValue(buffer, p.variance(channel));
+            }
+        }
+    }
+
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Impossible to write samples to file " << filepath);
+        return false;
+    }
+
+    file.write(buffer.data(), buffer.size());
+
+    return bool(file);
+}
+
+bool readSamples(const std::string& filepath, std::vector<ImageSample>& samples)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        ALICEVISION_LOG_ERROR("Impossible to read samples from file " << filepath);
+        return false;
+    }
+
+    const std::streamsize fileSize = file.tellg();
+    file.seekg(0, std::ios::beg);
+
+    std::uint32_t magic = 0;
+    if (fileSize < std::streamsize(sizeof(magic)) || !file.read((char*)&magic, sizeof(magic)) || magic != samplesFileMagic)
+    {
+        // Files without header: the samples count followed by the streamed samples
+        file.clear();
+        file.seekg(0, std::ios::beg);
+
+        std::size_t size = 0;
+        file.read((char*)&size, sizeof(size));
+
+        samples.resize(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            file >> samples[i];
+        }
+
+        if (!file)
+        {
+            ALICEVISION_LOG_ERROR("Samples file " << filepath << " is truncated.");
+            return false;
+        }
+
+        return true;
+    }
+
+    file.seekg(0, std::ios::beg);
+    std::vector<char> buffer(fileSize);
+    file.read(buffer.data(), fileSize);
+
+    std::size_t pos = sizeof(magic);
+    std::uint32_t version = 0;
+    std::uint64_t size = 0;
+    if (!extractValue(buffer, pos, version) || version != samplesFileVersion || !extractValue(buffer, pos, size))
+    {
+        ALICEVISION_LOG_ERROR("Samples file " << filepath << " has an unsupported version.");
+        return false;
+    }
+
+    samples.resize(size);
+    for (ImageSample& sample : samples)
+    {
+        std::uint32_t x = 0, y = 0, countDescriptions = 0;
+        bool valid = extractValue(buffer, pos, x) && extractValue(buffer, pos, y) && extractValue(buffer, pos, countDescriptions);
+
+        sample.x = x;
+        sample.y = y;
+        sample.descriptions.resize(valid ? countDescriptions : 0);
+
+        for (PixelDescription& p : sample.descriptions)
+        {
+            valid = valid && extractValue(buffer, pos, p.srcId) && extractValue(buffer, pos, p.exposure);
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                valid = valid && extractValue(buffer, pos, p.mean(channel));
+            }
+            for (int channel = 0; channel < 3; ++channel)
+            {
+                valid = valid && extractValue(buffer, pos, p.variance(channel));
+            }
+        }
+
+        if (!valid)
+        {
+            ALICEVISION_LOG_ERROR("Samples file " << filepath << " is truncated.");
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void integral(image::Image<image::Rgb<double>> & dest, const Eigen::Matrix<image::RGBfColor, Eigen::Dynamic, Eigen::Dynamic> & source)
 {
     /*
@@ -154,6 +320,16 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples, c
     const int diameter = (params.radius * 2) + 1;
     const double area = double(diameter * diameter);
 
+    // The simplified sampling already uses its own sparse pattern
+    const int subsampling = simplified ? 1 : std::max(1, params.subsampling);
+    const int samplesWidth = (int(imageWidth) + subsampling - 1) / subsampling;
+    const int samplesHeight = (int(imageHeight) + subsampling - 1) / subsampling;
+
+    // Range of samples whose full resolution coordinates are out of the border of size radius
+    const int samplesBegin = (params.radius + subsampling - 1) / subsampling;
+    const int samplesEndX = (int(imageWidth) - params.radius + subsampling - 1) / subsampling;
+    const int samplesEndY = (int(imageHeight) - params.radius + subsampling - 1) / subsampling;
+
     std::vector<std::pair<int, int>> vec_blocks;
     const auto step = params.blockSize - diameter;
     vec_blocks.reserve(int(imageHeight / step) * int(imageWidth / step));
@@ -168,7 +344,7 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples, c
     Image<RGBfColor> img;
 
     // For all brackets, For each pixel, compute image sample
-    image::Image<ImageSample> samples(imageWidth, imageHeight, true);
+    image::Image<ImageSample> samples(samplesWidth, samplesHeight, true);
     for (unsigned int idBracket = 0; idBracket < imagePaths.size(); ++idBracket)
     {
         const double exposure = times[idBracket];
@@ -246,7 +422,6 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples, c
                 int blockHeight = ((img.Height() - cy) > params.blockSize) ? params.blockSize : img.Height() - cy;
 
                 auto blockInput = img.block(cy, cx, blockHeight, blockWidth);
-                auto blockOutput = samples.block(cy, cx, blockHeight, blockWidth);
 
                 // Stats for deviation
                 Image<Rgb<double>> imgIntegral, imgIntegralSquare;
@@ -258,8 +433,18 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples, c
 
                 for (int y = radiusp1; y < imgIntegral.Height() - params.radius; ++y)
                 {
+                    if ((cy + y) % subsampling != 0)
+                    {
+                        continue;
+                    }
+
                     for (int x = radiusp1; x < imgIntegral.Width() - params.radius; ++x)
                     {
+                        if ((cx + x) % subsampling != 0)
+                        {
+                            continue;
+                        }
+
                         image::Rgb<double> S1 = imgIntegral(y + params.radius, x + params.radius) + imgIntegral(y - radiusp1, x - radiusp1) - imgIntegral(y + params.radius, x - radiusp1) - imgIntegral(y - radiusp1, x + params.radius);
                         image::Rgb<double> S2 = imgIntegralSquare(y + params.radius, x + params.radius) + imgIntegralSquare(y - radiusp1, x - radiusp1) - imgIntegralSquare(y + params.radius, x - radiusp1) - imgIntegralSquare(y - radiusp1, x + params.radius);
 
@@ -274,9 +459,10 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples, c
                         pd.variance.g() = (S2.g() - (S1.g() * S1.g()) / area) / area;
                         pd.variance.b() = (S2.b() - (S1.b() * S1.b()) / area) / area;
 
-                        blockOutput(y, x).x = cx + x;
-                        blockOutput(y, x).y = cy + y;
-                        blockOutput(y, x).descriptions.push_back(pd);
+                        ImageSample& sample = samples((cy + y) / subsampling, (cx + x) / subsampling);
+                        sample.x = cx + x;
+                        sample.y = cy + y;
+                        sample.descriptions.push_back(pd);
                     }
                 }
             }
@@ -293,9 +479,9 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples, c
     {
         // Create samples image
         #pragma omp parallel for
-        for (int y = params.radius; y < samples.Height() - params.radius; ++y)
+        for (int y = samplesBegin; y < samplesEndY; ++y)
         {
-            for (int x = params.radius; x < samples.Width() - params.radius; ++x)
+            for (int x = samplesBegin; x < samplesEndX; ++x)
             {
                 ImageSample& sample = samples(y, x);
                 if (sample.descriptions.size() < 2)
@@ -424,11 +610,11 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples, c
         std::vector<Counters> counters_vec(omp_get_max_threads());
 
         #pragma omp parallel for
-        for (int y = params.radius; y < samples.Height() - params.radius; ++y)
+        for (int y = samplesBegin; y < samplesEndY; ++y)
         {
             Counters & counters_thread = counters_vec[omp_get_thread_num()];
 
-            for (int x = params.radius; x < samples.Width() - params.radius; ++x)
+            for (int x = samplesBegin; x < samplesEndX; ++x)
             {
                 const ImageSample & sample = samples(y, x);
                 UniqueDescriptor desc;
@@ -446,7 +632,7 @@ bool Sampling::extractSamplesFromImages(std::vector<ImageSample>& out_samples, c
                         {
                             continue;
                         }                        
-                        Coordinates coordinates = std::make_pair(sample.x, sample.y);
+                        Coordinates coordinates = std::make_pair(x, y);
                         counters_thread[desc].push_back(coordinates);
                     }
                 }
@@ -44,6 +44,22 @@ std::ostream & operator<<(std::ostream& os, const PixelDescription & p);
 std::istream & operator>>(std::istream& os, ImageSample & s);
 std::istream & operator>>(std::istream& os, PixelDescription & p);
 
+/**
+ * @brief Write samples to a binary file, as a versioned header followed by the packed samples.
+ * @param[in] filepath
+ * @param[in] samples
+ * @return false if the file cannot be written
+ */
+bool writeSamples(const std::string& filepath, const std::vector<ImageSample>& samples);
+
+/**
+ * @brief Read samples written by writeSamples. Files from older versions, without header, are also supported.
+ * @param[in] filepath
+ * @param[out] samples
+ * @return false if the file cannot be read or is truncated
+ */
+bool readSamples(const std::string& filepath, std::vector<ImageSample>& samples);
+
 
 class Sampling
 {
@@ -58,6 +74,8 @@ public:
         int blockSize = 256;
         int radius = 5;
         size_t maxCountSample = 200;
+        /// Only pixels on a grid of this step are candidate samples, to bound memory and time on large images
+        int subsampling = 1;
     };
 
     using MapSampleRefList = std::map<UniqueDescriptor, std::vector<Coordinates>>;
@@ -1,39 +1,201 @@
 #include "cache.hpp"
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include <boost/filesystem.hpp>
 
+#include <algorithm>
+
 
 namespace aliceVision
 {
 namespace image
 {
 
-CacheManager::CacheManager(const std::string & pathStorage, size_t blockSize, size_t maxBlocksPerIndex) :
+CacheManager::CacheManager(const std::string & pathStorage, size_t blockSize, size_t maxBlocksPerIndex, size_t shardCount) :
 _blockSize(blockSize),
-_incoreBlockUsageCount(0),
 _incoreBlockUsageMax(10),
 _blockCountPerIndex(maxBlocksPerIndex),
 _basePathStorage(pathStorage)
 {
+  /*By default, as many shards as threads which may acquire objects concurrently*/
+  if (shardCount == 0) {
+    shardCount = static_cast<size_t>(std::max(omp_get_max_threads(), 1));
+  }
+
+  for (size_t idShard = 0; idShard < shardCount; idShard++) {
+    _shards.emplace_back(new Shard);
+  }
+  _maxPrefetchedObjects = 4 * _shards.size();
+
   wipe();
+  startWorker();
 }
 
 CacheManager::~CacheManager() {
+  stopWorker();
+  logStatistics();
   wipe();
 }
 
 void CacheManager::wipe() {
   deleteIndexFiles();
 
-  _mru.clear();
+  for (std::unique_ptr<Shard> & shard : _shards) {
+    shard->mru.clear();
+    shard->incoreBlockUsageCount = 0;
+  }
+
+  _prefetched.clear();
+  _prefetchedOrder.clear();
   
-  _incoreBlockUsageCount = 0;
   _nextStartBlockId = 0;
   _nextObjectId = 0;
 }
 
+void CacheManager::startWorker() {
+  _stopWorker = false;
+  _worker = std::thread(&CacheManager::workerLoop, this);
+}
+
+void CacheManager::stopWorker() {
+  {
+    std::lock_guard<std::mutex> lock(_workerMutex);
+    _stopWorker = true;
+  }
+  _workerCondition.notify_all();
+
+  if (_worker.joinable()) {
+    _worker.join();
+  }
+
+  _pendingWrites.clear();
+  _writeQueue.clear();
+  _prefetchQueue.clear();
+}
+
+void CacheManager::workerLoop() {
+
+  std::unique_lock<std::mutex> lock(_workerMutex);
+
+  while (true) {
+
+    _workerCondition.wait(lock, [this] { 
+      return _stopWorker || !_writeQueue.empty() || !_prefetchQueue.empty(); 
+    });
+
+    if (_stopWorker) {
+      break;
+    }
+
+    /*Writes have priority as they give memory back*/
+    if (!_writeQueue.empty()) {
+
+      const size_t objectId = _writeQueue.front();
+      _writeQueue.pop_front();
+
+      /*The object may have been acquired again or destroyed since it was queued*/
+      auto itfind = _pendingWrites.find(objectId);
+      if (itfind == _pendingWrites.end()) {
+        continue;
+      }
+
+      std::unique_ptr<unsigned char> data = std::move(itfind->second);
+      _pendingWrites.erase(itfind);
+      _inflightWrite = objectId;
+
+      lock.unlock();
+      if (!saveObject(std::move(data), objectId)) {
+        ALICEVISION_LOG_ERROR("CacheManager: failed to write back object " << objectId << ".");
+      }
+      lock.lock();
+
+      _inflightWrite = ~size_t(0);
+      _writeDoneCondition.notify_all();
+      continue;
+    }
+
+    const size_t objectId = _prefetchQueue.front();
+    _prefetchQueue.pop_front();
+    _inflightPrefetch = true;
+
+    lock.unlock();
+    processPrefetch(objectId);
+    lock.lock();
+
+    _inflightPrefetch = false;
+    _writeDoneCondition.notify_all();
+  }
+}
+
+void CacheManager::processPrefetch(size_t objectId) {
+
+  Shard & shard = getShard(objectId);
+
+  /*Nothing to read if the object is in memory (in core, waiting to be written or already read ahead)*/
+  const auto isInMemory = [&]() {
+    const auto & mruIndex = shard.mru.get<1>();
+    return mruIndex.find(objectId) != mruIndex.end() ||
+           _pendingWrites.find(objectId) != _pendingWrites.end() ||
+           _prefetched.find(objectId) != _prefetched.end();
+  };
+
+  MemoryItem memitem;
+  {
+    std::lock_guard<std::mutex> lockShard(shard.mutex);
+    std::lock_guard<std::mutex> lockWorker(_workerMutex);
+    if (isInMemory()) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lockMemory(_mutex);
+    MemoryMap::iterator itfind = _memoryMap.find(objectId);
+    if (itfind == _memoryMap.end()) {
+      return;
+    }
+
+    memitem = itfind->second;
+  }
+
+  if (memitem.startBlockId == ~0) {
+    return;
+  }
+
+  /*
+  Read without the shard lock, so that the acquisitions of the shard are not blocked by the disk.
+  Only this worker writes objects back, so the stored data can not change meanwhile.
+  */
+  std::unique_ptr<unsigned char> data = load(memitem.startBlockId, memitem.countBlock);
+  if (!data) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lockShard(shard.mutex);
+  std::lock_guard<std::mutex> lockWorker(_workerMutex);
+
+  /*The object may have been acquired (and modified) while it was read*/
+  if (isInMemory()) {
+    return;
+  }
+
+  {
+    /*The object may have been destroyed while it was read*/
+    std::lock_guard<std::mutex> lockMemory(_mutex);
+    if (_memoryMap.find(objectId) == _memoryMap.end()) {
+      return;
+    }
+  }
+
+  /*Bound the memory used by objects read ahead and never acquired, the oldest ones are dropped*/
+  while (_prefetched.size() >= _maxPrefetchedObjects && !_prefetchedOrder.empty()) {
+    _prefetched.erase(_prefetchedOrder.front());
+    _prefetchedOrder.pop_front();
+  }
+
+  _prefetched[objectId] = std::move(data);
+  _prefetchedOrder.push_back(objectId);
+}
 
 void CacheManager::setMaxMemory(size_t maxMemorySize) {
   _incoreBlockUsageMax = maxMemorySize / _blockSize;
@@ -43,8 +205,46 @@ void CacheManager::setInCoreMaxObjectCount(size_t max) {
   _incoreBlockUsageMax = max;
 }
 
+void CacheManager::flush() {
+  std::unique_lock<std::mutex> lock(_workerMutex);
+  _writeDoneCondition.wait(lock, [this] { 
+    return _stopWorker || (_pendingWrites.empty() && _inflightWrite == ~size_t(0) && _prefetchQueue.empty() && !_inflightPrefetch); 
+  });
+}
+
+CacheStatistics CacheManager::getStatistics() const {
+  
+  CacheStatistics stats;
+  stats.hits = _hits;
+  stats.misses = _misses;
+  stats.creations = _creations;
+  stats.writeBackHits = _writeBackHits;
+  stats.prefetchHits = _prefetchHits;
+  stats.evictions = _evictions;
+  stats.bytesRead = _bytesRead;
+  stats.bytesWritten = _bytesWritten;
+
+  return stats;
+}
+
+void CacheManager::logStatistics() const {
+
+  const CacheStatistics stats = getStatistics();
+  const size_t acquisitions = stats.hits + stats.misses + stats.creations + stats.writeBackHits + stats.prefetchHits;
+  const double hitRate = (acquisitions > 0) ? double(acquisitions - stats.misses) / double(acquisitions) : 0.0;
+
+  ALICEVISION_LOG_DEBUG("CacheManager statistics:" << std::endl
+                        << "\t- acquisitions: " << acquisitions << " (hit rate: " << hitRate * 100.0 << "%)" << std::endl
+                        << "\t- hits: " << stats.hits << ", misses: " << stats.misses << ", creations: " << stats.creations << std::endl
+                        << "\t- write-back hits: " << stats.writeBackHits << ", prefetch hits: " << stats.prefetchHits << std::endl
+                        << "\t- evictions: " << stats.evictions << std::endl
+                        << "\t- read: " << stats.bytesRead / (1024*1024) << "MB, written: " << stats.bytesWritten / (1024*1024) << "MB.");
+}
+
 std::string CacheManager::getPathForIndex(size_t indexId) {
 
+  std::lock_guard<std::mutex> lock(_mutex);
+
   if (_indexPaths.find(indexId) == _indexPaths.end()) {
 
     boost::filesystem::path path(_basePathStorage);
@@ -143,6 +343,8 @@ std::unique_ptr<unsigned char> CacheManager::load(size_t startBlockId, size_t bl
     return std::unique_ptr<unsigned char>();
   }
 
+  _bytesRead += groupLength;
+
   return data;
 }
 
@@ -181,6 +383,8 @@ bool CacheManager::save(std::unique_ptr<unsigned char> && data, size_t startBloc
 
   file_index.close();
 
+  _bytesWritten += groupLength;
+
   return true;
 }
 
@@ -202,7 +406,9 @@ size_t CacheManager::getFreeBlockId(size_t blockCount) {
 }
 
 bool CacheManager::createObject(size_t & objectId, size_t blockCount) {
-    
+
+  std::lock_guard<std::mutex> lock(_mutex);
+
   objectId = _nextObjectId;
   _nextObjectId++;
 
@@ -214,54 +420,120 @@ bool CacheManager::createObject(size_t & objectId, size_t blockCount) {
   return true;
 }
 
-bool CacheManager::acquireObject(std::unique_ptr<unsigned char> & data, size_t objectId) {
+bool CacheManager::acquireObject(std::unique_ptr<unsigned char> & data, size_t objectId, bool pin) {
 
-  MemoryMap::iterator itfind = _memoryMap.find(objectId);
-  if (itfind == _memoryMap.end()) {
-    return false;
+  Shard & shard = getShard(objectId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  return acquireObjectLocked(shard, data, objectId, pin);
+}
+
+bool CacheManager::acquireObjectLocked(Shard & shard, std::unique_ptr<unsigned char> & data, size_t objectId, bool pin) {
+
+  MemoryItem memitem;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    MemoryMap::iterator itfind = _memoryMap.find(objectId);
+    if (itfind == _memoryMap.end()) {
+      return false;
+    }
+
+    memitem = itfind->second;
   }
 
-  MemoryItem memitem = itfind->second;  
   MRUItem item;
   item.objectId = objectId;
   item.objectSize = memitem.countBlock;
+  item.pinCount = 0;
 
   /* Check mru */
-  std::pair<MRUType::iterator, bool> p = _mru.push_front(item);
+  std::pair<MRUType::iterator, bool> p = shard.mru.push_front(item);
   if (p.second) {
     
     /*
     Effectively added to the mru.
     This means that we have to find this in the storage
     */
-    if (memitem.startBlockId == ~0) {
-      std::unique_ptr<unsigned char> buffer(new unsigned char[_blockSize * memitem.countBlock]);
-      data = std::move(buffer);
+    std::unique_ptr<unsigned char> pending = cancelWriteBack(objectId);
+    std::unique_ptr<unsigned char> prefetched = takePrefetched(objectId);
+
+    if (pending) {
+      /*Evicted but not yet written, no need to go through the disk*/
+      data = std::move(pending);
+      _writeBackHits++;
+    }
+    else if (prefetched) {
+      data = std::move(prefetched);
+      _prefetchHits++;
     }
     else {
-      data = std::move(load(memitem.startBlockId, memitem.countBlock));
+      
+      /*The write-back may have just allocated the storage*/
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        memitem = _memoryMap[objectId];
+      }
+
+      if (memitem.startBlockId == ~0) {
+        std::unique_ptr<unsigned char> buffer(new unsigned char[_blockSize * memitem.countBlock]);
+        data = std::move(buffer);
+        _creations++;
+      }
+      else {
+        data = std::move(load(memitem.startBlockId, memitem.countBlock));
+        _misses++;
+      }
+    }
+
+    if (!data) {
+      shard.mru.erase(p.first);
+      return false;
     }
 
     /*Update memory usage*/
-    _incoreBlockUsageCount += memitem.countBlock;
+    shard.incoreBlockUsageCount += memitem.countBlock;
   }
   else {
     /*
     The uid is present in the mru, put it in first position.
     Note that the item may contain a previously deleted info
     */
-    _mru.relocate(_mru.begin(), p.first);
+    shard.mru.relocate(shard.mru.begin(), p.first);
+    _hits++;
   }
 
-  while (_incoreBlockUsageCount > _incoreBlockUsageMax && _mru.size() > 1) {
-    
-    MRUItem item = _mru.back();
+  if (pin) {
+    shard.mru.front().pinCount++;
+  }
+
+  /*Each shard gets an equal part of the memory budget*/
+  const size_t shardUsageMax = std::max(size_t(1), _incoreBlockUsageMax / _shards.size());
+
+  /*Evict the least recently used objects which are not pinned, never the one just acquired*/
+  MRUType::iterator it = shard.mru.end();
+  while (shard.incoreBlockUsageCount > shardUsageMax) {
+
+    if (it == shard.mru.begin()) {
+      break;
+    }
+
+    --it;
+    if (it == shard.mru.begin()) {
+      break;
+    }
+
+    if (it->pinCount > 0) {
+      continue;
+    }
+
+    MRUItem item = *it;
 
     /*Remove item from mru*/
-    _mru.pop_back();
+    it = shard.mru.erase(it);
 
     /*Update memory usage*/
-    _incoreBlockUsageCount -= item.objectSize;
+    shard.incoreBlockUsageCount -= item.objectSize;
+    _evictions++;
 
     onRemovedFromMRU(item.objectId);
   }
@@ -269,20 +541,136 @@ bool CacheManager::acquireObject(std::unique_ptr<unsigned char> & data, size_t o
   return true;
 }
 
+void CacheManager::releaseObject(size_t objectId) {
+
+  Shard & shard = getShard(objectId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto & mruIndex = shard.mru.get<1>();
+  auto itfind = mruIndex.find(objectId);
+  if (itfind == mruIndex.end()) {
+    return;
+  }
+
+  if (itfind->pinCount > 0) {
+    itfind->pinCount--;
+  }
+}
+
+void CacheManager::prefetchObject(size_t objectId) {
+
+  {
+    std::lock_guard<std::mutex> lock(_workerMutex);
+    _prefetchQueue.push_back(objectId);
+  }
+
+  _workerCondition.notify_one();
+}
+
+void CacheManager::queueWriteBack(std::unique_ptr<unsigned char> && data, size_t objectId) {
+
+  if (!data) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(_workerMutex);
+    _pendingWrites[objectId] = std::move(data);
+    _writeQueue.push_back(objectId);
+  }
+
+  _workerCondition.notify_one();
+}
+
+std::unique_ptr<unsigned char> CacheManager::cancelWriteBack(size_t objectId) {
+
+  std::unique_lock<std::mutex> lock(_workerMutex);
+
+  /*If the object is being written, the disk content will be valid once done*/
+  _writeDoneCondition.wait(lock, [this, objectId] { 
+    return _stopWorker || _inflightWrite != objectId; 
+  });
+
+  std::unique_ptr<unsigned char> ret;
+  auto itfind = _pendingWrites.find(objectId);
+  if (itfind != _pendingWrites.end()) {
+    ret = std::move(itfind->second);
+    _pendingWrites.erase(itfind);
+  }
+
+  return ret;
+}
+
+std::unique_ptr<unsigned char> CacheManager::takePrefetched(size_t objectId) {
+
+  std::lock_guard<std::mutex> lock(_workerMutex);
+
+  std::unique_ptr<unsigned char> ret;
+  auto itfind = _prefetched.find(objectId);
+  if (itfind != _prefetched.end()) {
+    ret = std::move(itfind->second);
+    _prefetched.erase(itfind);
+    _prefetchedOrder.erase(std::find(_prefetchedOrder.begin(), _prefetchedOrder.end(), objectId));
+  }
+
+  return ret;
+}
+
+size_t CacheManager::getPrefetchedObjectCount() const {
+  std::lock_guard<std::mutex> lock(_workerMutex);
+  return _prefetched.size();
+}
+
+void CacheManager::destroyObject(size_t objectId) {
+
+  /*Make sure no write for this object is pending, as its blocks may be reused*/
+  cancelWriteBack(objectId);
+
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    /* Remove map from object to block id*/
+    MemoryMap::iterator it = _memoryMap.find(objectId);
+    if (it == _memoryMap.end()) {
+      return;
+    }
+    size_t blockId = it->second.startBlockId;
+    size_t blockCount = it->second.countBlock;
+    _memoryMap.erase(it);
+
+    /*If memory block is valid*/
+    if (blockId != ~0) {
+
+      /*Add block to list of available*/
+      addFreeBlock(blockId, blockCount);
+    }
+  }
+
+  /*Release the data read ahead for this object, after the memory map so that the worker can not add it back*/
+  takePrefetched(objectId);
+}
+
 bool CacheManager::saveObject(std::unique_ptr<unsigned char> && data, size_t objectId) {
   
-  MemoryMap::iterator itfind = _memoryMap.find(objectId);
-  if (itfind == _memoryMap.end()) {
-    return false;
-  }
+  MemoryItem item;
+  bool needPrepare = false;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
 
-  MemoryItem item = itfind->second;
+    MemoryMap::iterator itfind = _memoryMap.find(objectId);
+    if (itfind == _memoryMap.end()) {
+      return false;
+    }
 
-  if (itfind->second.startBlockId == ~0) {
-    
-    item.startBlockId = getFreeBlockId(item.countBlock);
-    _memoryMap[objectId] = item;
+    item = itfind->second;
+
+    if (item.startBlockId == ~0) {
+      item.startBlockId = getFreeBlockId(item.countBlock);
+      needPrepare = true;
+    }
+  }
 
+  if (needPrepare) {
     prepareBlockGroup(item.startBlockId, item.countBlock);
   }
 
@@ -290,6 +678,15 @@ bool CacheManager::saveObject(std::unique_ptr<unsigned char> && data, size_t obj
     return false;
   }
 
+  if (needPrepare) {
+    /*Publish the storage location once the content is valid on disk*/
+    std::lock_guard<std::mutex> lock(_mutex);
+    MemoryMap::iterator itfind = _memoryMap.find(objectId);
+    if (itfind != _memoryMap.end()) {
+      itfind->second.startBlockId = item.startBlockId;
+    }
+  }
+
   return true;
 }
 
@@ -299,6 +696,7 @@ void CacheManager::addFreeBlock(size_t blockId, size_t blockCount) {
 }
 
 size_t CacheManager::getActiveBlocks() const {
+  std::lock_guard<std::mutex> lock(_mutex);
   return _memoryMap.size();
 }
 
@@ -310,21 +708,34 @@ CachedTile::~CachedTile() {
   }
 }
 
-bool CachedTile::acquire() {
+bool CachedTile::acquire(bool pin) {
 
   std::shared_ptr<TileCacheManager> manager = _manager.lock();
   if (!manager) {
     return false;
   }
   
-  
-  return manager->acquire(_uid);
+  return manager->acquire(_uid, pin);
+}
 
-  return true;
+void CachedTile::release() {
+
+  std::shared_ptr<TileCacheManager> manager = _manager.lock();
+  if (manager) {
+    manager->release(_uid);
+  }
 }
 
-TileCacheManager::TileCacheManager(const std::string & pathStorage, size_t tileWidth, size_t tileHeight, size_t maxTilesPerIndex) :
-CacheManager(pathStorage, tileWidth * tileHeight, maxTilesPerIndex),
+void CachedTile::prefetch() {
+
+  std::shared_ptr<TileCacheManager> manager = _manager.lock();
+  if (manager) {
+    manager->prefetch(_uid);
+  }
+}
+
+TileCacheManager::TileCacheManager(const std::string & pathStorage, size_t tileWidth, size_t tileHeight, size_t maxTilesPerIndex, size_t shardCount) :
+CacheManager(pathStorage, tileWidth * tileHeight, maxTilesPerIndex, shardCount),
 _tileWidth(tileWidth), _tileHeight(tileHeight)
 {
 }
@@ -347,7 +758,7 @@ static unsigned int bitCount (unsigned int value)
 }
 
 
-std::shared_ptr<TileCacheManager> TileCacheManager::create(const std::string & path_storage, size_t tileWidth, size_t tileHeight, size_t maxTilesPerIndex) {
+std::shared_ptr<TileCacheManager> TileCacheManager::create(const std::string & path_storage, size_t tileWidth, size_t tileHeight, size_t maxTilesPerIndex, size_t shardCount) {
 
   if (bitCount(tileWidth) != 1) 
   {
@@ -359,7 +770,7 @@ std::shared_ptr<TileCacheManager> TileCacheManager::create(const std::string & p
     return nullptr;
   }
 
-  TileCacheManager * obj = new TileCacheManager(path_storage, tileWidth, tileHeight, maxTilesPerIndex);
+  TileCacheManager * obj = new TileCacheManager(path_storage, tileWidth, tileHeight, maxTilesPerIndex, shardCount);
     
   return std::shared_ptr<TileCacheManager>(obj);
 }
@@ -379,6 +790,7 @@ std::shared_ptr<CachedTile> TileCacheManager::requireNewCachedTile(size_t width,
   ret.reset(new CachedTile(sptr, uid, _tileWidth, _tileHeight, width, height, blockCount));
 
   /*Store weak pointer internally*/
+  std::lock_guard<std::mutex> lock(_objectMapMutex);
   _objectMap[uid] = ret;
 
   return ret;
@@ -387,66 +799,65 @@ std::shared_ptr<CachedTile> TileCacheManager::requireNewCachedTile(size_t width,
 void TileCacheManager::notifyDestroy(size_t tileId) {
   
   /* Remove weak pointer */
-  _objectMap.erase(tileId);
-
-  /* Remove map from object to block id*/
-  MemoryMap::iterator it = _memoryMap.find(tileId);
-  if (it == _memoryMap.end()) {
-    return;
+  {
+    std::lock_guard<std::mutex> lock(_objectMapMutex);
+    _objectMap.erase(tileId);
   }
-  size_t blockId = it->second.startBlockId;
-  size_t blockCount = it->second.countBlock;
-  _memoryMap.erase(it);
 
-  /*If memory block is valid*/
-  if (blockId != ~0) {
-
-    /*Add block to list of available*/
-    addFreeBlock(blockId, blockCount);
-  }
+  destroyObject(tileId);
 }
 
-bool TileCacheManager::acquire(size_t tileId) {
+CachedTile::smart_pointer TileCacheManager::getTile(size_t tileId) {
 
+  std::lock_guard<std::mutex> lock(_objectMapMutex);
 
   MapCachedTile::iterator itfind = _objectMap.find(tileId);
   if (itfind == _objectMap.end()) {
-    return false;
+    return nullptr;
   }
 
-  CachedTile::smart_pointer tile = itfind->second.lock();
+  return itfind->second.lock();
+}
+
+bool TileCacheManager::acquire(size_t tileId, bool pin) {
+
+  CachedTile::smart_pointer tile = getTile(tileId);
   if (!tile) {
     return false;
   }
+
+  /*The tile data is only moved with the shard locked*/
+  Shard & shard = getShard(tileId);
+  std::lock_guard<std::mutex> lock(shard.mutex);
   
   /*Acquire the object*/
   std::unique_ptr<unsigned char> content = tile->getData();
-  if (!CacheManager::acquireObject(content, tileId)) {
-    return false;
-  }
+  const bool acquired = CacheManager::acquireObjectLocked(shard, content, tileId, pin);
 
   /*Update tile data*/
   tile->setData(std::move(content));
 
+  return acquired;
+}
 
-  return true;
+void TileCacheManager::release(size_t tileId) {
+  CacheManager::releaseObject(tileId);
 }
 
-void TileCacheManager::onRemovedFromMRU(size_t objectId) {
+void TileCacheManager::prefetch(size_t tileId) {
+  CacheManager::prefetchObject(tileId);
+}
 
-  MapCachedTile::iterator itfind = _objectMap.find(objectId);
-  if (itfind == _objectMap.end()) {
-    return;
-  }
+void TileCacheManager::onRemovedFromMRU(size_t objectId) {
 
-  CachedTile::smart_pointer tile = itfind->second.lock();
+  CachedTile::smart_pointer tile = getTile(objectId);
   if (!tile) {
     return;
   }  
 
-  /* Save object and set the tile data to nullptr */
+  /* Give the data to the background writer and set the tile data to nullptr */
   std::unique_ptr<unsigned char> content = tile->getData();
-  CacheManager::saveObject(std::move(content), objectId);
+  CacheManager::queueWriteBack(std::move(content), objectId);
 } 
 
 }
@@ -17,9 +17,14 @@
 #include <boost/multi_index/sequenced_index.hpp>
 #include <boost/multi_index/member.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <fstream>
 #include <list>
+#include <mutex>
 #include <sstream>
+#include <thread>
 #include <queue>
 
 namespace aliceVision
@@ -83,9 +88,21 @@ public:
   /*
   Tells the system that we need the data for this tile.
   This means that the data is out of core, we want it back.
+  @param pin if true, the tile can not be evicted until release() is called
   @return false if the process failed to grab data.
   */
-  bool acquire();
+  bool acquire(bool pin = false);
+
+  /*
+  Tells the system that a pinned tile may be evicted again.
+  */
+  void release();
+
+  /*
+  Tells the system that we will need the data for this tile soon.
+  The data is loaded back from disk in the background if it is out of core.
+  */
+  void prefetch();
 
   /**
    * Update data with a new buffer
@@ -129,8 +146,73 @@ private:
   size_t _depth;
 };
 
+/**
+ * Scoped acquisition of a cached tile.
+ * The tile is pinned in core for the lifetime of this object,
+ * so that concurrent acquisitions of other tiles can not evict it.
+ */
+class CachedTileLock {
+public:
+  CachedTileLock() = delete;
+  CachedTileLock(const CachedTileLock &) = delete;
+  CachedTileLock & operator=(const CachedTileLock &) = delete;
+
+  explicit CachedTileLock(const CachedTile::smart_pointer & tile)
+  : _tile(tile) {
+    _acquired = _tile && _tile->acquire(true);
+  }
+
+  ~CachedTileLock() {
+    if (_acquired) {
+      _tile->release();
+    }
+  }
+
+  /**
+   * @return true if the tile data is in core
+   */
+  bool isAcquired() const {
+    return _acquired;
+  }
+
+  /**
+   * @return a pointer to the tile data, nullptr if the tile was not acquired
+   */
+  unsigned char * getDataPointer() const {
+    return _acquired ? _tile->getDataPointer() : nullptr;
+  }
+
+private:
+  CachedTile::smart_pointer _tile;
+  bool _acquired{false};
+};
+
+/**
+ * Counters describing the cache activity since its creation
+ */
+struct CacheStatistics
+{
+  /// Acquisitions of an object already in core
+  size_t hits{0};
+  /// Acquisitions of an object which had to be read from disk
+  size_t misses{0};
+  /// Acquisitions of a newly created object (no disk access)
+  size_t creations{0};
+  /// Acquisitions of an object taken back from the write-back queue
+  size_t writeBackHits{0};
+  /// Acquisitions of an object read ahead by the background worker
+  size_t prefetchHits{0};
+  /// Objects removed from core memory
+  size_t evictions{0};
+  size_t bytesRead{0};
+  size_t bytesWritten{0};
+};
+
 /*
 An abstract concept of cache management for generic objects
+The objects are spread over several shards, each with its own lock and most recently used list,
+so that concurrent acquisitions of different objects do not contend.
+Evicted objects are written to disk by a background worker which also handles read-ahead requests.
 */
 class CacheManager {
 public:
@@ -144,6 +226,8 @@ public:
   {
     size_t objectId;
     size_t objectSize;
+    /* Number of users which forbid the eviction of this object (not part of the index) */
+    mutable size_t pinCount;
   };
 
   /*
@@ -174,6 +258,16 @@ public:
                       >
                     >;
 
+  /*
+  A subset of the objects sharing a lock and a MRU list
+  */
+  struct Shard
+  {
+    std::mutex mutex;
+    MRUType mru;
+    size_t incoreBlockUsageCount{0};
+  };
+
 public:
   CacheManager() = delete;
 
@@ -183,12 +277,14 @@ public:
    * @param pathStorage the path to the directory where the file will be stored
    * @param blockSize the base size of an object
    * @param maxTilesPerIndex the maximal number of blocks for a given file (give a maximal size for a cache file)
+   * @param shardCount the number of independent partitions of the in core objects (0 for one per OpenMP thread)
    */
-  CacheManager(const std::string & pathStorage, size_t blockSize, size_t maxBlocksPerIndex);
+  CacheManager(const std::string & pathStorage, size_t blockSize, size_t maxBlocksPerIndex, size_t shardCount = 0);
   virtual ~CacheManager();
 
   /**
    * Set the maximal memory size
+   * The budget is evenly split between the shards.
    * @param max the maximal memory size
    */
   void setMaxMemory(size_t maxMemorySize);
@@ -199,6 +295,22 @@ public:
    */
   void setInCoreMaxObjectCount(size_t max);
 
+  /**
+   * Wait until all the pending write-back and read-ahead operations are done
+   */
+  void flush();
+
+  /**
+   * Get a snapshot of the cache counters
+   * @return the statistics
+   */
+  CacheStatistics getStatistics() const;
+
+  /**
+   * Log the cache counters
+   */
+  void logStatistics() const;
+
   /**
    * Create a new object of size block count
    * @param objectId the created object index
@@ -211,9 +323,29 @@ public:
    * Acquire a given object
    * @param data the result data acquired
    * @param objectId the object index to acquire
+   * @param pin if true, the object can not be evicted until releaseObject is called
    * @return true if the object was acquired
    */
-  bool acquireObject(std::unique_ptr<unsigned char> & data, size_t objectId);
+  bool acquireObject(std::unique_ptr<unsigned char> & data, size_t objectId, bool pin = false);
+
+  /**
+   * Allow the eviction of a previously pinned object
+   * @param objectId the object index to release
+   */
+  void releaseObject(size_t objectId);
+
+  /**
+   * Ask the background worker to read an object back from disk
+   * Nothing is done if the object is in core or was never stored.
+   * @param objectId the object index to prefetch
+   */
+  void prefetchObject(size_t objectId);
+
+  /**
+   * Get the number of objects read ahead and not yet acquired
+   * @return an object count
+   */
+  size_t getPrefetchedObjectCount() const;
 
   /**
    * Get the number of managed blocks
@@ -221,8 +353,20 @@ public:
    */
   size_t getActiveBlocks() const;
 
+  /**
+   * Get the number of independent partitions of the in core objects
+   * @return a shard count
+   */
+  size_t getShardCount() const {
+    return _shards.size();
+  }
+
 protected:
 
+  Shard & getShard(size_t objectId) {
+    return *_shards[objectId % _shards.size()];
+  }
+
   std::string getPathForIndex(size_t indexId);
   void deleteIndexFiles();
   void wipe();
@@ -232,16 +376,52 @@ protected:
   bool save(std::unique_ptr<unsigned char> && data, size_t startBlockId, size_t blockCount);
   bool saveObject(std::unique_ptr<unsigned char> && data, size_t objectId);
 
+  /**
+   * Acquire a given object
+   * @note the mutex of the object shard must be locked by the caller
+   */
+  bool acquireObjectLocked(Shard & shard, std::unique_ptr<unsigned char> & data, size_t objectId, bool pin);
+
+  /**
+   * Give the data of an evicted object to the background worker
+   */
+  void queueWriteBack(std::unique_ptr<unsigned char> && data, size_t objectId);
+
+  /**
+   * Remove an object from the write-back queue, waiting for it if it is being written
+   * @return the data if the object was still waiting to be written
+   */
+  std::unique_ptr<unsigned char> cancelWriteBack(size_t objectId);
+
+  /**
+   * Remove an object from the read-ahead buffers
+   * @return the data if the object was read ahead
+   */
+  std::unique_ptr<unsigned char> takePrefetched(size_t objectId);
+
+  /**
+   * Forget an object and release its storage
+   */
+  void destroyObject(size_t objectId);
+
+  /**
+   * Called with the shard mutex locked when an object is evicted.
+   * The implementation is expected to give the object data to queueWriteBack.
+   */
   virtual void onRemovedFromMRU(size_t objectId) = 0;
 
   void addFreeBlock(size_t blockId, size_t blockCount);
   size_t getFreeBlockId(size_t blockCount);
 
-  
+private:
+
+  void startWorker();
+  void stopWorker();
+  void workerLoop();
+  void processPrefetch(size_t objectId);
 
 protected:
   size_t _blockSize{0};
-  size_t _incoreBlockUsageCount{0};
   size_t _incoreBlockUsageMax{0};
   size_t _blockCountPerIndex{0};
   size_t _nextStartBlockId{0};
@@ -251,8 +431,37 @@ protected:
   IndexedStoragePaths _indexPaths;
   IndexedFreeBlocks _freeBlocks;
 
-  MRUType _mru;
+  std::vector<std::unique_ptr<Shard>> _shards;
+
+  /* Protects the memory map, the free blocks and the storage paths */
+  mutable std::mutex _mutex;
   MemoryMap _memoryMap;
+
+private:
+  /* Protects the write-back and prefetch queues and the read-ahead buffers */
+  mutable std::mutex _workerMutex;
+  std::condition_variable _workerCondition;
+  std::condition_variable _writeDoneCondition;
+  std::map<size_t, std::unique_ptr<unsigned char>> _pendingWrites;
+  std::deque<size_t> _writeQueue;
+  std::deque<size_t> _prefetchQueue;
+  /* Objects read ahead by the background worker, not yet acquired, oldest first in _prefetchedOrder */
+  std::map<size_t, std::unique_ptr<unsigned char>> _prefetched;
+  std::deque<size_t> _prefetchedOrder;
+  size_t _maxPrefetchedObjects{4};
+  size_t _inflightWrite{~size_t(0)};
+  bool _inflightPrefetch{false};
+  bool _stopWorker{false};
+  std::thread _worker;
+
+  std::atomic<size_t> _hits{0};
+  std::atomic<size_t> _misses{0};
+  std::atomic<size_t> _creations{0};
+  std::atomic<size_t> _writeBackHits{0};
+  std::atomic<size_t> _prefetchHits{0};
+  std::atomic<size_t> _evictions{0};
+  std::atomic<size_t> _bytesRead{0};
+  std::atomic<size_t> _bytesWritten{0};
 };
 
 /**
@@ -274,9 +483,10 @@ public:
    * @param tileWidth the base width of a tile
    * @param tileWidth the base height of a tile
    * @param maxTilesPerIndex the maximal number of tiles for a given file (give a maximal size for a cache file)
+   * @param shardCount the number of independent partitions of the in core tiles (0 for one per OpenMP thread)
    * @retuurn the manager shared pointer
    */
-  static std::shared_ptr<TileCacheManager> create(const std::string & pathStorage, size_t tileWidth, size_t tileHeight, size_t maxTilesPerIndex);
+  static std::shared_ptr<TileCacheManager> create(const std::string & pathStorage, size_t tileWidth, size_t tileHeight, size_t maxTilesPerIndex, size_t shardCount = 0);
 
   /**
    * Notify the manager that a given tile was destroyed.
@@ -288,9 +498,22 @@ public:
   /**
    * Acquire a given tile
    * @param tileId the tile index to acquire
+   * @param pin if true, the tile can not be evicted until release is called
    * @return true if the tile was acquired
    */
-  bool acquire(size_t tileId);
+  bool acquire(size_t tileId, bool pin = false);
+
+  /**
+   * Allow the eviction of a previously pinned tile
+   * @param tileId the tile index to release
+   */
+  void release(size_t tileId);
+
+  /**
+   * Ask for a tile to be read back from disk in the background
+   * @param tileId the tile index to prefetch
+   */
+  void prefetch(size_t tileId);
 
   /**
    * Acquire a given tile
@@ -324,15 +547,19 @@ public:
 
 protected:
 
-  TileCacheManager(const std::string & pathStorage, size_t tileWidth, size_t tileHeight, size_t maxTilesPerIndex);
+  TileCacheManager(const std::string & pathStorage, size_t tileWidth, size_t tileHeight, size_t maxTilesPerIndex, size_t shardCount);
 
   virtual void onRemovedFromMRU(size_t objectId);
 
+  CachedTile::smart_pointer getTile(size_t tileId);
+
 protected:
 
   size_t _tileWidth;
   size_t _tileHeight;
 
+  /* Protects the tile map */
+  std::mutex _objectMapMutex;
   MapCachedTile _objectMap;
 };
 
@@ -0,0 +1,213 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2020 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/image/cache.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE ImageCache
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::image;
+
+namespace {
+
+bool fillTile(const CachedTile::smart_pointer & tile, float value)
+{
+  CachedTileLock lock(tile);
+  if (!lock.isAcquired()) {
+    return false;
+  }
+
+  float * data = reinterpret_cast<float *>(lock.getDataPointer());
+  std::fill(data, data + tile->getTileWidth() * tile->getTileHeight(), value);
+
+  return true;
+}
+
+bool checkTile(const CachedTile::smart_pointer & tile, float value)
+{
+  CachedTileLock lock(tile);
+  if (!lock.isAcquired()) {
+    return false;
+  }
+
+  const float * data = reinterpret_cast<const float *>(lock.getDataPointer());
+  for (size_t i = 0; i < tile->getTileWidth() * tile->getTileHeight(); i++) {
+    if (data[i] != value) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(Cache_invalidTileSize)
+{
+  const std::string tempDirPath = boost::filesystem::temp_directory_path().generic_string();
+  BOOST_CHECK(TileCacheManager::create(tempDirPath, 100, 64, 16) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Cache_defaultShardCount)
+{
+  const std::string tempDirPath = boost::filesystem::temp_directory_path().generic_string();
+
+  // One shard per thread by default
+  TileCacheManager::shared_ptr manager = TileCacheManager::create(tempDirPath, 32, 32, 16);
+  BOOST_REQUIRE(manager);
+  BOOST_CHECK_EQUAL(manager->getShardCount(), size_t(std::max(omp_get_max_threads(), 1)));
+
+  TileCacheManager::shared_ptr single = TileCacheManager::create(tempDirPath, 32, 32, 16, 1);
+  BOOST_REQUIRE(single);
+  BOOST_CHECK_EQUAL(single->getShardCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Cache_writeBackAndReload)
+{
+  const std::string tempDirPath = boost::filesystem::temp_directory_path().generic_string();
+  TileCacheManager::shared_ptr manager = TileCacheManager::create(tempDirPath, 64, 64, 16, 1);
+  BOOST_REQUIRE(manager);
+
+  // Keep at most two tiles in core
+  manager->setMaxMemory(2 * 64 * 64 * sizeof(float));
+
+  std::vector<CachedTile::smart_pointer> tiles;
+  for (int i = 0; i < 20; i++) {
+    tiles.push_back(manager->requireNewCachedTile<float>(64, 64));
+    BOOST_CHECK(fillTile(tiles.back(), float(i)));
+  }
+
+  manager->flush();
+
+  for (int i = 0; i < 20; i++) {
+    BOOST_CHECK(checkTile(tiles[i], float(i)));
+  }
+
+  const CacheStatistics stats = manager->getStatistics();
+  BOOST_CHECK_EQUAL(stats.creations, 20);
+  BOOST_CHECK(stats.evictions > 0);
+  BOOST_CHECK(stats.bytesWritten > 0);
+}
+
+BOOST_AUTO_TEST_CASE(Cache_prefetch)
+{
+  const std::string tempDirPath = boost::filesystem::temp_directory_path().generic_string();
+  TileCacheManager::shared_ptr manager = TileCacheManager::create(tempDirPath, 32, 32, 16, 1);
+  BOOST_REQUIRE(manager);
+
+  manager->setMaxMemory(32 * 32 * sizeof(float));
+
+  CachedTile::smart_pointer first = manager->requireNewCachedTile<float>(32, 32);
+  CachedTile::smart_pointer second = manager->requireNewCachedTile<float>(32, 32);
+  BOOST_CHECK(fillTile(first, 1.0f));
+  BOOST_CHECK(fillTile(second, 2.0f));
+  manager->flush();
+
+  // The first tile is on disk, ask for it to be read ahead
+  first->prefetch();
+  manager->flush();
+
+  BOOST_CHECK(checkTile(first, 1.0f));
+  BOOST_CHECK(checkTile(second, 2.0f));
+}
+
+BOOST_AUTO_TEST_CASE(Cache_prefetchNeverAcquired)
+{
+  const std::string tempDirPath = boost::filesystem::temp_directory_path().generic_string();
+  TileCacheManager::shared_ptr manager = TileCacheManager::create(tempDirPath, 32, 32, 16, 1);
+  BOOST_REQUIRE(manager);
+
+  manager->setMaxMemory(32 * 32 * sizeof(float));
+
+  std::vector<CachedTile::smart_pointer> tiles;
+  for (int i = 0; i < 12; i++) {
+    tiles.push_back(manager->requireNewCachedTile<float>(32, 32));
+    BOOST_CHECK(fillTile(tiles.back(), float(i)));
+  }
+  manager->flush();
+
+  // Read ahead more tiles than the buffers can hold, without acquiring them
+  for (int i = 0; i < 8; i++) {
+    tiles[i]->prefetch();
+  }
+  manager->flush();
+  BOOST_CHECK_EQUAL(manager->getPrefetchedObjectCount(), 4);
+
+  // Destroyed tiles release their buffers
+  tiles[6].reset();
+  tiles[7].reset();
+  BOOST_CHECK_EQUAL(manager->getPrefetchedObjectCount(), 2);
+
+  // Read-ahead still works once the buffers have been filled, the oldest buffers are dropped
+  for (int i = 8; i < 11; i++) {
+    tiles[i]->prefetch();
+  }
+  manager->flush();
+  BOOST_CHECK_EQUAL(manager->getPrefetchedObjectCount(), 4);
+
+  BOOST_CHECK(checkTile(tiles[10], 10.0f));
+  BOOST_CHECK(checkTile(tiles[4], 4.0f));
+  const CacheStatistics stats = manager->getStatistics();
+  BOOST_CHECK_EQUAL(stats.prefetchHits, 1);
+  BOOST_CHECK_EQUAL(manager->getPrefetchedObjectCount(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Cache_concurrentAccess)
+{
+  const std::string tempDirPath = boost::filesystem::temp_directory_path().generic_string();
+  TileCacheManager::shared_ptr manager = TileCacheManager::create(tempDirPath, 32, 32, 16, 3);
+  BOOST_REQUIRE(manager);
+
+  // Much smaller than the working set, to force evictions while other threads use their tiles
+  manager->setMaxMemory(8 * 32 * 32 * sizeof(float));
+
+  const int countTiles = 64;
+  std::vector<CachedTile::smart_pointer> tiles;
+  for (int i = 0; i < countTiles; i++) {
+    tiles.push_back(manager->requireNewCachedTile<float>(32, 32));
+    BOOST_CHECK(fillTile(tiles.back(), float(i)));
+  }
+
+  const int countThreads = 4;
+  std::vector<int> errors(countThreads, 0);
+  std::vector<std::thread> threads;
+  for (int idThread = 0; idThread < countThreads; idThread++) {
+    threads.emplace_back([&, idThread]() {
+      for (int iteration = 0; iteration < 10; iteration++) {
+        for (int i = idThread; i < countTiles; i += countThreads) {
+          if (!checkTile(tiles[i], float(i + iteration))) {
+            errors[idThread]++;
+          }
+          if (!fillTile(tiles[i], float(i + iteration + 1))) {
+            errors[idThread]++;
+          }
+        }
+      }
+    });
+  }
+
+  for (std::thread & thread : threads) {
+    thread.join();
+  }
+
+  for (int idThread = 0; idThread < countThreads; idThread++) {
+    BOOST_CHECK_EQUAL(errors[idThread], 0);
+  }
+
+  manager->flush();
+  for (int i = 0; i < countTiles; i++) {
+    BOOST_CHECK(checkTile(tiles[i], float(i + 10)));
+  }
+}
@@ -7,72 +7,123 @@
 
 #include "convolution.hpp"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+#include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <utility>
+
 namespace aliceVision {
 namespace image {
 
-void SeparableConvolution2d(const RowMatrixXf& image,
-                            const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_x,
-                            const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_y,
-                            RowMatrixXf* out) {
-  const int sigma_y = static_cast<int>( kernel_y.cols() );
-  const int half_sigma_y = static_cast<int>( kernel_y.cols() ) / 2;
+namespace {
 
-  // Convolving a vertical filter across rows is the same thing as transpose
-  // multiply i.e. kernel_y^t * rows. This will give us the convoled value for
-  // each row. However, care must be taken at the top and bottom borders.
-  const Eigen::Matrix<float, 1, Eigen::Dynamic> reverse_kernel_y = kernel_y.reverse();
+/// Number of rows given to a thread at once, consecutive rows share most of their vertical taps in cache
+const int convolutionStripHeight = 16;
 
-  #pragma omp parallel for schedule(dynamic)
-  for (int i = 0; i < half_sigma_y; i++)
+/**
+ * @brief out[x] += k * in[x] for x in [0, size)
+ *        Both buffers are contiguous so the loop runs on 8 (AVX) or 4 (SSE) floats at a time.
+ */
+inline void accumulateScaledRow(float* out, const float* in, float k, int size)
+{
+  int x = 0;
+#if defined(__AVX__)
+  const __m256 k8 = _mm256_set1_ps(k);
+  for(; x + 8 <= size; x += 8)
   {
-    const int forward_size = i + half_sigma_y + 1;
-    const int reverse_size = sigma_y - forward_size;
-    out->row(i) = kernel_y.tail(forward_size) *
-                  image.block(0, 0, forward_size, image.cols()) +
-                  reverse_kernel_y.tail(reverse_size) *
-                  image.block(1, 0, reverse_size, image.cols());
-
-    // Apply the same technique for the end rows.
-    out->row(image.rows() - i - 1) =
-      kernel_y.head(forward_size) *
-      image.block(image.rows() - forward_size, 0, forward_size, image.cols())
-      +
-      reverse_kernel_y.head(reverse_size) *
-      image.block(image.rows() - reverse_size - 1, 0, reverse_size, image.cols());
+    _mm256_storeu_ps(out + x, _mm256_add_ps(_mm256_loadu_ps(out + x), _mm256_mul_ps(k8, _mm256_loadu_ps(in + x))));
   }
+#elif ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE)
+  const __m128 k4 = _mm_set1_ps(k);
+  for(; x + 4 <= size; x += 4)
+  {
+    _mm_storeu_ps(out + x, _mm_add_ps(_mm_loadu_ps(out + x), _mm_mul_ps(k4, _mm_loadu_ps(in + x))));
+  }
+#endif
+  for(; x < size; ++x)
+  {
+    out[x] += k * in[x];
+  }
+}
 
-  // Applying the rest of the y filter.
-  #pragma omp parallel for schedule(dynamic)
-  for (int row = half_sigma_y; row < image.rows() - half_sigma_y; row++)
+/**
+ * @brief Keep the non zero taps of a kernel as (offset, weight).
+ *        Derivative kernels (e.g. the scaled Scharr ones) are mostly zeros.
+ */
+std::vector<std::pair<int, float>> nonZeroTaps(const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel)
+{
+  std::vector<std::pair<int, float>> taps;
+  for(int i = 0; i < kernel.cols(); ++i)
   {
-    out->row(row) =  kernel_y * image.block(row - half_sigma_y, 0, sigma_y, out->cols());
+    if(kernel(i) != 0.f)
+      taps.emplace_back(i, kernel(i));
   }
+  return taps;
+}
+
+/// Reflect101 border (-1 -> 1), clamped to stay in the image when it is smaller than the kernel
+inline int mirrorIndex(int i, int size)
+{
+  if(i < 0)
+    i = -i;
+  else if(i >= size)
+    i = 2 * (size - 1) - i;
+  return std::min(std::max(i, 0), size - 1);
+}
 
+} // namespace
+
+void SeparableConvolution2d(const RowMatrixXf& image,
+                            const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_x,
+                            const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_y,
+                            RowMatrixXf* out) {
+  const int rows = static_cast<int>(image.rows());
+  const int cols = static_cast<int>(image.cols());
+  const int half_sigma_y = static_cast<int>(kernel_y.cols()) / 2;
   const int sigma_x = static_cast<int>(kernel_x.cols());
-  const int half_sigma_x = static_cast<int>(kernel_x.cols() / 2);
+  const int half_sigma_x = sigma_x / 2;
 
-  // Convolving with the horizontal filter is easy. Rather than using the kernel
-  // as a sliding window, we use the row pixels as a sliding window around the
-  // filter. We prepend and append the proper border values so that we are sure
-  // to end up with the correct convolved values.
-  Eigen::RowVectorXf temp_row(image.cols() + sigma_x - 1);
+  const std::vector<std::pair<int, float>> taps_y = nonZeroTaps(kernel_y);
+  const std::vector<std::pair<int, float>> taps_x = nonZeroTaps(kernel_x);
 
-  #pragma omp parallel for firstprivate(temp_row), schedule(dynamic)
-  for (int row = 0; row < out->rows(); row++)
+  // Both passes are fused row by row: the vertical filter accumulates whole input rows into
+  // a padded line buffer, then the horizontal filter slides this line over the output row.
+  // Every inner loop runs on contiguous memory and the intermediate image is never stored.
+  #pragma omp parallel
   {
-    temp_row.head(half_sigma_x) =
-      out->row(row).segment(1, half_sigma_x).reverse();
-    temp_row.segment(half_sigma_x, image.cols()) = out->row(row);
-    temp_row.tail(half_sigma_x) =
-      out->row(row)
-      .segment(image.cols() - 2 - half_sigma_x, half_sigma_x)
-      .reverse();
-
-    // Convolve the row. We perform the first step here explicitly so that we
-    // avoid setting the row equal to zero.
-    out->row(row) = kernel_x(0) * temp_row.head(image.cols());
-    for (int i = 1; i < sigma_x; i++) {
-      out->row(row) += kernel_x(i) * temp_row.segment(i, image.cols());
+    std::vector<float> line(cols + sigma_x - 1);
+    float* center = line.data() + half_sigma_x;
+
+    #pragma omp for schedule(dynamic, convolutionStripHeight)
+    for (int row = 0; row < rows; row++)
+    {
+      // Vertical pass, rows out of the image are mirrored around the first/last one
+      std::fill(center, center + cols, 0.f);
+      for (const auto& tap : taps_y)
+      {
+        const int y = mirrorIndex(row - half_sigma_y + tap.first, rows);
+        accumulateScaledRow(center, image.data() + static_cast<std::size_t>(y) * cols, tap.second, cols);
+      }
+
+      // Prepend and append the border values so that the horizontal pass needs no bound check.
+      // The right border reproduces the historical implementation (segment(cols - 2 - half, half) reversed).
+      for (int i = 0; i < half_sigma_x; i++)
+      {
+        line[i] = center[std::min(half_sigma_x - i, cols - 1)];
+        center[cols + i] = center[std::max(cols - 3 - i, 0)];
+      }
+
+      // Horizontal pass
+      float* dst = out->data() + static_cast<std::size_t>(row) * cols;
+      std::fill(dst, dst + cols, 0.f);
+      for (const auto& tap : taps_x)
+      {
+        accumulateScaledRow(dst, line.data() + tap.first, tap.second, cols);
+      }
     }
   }
 }
@@ -13,6 +13,7 @@
 #include <aliceVision/image/Image.hpp>
 #include <aliceVision/config.hpp>
 
+#include <algorithm>
 #include <vector>
 #include <cassert>
 
@@ -126,6 +127,7 @@ template< typename ImageTypeIn , typename ImageTypeOut, typename Kernel >
 void ImageVerticalConvolution( const ImageTypeIn & img , const Kernel & kernel , ImageTypeOut & out)
 {
   typedef typename ImageTypeIn::Tpixel pix_t ;
+  typedef typename Kernel::Scalar sum_t ;
 
   const int kernel_width = kernel.size() ;
   const int half_kernel_width = kernel_width / 2 ;
@@ -133,32 +135,42 @@ void ImageVerticalConvolution( const ImageTypeIn & img , const Kernel & kernel ,
   const int rows = img.rows() ;
   const int cols = img.cols() ;
 
-  out.resize( cols , rows ) ;
+  // Every pixel is written: no initialization, which would also erase the input of an in place call
+  out.resize( cols , rows , false ) ;
+
+  // Accumulate whole rows rather than filtering column by column:
+  // every access is contiguous and the result is the same as conv_buffer_ on each column.
+  std::vector<sum_t> sum( cols );
 
-  std::vector<pix_t, Eigen::aligned_allocator<pix_t> > line( rows + kernel_width );
+  // The input rows above the current one, kept in a ring buffer so that img and out may be the same image
+  std::vector<pix_t, Eigen::aligned_allocator<pix_t> > previousRows( static_cast<std::size_t>( half_kernel_width ) * cols );
 
-  for( int col = 0 ; col < cols ; ++col )
+  for( int row = 0 ; row < rows ; ++row )
   {
-    // Copy column
-    for( int k = 0 ; k < half_kernel_width ; ++k )
-    {
-      line[ k ] = img.coeffRef( 0 , col ) ;
-    }
-    for( int k = 0 ; k < rows ; ++k )
+    std::fill( sum.begin() , sum.end() , sum_t( 0 ) ) ;
+    for( int k = 0 ; k < kernel_width ; ++k )
     {
-      line[ k + half_kernel_width ] = img.coeffRef( k , col ) ;
+      // Border rows are copied
+      const int idy = std::min( std::max( row + k - half_kernel_width , 0 ) , rows - 1 ) ;
+      const pix_t * src = ( idy < row ) ?
+        &previousRows[ static_cast<std::size_t>( idy % half_kernel_width ) * cols ] :
+        img.data() + static_cast<std::size_t>( idy ) * cols ;
+      const sum_t weight = kernel( k ) ;
+      for( int col = 0 ; col < cols ; ++col )
+      {
+        sum[ col ] += src[ col ] * weight ;
+      }
     }
-    for( int k = 0 ; k < half_kernel_width ; ++k )
+
+    if( half_kernel_width > 0 )
     {
-      line[ k + half_kernel_width + rows ] = img.coeffRef( rows - 1 , col ) ;
+      memcpy( &previousRows[ static_cast<std::size_t>( row % half_kernel_width ) * cols ] ,
+              img.data() + static_cast<std::size_t>( row ) * cols , sizeof( pix_t ) * cols ) ;
     }
 
-    // Apply convolution
-    conv_buffer_( &line[0] , kernel.data() , rows , kernel_width );
-
-    for( int row = 0 ; row < rows ; ++row )
+    for( int col = 0 ; col < cols ; ++col )
     {
-      out.coeffRef( row , col ) = line[row];
+      out.coeffRef( row , col ) = pix_t( sum[ col ] ) ;
     }
   }
 }
@@ -11,6 +11,7 @@
 #include <cstdio>
 #include <cstring>
 #include <functional>
+#include <mutex>
 
 namespace aliceVision {
 namespace image {
@@ -273,6 +274,58 @@ const DCPProfile::Matrix xyzD50ToSrgbD50LinearMatrix = { 3.1338561, -1.6168667,
 const DCPProfile::Matrix xyzD50ToACES2065Matrix = { 1.019573375, -0.022815668, 0.048147546, -0.503070253, 1.384421764, 0.121965628, 0.000961591, 0.003054793, 1.207019111 };
 
 const double TINT_SCALE = -3000.0;
+
+/**
+ * @brief Apply a 3x3 matrix on the first three channels of a row of interleaved float pixels.
+ * The row is split into one plane per channel so that the matrix product is vectorized.
+ * @param[in] m The matrix, row major
+ * @param[in,out] row The first pixel of the row
+ * @param[in] width The number of pixels in the row
+ * @param[in] nchannels The number of interleaved channels (at least 3)
+ * @param[in,out] planes Scratch buffer, resized to 3 * width
+ */
+void applyMatrixOnRow(const std::array<float, 9>& m, float* row, const int width, const int nchannels, std::vector<float>& planes)
+{
+    planes.resize(3 * std::size_t(width));
+    float* const r = planes.data();
+    float* const g = r + width;
+    float* const b = g + width;
+
+    for (int j = 0; j < width; ++j)
+    {
+        const float* pixel = row + std::size_t(j) * nchannels;
+        r[j] = pixel[0];
+        g[j] = pixel[1];
+        b[j] = pixel[2];
+    }
+
+    for (int j = 0; j < width; ++j)
+    {
+        const float red = r[j];
+        const float green = g[j];
+        const float blue = b[j];
+        r[j] = m[0] * red + m[1] * green + m[2] * blue;
+        g[j] = m[3] * red + m[4] * green + m[5] * blue;
+        b[j] = m[6] * red + m[7] * green + m[8] * blue;
+    }
+
+    for (int j = 0; j < width; ++j)
+    {
+        float* pixel = row + std::size_t(j) * nchannels;
+        pixel[0] = r[j];
+        pixel[1] = g[j];
+        pixel[2] = b[j];
+    }
+}
+
+std::array<float, 9> toFloatMatrix(const DCPProfile::Matrix& M)
+{
+    std::array<float, 9> m;
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+            m[3 * r + c] = static_cast<float>(M[r][c]);
+    return m;
+}
 } // namespace
 
 enum class TagType : int
@@ -2270,49 +2323,80 @@ void DCPProfile::setMatricesFromStrings(const std::string& type, std::vector<std
 
 void DCPProfile::applyLinear(OIIO::ImageBuf& image, const Triple& neutral, const bool sourceIsRaw) const
 {
-    const Matrix cameraToACES2065Matrix = getCameraToACES2065Matrix(neutral, sourceIsRaw);
+    const std::array<float, 9> m = toFloatMatrix(getCameraToACES2065Matrix(neutral, sourceIsRaw));
 
-    #pragma omp parallel for
-    for (int i = 0; i < image.spec().height; ++i)
-        for (int j = 0; j < image.spec().width; ++j)
-        {
-            float rgb[3];
-            image.getpixel(j, i, rgb, 3);
+    const OIIO::ImageSpec& spec = image.spec();
+    float* const pixels = (spec.format == OIIO::TypeDesc::FLOAT) ? static_cast<float*>(image.localpixels()) : nullptr;
+
+    #pragma omp parallel
+    {
+        std::vector<float> planes;
+        std::vector<float> row;
 
-            float rgbOut[3];
-            for (int r = 0; r < 3; ++r)
+        #pragma omp for
+        for (int i = 0; i < spec.height; ++i)
+        {
+            if (pixels != nullptr)
             {
-                rgbOut[r] = 0.0;
-                for (int c = 0; c < 3; ++c)
-                {
-                    rgbOut[r] += cameraToACES2065Matrix[r][c] * rgb[c];
-                }
+                applyMatrixOnRow(m, pixels + std::size_t(i) * spec.width * spec.nchannels, spec.width, spec.nchannels, planes);
+            }
+            else
+            {
+                // Not stored as float, go through a converted copy of the row
+                const OIIO::ROI rowROI(spec.x, spec.x + spec.width, spec.y + i, spec.y + i + 1, 0, 1, 0, spec.nchannels);
+                row.resize(std::size_t(spec.width) * spec.nchannels);
+                image.get_pixels(rowROI, OIIO::TypeDesc::FLOAT, row.data());
+                applyMatrixOnRow(m, row.data(), spec.width, spec.nchannels, planes);
+                image.set_pixels(rowROI, OIIO::TypeDesc::FLOAT, row.data());
             }
-            image.setpixel(j, i, rgbOut, 3);
         }
+    }
 }
 
 void DCPProfile::applyLinear(Image<image::RGBAfColor>& image, const Triple& neutral, const bool sourceIsRaw) const
 {
-    const Matrix cameraToACES2065Matrix = getCameraToACES2065Matrix(neutral, sourceIsRaw);
+    const std::array<float, 9> m = toFloatMatrix(getCameraToACES2065Matrix(neutral, sourceIsRaw));
 
-    #pragma omp parallel for
-    for (int i = 0; i < image.Height(); ++i)
-        for (int j = 0; j < image.Width(); ++j)
-        {
-            const RGBAfColor rgb = image(i, j);
+    float* const pixels = reinterpret_cast<float*>(image.data());
 
-            RGBAfColor rgbOut = rgb;
-            for (int r = 0; r < 3; ++r)
-            {
-                rgbOut[r] = 0.0;
-                for (int c = 0; c < 3; ++c)
-                {
-                    rgbOut[r] += cameraToACES2065Matrix[r][c] * rgb[c];
-                }
-            }
-            image(i, j) = rgbOut;
+    #pragma omp parallel
+    {
+        std::vector<float> planes;
+
+        #pragma omp for
+        for (int i = 0; i < image.Height(); ++i)
+        {
+            applyMatrixOnRow(m, pixels + std::size_t(i) * image.Width() * 4, image.Width(), 4, planes);
         }
+    }
+}
+
+std::shared_ptr<const DCPProfile> getSharedDCPProfile(const std::string& filename)
+{
+    struct CachedProfile
+    {
+        std::time_t lastWriteTime;
+        std::shared_ptr<const DCPProfile> profile;
+    };
+
+    static std::mutex cacheMutex;
+    static std::map<std::string, CachedProfile> cache;
+
+    const std::time_t lastWriteTime = bfs::last_write_time(filename);
+
+    // Profiles are small: parse under the lock so that concurrent reads of the same profile only parse it once
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    const auto it = cache.find(filename);
+    if (it != cache.end() && it->second.lastWriteTime == lastWriteTime)
+    {
+        return it->second.profile;
+    }
+
+    std::shared_ptr<const DCPProfile> profile = std::make_shared<const DCPProfile>(filename);
+    cache[filename] = {lastWriteTime, profile};
+
+    return profile;
 }
 
 DCPDatabase::DCPDatabase(const std::string& databaseDirPath)
@@ -294,6 +294,15 @@ private:
     SplineToneCurve igammatab_srgb;
 };
 
+/**
+ * @brief getSharedDCPProfile loads a DCP profile once per process and shares it between callers.
+ * The profile is parsed again only if the file has been modified since it was cached.
+ * This function is thread safe.
+ * param[in] filename The dcp path on disk
+ * return The read-only profile
+ */
+std::shared_ptr<const DCPProfile> getSharedDCPProfile(const std::string& filename);
+
 /**
 * @brief DCPDatabase manages DCP profiles loading and caching
 */
@@ -0,0 +1,146 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/image/dcp.hpp>
+
+#include <OpenImageIO/imagebuf.h>
+
+#include <random>
+
+#define BOOST_TEST_MODULE ImageDCP
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::image;
+
+BOOST_AUTO_TEST_CASE(DCP_applyLinearBuffers)
+{
+    const int width = 37;
+    const int height = 11;
+
+    // Color matrices only: the camera to ACES matrix depends on the neutral
+    DCPProfile dcpProfile;
+    std::vector<DCPProfile::Matrix> colorMatrices = {{{{0.68, -0.14, -0.07}, {-0.42, 1.21, 0.23}, {-0.09, 0.21, 0.62}}}};
+    dcpProfile.setMatrices("color", colorMatrices);
+
+    const DCPProfile::Triple neutral = {0.48, 1.0, 0.71};
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+    Image<RGBAfColor> image(width, height);
+    for (int i = 0; i < height; ++i)
+        for (int j = 0; j < width; ++j)
+            image(i, j) = RGBAfColor(distribution(generator), distribution(generator), distribution(generator), distribution(generator));
+
+    // Same pixels in a 3 channels float buffer and in a 4 channels half buffer (row by row conversion)
+    OIIO::ImageBuf floatBuf(OIIO::ImageSpec(width, height, 3, OIIO::TypeDesc::FLOAT));
+    OIIO::ImageBuf halfBuf(OIIO::ImageSpec(width, height, 4, OIIO::TypeDesc::HALF));
+    for (int i = 0; i < height; ++i)
+        for (int j = 0; j < width; ++j)
+        {
+            floatBuf.setpixel(j, i, image(i, j).data(), 3);
+            halfBuf.setpixel(j, i, image(i, j).data(), 4);
+        }
+
+    Image<RGBAfColor> expected = image;
+    dcpProfile.applyLinear(image, neutral, true);
+    dcpProfile.applyLinear(floatBuf, neutral, true);
+    dcpProfile.applyLinear(halfBuf, neutral, true);
+
+    for (int i = 0; i < height; ++i)
+        for (int j = 0; j < width; ++j)
+        {
+            // Alpha is untouched
+            BOOST_CHECK_EQUAL(image(i, j).a(), expected(i, j).a());
+
+            float floatPixel[3];
+            floatBuf.getpixel(j, i, floatPixel, 3);
+            float halfPixel[4];
+            halfBuf.getpixel(j, i, halfPixel, 4);
+
+            for (int c = 0; c < 3; ++c)
+            {
+                BOOST_CHECK_CLOSE(floatPixel[c], image(i, j)(c), 1e-4);
+                BOOST_CHECK_SMALL(halfPixel[c] - image(i, j)(c), 5e-3f);
+            }
+        }
+
+    // The matrix is not the identity
+    BOOST_CHECK(std::abs(image(0, 0).r() - expected(0, 0).r()) > 1e-3f);
+}
+
+BOOST_AUTO_TEST_CASE(DCP_applyLinearReference)
+{
+    // Single forward matrix on raw data: camera to ACES = xyzD50ToACES2065 * forward * diag(1 / neutral)
+    DCPProfile dcpProfile;
+    std::vector<DCPProfile::Matrix> forwardMatrices = {{{{0.71, 0.16, 0.09}, {0.28, 0.83, -0.11}, {0.03, -0.12, 0.91}}}};
+    dcpProfile.setMatrices("forward", forwardMatrices);
+
+    const DCPProfile::Triple neutral = {0.48, 1.0, 0.71};
+    const DCPProfile::Matrix xyzD50ToACES2065 = {{{1.019573375, -0.022815668, 0.048147546},
+                                                  {-0.503070253, 1.384421764, 0.121965628},
+                                                  {0.000961591, 0.003054793, 1.207019111}}};
+
+    DCPProfile::Matrix reference;
+    for (int r = 0; r < 3; ++r)
+        for (int c = 0; c < 3; ++c)
+        {
+            reference[r][c] = 0.0;
+            for (int k = 0; k < 3; ++k)
+                reference[r][c] += xyzD50ToACES2065[r][k] * forwardMatrices[0][k][c] / neutral[c];
+        }
+
+    const int width = 19;
+    const int height = 7;
+
+    std::default_random_engine generator;
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+    Image<RGBAfColor> image(width, height);
+    for (int i = 0; i < height; ++i)
+        for (int j = 0; j < width; ++j)
+            image(i, j) = RGBAfColor(distribution(generator), distribution(generator), distribution(generator), 1.0f);
+    image(0, 0) = RGBAfColor(0.2f, 0.5f, 0.3f, 1.0f);
+
+    OIIO::ImageBuf floatBuf(OIIO::ImageSpec(width, height, 3, OIIO::TypeDesc::FLOAT));
+    for (int i = 0; i < height; ++i)
+        for (int j = 0; j < width; ++j)
+            floatBuf.setpixel(j, i, image(i, j).data(), 3);
+
+    const Image<RGBAfColor> input = image;
+    dcpProfile.applyLinear(image, neutral, true);
+    dcpProfile.applyLinear(floatBuf, neutral, true);
+
+    for (int i = 0; i < height; ++i)
+        for (int j = 0; j < width; ++j)
+        {
+            float floatPixel[3];
+            floatBuf.getpixel(j, i, floatPixel, 3);
+
+            for (int r = 0; r < 3; ++r)
+            {
+                double expected = 0.0;
+                for (int c = 0; c < 3; ++c)
+                    expected += reference[r][c] * input(i, j)(c);
+
+                BOOST_CHECK_SMALL(image(i, j)(r) - expected, 1e-5);
+                BOOST_CHECK_SMALL(floatPixel[r] - expected, 1e-5);
+            }
+        }
+
+    // Explicit value of M * (0.2, 0.5, 0.3)
+    BOOST_CHECK_CLOSE(image(0, 0).r(), 0.427118, 1e-3);
+    BOOST_CHECK_CLOSE(image(0, 0).g(), 0.504606, 1e-3);
+    BOOST_CHECK_CLOSE(image(0, 0).b(), 0.408654, 1e-3);
+}
+
+BOOST_AUTO_TEST_CASE(DCP_sharedProfileMissingFile)
+{
+    BOOST_CHECK_THROW(getSharedDCPProfile("not_a_dcp_profile.dcp"), std::exception);
+}
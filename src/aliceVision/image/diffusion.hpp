@@ -10,6 +10,7 @@
 #include <aliceVision/config.hpp>
 #include <aliceVision/alicevision_omp.hpp>
 
+#include <algorithm>
 #include <vector>
 
 #ifdef _MSC_VER
@@ -38,74 +39,94 @@ void ImagePeronaMalikG2DiffusionCoef( const Image & Lx , const Image & Ly , cons
   }
 
   typedef typename Image::Tpixel Real;
-  out.array() = ( static_cast<Real>(1.f) + (Lx.array().square()+Ly.array().square() )/(k*k) ).inverse();
+  const Real k2 = k*k;
+
+  #pragma omp parallel for
+  for( int i = 0 ; i < height ; ++i )
+  {
+    out.row(i).array() = ( static_cast<Real>(1.f) + (Lx.row(i).array().square()+Ly.row(i).array().square() ) / k2 ).inverse();
+  }
 }
 
 /**
-** Apply Fast Explicit Diffusion to an Image (on central part)
-** @param src input image
-** @param diff diffusion coefficient image
+** Apply one Fast Explicit Diffusion step on a row
+** Neighbors out of the image are given as the row itself, so that their flux is exactly zero.
+** @param src_up previous source row (or src_row on the first row)
+** @param src_row source row
+** @param src_down next source row (or src_row on the last row)
+** @param diff_up previous diffusion coefficient row (or diff_row on the first row)
+** @param diff_row diffusion coefficient row
+** @param diff_down next diffusion coefficient row (or diff_row on the last row)
+** @param width row length
 ** @param half_t Half diffusion time
-** @param out Output image
-** @param row_start Row range beginning (range is [row_start ; row_end [ )
-** @param row_end Row range end (range is [row_start ; row_end [ )
+** @param add_source if true out = src + step, else out = step
+** @param out output row
 **/
-template< typename Image >
-void ImageFEDCentral( const Image & src , const Image & diff , const typename Image::Tpixel half_t , Image & out ,
-                      const int row_start , const int row_end )
+template< typename Real >
+inline void FEDStepRow( const Real * src_up , const Real * src_row , const Real * src_down ,
+                        const Real * diff_up , const Real * diff_row , const Real * diff_down ,
+                        const int width , const Real half_t , const bool add_source , Real * out )
 {
-  typedef typename Image::Tpixel Real ;
-  const int width = src.Width() ;
-  Real n_diff[4] ;
-  Real n_src[4] ;
-  // Compute FED step on general range
-  for( int i = row_start ; i < row_end ; ++i )
+  // Value of the step for the pixel j with its left (j_left) and right (j_right) neighbors
+  const auto step = [&]( const int j , const int j_left , const int j_right )
+  {
+    const Real cur_src = src_row[ j ] ;
+    const Real cur_diff = diff_row[ j ] ;
+    const Real a = ( cur_diff + diff_row[ j_right ] ) * ( src_row[ j_right ] - cur_src ) ;
+    const Real b = ( cur_diff + diff_up[ j ] ) * ( cur_src - src_up[ j ] ) ;
+    const Real c = ( cur_diff + diff_row[ j_left ] ) * ( cur_src - src_row[ j_left ] ) ;
+    const Real d = ( cur_diff + diff_down[ j ] ) * ( src_down[ j ] - cur_src ) ;
+    return half_t * ( a - c + d - b ) ;
+  };
+
+  const Real first = step( 0 , 0 , std::min( 1 , width - 1 ) ) ;
+  out[ 0 ] = add_source ? src_row[ 0 ] + first : first ;
+
+  // Central part, without any branch so that it can be vectorized
+  if( add_source )
   {
     for( int j = 1 ; j < width - 1 ; ++j )
     {
-      // Retrieve neighbors : TODO check if we need a cache efficient version ?
-      n_diff[0] = diff( i , j + 1 ) ;
-      n_diff[1] = diff( i - 1 , j ) ;
-      n_diff[2] = diff( i , j - 1 ) ;
-      n_diff[3] = diff( i + 1 , j ) ;
-      n_src[0] = src( i , j + 1 ) ;
-      n_src[1] = src( i - 1 , j ) ;
-      n_src[2] = src( i , j - 1 ) ;
-      n_src[3] = src( i + 1 , j ) ;
-
-      // Compute diffusion factor for given pixel
-      const Real cur_src = src( i , j ) ;
-      const Real cur_diff = diff( i , j ) ;
-      const Real a = ( cur_diff + n_diff[0] ) * ( n_src[0] - cur_src ) ;
-      const Real b = ( cur_diff + n_diff[1] ) * ( cur_src - n_src[1] ) ;
-      const Real c = ( cur_diff + n_diff[2] ) * ( cur_src - n_src[2] ) ;
-      const Real d = ( cur_diff + n_diff[3] ) * ( n_src[3] - cur_src ) ;
-      const Real value = half_t * ( a - c + d - b ) ;
-      out( i , j ) = value ;
+      out[ j ] = src_row[ j ] + step( j , j - 1 , j + 1 ) ;
     }
   }
+  else
+  {
+    for( int j = 1 ; j < width - 1 ; ++j )
+    {
+      out[ j ] = step( j , j - 1 , j + 1 ) ;
+    }
+  }
+
+  if( width > 1 )
+  {
+    const Real last = step( width - 1 , width - 2 , width - 1 ) ;
+    out[ width - 1 ] = add_source ? src_row[ width - 1 ] + last : last ;
+  }
 }
 
 /**
-** Apply Fast Explicit Diffusion to an Image (on central part)
+** Apply one Fast Explicit Diffusion step to every rows of an Image
 ** @param src input image
 ** @param diff diffusion coefficient image
 ** @param half_t Half diffusion time
-** @param out Output image
+** @param add_source if true out = src + step, else out = step
+** @param out output image (must be allocated and different from src)
 **/
 template< typename Image >
-void ImageFEDCentralCPPThread( const Image & src , const Image & diff , const typename Image::Tpixel half_t , Image & out )
+void ImageFEDStep( const Image & src , const Image & diff , const typename Image::Tpixel half_t , const bool add_source , Image & out )
 {
-  const int nb_thread = omp_get_max_threads();
-
-  // Compute ranges
-  std::vector< int > range;
-  SplitRange( 1 , (int) ( src.rows() - 1 ) , nb_thread , range ) ;
+  const int width = src.Width() ;
+  const int height = src.Height() ;
 
-  #pragma omp parallel for schedule(dynamic)
-  for( int i = 1 ; i < static_cast<int>(range.size()) ; ++i )
+  #pragma omp parallel for
+  for( int i = 0 ; i < height ; ++i )
   {
-    ImageFEDCentral( src, diff, half_t, out, range[i-1] , range[i]) ;
+    const int i_up = std::max( i - 1 , 0 ) ;
+    const int i_down = std::min( i + 1 , height - 1 ) ;
+    FEDStepRow( &src( i_up , 0 ) , &src( i , 0 ) , &src( i_down , 0 ) ,
+                &diff( i_up , 0 ) , &diff( i , 0 ) , &diff( i_down , 0 ) ,
+                width , half_t , add_source , &out( i , 0 ) ) ;
   }
 }
 
@@ -127,99 +148,13 @@ void ImageFED( const Image & src , const Image & diff , const typename Image::Tp
   {
     out.resize( width , height ) ;
   }
-  Real n_diff[4] ;
-  Real n_src[4] ;
-
-  // Take care of the central part
-  ImageFEDCentralCPPThread( src , diff , half_t , out ) ;
-
-  // Take care of the border
-  // - first/last row
-  // - first/last col
-
-  // Compute FED step on first row
-  for( int j = 1 ; j < width - 1 ; ++j )
-  {
-    n_diff[0] = diff( 0 , j + 1 ) ;
-    n_diff[2] = diff( 0 , j - 1 ) ;
-    n_diff[3] = diff( 1 , j ) ;
-    n_src[0] = src( 0 , j + 1 ) ;
-    n_src[2] = src( 0 , j - 1 ) ;
-    n_src[3] = src( 1 , j ) ;
-
-    // Compute diffusion factor for given pixel
-    const Real cur_src = src( 0 , j ) ;
-    const Real cur_diff = diff( 0 , j ) ;
-    const Real a = ( cur_diff + n_diff[0] ) * ( n_src[0] - cur_src ) ;
-    const Real c = ( cur_diff + n_diff[2] ) * ( cur_src - n_src[2] ) ;
-    const Real d = ( cur_diff + n_diff[3] ) * ( n_src[3] - cur_src ) ;
-    const Real value = half_t * ( a - c + d ) ;
-    out( 0 , j ) = value ;
-  }
 
-  // Compute FED step on last row
-  for( int j = 1 ; j < width - 1 ; ++j )
-  {
-    n_diff[0] = diff( height - 1 , j + 1 ) ;
-    n_diff[1] = diff( height - 2 , j ) ;
-    n_diff[2] = diff( height - 1 , j - 1 ) ;
-    n_src[0] = src( height - 1 , j + 1 ) ;
-    n_src[1] = src( height - 2 , j ) ;
-    n_src[2] = src( height - 1 , j - 1 ) ;
-
-    // Compute diffusion factor for given pixel
-    const Real cur_src = src( height - 1 , j ) ;
-    const Real cur_diff = diff( height - 1 , j ) ;
-    const Real a = ( cur_diff + n_diff[0] ) * ( n_src[0] - cur_src ) ;
-    const Real b = ( cur_diff + n_diff[1] ) * ( cur_src - n_src[1] ) ;
-    const Real c = ( cur_diff + n_diff[2] ) * ( cur_src - n_src[2] ) ;
-    const Real value = half_t * ( a - c - b ) ;
-    out( height - 1 , j ) = value ;
-  }
-
-  // Compute FED step on first col
-  for( int i = 1 ; i < height - 1 ; ++i )
-  {
-    n_diff[0] = diff( i , 1 ) ;
-    n_diff[1] = diff( i - 1 , 0 ) ;
-    n_diff[3] = diff( i + 1 , 0 ) ;
-    n_src[0] = src( i , 1 ) ;
-    n_src[1] = src( i - 1 , 0 ) ;
-    n_src[3] = src( i + 1 , 0 ) ;
-
-    // Compute diffusion factor for given pixel
-    const Real cur_src = src( i , 0 ) ;
-    const Real cur_diff = diff( i , 0 ) ;
-    const Real a = ( cur_diff + n_diff[0] ) * ( n_src[0] - cur_src ) ;
-    const Real b = ( cur_diff + n_diff[1] ) * ( cur_src - n_src[1] ) ;
-    const Real d = ( cur_diff + n_diff[3] ) * ( n_src[3] - cur_src ) ;
-    const Real value = half_t * ( a + d - b ) ;
-    out( i , 0 ) = value ;
-  }
-
-  // Compute FED step on last col
-  for( int i = 1 ; i < height - 1 ; ++i )
-  {
-    n_diff[1] = diff( i - 1 , width - 1 ) ;
-    n_diff[2] = diff( i , width - 2 ) ;
-    n_diff[3] = diff( i + 1 , width - 1 ) ;
-    n_src[1] = src( i - 1 , width - 1 ) ;
-    n_src[2] = src( i , width - 2 ) ;
-    n_src[3] = src( i + 1 , width - 1 ) ;
-
-    // Compute diffusion factor for given pixel
-    const Real cur_src = src( i , width - 1 ) ;
-    const Real cur_diff = diff( i , width - 1 ) ;
-    const Real b = ( cur_diff + n_diff[1] ) * ( cur_src - n_src[1] ) ;
-    const Real c = ( cur_diff + n_diff[2] ) * ( cur_src - n_src[2] ) ;
-    const Real d = ( cur_diff + n_diff[3] ) * ( n_src[3] - cur_src ) ;
-    const Real value = half_t * ( - c + d - b ) ;
-    out( i , width - 1 ) = value ;
-  }
+  ImageFEDStep( src , diff , half_t , false , out ) ;
 }
 
 /**
  ** Compute Fast Explicit Diffusion cycle
+ ** Each step directly writes src + step in a second buffer, then the buffers are swapped.
  ** @param self input/output image
  ** @param diff diffusion coefficient
  ** @param tau cycle timing vector
@@ -227,11 +162,12 @@ void ImageFED( const Image & src , const Image & diff , const typename Image::Tp
 template< typename Image >
 void ImageFEDCycle( Image & self , const Image & diff , const std::vector< typename Image::Tpixel > & tau )
 {
-  Image tmp;
+  typedef typename Image::Tpixel Real ;
+  Image tmp( self.Width() , self.Height() ) ;
   for( int i = 0 ; i < tau.size() ; ++i )
   {
-    ImageFED( self , diff , tau[i] , tmp ) ;
-    self.array() += tmp.array();
+    ImageFEDStep( self , diff , tau[i] * static_cast<Real>( 0.5 ) , true , tmp ) ;
+    self.swap( tmp ) ;
   }
 }
 
@@ -6,8 +6,11 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include "aliceVision/image/all.hpp"
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
 
 #include <iostream>
+#include <random>
 
 #define BOOST_TEST_MODULE ImageFiltering
 
@@ -17,6 +20,53 @@
 using namespace aliceVision;
 using namespace aliceVision::image;
 
+namespace {
+
+/**
+ * @brief Straightforward double precision version of SeparableConvolution2d, with the same borders:
+ *        reflect101 vertically and on the left, the right border mirrors around cols - 2.
+ */
+RowMatrixXf referenceSeparableConvolution(const RowMatrixXf& image,
+                                          const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_x,
+                                          const Eigen::Matrix<float, 1, Eigen::Dynamic>& kernel_y)
+{
+  const int rows = image.rows();
+  const int cols = image.cols();
+  const int half_y = kernel_y.cols() / 2;
+  const int half_x = kernel_x.cols() / 2;
+
+  Eigen::MatrixXd vertical(rows, cols);
+  for(int row = 0; row < rows; ++row)
+    for(int col = 0; col < cols; ++col)
+    {
+      double sum = 0.0;
+      for(int j = 0; j < kernel_y.cols(); ++j)
+      {
+        int y = row - half_y + j;
+        y = (y < 0) ? -y : (y >= rows ? 2 * (rows - 1) - y : y);
+        sum += double(kernel_y(j)) * image(y, col);
+      }
+      vertical(row, col) = sum;
+    }
+
+  RowMatrixXf out(rows, cols);
+  for(int row = 0; row < rows; ++row)
+    for(int col = 0; col < cols; ++col)
+    {
+      double sum = 0.0;
+      for(int i = 0; i < kernel_x.cols(); ++i)
+      {
+        int x = col - half_x + i;
+        x = (x < 0) ? -x : (x >= cols ? 2 * cols - 3 - x : x);
+        sum += double(kernel_x(i)) * vertical(row, x);
+      }
+      out(row, col) = float(sum);
+    }
+  return out;
+}
+
+} // namespace
+
 BOOST_AUTO_TEST_CASE(Image_Convolution)
 {
   Image<unsigned char> in(250,250,true);
@@ -143,3 +193,150 @@ BOOST_AUTO_TEST_CASE(Image_Convolution_Sobel_X_Y)
   BOOST_CHECK_NO_THROW(writeImage("out_SobelY.png", outFilteredCast,
                                   image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION)));
 }
+
+BOOST_AUTO_TEST_CASE(Image_SeparableConvolution2d_Reference)
+{
+  std::default_random_engine generator;
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+  // Sizes not multiple of the SIMD width, dense and sparse (scaled Scharr like) kernels
+  for(const int width : {17, 64, 133})
+  {
+    for(const int height : {15, 47})
+    {
+      for(const int kernelSize : {3, 5, 9, 15})
+      {
+        RowMatrixXf image(height, width);
+        for(int i = 0; i < image.size(); ++i)
+          image.data()[i] = distribution(generator);
+
+        Eigen::Matrix<float, 1, Eigen::Dynamic> kernel_x(kernelSize);
+        Eigen::Matrix<float, 1, Eigen::Dynamic> kernel_y(kernelSize);
+        for(int i = 0; i < kernelSize; ++i)
+        {
+          kernel_x(i) = distribution(generator);
+          kernel_y(i) = (i % 2) ? 0.f : distribution(generator);
+        }
+
+        RowMatrixXf out(height, width);
+        SeparableConvolution2d(image, kernel_x, kernel_y, &out);
+        const RowMatrixXf expected = referenceSeparableConvolution(image, kernel_x, kernel_y);
+
+        BOOST_CHECK_SMALL((out - expected).cwiseAbs().maxCoeff(), 1e-5f);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Image_VerticalConvolution_Transpose)
+{
+  std::default_random_engine generator;
+  std::uniform_real_distribution<float> distribution(0.0f, 255.0f);
+
+  Image<float> in(71, 43);
+  for(int y = 0; y < in.Height(); ++y)
+    for(int x = 0; x < in.Width(); ++x)
+      in(y, x) = distribution(generator);
+  const Image<float> inTransposed(in.GetMat().transpose());
+
+  Vec kernel(7);
+  kernel << 0.1, -0.5, 0.3, 1.0, 0.3, -0.5, 0.1;
+
+  // Same borders (copied) and same arithmetic as the horizontal filter
+  Image<float> vertical, horizontal;
+  ImageVerticalConvolution(in, kernel, vertical);
+  ImageHorizontalConvolution(inTransposed, kernel, horizontal);
+
+  BOOST_REQUIRE_EQUAL(vertical.Width(), horizontal.Height());
+  BOOST_REQUIRE_EQUAL(vertical.Height(), horizontal.Width());
+  for(int y = 0; y < vertical.Height(); ++y)
+    for(int x = 0; x < vertical.Width(); ++x)
+      BOOST_CHECK_EQUAL(vertical(y, x), horizontal(x, y));
+}
+
+BOOST_AUTO_TEST_CASE(Image_VerticalConvolution_InPlace)
+{
+  std::default_random_engine generator;
+  std::uniform_real_distribution<float> distribution(0.0f, 255.0f);
+
+  Image<float> in(37, 29);
+  for(int y = 0; y < in.Height(); ++y)
+    for(int x = 0; x < in.Width(); ++x)
+      in(y, x) = distribution(generator);
+
+  Vec kernel(7);
+  kernel << 0.1, -0.5, 0.3, 1.0, 0.3, -0.5, 0.1;
+
+  Image<float> expected;
+  ImageVerticalConvolution(in, kernel, expected);
+
+  // The rows already written must not be read back as input
+  Image<float> inPlace = in;
+  ImageVerticalConvolution(inPlace, kernel, inPlace);
+
+  for(int y = 0; y < in.Height(); ++y)
+    for(int x = 0; x < in.Width(); ++x)
+      BOOST_CHECK_EQUAL(inPlace(y, x), expected(y, x));
+}
+
+BOOST_AUTO_TEST_CASE(Image_Convolution_Timing)
+{
+  std::default_random_engine generator;
+  std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+  Image<float> in(1920, 1080);
+  for(int y = 0; y < in.Height(); ++y)
+    for(int x = 0; x < in.Width(); ++x)
+      in(y, x) = distribution(generator);
+
+  const int repetitions = 5;
+  Image<float> out;
+  system::Timer timer;
+  for(int i = 0; i < repetitions; ++i)
+    ImageGaussianFilter(in, 1.6, out);
+  ALICEVISION_LOG_INFO("Gaussian filter: " << timer.elapsedMs() / repetitions << " ms");
+
+  for(const int scale : {1, 4})
+  {
+    timer.reset();
+    for(int i = 0; i < repetitions; ++i)
+      ImageScaledScharrXDerivative(in, out, scale);
+    ALICEVISION_LOG_INFO("Scaled Scharr X derivative (scale " << scale << "): " << timer.elapsedMs() / repetitions << " ms");
+  }
+
+  timer.reset();
+  for(int i = 0; i < repetitions; ++i)
+    ImageYDerivative(in, out);
+  ALICEVISION_LOG_INFO("Y derivative: " << timer.elapsedMs() / repetitions << " ms");
+
+  BOOST_CHECK_EQUAL(out.Width(), in.Width());
+  BOOST_CHECK_EQUAL(out.Height(), in.Height());
+}
+
+BOOST_AUTO_TEST_CASE(Image_FEDCycle_Conservation)
+{
+  std::default_random_engine generator;
+  std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+
+  Image<float> in(63, 37);
+  Image<float> diff(63, 37);
+  for(int y = 0; y < in.Height(); ++y)
+    for(int x = 0; x < in.Width(); ++x)
+    {
+      in(y, x) = distribution(generator);
+      diff(y, x) = distribution(generator);
+    }
+
+  // No flux goes through the borders (corners included): a step sums to zero and a cycle keeps the mean
+  Image<float> step;
+  ImageFED(in, diff, 0.2f, step);
+  BOOST_CHECK_SMALL(step.sum(), 1e-3f);
+
+  std::vector<float> tau;
+  FEDCycleTimings(2.f, 0.25f, tau);
+  Image<float> out = in;
+  ImageFEDCycle(out, diff, tau);
+
+  BOOST_CHECK_CLOSE(out.mean(), in.mean(), 1e-3);
+  BOOST_CHECK((out - in).cwiseAbs().maxCoeff() > 1e-3f);
+}
@@ -13,6 +13,7 @@
 #include <OpenImageIO/imagebuf.h>
 #include <OpenImageIO/imagebufalgo.h>
 #include <OpenImageIO/color.h>
+#include <OpenImageIO/fmath.h>
 
 #include <aliceVision/half.hpp>
 
@@ -20,6 +21,7 @@
 #include <boost/filesystem.hpp>
 
 #include <cstring>
+#include <functional>
 #include <stdexcept>
 #include <iostream>
 #include <cmath>
@@ -415,6 +417,195 @@ bool isRawFormat(const std::string& path)
 }
 
 
+template<typename C>
+inline C convertChannel(float value)
+{
+    return oiio::convert_type<float, C>(value);
+}
+
+template<>
+inline float convertChannel<float>(float value)
+{
+    return value;
+}
+
+/**
+ * @brief Write float pixels into the output storage in a single pass.
+ *        Reduce RGB to luminance, duplicate a gray channel or add an opaque alpha as requested,
+ *        and convert each channel to the storage type.
+ */
+template<typename C>
+void fuseChannels(const float* src, int srcChannels, C* dst, int nchannels, std::size_t nbPixels)
+{
+    // compute luminance via a weighted sum of R,G,B
+    // (assuming Rec709 primaries and a linear scale)
+    const float weights[3] = {.2126f, .7152f, .0722f}; // To be changed if not sRGB Rec 709 Linear.
+
+    #pragma omp parallel for
+    for (std::ptrdiff_t i = 0; i < std::ptrdiff_t(nbPixels); ++i)
+    {
+        const float* srcPixel = src + i * srcChannels;
+        C* dstPixel = dst + i * nchannels;
+
+        if (nchannels == 1)
+        {
+            // TODO: if srcChannels == 4: premult?
+            const float value = (srcChannels >= 3) ? weights[0] * srcPixel[0] + weights[1] * srcPixel[1] + weights[2] * srcPixel[2] : srcPixel[0];
+            dstPixel[0] = convertChannel<C>(value);
+            continue;
+        }
+
+        for (int c = 0; c < 3; ++c)
+        {
+            dstPixel[c] = convertChannel<C>(srcPixel[(srcChannels == 1) ? 0 : c]);
+        }
+
+        if (nchannels == 4)
+        {
+            dstPixel[3] = convertChannel<C>((srcChannels == 4) ? srcPixel[3] : 1.0f);
+        }
+    }
+}
+
+/**
+ * @brief Read a band of rows [ybegin, yend) of the current subimage, relative to its data window.
+ *        Tiled files are read by whole rows of tiles, then the requested rows are extracted.
+ */
+bool readRows(oiio::ImageInput& in, const oiio::ImageSpec& spec, int ybegin, int yend, std::vector<float>& rows)
+{
+    const std::size_t rowSize = std::size_t(spec.width) * spec.nchannels;
+    rows.resize(std::size_t(yend - ybegin) * rowSize);
+
+    if (spec.tile_width == 0)
+    {
+        return in.read_scanlines(spec.y + ybegin, spec.y + yend, spec.z, oiio::TypeDesc::FLOAT, rows.data());
+    }
+
+    const int tileBegin = (ybegin / spec.tile_height) * spec.tile_height;
+    const int tileEnd = std::min(spec.height, ((yend + spec.tile_height - 1) / spec.tile_height) * spec.tile_height);
+
+    std::vector<float> tiles(std::size_t(tileEnd - tileBegin) * rowSize);
+    if (!in.read_tiles(spec.x, spec.x + spec.width, spec.y + tileBegin, spec.y + tileEnd, spec.z, spec.z + std::max(1, spec.depth),
+                       oiio::TypeDesc::FLOAT, tiles.data()))
+    {
+        return false;
+    }
+
+    std::copy(tiles.begin() + std::size_t(ybegin - tileBegin) * rowSize,
+              tiles.begin() + std::size_t(yend - tileBegin) * rowSize,
+              rows.begin());
+
+    return true;
+}
+
+/**
+ * @brief Decode a region of the image with an integer downscale, without allocating the full frame.
+ *        A mip level of the right size is used when the file provides one,
+ *        otherwise the rows are streamed by bands and decimated with a box filter.
+ *        Each band is given to processRows (color conversion) before the decimation,
+ *        so that the pixels are averaged in the working color space.
+ * @note The output pixel (x, y) is the mean of the input pixels [x * downscale, (x + 1) * downscale) in each dimension,
+ *       so the output size is floor(roi / downscale) and the last roi % downscale rows and columns are dropped.
+ *       This exactly matches the downscaled camera intrinsics of MultiViewParams (unlike a resize to the same size).
+ * @param[in] in opened image input
+ * @param[in] roi region to read, relative to the data window of the first mip level
+ * @param[in] downscale integer downscale factor
+ * @param[in] processRows in place processing of a band of decoded rows
+ * @param[out] buffer float buffer with the file channels, of size roi / downscale
+ */
+void readImageRegion(oiio::ImageInput& in, const std::string& path, oiio::ROI roi, int downscale,
+                     const std::function<void(oiio::ImageBuf&)>& processRows, oiio::ImageBuf& buffer)
+{
+    oiio::ImageSpec spec = in.spec();
+
+    // Use a reduced resolution stored in the file if one matches the downscale
+    if (downscale > 1 && roi.xbegin % downscale == 0 && roi.ybegin % downscale == 0)
+    {
+        const int fullWidth = spec.width;
+        const int fullHeight = spec.height;
+        oiio::ImageSpec mipSpec;
+        for (int level = 1; in.seek_subimage(0, level, mipSpec); ++level)
+        {
+            if (mipSpec.width == fullWidth / downscale && mipSpec.height == fullHeight / downscale)
+            {
+                ALICEVISION_LOG_TRACE("Read mip level " << level << " of image " << path << ".");
+                spec = mipSpec;
+                roi = oiio::ROI(roi.xbegin / downscale, roi.xend / downscale, roi.ybegin / downscale, roi.yend / downscale);
+                downscale = 1;
+                break;
+            }
+        }
+        if (downscale > 1)
+        {
+            in.seek_subimage(0, 0, spec);
+        }
+    }
+
+    const int outWidth = roi.width() / downscale;
+    const int outHeight = roi.height() / downscale;
+    const int nchannels = spec.nchannels;
+
+    if (outWidth <= 0 || outHeight <= 0)
+        ALICEVISION_THROW_ERROR("Empty region requested in image file '" << path << "'.");
+
+    oiio::ImageBuf decodeBuf(oiio::ImageSpec(outWidth, outHeight, nchannels, oiio::TypeDesc::FLOAT));
+    buffer.swap(decodeBuf);
+    float* pixels = static_cast<float*>(buffer.localpixels());
+
+    // Bands of whole output rows, covering at least a row of tiles
+    const int bandOutRows = std::max(1, (std::max(64, spec.tile_height) + downscale - 1) / downscale);
+    const float normalization = 1.0f / float(downscale * downscale);
+    const std::size_t rowSize = std::size_t(spec.width) * nchannels;
+    std::vector<float> rows;
+
+    for (int outBegin = 0; outBegin < outHeight; outBegin += bandOutRows)
+    {
+        const int outEnd = std::min(outHeight, outBegin + bandOutRows);
+        const int ybegin = roi.ybegin + outBegin * downscale;
+
+        const int yend = roi.ybegin + outEnd * downscale;
+
+        if (!readRows(in, spec, ybegin, yend, rows))
+            ALICEVISION_THROW_ERROR("Failed to read the image file: '" << path << "' (" << in.geterror() << ").");
+
+        {
+            oiio::ImageBuf rowsBuf(oiio::ImageSpec(spec.width, yend - ybegin, nchannels, oiio::TypeDesc::FLOAT), rows.data());
+            processRows(rowsBuf);
+        }
+
+        #pragma omp parallel for
+        for (int oy = outBegin; oy < outEnd; ++oy)
+        {
+            float* outRow = pixels + std::size_t(oy) * outWidth * nchannels;
+            std::fill(outRow, outRow + std::size_t(outWidth) * nchannels, 0.0f);
+
+            for (int dy = 0; dy < downscale; ++dy)
+            {
+                const float* inRow = rows.data() + std::size_t(roi.ybegin + oy * downscale + dy - ybegin) * rowSize;
+
+                for (int ox = 0; ox < outWidth; ++ox)
+                {
+                    const float* inPixel = inRow + std::size_t(roi.xbegin + ox * downscale) * nchannels;
+                    float* outPixel = outRow + std::size_t(ox) * nchannels;
+
+                    for (int i = 0; i < downscale * nchannels; ++i)
+                    {
+                        outPixel[i % nchannels] += inPixel[i];
+                    }
+                }
+            }
+
+            if (downscale > 1)
+            {
+                for (std::size_t i = 0; i < std::size_t(outWidth) * nchannels; ++i)
+                {
+                    outRow[i] *= normalization;
+                }
+            }
+        }
+    }
+}
+
 template<typename T>
 void readImage(const std::string& path,
                oiio::TypeDesc format,
@@ -507,28 +698,47 @@ void readImage(const std::string& path,
         }
     }
 
-    oiio::ImageBuf inBuf(path, 0, 0, NULL, &configSpec);
-
-    inBuf.read(0, 0, true, oiio::TypeDesc::FLOAT); // force image convertion to float (for grayscale and color space convertion)
+    std::unique_ptr<oiio::ImageInput> in(oiio::ImageInput::open(path, &configSpec));
 
-    if(!inBuf.initialized())
+    if(!in)
         ALICEVISION_THROW_ERROR("Failed to open the image file: '" << path << "'.");
 
+    const oiio::ImageSpec fileSpec = in->spec();
+    const int fileChannels = fileSpec.nchannels;
+
     // check picture channels number
-    if (inBuf.spec().nchannels == 0)
+    if (fileChannels == 0)
         ALICEVISION_THROW_ERROR("No channel in the input image file: '" + path + "'.");
-    if (inBuf.spec().nchannels == 2)
+    if (fileChannels == 2)
         ALICEVISION_THROW_ERROR("Load of 2 channels is not supported. Image file: '" + path + "'.");
 
+    // Region to decode, relative to the data window
+    oiio::ROI readROI(0, fileSpec.width, 0, fileSpec.height);
+    if (imageReadOptions.subROI.defined())
+    {
+        readROI = oiio::ROI(std::max(0, imageReadOptions.subROI.xbegin), std::min(fileSpec.width, imageReadOptions.subROI.xend),
+                            std::max(0, imageReadOptions.subROI.ybegin), std::min(fileSpec.height, imageReadOptions.subROI.yend));
+    }
+    const int downscale = std::max(1, imageReadOptions.downscale);
+    const bool fullFrame = (downscale == 1) && (readROI.width() == fileSpec.width) && (readROI.height() == fileSpec.height);
+
+    // Pixels are decoded as float (for grayscale and color space convertion).
+    // If the output image stores float with the same channels (or only an extra alpha), decode directly into it.
+    const bool decodeInPlace = fullFrame && (format == oiio::TypeDesc::FLOAT) &&
+                               (fileChannels == nchannels || (nchannels == 4 && fileChannels == 3));
+
     // Apply DCP profile
-    if (!imageReadOptions.colorProfileFileName.empty() &&
-        imageReadOptions.rawColorInterpretation == ERawColorInterpretation::DcpLinearProcessing)
+    const bool applyDcp = !imageReadOptions.colorProfileFileName.empty() &&
+                          imageReadOptions.rawColorInterpretation == ERawColorInterpretation::DcpLinearProcessing;
+    std::shared_ptr<const image::DCPProfile> dcpProfile;
+    image::DCPProfile::Triple neutral;
+    if (applyDcp)
     {
-        image::DCPProfile dcpProfile(imageReadOptions.colorProfileFileName);
+        // Profiles are parsed once per process and shared by all the images of the same camera
+        dcpProfile = image::getSharedDCPProfile(imageReadOptions.colorProfileFileName);
 
-        oiio::ParamValueList imgMetadata = readImageMetadata(path);
         std::string cam_mul = "";
-        if (!imgMetadata.getattribute("raw:cam_mul", cam_mul))
+        if (!fileSpec.extra_attribs.getattribute("raw:cam_mul", cam_mul))
         {
             cam_mul = "{1024, 1024, 1024, 1024}";
             ALICEVISION_LOG_WARNING("[readImage]: cam_mul metadata not availbale, the openImageIO version might be too old (>= 2.4.5.0 requested for dcp management).");
@@ -544,15 +754,12 @@ void readImage(const std::string& path,
         }
         v_mult.push_back(std::stof(cam_mul.substr(last, cam_mul.find("}", last) - last)));
 
-        image::DCPProfile::Triple neutral;
         for (int i = 0; i < 3; i++)
         {
             neutral[i] = v_mult[1] / v_mult[i];
         }
 
         ALICEVISION_LOG_TRACE("Apply DCP Linear processing with neutral = {" << neutral[0] << ", " << neutral[1] << ", " << neutral[2] << "}");
-
-        dcpProfile.applyLinear(inBuf, neutral, true);
     }
 
     // color conversion
@@ -562,90 +769,110 @@ void readImage(const std::string& path,
     // Get color space name. Default image color space is sRGB
     const std::string fromColorSpaceName = (isRawImage && imageReadOptions.rawColorInterpretation == ERawColorInterpretation::DcpLinearProcessing) ? "aces2065-1" :
                                             (isRawImage ? "linear" :
-                                             inBuf.spec().get_string_attribute("aliceVision:ColorSpace", inBuf.spec().get_string_attribute("oiio:ColorSpace", "sRGB")));
+                                             fileSpec.get_string_attribute("aliceVision:ColorSpace", fileSpec.get_string_attribute("oiio:ColorSpace", "sRGB")));
 
     ALICEVISION_LOG_TRACE("Read image " << path << " (encoded in " << fromColorSpaceName << " colorspace).");
-  
-    if ((imageReadOptions.workingColorSpace == EImageColorSpace::NO_CONVERSION) ||
-        (imageReadOptions.workingColorSpace == EImageColorSpace_stringToEnum(fromColorSpaceName)))
-    {
-        // Do nothing. Note that calling imageAlgo::colorconvert() will copy the source buffer
-        // even if no conversion is needed.
-    }
-    else if ((imageReadOptions.workingColorSpace == EImageColorSpace::ACES2065_1) || (imageReadOptions.workingColorSpace == EImageColorSpace::ACEScg) ||
-             (EImageColorSpace_stringToEnum(fromColorSpaceName) == EImageColorSpace::ACES2065_1) || (EImageColorSpace_stringToEnum(fromColorSpaceName) == EImageColorSpace::ACEScg))
+
+    const bool needConversion = (imageReadOptions.workingColorSpace != EImageColorSpace::NO_CONVERSION) &&
+                                (imageReadOptions.workingColorSpace != EImageColorSpace_stringToEnum(fromColorSpaceName));
+    std::unique_ptr<oiio::ColorConfig> acesColorConfig;
+    if (needConversion &&
+        ((imageReadOptions.workingColorSpace == EImageColorSpace::ACES2065_1) || (imageReadOptions.workingColorSpace == EImageColorSpace::ACEScg) ||
+         (EImageColorSpace_stringToEnum(fromColorSpaceName) == EImageColorSpace::ACES2065_1) || (EImageColorSpace_stringToEnum(fromColorSpaceName) == EImageColorSpace::ACEScg)))
     {
         const auto colorConfigPath = getAliceVisionOCIOConfig();
         if (colorConfigPath.empty())
         {
             throw std::runtime_error("ALICEVISION_ROOT is not defined, OCIO config file cannot be accessed.");
         }
-        oiio::ImageBuf colorspaceBuf;
-        oiio::ColorConfig colorConfig(colorConfigPath);
-        oiio::ImageBufAlgo::colorconvert(colorspaceBuf, inBuf,
-            fromColorSpaceName,
-            EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace), true, "", "",
-            &colorConfig);
-        inBuf = colorspaceBuf;
+        acesColorConfig.reset(new oiio::ColorConfig(colorConfigPath));
+    }
+
+    // DCP profile and color conversion of decoded pixels, done in place without any intermediate buffer.
+    // It is applied before any downscale so that the pixels are filtered in the working color space.
+    const auto processPixels = [&](oiio::ImageBuf& buf) {
+        if (applyDcp)
+        {
+            dcpProfile->applyLinear(buf, neutral, true);
+        }
+
+        if (!needConversion)
+        {
+            // Do nothing.
+        }
+        else if (acesColorConfig)
+        {
+            oiio::ImageBufAlgo::colorconvert(buf, buf,
+                fromColorSpaceName,
+                EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace), true, "", "",
+                acesColorConfig.get());
+        }
+        else
+        {
+            oiio::ImageBufAlgo::colorconvert(buf, buf, fromColorSpaceName, EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace));
+        }
+    };
+
+    oiio::ImageBuf inBuf;
+    float* pixels = nullptr;
+    if (!fullFrame)
+    {
+        readImageRegion(*in, path, readROI, downscale, processPixels, inBuf);
+        pixels = static_cast<float*>(inBuf.localpixels());
     }
     else
     {
-        oiio::ImageBuf colorspaceBuf;
-        oiio::ImageBufAlgo::colorconvert(colorspaceBuf, inBuf, fromColorSpaceName, EImageColorSpace_enumToOIIOString(imageReadOptions.workingColorSpace));
-        inBuf = colorspaceBuf;
+        if (decodeInPlace)
+        {
+            image.resize(fileSpec.width, fileSpec.height, false);
+            getBufferFromImage(image, format, nchannels, inBuf);
+        }
+        else
+        {
+            oiio::ImageBuf decodeBuf(oiio::ImageSpec(fileSpec.width, fileSpec.height, fileChannels, oiio::TypeDesc::FLOAT));
+            inBuf.swap(decodeBuf);
+        }
+
+        pixels = static_cast<float*>(inBuf.localpixels());
+        if (!in->read_image(oiio::TypeDesc::FLOAT, pixels, inBuf.spec().nchannels * sizeof(float)))
+            ALICEVISION_THROW_ERROR("Failed to read the image file: '" << path << "' (" << in->geterror() << ").");
+
+        // The opaque alpha must be set before the color conversion, which unpremultiplies
+        if (decodeInPlace && nchannels == 4 && fileChannels == 3)
+        {
+            const std::size_t nbPixels = std::size_t(fileSpec.width) * std::size_t(fileSpec.height);
+            #pragma omp parallel for
+            for (std::ptrdiff_t i = 0; i < std::ptrdiff_t(nbPixels); ++i)
+            {
+                pixels[4 * i + 3] = 1.0f;
+            }
+        }
+
+        processPixels(inBuf);
     }
+    in->close();
 
-    // convert to grayscale if needed
-    if(nchannels == 1 && inBuf.spec().nchannels >= 3)
+    if (decodeInPlace)
     {
-        // convertion region of interest (for inBuf.spec().nchannels > 3)
-        oiio::ROI convertionROI = inBuf.roi();
-        convertionROI.chbegin = 0;
-        convertionROI.chend = 3;
-
-        // compute luminance via a weighted sum of R,G,B
-        // (assuming Rec709 primaries and a linear scale)
-        const float weights[3] = {.2126f, .7152f, .0722f}; // To be changed if not sRGB Rec 709 Linear.
-        oiio::ImageBuf grayscaleBuf;
-        oiio::ImageBufAlgo::channel_sum(grayscaleBuf, inBuf, weights, convertionROI);
-        inBuf.copy(grayscaleBuf);
-
-        // TODO: if inBuf.spec().nchannels == 4: premult?
+        return;
     }
 
-    // duplicate first channel for RGB
-    if (nchannels >= 3 && inBuf.spec().nchannels == 1)
+    // Single pass from the decoded pixels to the output storage:
+    // grayscale reduction, channel duplication or alpha completion, then type convertion.
+    image.resize(inBuf.spec().width, inBuf.spec().height, false);
+    const std::size_t nbPixels = std::size_t(inBuf.spec().width) * std::size_t(inBuf.spec().height);
+
+    if (format == oiio::TypeDesc::FLOAT)
     {
-        oiio::ImageSpec requestedSpec(inBuf.spec().width, inBuf.spec().height, 3, format);
-        oiio::ImageBuf requestedBuf(requestedSpec);
-        int channelOrder[] = { 0, 0, 0 };
-        float channelValues[] = { 0 /*ignore*/, 0 /*ignore*/, 0 /*ignore*/ };
-        oiio::ImageBufAlgo::channels(requestedBuf, inBuf, 3, channelOrder, channelValues);
-        inBuf.swap(requestedBuf);
+        fuseChannels(pixels, fileChannels, reinterpret_cast<float*>(image.data()), nchannels, nbPixels);
     }
-
-    // Add an alpha channel if needed
-    if (nchannels == 4 && inBuf.spec().nchannels == 3)
+    else if (format == oiio::TypeDesc::UINT8)
     {
-        oiio::ImageSpec requestedSpec(inBuf.spec().width, inBuf.spec().height, 3, format);
-        oiio::ImageBuf requestedBuf(requestedSpec);
-        int channelOrder[] = { 0, 1, 2, -1 /*constant value*/ };
-        float channelValues[] = { 0 /*ignore*/, 0 /*ignore*/, 0 /*ignore*/, 1.0 };
-        oiio::ImageBufAlgo::channels(requestedBuf, inBuf,
-                                        4, // create an image with 4 channels
-                                        channelOrder,
-                                        channelValues); // only the 4th value is used
-        inBuf.swap(requestedBuf);
+        fuseChannels(pixels, fileChannels, reinterpret_cast<unsigned char*>(image.data()), nchannels, nbPixels);
     }
-
-    // copy pixels from oiio to eigen
-    image.resize(inBuf.spec().width, inBuf.spec().height, false);
+    else
     {
-        oiio::ROI exportROI = inBuf.roi();
-        exportROI.chbegin = 0;
-        exportROI.chend = nchannels;
-
-        inBuf.get_pixels(exportROI, format, image.data());
+        ALICEVISION_THROW_ERROR("[image] readImage: unsupported output pixel format for image file '" + path + "'.");
     }
 }
 
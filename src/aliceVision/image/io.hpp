@@ -195,6 +195,10 @@ struct ImageReadOptions
     //ROI for this image.
     //If the image contains an roi, this is the roi INSIDE the roi.
     oiio::ROI subROI;
+
+    //Integer downscale factor applied while decoding (box filter), the output size is subROI size / downscale.
+    //A matching mip level of the file is used if available, otherwise the full frame is never allocated.
+    int downscale = 1;
 };
 
 /**
@@ -6,6 +6,7 @@
 // You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
 #include "aliceVision/image/all.hpp"
 
 #define BOOST_TEST_MODULE imageIO
@@ -13,6 +14,9 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/tools/floating_point_comparison.hpp>
 
+#include <OpenImageIO/imagebuf.h>
+#include <OpenImageIO/imagebufalgo.h>
+
 #include <cstdio>
 #include <iostream>
 #include <vector>
@@ -263,3 +267,252 @@ BOOST_AUTO_TEST_CASE(read_write_from_grayscale_to_rgb) {
     remove(filename.c_str());
   }
 }
+
+template <typename T>
+double readImageTiming(const std::string& filename, Image<T>& image, int repetitions)
+{
+  system::Timer timer;
+  for(int i = 0; i < repetitions; ++i)
+  {
+    readImage(filename, image, image::EImageColorSpace::NO_CONVERSION);
+  }
+  return timer.elapsedMs() / repetitions;
+}
+
+BOOST_AUTO_TEST_CASE(read_all_pixel_types) {
+  // Large enough to time the read of each pixel type
+  const int width = 1024;
+  const int height = 768;
+  const int repetitions = 5;
+
+  Image<RGBfColor> imageRGB(width, height);
+  for(int y = 0; y < height; ++y)
+    for(int x = 0; x < width; ++x)
+      imageRGB(y, x) = RGBfColor(float(x) / width, float(y) / height, 0.5f);
+
+  const std::string filename = "test_read_all_pixel_types.exr";
+  BOOST_REQUIRE_NO_THROW(writeImage(filename, imageRGB,
+                                    image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION)));
+
+  const int y = 300;
+  const int x = 700;
+  const RGBfColor& expected = imageRGB(y, x);
+  const float expectedLuminance = 0.2126f * expected.r() + 0.7152f * expected.g() + 0.0722f * expected.b();
+
+  // Same layout as the file: decoded in place
+  Image<RGBfColor> readRGBf;
+  ALICEVISION_LOG_INFO("Read RGBfColor: " << readImageTiming(filename, readRGBf, repetitions) << " ms");
+  BOOST_CHECK_EQUAL(readRGBf.Width(), width);
+  BOOST_CHECK_EQUAL(readRGBf.Height(), height);
+  BOOST_CHECK_SMALL(readRGBf(y, x).r() - expected.r(), 1e-3f);
+  BOOST_CHECK_SMALL(readRGBf(y, x).g() - expected.g(), 1e-3f);
+  BOOST_CHECK_SMALL(readRGBf(y, x).b() - expected.b(), 1e-3f);
+
+  // Decoded in place, then completed with an opaque alpha
+  Image<RGBAfColor> readRGBAf;
+  ALICEVISION_LOG_INFO("Read RGBAfColor: " << readImageTiming(filename, readRGBAf, repetitions) << " ms");
+  BOOST_CHECK_SMALL(readRGBAf(y, x).r() - expected.r(), 1e-3f);
+  BOOST_CHECK_SMALL(readRGBAf(y, x).b() - expected.b(), 1e-3f);
+  BOOST_CHECK_EQUAL(readRGBAf(y, x).a(), 1.0f);
+
+  Image<float> readGray;
+  ALICEVISION_LOG_INFO("Read float: " << readImageTiming(filename, readGray, repetitions) << " ms");
+  BOOST_CHECK_SMALL(readGray(y, x) - expectedLuminance, 1e-3f);
+
+  Image<RGBColor> readRGB;
+  ALICEVISION_LOG_INFO("Read RGBColor: " << readImageTiming(filename, readRGB, repetitions) << " ms");
+  BOOST_CHECK_LE(std::abs(int(readRGB(y, x).r()) - int(std::round(expected.r() * 255.f))), 1);
+  BOOST_CHECK_LE(std::abs(int(readRGB(y, x).b()) - int(std::round(expected.b() * 255.f))), 1);
+
+  Image<RGBAColor> readRGBA;
+  ALICEVISION_LOG_INFO("Read RGBAColor: " << readImageTiming(filename, readRGBA, repetitions) << " ms");
+  BOOST_CHECK_LE(std::abs(int(readRGBA(y, x).g()) - int(std::round(expected.g() * 255.f))), 1);
+  BOOST_CHECK_EQUAL(int(readRGBA(y, x).a()), 255);
+
+  Image<unsigned char> readGrayUChar;
+  ALICEVISION_LOG_INFO("Read unsigned char: " << readImageTiming(filename, readGrayUChar, repetitions) << " ms");
+  BOOST_CHECK_LE(std::abs(int(readGrayUChar(y, x)) - int(std::round(expectedLuminance * 255.f))), 1);
+
+  remove(filename.c_str());
+}
+
+namespace {
+
+/// Box filtered reference of the block [x * downscale, (x + 1) * downscale) x [y * downscale, (y + 1) * downscale) from (left, top)
+RGBfColor blockMean(const Image<RGBfColor>& image, int left, int top, int downscale, int x, int y)
+{
+  RGBfColor sum(0.f, 0.f, 0.f);
+  for(int dy = 0; dy < downscale; ++dy)
+    for(int dx = 0; dx < downscale; ++dx)
+      sum = sum + image(top + y * downscale + dy, left + x * downscale + dx);
+  return sum / float(downscale * downscale);
+}
+
+Image<RGBfColor> createGradientImage(int width, int height)
+{
+  Image<RGBfColor> image(width, height);
+  for(int y = 0; y < height; ++y)
+    for(int x = 0; x < width; ++x)
+      image(y, x) = RGBfColor(float(x) / width, float(y) / height, float((x * 7 + y * 13) % 17) / 17.f);
+  return image;
+}
+
+void checkBoxDownscale(const Image<RGBfColor>& reference, const Image<RGBfColor>& read, int left, int top, int downscale, float tolerance)
+{
+  for(int y = 0; y < read.Height(); ++y)
+  {
+    for(int x = 0; x < read.Width(); ++x)
+    {
+      const RGBfColor expected = blockMean(reference, left, top, downscale, x, y);
+      BOOST_CHECK_SMALL(read(y, x).r() - expected.r(), tolerance);
+      BOOST_CHECK_SMALL(read(y, x).g() - expected.g(), tolerance);
+      BOOST_CHECK_SMALL(read(y, x).b() - expected.b(), tolerance);
+    }
+  }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(read_downscale) {
+  // Dimensions which are not a multiple of the downscale
+  const int width = 37;
+  const int height = 23;
+  const Image<RGBfColor> image = createGradientImage(width, height);
+
+  const std::string filename = "test_read_downscale.exr";
+  BOOST_REQUIRE_NO_THROW(writeImage(filename, image,
+                                    image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION)
+                                                              .storageDataType(image::EStorageDataType::Float)));
+
+  for(int downscale : {1, 2, 3, 4})
+  {
+    image::ImageReadOptions options(image::EImageColorSpace::NO_CONVERSION);
+    options.downscale = downscale;
+
+    Image<RGBfColor> read;
+    BOOST_REQUIRE_NO_THROW(readImage(filename, read, options));
+
+    // Same size as imageAlgo::resizeImage and MultiViewParams::getWidth/getHeight, the last pixels are dropped
+    BOOST_CHECK_EQUAL(read.Width(), width / downscale);
+    BOOST_CHECK_EQUAL(read.Height(), height / downscale);
+    checkBoxDownscale(image, read, 0, 0, downscale, 1e-5f);
+  }
+
+  remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(read_roi) {
+  const int width = 41;
+  const int height = 29;
+  const Image<RGBfColor> image = createGradientImage(width, height);
+
+  const std::string filename = "test_read_roi.exr";
+  BOOST_REQUIRE_NO_THROW(writeImage(filename, image,
+                                    image::ImageWriteOptions().toColorSpace(image::EImageColorSpace::NO_CONVERSION)
+                                                              .storageDataType(image::EStorageDataType::Float)));
+
+  // Region without downscale
+  {
+    const oiio::ROI roi(5, 21, 3, 17);
+    Image<RGBfColor> read;
+    BOOST_REQUIRE_NO_THROW(readImage(filename, read, image::ImageReadOptions(image::EImageColorSpace::NO_CONVERSION,
+                                                                             image::ERawColorInterpretation::LibRawWhiteBalancing, "", roi)));
+    BOOST_CHECK_EQUAL(read.Width(), 16);
+    BOOST_CHECK_EQUAL(read.Height(), 14);
+    checkBoxDownscale(image, read, 5, 3, 1, 1e-5f);
+  }
+
+  // Region and downscale, with a region size which is not a multiple of the downscale
+  {
+    const oiio::ROI roi(7, 30, 2, 27);
+    image::ImageReadOptions options(image::EImageColorSpace::NO_CONVERSION,
+                                    image::ERawColorInterpretation::LibRawWhiteBalancing, "", roi);
+    options.downscale = 3;
+    Image<RGBfColor> read;
+    BOOST_REQUIRE_NO_THROW(readImage(filename, read, options));
+    BOOST_CHECK_EQUAL(read.Width(), 23 / 3);
+    BOOST_CHECK_EQUAL(read.Height(), 25 / 3);
+    checkBoxDownscale(image, read, 7, 2, 3, 1e-5f);
+  }
+
+  // Region clamped to the image
+  {
+    const oiio::ROI roi(30, 60, 20, 40);
+    Image<RGBfColor> read;
+    BOOST_REQUIRE_NO_THROW(readImage(filename, read, image::ImageReadOptions(image::EImageColorSpace::NO_CONVERSION,
+                                                                             image::ERawColorInterpretation::LibRawWhiteBalancing, "", roi)));
+    BOOST_CHECK_EQUAL(read.Width(), width - 30);
+    BOOST_CHECK_EQUAL(read.Height(), height - 20);
+    checkBoxDownscale(image, read, 30, 20, 1, 1e-5f);
+  }
+
+  remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(read_downscale_working_colorspace) {
+  const int width = 30;
+  const int height = 20;
+  const Image<RGBfColor> image = createGradientImage(width, height);
+
+  // Stored in sRGB, the pixels must be averaged once converted to the working color space
+  const std::string filename = "test_read_downscale_colorspace.exr";
+  BOOST_REQUIRE_NO_THROW(writeImage(filename, image,
+                                    image::ImageWriteOptions().fromColorSpace(image::EImageColorSpace::LINEAR)
+                                                              .toColorSpace(image::EImageColorSpace::SRGB)
+                                                              .storageDataType(image::EStorageDataType::Float)));
+
+  Image<RGBfColor> readFull;
+  BOOST_REQUIRE_NO_THROW(readImage(filename, readFull, image::EImageColorSpace::LINEAR));
+
+  image::ImageReadOptions options(image::EImageColorSpace::LINEAR);
+  options.downscale = 2;
+  Image<RGBfColor> read;
+  BOOST_REQUIRE_NO_THROW(readImage(filename, read, options));
+  BOOST_CHECK_EQUAL(read.Width(), width / 2);
+  BOOST_CHECK_EQUAL(read.Height(), height / 2);
+  checkBoxDownscale(readFull, read, 0, 0, 2, 1e-4f);
+
+  remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(read_downscale_mip_level) {
+  const int width = 64;
+  const int height = 48;
+  const Image<RGBfColor> image = createGradientImage(width, height);
+
+  // Tiled file with mip levels, filtered with a 2x2 box
+  const std::string filename = "test_read_downscale_mip.exr";
+  {
+    const oiio::ImageBuf inBuf(oiio::ImageSpec(width, height, 3, oiio::TypeDesc::FLOAT), const_cast<RGBfColor*>(image.data()));
+    oiio::ImageSpec config;
+    config.attribute("maketx:filtername", "box");
+    config.attribute("maketx:fixnan", "none");
+    BOOST_REQUIRE(oiio::ImageBufAlgo::make_texture(oiio::ImageBufAlgo::MakeTxTexture, inBuf, filename, config));
+  }
+
+  for(int downscale : {2, 4})
+  {
+    image::ImageReadOptions options(image::EImageColorSpace::NO_CONVERSION);
+    options.downscale = downscale;
+    Image<RGBfColor> read;
+    BOOST_REQUIRE_NO_THROW(readImage(filename, read, options));
+    BOOST_CHECK_EQUAL(read.Width(), width / downscale);
+    BOOST_CHECK_EQUAL(read.Height(), height / downscale);
+    checkBoxDownscale(image, read, 0, 0, downscale, 1e-3f);
+  }
+
+  // Region aligned on the mip level
+  {
+    const oiio::ROI roi(8, 40, 4, 36);
+    image::ImageReadOptions options(image::EImageColorSpace::NO_CONVERSION,
+                                    image::ERawColorInterpretation::LibRawWhiteBalancing, "", roi);
+    options.downscale = 2;
+    Image<RGBfColor> read;
+    BOOST_REQUIRE_NO_THROW(readImage(filename, read, options));
+    BOOST_CHECK_EQUAL(read.Width(), 16);
+    BOOST_CHECK_EQUAL(read.Height(), 16);
+    checkBoxDownscale(image, read, 8, 4, 2, 1e-3f);
+  }
+
+  remove(filename.c_str());
+}
@@ -6,6 +6,7 @@
 
 #include "Mesh.hpp"
 #include <aliceVision/system/Logger.hpp>
+#include <aliceVision/mesh/meshIO.hpp>
 #include <aliceVision/mesh/meshVisibility.hpp>
 #include <aliceVision/mvsData/geometry.hpp>
 #include <aliceVision/mvsData/OrientedPoint.hpp>
@@ -51,6 +52,8 @@ std::string EFileType_enumToString(const EFileType meshFileType)
             return "stl";
         case EFileType::GLTF:
             return "gltf";
+        case EFileType::PLY:
+            return "ply";
     }
     throw std::out_of_range("Unrecognized EMeshFileType");
 }
@@ -68,6 +71,8 @@ EFileType EFileType_stringToEnum(const std::string& meshFileType)
         return EFileType::STL;
     if(m == "gltf")
         return EFileType::GLTF;
+    if(m == "ply")
+        return EFileType::PLY;
     throw std::out_of_range("Invalid mesh file type " + meshFileType);
 }
 
@@ -90,6 +95,20 @@ void Mesh::save(const std::string& filepath)
 
     ALICEVISION_LOG_INFO("Save " << fileTypeStr << " mesh file");
 
+    // native writers, without intermediate Assimp scene
+    if(fileType == EFileType::PLY || fileType == EFileType::OBJ)
+    {
+        if(fileType == EFileType::PLY)
+            saveMeshAsPly(*this, filepath);
+        else
+            saveMeshAsObj(*this, filepath);
+
+        ALICEVISION_LOG_INFO("Save mesh to " << fileTypeStr << " done.");
+        ALICEVISION_LOG_DEBUG("Vertices: " << pts.size());
+        ALICEVISION_LOG_DEBUG("Triangles: " << tris.size());
+        return;
+    }
+
     aiScene scene;
 
     scene.mRootNode = new aiNode;
@@ -145,11 +164,6 @@ void Mesh::save(const std::string& filepath)
         // but cause problems with assimp importer
         pPreprocessing |= aiProcess_GenNormals;
     }
-    // If obj, do not use material
-    else if (fileType == EFileType::OBJ)
-    {
-        formatId = "objnomtl";
-    }
 
     Assimp::Exporter exporter;
     exporter.Export(&scene, formatId, filepath, pPreprocessing);
@@ -164,49 +178,14 @@ void Mesh::save(const std::string& filepath)
 
 bool Mesh::loadFromBin(const std::string& binFilepath)
 {
-    FILE* f = fopen(binFilepath.c_str(), "rb");
-
-    if(f == nullptr)
-        return false;
-
-    int npts;
-    fread(&npts, sizeof(int), 1, f);
-    pts = StaticVector<Point3d>();
-    pts.resize(npts);
-    fread(&pts[0], sizeof(Point3d), npts, f);
-
-    int ntris;
-    fread(&ntris, sizeof(int), 1, f);
-    tris = StaticVector<Mesh::triangle>();
-    tris.resize(ntris);
-    fread(&tris[0], sizeof(Mesh::triangle), ntris, f);
-
-    fclose(f);
-    return true;
+    return loadMeshFromBin(*this, binFilepath);
 }
 
 void Mesh::saveToBin(const std::string& binFilepath)
 {
     long t = std::clock();
     ALICEVISION_LOG_DEBUG("Save mesh to bin.");
-    // printf("open\n");
-    FILE* f = fopen(binFilepath.c_str(), "wb");
-
-    int npts = pts.size();
-    // printf("write npts %i\n",npts);
-    fwrite(&npts, sizeof(int), 1, f);
-    // printf("write pts\n");
-    fwrite(&pts[0], sizeof(Point3d), npts, f);
-
-    int ntris = tris.size();
-    // printf("write ntris %i\n",ntris);
-    fwrite(&ntris, sizeof(int), 1, f);
-    // printf("write tris\n");
-    fwrite(&tris[0], sizeof(Mesh::triangle), ntris, f);
-
-    // printf("close\n");
-    fclose(f);
-    // printf("done\n");
+    saveMeshAsBin(*this, binFilepath);
     mvsUtils::printfElapsedTime(t, "Save mesh to bin ");
 }
 
@@ -239,6 +218,7 @@ void Mesh::addMesh(const Mesh& mesh)
             ALICEVISION_LOG_WARNING("addMesh: bad triangle index: " << t.v[0] << " " << t.v[1] << " " << t.v[2] << ", npts: " << mesh.pts.size());
         }
     }
+    invalidateAdjacency();
 
     if(!mesh.uvCoords.empty())
     {
@@ -557,73 +537,98 @@ bool Mesh::doesTriangleIntersectsRectangle(Mesh::triangle_proj& tp, Mesh::rectan
     */
 }
 
-void Mesh::getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const
+const Mesh::VertexTrianglesAdjacency& Mesh::getVertexTrianglesAdjacency() const
 {
-    // array of tuples <x: vertexIndex, y: triangleIndex, z: numberOfNeighbors>
-    StaticVector<Voxel> vertexNeighborhoodPairs;
-    vertexNeighborhoodPairs.reserve(tris.size() * 3);
-    for(int i = 0; i < tris.size(); ++i)
+    const int nbPts = pts.size();
+    const int nbTris = tris.size();
+
+    if(_isAdjacencyValid && _adjacencyNbTris == nbTris && _vertexTrianglesAdjacency.offsets.size() == static_cast<std::size_t>(nbPts) + 1)
+        return _vertexTrianglesAdjacency;
+
+    // count the triangles of each vertex
+    std::vector<std::size_t> offsets(nbPts + 1, 0);
+    #pragma omp parallel for
+    for(int i = 0; i < nbTris; ++i)
     {
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[0], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[1], i, 0));
-        vertexNeighborhoodPairs.push_back(Voxel(tris[i].v[2], i, 0));
+        for(int k = 0; k < 3; ++k)
+        {
+            const int ptId = tris[i].v[k];
+            if(ptId >= 0 && ptId < nbPts)
+                boost::atomic_ref<std::size_t>{offsets[ptId + 1]}.fetch_add(1);
+        }
     }
-    qsort(&vertexNeighborhoodPairs[0], vertexNeighborhoodPairs.size(), sizeof(Voxel), qSortCompareVoxelByXAsc);
+    for(int i = 0; i < nbPts; ++i)
+        offsets[i + 1] += offsets[i];
 
-    int i = 0; // index of the unique pair of <vertex, neighborhood>
-    int j = 0; // index of the vertex
-    int k = 0; // number of neighbors
-    int firstid = 0;
-    while(i < vertexNeighborhoodPairs.size())
+    // fill the triangles, then sort them so the result does not depend on the threads scheduling
+    std::vector<int> triangles(offsets.back());
+    std::vector<std::size_t> fillIndex(offsets.begin(), offsets.end() - 1);
+    #pragma omp parallel for
+    for(int i = 0; i < nbTris; ++i)
     {
-        ++k;
-        // (*vertexNeighborhoodPairs)[i].z = j;
-        if((i == vertexNeighborhoodPairs.size() - 1) || (vertexNeighborhoodPairs[i].x != vertexNeighborhoodPairs[i + 1].x))
+        for(int k = 0; k < 3; ++k)
         {
-            vertexNeighborhoodPairs[firstid].z = k; // store the number of neighbors
-            ++j;
-            firstid = i + 1;
-            k = 0;
+            const int ptId = tris[i].v[k];
+            if(ptId >= 0 && ptId < nbPts)
+                triangles[boost::atomic_ref<std::size_t>{fillIndex[ptId]}.fetch_add(1)] = i;
         }
-        ++i;
     }
-    int npts = j;
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for(int i = 0; i < nbPts; ++i)
+        std::sort(triangles.begin() + offsets[i], triangles.begin() + offsets[i + 1]);
+
+    _vertexTrianglesAdjacency.offsets.swap(offsets);
+    _vertexTrianglesAdjacency.triangles.swap(triangles);
+    _adjacencyNbTris = nbTris;
+    _isAdjacencyValid = true;
+
+    return _vertexTrianglesAdjacency;
+}
+
+void Mesh::getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const
+{
+    const VertexTrianglesAdjacency& adjacency = getVertexTrianglesAdjacency();
 
     out_ptsNeighTris.reserve(pts.size());
     out_ptsNeighTris.resize(pts.size());
 
-    i = 0;
-    for(j = 0; j < npts; ++j)
+    #pragma omp parallel for
+    for(int i = 0; i < pts.size(); ++i)
     {
-        int middlePtId = vertexNeighborhoodPairs[i].x;
-        int nbNeighbors = vertexNeighborhoodPairs[i].z;
-        int i0 = i;
-        int i1 = i + nbNeighbors;
-        i = i1;
-
-        StaticVector<int>& triTmp = out_ptsNeighTris[middlePtId];
-        triTmp.reserve(nbNeighbors);
-        for(int l = i0; l < i1; ++l)
-        {
-            triTmp.push_back(vertexNeighborhoodPairs[l].y); // index of triangle
-        }
+        const TrianglesRange ptTris = adjacency.getTriangles(i);
+        if(!ptTris.empty())
+            out_ptsNeighTris[i].getDataWritable().assign(ptTris.begin(), ptTris.end());
     }
 }
 
 void Mesh::getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeigh) const
 {
+    const VertexTrianglesAdjacency& adjacency = getVertexTrianglesAdjacency();
+
     out_ptsNeigh.resize(pts.size());
-    for(int triangleId = 0; triangleId < tris.size(); ++triangleId)
+
+    // the triangles are sorted, so the neighbors are in the same order as with a sequential loop over the triangles
+    #pragma omp parallel for
+    for(int ptId = 0; ptId < pts.size(); ++ptId)
     {
-        const Mesh::triangle& triangle = tris[triangleId];
-        for(int k = 0; k < 3; ++k)
+        const TrianglesRange ptTris = adjacency.getTriangles(ptId);
+        std::vector<int>& ptNeigh = out_ptsNeigh[ptId];
+        for(int n = 0; n < ptTris.size(); ++n)
         {
-            int ptId = triangle.v[k];
-            std::vector<int>& ptNeigh = out_ptsNeigh[ptId];
-            if(std::find(ptNeigh.begin(), ptNeigh.end(), triangle.v[(k+1)%3]) == ptNeigh.end())
-                ptNeigh.push_back(triangle.v[(k+1)%3]);
-            if(std::find(ptNeigh.begin(), ptNeigh.end(), triangle.v[(k+2)%3]) == ptNeigh.end())
-                ptNeigh.push_back(triangle.v[(k+2)%3]);
+            // a triangle is referenced once per corner on the vertex
+            if(n > 0 && ptTris[n] == ptTris[n - 1])
+                continue;
+
+            const Mesh::triangle& triangle = tris[ptTris[n]];
+            for(int k = 0; k < 3; ++k)
+            {
+                if(triangle.v[k] != ptId)
+                    continue;
+                if(std::find(ptNeigh.begin(), ptNeigh.end(), triangle.v[(k+1)%3]) == ptNeigh.end())
+                    ptNeigh.push_back(triangle.v[(k+1)%3]);
+                if(std::find(ptNeigh.begin(), ptNeigh.end(), triangle.v[(k+2)%3]) == ptNeigh.end())
+                    ptNeigh.push_back(triangle.v[(k+2)%3]);
+            }
         }
     }
 }
@@ -631,20 +636,24 @@ void Mesh::getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeigh) const
 
 void Mesh::getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighPts) const
 {
-    StaticVector<StaticVector<int>> ptsNeighborTriangles;
-    getPtsNeighborTriangles(ptsNeighborTriangles);
+    const VertexTrianglesAdjacency& adjacency = getVertexTrianglesAdjacency();
 
     out_ptsNeighPts.resize(pts.size());
 
+    #pragma omp parallel for schedule(dynamic, 1024)
     for(int middlePtId = 0; middlePtId < pts.size(); ++middlePtId)
     {
-        StaticVector<int>& neighborTriangles = ptsNeighborTriangles[middlePtId];
-        if(neighborTriangles.empty())
+        const TrianglesRange ptTris = adjacency.getTriangles(middlePtId);
+        if(ptTris.empty())
             continue;
 
+        StaticVector<int> neighborTriangles;
+        neighborTriangles.getDataWritable().assign(ptTris.begin(), ptTris.end());
+
         StaticVector<int> vhid;
         vhid.reserve(neighborTriangles.size() * 2);
-        int currentTriPtId = tris[neighborTriangles[0]].v[0];
+        // start from the vertex following middlePtId in its first triangle
+        int currentTriPtId = tris[neighborTriangles[0]].v[(getTriPtIndex(neighborTriangles[0], middlePtId) + 1) % 3];
         int firstTriPtId = currentTriPtId;
         vhid.push_back(currentTriPtId);
 
@@ -1147,6 +1156,7 @@ void Mesh::generateMeshFromTrianglesSubset(const StaticVector<int>& visTris, Mes
         t.v[2] = out_ptIdToNewPtId[tris[idTri].v[2]];
         outMesh.tris.push_back(t);
     }
+    outMesh.invalidateAdjacency();
 }
 
 void Mesh::getNotOrientedEdges(StaticVector<StaticVector<int>>& edgesNeighTris, StaticVector<Pixel>& edgesPointsPairs)
@@ -1206,12 +1216,13 @@ void Mesh::getNotOrientedEdges(StaticVector<StaticVector<int>>& edgesNeighTris,
 void Mesh::getLaplacianSmoothingVectors(StaticVector<StaticVector<int>>& ptsNeighPts, StaticVector<Point3d>& out_nms,
                                         double maximalNeighDist)
 {
-    out_nms.reserve(pts.size());
+    out_nms.resize(pts.size());
 
+    #pragma omp parallel for
     for(int i = 0; i < pts.size(); ++i)
     {
-        Point3d& p = pts[i];
-        StaticVector<int>& nei = ptsNeighPts[i];
+        const Point3d& p = pts[i];
+        const StaticVector<int>& nei = ptsNeighPts[i];
         int nneighs = 0;
         if(!nei.empty())
         {
@@ -1220,7 +1231,7 @@ void Mesh::getLaplacianSmoothingVectors(StaticVector<StaticVector<int>>& ptsNeig
 
         if(nneighs == 0)
         {
-            out_nms.push_back(Point3d(0.0, 0.0, 0.0));
+            out_nms[i] = Point3d(0.0, 0.0, 0.0);
         }
         else
         {
@@ -1256,7 +1267,7 @@ void Mesh::getLaplacianSmoothingVectors(StaticVector<StaticVector<int>>& ptsNeig
                 n = Point3d(0.0, 0.0, 0.0);
             }
 
-            out_nms.push_back(n);
+            out_nms[i] = n;
         }
     }
 }
@@ -1274,6 +1285,7 @@ void Mesh::laplacianSmoothPts(StaticVector<StaticVector<int>>& ptsNeighPts, doub
     getLaplacianSmoothingVectors(ptsNeighPts, nms, maximalNeighDist);
 
     // smooth
+    #pragma omp parallel for
     for(int i = 0; i < pts.size(); ++i)
     {
         pts[i] = pts[i] + nms[i];
@@ -1310,11 +1322,46 @@ double Mesh::computeTriangleMinEdgeLength(int idTri) const
                      (pts[t.v[2]] - pts[t.v[0]]).size()});
 }
 
+/// Average normal of the triangles around a vertex
+template <typename TrianglesIds>
+Point3d computeVertexNormal(Mesh& mesh, const TrianglesIds& triTmp)
+{
+    Point3d n = Point3d(0.0f, 0.0f, 0.0f);
+    float nn = 0.0f;
+    for(int j = 0; j < triTmp.size(); ++j)
+    {
+        Point3d n1 = mesh.computeTriangleNormal(triTmp[j]);
+        n1 = n1.normalize();
+        if(!std::isnan(n1.x) && !std::isnan(n1.y) && std::isnan(n1.z)) // check if is not NaN
+        {
+            n = n + mesh.computeTriangleNormal(triTmp[j]);
+            nn += 1.0f;
+        }
+    }
+    n = n / nn;
+
+    n = n.normalize();
+    if(std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z)) // check if is not NaN
+    {
+        n = Point3d(0.0f, 0.0f, 0.0f);
+    }
+    return n;
+}
+
 void Mesh::computeNormalsForPts(StaticVector<Point3d>& out_nms)
 {
-    StaticVector<StaticVector<int>> ptsNeighTris;
-    getPtsNeighborTriangles(ptsNeighTris);
-    computeNormalsForPts(ptsNeighTris, out_nms);
+    const VertexTrianglesAdjacency& adjacency = getVertexTrianglesAdjacency();
+
+    out_nms.reserve(pts.size());
+    out_nms.resize_with(pts.size(), Point3d(0.0f, 0.0f, 0.0f));
+
+    #pragma omp parallel for
+    for(int i = 0; i < pts.size(); ++i)
+    {
+        const TrianglesRange ptTris = adjacency.getTriangles(i);
+        if(!ptTris.empty())
+            out_nms[i] = computeVertexNormal(*this, ptTris);
+    }
 }
 
 void Mesh::computeNormalsForPts(StaticVector<StaticVector<int>>& ptsNeighTris, StaticVector<Point3d>& out_nms)
@@ -1322,33 +1369,12 @@ void Mesh::computeNormalsForPts(StaticVector<StaticVector<int>>& ptsNeighTris, S
     out_nms.reserve(pts.size());
     out_nms.resize_with(pts.size(), Point3d(0.0f, 0.0f, 0.0f));
 
+    #pragma omp parallel for
     for(int i = 0; i < pts.size(); ++i)
     {
-        StaticVector<int>& triTmp = ptsNeighTris[i];
+        const StaticVector<int>& triTmp = ptsNeighTris[i];
         if(!triTmp.empty())
-        {
-            Point3d n = Point3d(0.0f, 0.0f, 0.0f);
-            float nn = 0.0f;
-            for(int j = 0; j < triTmp.size(); ++j)
-            {
-                Point3d n1 = computeTriangleNormal(triTmp[j]);
-                n1 = n1.normalize();
-                if(!std::isnan(n1.x) && !std::isnan(n1.y) && std::isnan(n1.z)) // check if is not NaN
-                {
-                    n = n + computeTriangleNormal(triTmp[j]);
-                    nn += 1.0f;
-                }
-            }
-            n = n / nn;
-
-            n = n.normalize();
-            if(std::isnan(n.x) || std::isnan(n.y) || std::isnan(n.z)) // check if is not NaN
-            {
-                n = Point3d(0.0f, 0.0f, 0.0f);
-            }
-
-            out_nms[i] = n;
-        }
+            out_nms[i] = computeVertexNormal(*this, triTmp);
     }
 }
 
@@ -1377,20 +1403,42 @@ void Mesh::removeFreePointsFromMesh(StaticVector<int>& out_ptIdToNewPtId)
 {
     ALICEVISION_LOG_INFO("remove free points from mesh.");
 
-    // declare all triangles as used
-    StaticVector<int> visTris;
-    visTris.reserve(tris.size());
+    const VertexTrianglesAdjacency& adjacency = getVertexTrianglesAdjacency();
+    const int nbPts = pts.size();
+
+    // a point is used if it has at least one triangle
+    out_ptIdToNewPtId.resize_with(nbPts, -1); // -1 means unused
+    int nbUsedPts = 0;
+    for(int i = 0; i < nbPts; ++i)
+        out_ptIdToNewPtId[i] = adjacency.getTriangles(i).empty() ? -1 : nbUsedPts++;
+
+    const bool updateColors = !_colors.empty();
+    StaticVector<Point3d> newPts(nbUsedPts);
+    std::vector<rgb> newColors(updateColors ? nbUsedPts : 0);
+
+    #pragma omp parallel for
+    for(int i = 0; i < nbPts; ++i)
+    {
+        const int newPtId = out_ptIdToNewPtId[i];
+        if(newPtId == -1)
+            continue;
+        newPts[newPtId] = pts[i];
+        if(updateColors)
+            newColors[newPtId] = _colors[i];
+    }
+
+    #pragma omp parallel for
     for(int i = 0; i < tris.size(); ++i)
     {
-        visTris.push_back(i);
+        Mesh::triangle& t = tris[i];
+        t.alive = true;
+        for(int k = 0; k < 3; ++k)
+            t.v[k] = out_ptIdToNewPtId[t.v[k]];
     }
-    // generate a new mesh from all triangles so all unused points will be removed
-    Mesh cleanedMesh;
-    generateMeshFromTrianglesSubset(visTris, cleanedMesh, out_ptIdToNewPtId);
 
-    std::swap(cleanedMesh.pts, pts);
-    std::swap(cleanedMesh.tris, tris);
-    std::swap(cleanedMesh._colors, _colors);
+    pts.swap(newPts);
+    _colors.swap(newColors);
+    invalidateAdjacency();
 }
 
 double Mesh::computeTriangleProjectionArea(const triangle_proj& tp) const
@@ -1840,6 +1888,7 @@ int Mesh::subdivideMeshOnce(const Mesh& refMesh, const GEO::AdaptiveKdTree& refM
 
     pts.swap(new_pts);
     tris.swap(new_tris);
+    invalidateAdjacency();
     uvCoords.swap(new_uvCoords);
     trisUvIds.swap(new_trisUvIds);
     _trisMtlIds.swap(new_trisMtlIds);
@@ -1849,19 +1898,30 @@ int Mesh::subdivideMeshOnce(const Mesh& refMesh, const GEO::AdaptiveKdTree& refM
 
 double Mesh::computeAverageEdgeLength() const
 {
-    double s = 0.0;
-    double n = 0.0;
-    for(int i = 0; i < tris.size(); ++i)
+    const int nbTris = tris.size();
+    if(nbTris == 0)
     {
-        s += computeTriangleMaxEdgeLength(i);
-        n += 1.0;
+        return 0.0;
     }
-    if(n == 0.0)
+
+    // sum fixed blocks of triangles, then the blocks in order,
+    // so the result does not depend on the number of threads
+    const int blockSize = 4096;
+    const int nbBlocks = (nbTris + blockSize - 1) / blockSize;
+    std::vector<double> blockSums(nbBlocks, 0.0);
+    #pragma omp parallel for
+    for(int b = 0; b < nbBlocks; ++b)
     {
-        return 0.0;
+        const int end = std::min(nbTris, (b + 1) * blockSize);
+        for(int i = b * blockSize; i < end; ++i)
+            blockSums[b] += computeTriangleMaxEdgeLength(i);
     }
 
-    return (s / n);
+    double s = 0.0;
+    for(const double blockSum : blockSums)
+        s += blockSum;
+
+    return (s / nbTris);
 }
 
 double Mesh::computeLocalAverageEdgeLength(const std::vector<std::vector<int>>& ptsNeighbors, int ptId) const
@@ -1895,6 +1955,7 @@ void Mesh::letJustTringlesIdsInMesh(StaticVector<int>& trisIdsToStay)
         trisTmp.push_back(tris[trisIdsToStay[i]]);
     }
     tris.swap(trisTmp);
+    invalidateAdjacency();
 }
 
 void Mesh::letJustTringlesIdsInMesh(const StaticVectorBool& trisToStay)
@@ -1912,6 +1973,7 @@ void Mesh::letJustTringlesIdsInMesh(const StaticVectorBool& trisToStay)
             trisTmp.push_back(tris[i]);
 
     tris.swap(trisTmp);
+    invalidateAdjacency();
 }
 
 void Mesh::computeTrisCams(StaticVector<StaticVector<int>>& trisCams, const mvsUtils::MultiViewParams& mp, const std::string tmpDir)
@@ -2069,6 +2131,7 @@ void Mesh::initFromDepthMap(int stepDetail, const mvsUtils::MultiViewParams& mp,
             }
         }
     }
+    invalidateAdjacency();
 
     StaticVector<int> ptIdToNewPtId;
     removeFreePointsFromMesh(ptIdToNewPtId);
@@ -2207,6 +2270,7 @@ void Mesh::changeTriPtId(int triId, int oldPtId, int newPtId)
         if(oldPtId == tris[triId].v[k])
         {
             tris[triId].v[k] = newPtId;
+            invalidateAdjacency();
         }
     }
 }
@@ -2356,6 +2420,7 @@ void Mesh::load(const std::string& filepath)
 
     pts.clear();
     tris.clear();
+    invalidateAdjacency();
     trisNormalsIds.clear();
     trisUvIds.clear();
     _trisMtlIds.clear();
@@ -2370,6 +2435,15 @@ void Mesh::load(const std::string& filepath)
         ALICEVISION_THROW_ERROR("Mesh::load: no such file: " << filepath);
     }
 
+    // native binary PLY reader, without intermediate Assimp scene
+    if(boost::to_lower_copy(boost::filesystem::path(filepath).extension().string()) == ".ply" && loadMeshFromPly(*this, filepath))
+    {
+        ALICEVISION_LOG_DEBUG("Vertices: " << pts.size());
+        ALICEVISION_LOG_DEBUG("Triangles: " << tris.size());
+        ALICEVISION_LOG_DEBUG("UVs: " << uvCoords.size());
+        return;
+    }
+
     // see https://github.com/assimp/assimp/blob/master/include/assimp/postprocess.h#L85
     const unsigned int pFlags =
         // If this flag is not specified, no vertices are referenced by more than one face
@@ -15,6 +15,9 @@
 #include <aliceVision/mvsUtils/common.hpp>
 #include <aliceVision/stl/bitmask.hpp>
 
+#include <cstddef>
+#include <vector>
+
 namespace GEO {
     class AdaptiveKdTree;
 }
@@ -49,7 +52,8 @@ enum class EFileType
     OBJ = 0,
     FBX,
     GLTF,
-    STL
+    STL,
+    PLY
 };
 
 EFileType EFileType_stringToEnum(const std::string& filetype);
@@ -144,6 +148,38 @@ public:
         }
     };
 
+    /// Contiguous range of triangle indexes, valid as long as the vertex to triangles adjacency is not rebuilt
+    struct TrianglesRange
+    {
+        const int* first = nullptr;
+        const int* last = nullptr;
+
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        int size() const { return static_cast<int>(last - first); }
+        bool empty() const { return first == last; }
+        int operator[](int i) const { return first[i]; }
+    };
+
+    /**
+     * @brief Vertex to triangles adjacency in compressed rows (CSR).
+     * The triangles around the vertex i are triangles[offsets[i]] ... triangles[offsets[i + 1] - 1],
+     * in increasing order (a triangle appears once per corner on the vertex).
+     */
+    struct VertexTrianglesAdjacency
+    {
+        std::vector<std::size_t> offsets;
+        std::vector<int> triangles;
+
+        TrianglesRange getTriangles(int ptId) const
+        {
+            TrianglesRange range;
+            range.first = triangles.data() + offsets[ptId];
+            range.last = triangles.data() + offsets[ptId + 1];
+            return range;
+        }
+    };
+
 protected:
     /// Per-vertex color data
     std::vector<rgb> _colors;
@@ -188,6 +224,18 @@ public:
     void getDepthMap(StaticVector<float>& depthMap, StaticVector<StaticVector<int>>& tmp, const mvsUtils::MultiViewParams& mp, int rc,
                      int scale, int w, int h);
 
+    /**
+     * @brief Get the vertex to triangles adjacency.
+     * It is built in parallel on the first call and cached until the topology changes.
+     * The Mesh methods modifying the triangles invalidate it, direct modifications of the triangles vertex indexes
+     * must be followed by invalidateAdjacency().
+     * @note not thread safe if the adjacency has to be built
+     */
+    const VertexTrianglesAdjacency& getVertexTrianglesAdjacency() const;
+
+    /// Discard the cached vertex to triangles adjacency
+    void invalidateAdjacency() { _isAdjacencyValid = false; }
+
     void getPtsNeighbors(std::vector<std::vector<int>>& out_ptsNeighTris) const;
     void getPtsNeighborTriangles(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
     void getPtsNeighPtsOrdered(StaticVector<StaticVector<int>>& out_ptsNeighTris) const;
@@ -310,6 +358,13 @@ public:
      * @param[in] refPointsVisibilities the reference visibilities
      */
     void remapVisibilities(EVisibilityRemappingMethod remappingMethod, const Mesh& refMesh);
+
+private:
+    /// Cached vertex to triangles adjacency, see getVertexTrianglesAdjacency
+    mutable VertexTrianglesAdjacency _vertexTrianglesAdjacency;
+    /// Number of triangles of the cached adjacency
+    mutable int _adjacencyNbTris = 0;
+    mutable bool _isAdjacencyValid = false;
 };
 
 } // namespace mesh
@@ -10,66 +10,14 @@
 #include <aliceVision/mvsData/Voxel.hpp>
 #include <aliceVision/mesh/Mesh.hpp>
 
+#include <vector>
+
 namespace aliceVision {
 namespace mesh {
 
 class MeshClean : public Mesh
 {
 public:
-    class path
-    {
-    public:
-        struct pathPart
-        {
-            int triId;
-            int ptsIds[2];
-
-            pathPart()
-              : triId(-1)
-            {}
-
-            pathPart(int id, int ptId1, int ptId2)
-            {
-                triId = id;
-                ptsIds[0] = ptId1;
-                ptsIds[1] = ptId2;
-            }
-
-            pathPart& operator=(const pathPart& m)
-            {
-                triId = m.triId;
-                ptsIds[0] = m.ptsIds[0];
-                ptsIds[1] = m.ptsIds[1];
-                return *this;
-            }
-        };
-
-        MeshClean* meshClean;
-        int _ptId;
-
-        path(MeshClean* mesh, int ptId);
-        ~path();
-
-        void printfState(StaticVector<pathPart>& path);
-        bool addNextTriIdToPathBack(int nextTriId, StaticVector<pathPart>& path);
-        bool addNextTriIdToPathFront(int nextTriId, StaticVector<pathPart>& path);
-        int getNextNeighBouringUnprocessedLast(StaticVector<int>& ptNeighTrisSortedAscToProcess,
-                                               StaticVector<pathPart>& out_path);
-        int getNextNeighBouringUnprocessedFirst(StaticVector<int>& ptNeighTrisSortedAscToProcess,
-                                                StaticVector<pathPart>& out_path);
-        int nCrossings(StaticVector<pathPart>& path);
-        void removeCycleFromPath(StaticVector<MeshClean::path::pathPart>& inPath, StaticVector<MeshClean::path::pathPart>& outPath);
-        void deployTriangle(int triId);
-        int deployTriangles(StaticVector<int>& trisIds, bool isBoundaryPt);
-        void deployPath(StaticVector<pathPart>& path);
-        bool isClodePath(StaticVector<pathPart>& path);
-        void clearPointNeighbors(int ptId);
-        void updatePtNeighPtsOrderedByPath(int ptId, StaticVector<pathPart>& path);
-        void createPath(StaticVector<int>& ptNeighTrisSortedAscToProcess, StaticVector<pathPart>& out_path);
-        int deployAll();
-        bool isWrongPt();
-    };
-
     mvsUtils::MultiViewParams* mp;
 
     StaticVector<StaticVector<int>> ptsNeighTrisSortedAsc;
@@ -77,28 +25,46 @@ public:
     StaticVectorBool ptsBoundary;
     StaticVector<int> newPtsOldPtId;
 
-    StaticVectorBool edgesNeigTrisAlive;
-    StaticVector<Voxel> edgesNeigTris;
-    StaticVector<Voxel> edgesXStat;
-    StaticVector<Voxel> edgesXYStat;
-
     int nPtsInit;
 
     explicit MeshClean(mvsUtils::MultiViewParams* _mp);
     ~MeshClean();
 
-    bool getEdgeNeighTrisInterval(Pixel& itr, int ptId1, int ptId2);
     bool isIsBoundaryPt(int ptId);
 
     void deallocateCleaningAttributes();
     void init();
 
     void testPtsNeighTrisSortedAsc();
-    void testEdgesNeighTris();
     void testPtsNeighPtsOrdered();
 
+    /**
+     * @brief Split the non-manifold vertices: each consistently oriented fan of triangles around a vertex gets its own
+     *        copy of the vertex, and update the ordered neighbors and the boundary flag of the vertices.
+     *
+     * The fans of all the vertices are computed in parallel from the vertex to triangles adjacency. The vertices which
+     * have to be split, and the vertices whose fans are modified by these splits, are then processed by increasing id,
+     * so the resulting mesh is the same as with a sequential processing of the vertices.
+     *
+     * @return the number of new vertices
+     */
     int cleanMesh();
     int cleanMesh(int maxIters);
+
+private:
+    /// Consistently oriented fans of triangles around a vertex, with the buffers reused from one vertex to the next
+    struct VertexFans;
+
+    int addVertexCopy(int ptId, const std::vector<int>& trisIds, bool isBoundary);
+    int splitVertexFans(int ptId, VertexFans& fans);
+
+    /**
+     * @brief Clean a subset of the vertices, the other vertices being already cleaned and not modified since.
+     * @param[in] ptsIds the sorted vertices to clean, or nullptr for all the vertices
+     * @param[out] out_touchedPts the vertices of the triangles modified by the splits
+     * @return the number of new vertices
+     */
+    int cleanVertices(const std::vector<int>* ptsIds, std::vector<int>& out_touchedPts);
 };
 
 } // namespace mesh
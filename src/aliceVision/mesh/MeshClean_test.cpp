@@ -0,0 +1,166 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/MeshClean.hpp>
+#include <aliceVision/mesh/meshTestCommon.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <utility>
+
+#define BOOST_TEST_MODULE meshClean
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace {
+
+/// Add a closed fan of nbRimPts triangles around the vertex apexPtId
+void addClosedFan(int apexPtId, int nbRimPts, double z, MeshClean& out_mesh)
+{
+    const int firstRimPtId = out_mesh.pts.size();
+    for(int i = 0; i < nbRimPts; ++i)
+    {
+        const double angle = 2.0 * M_PI * i / nbRimPts;
+        out_mesh.pts.push_back(Point3d(std::cos(angle), std::sin(angle), z));
+        out_mesh.colors().push_back(rgb(10, 10, 10));
+    }
+    for(int i = 0; i < nbRimPts; ++i)
+        out_mesh.tris.push_back(Mesh::triangle(apexPtId, firstRimPtId + i, firstRimPtId + (i + 1) % nbRimPts));
+}
+
+/// Grid with merged vertices and flipped triangles
+void createNonManifoldGridMesh(int n, unsigned int seed, MeshClean& out_mesh)
+{
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> ptDistribution(0, (n + 1) * (n + 1) - 1);
+    std::uniform_real_distribution<double> ratioDistribution(0.0, 1.0);
+
+    Mesh grid;
+    test::createGridMesh(n, [](int x, int y) { return Point3d(x, y, 0.0); }, grid);
+    out_mesh.pts = grid.pts;
+
+    std::vector<int> mergedPtId(out_mesh.pts.size());
+    for(int i = 0; i < mergedPtId.size(); ++i)
+        mergedPtId[i] = i;
+    for(int i = 0; i < n * n / 10; ++i)
+    {
+        const int ptId = ptDistribution(generator);
+        mergedPtId[ptId] = ptDistribution(generator);
+    }
+
+    for(int i = 0; i < grid.tris.size(); ++i)
+    {
+        Mesh::triangle t(mergedPtId[grid.tris[i].v[0]], mergedPtId[grid.tris[i].v[1]], mergedPtId[grid.tris[i].v[2]]);
+        if(t.v[0] == t.v[1] || t.v[1] == t.v[2] || t.v[2] == t.v[0])
+            continue;
+        if(ratioDistribution(generator) < 0.05)
+            std::swap(t.v[1], t.v[2]);
+        out_mesh.tris.push_back(t);
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(meshClean_closedFans)
+{
+    // two closed fans sharing their apex
+    MeshClean mesh(nullptr);
+    mesh.pts.push_back(Point3d(0.0, 0.0, 0.0));
+    mesh.colors().push_back(rgb(255, 0, 0));
+    addClosedFan(0, 4, 1.0, mesh);
+    addClosedFan(0, 5, -1.0, mesh);
+
+    mesh.init();
+    BOOST_CHECK_EQUAL(mesh.cleanMesh(10), 0);
+
+    // the fan of the last triangle stays on the apex
+    BOOST_REQUIRE_EQUAL(mesh.pts.size(), 11);
+    BOOST_REQUIRE_EQUAL(mesh.newPtsOldPtId.size(), 1);
+    BOOST_CHECK_EQUAL(mesh.newPtsOldPtId[0], 0);
+    BOOST_CHECK(mesh.pts[10] == mesh.pts[0]);
+    BOOST_CHECK_EQUAL(mesh.colors()[10].r, 255);
+    for(int i = 0; i < 4; ++i)
+        BOOST_CHECK_EQUAL(mesh.tris[i].v[0], 10);
+    for(int i = 4; i < 9; ++i)
+        BOOST_CHECK_EQUAL(mesh.tris[i].v[0], 0);
+
+    BOOST_CHECK(!mesh.isIsBoundaryPt(0));
+    BOOST_CHECK(!mesh.isIsBoundaryPt(10));
+    BOOST_CHECK_EQUAL(mesh.ptsNeighPtsOrdered[0].size(), 5);
+    BOOST_CHECK_EQUAL(mesh.ptsNeighPtsOrdered[10].size(), 4);
+    BOOST_CHECK_EQUAL(mesh.ptsNeighTrisSortedAsc[10].size(), 4);
+
+    // the rim vertices are on an open fan of two triangles
+    for(int i = 1; i < 10; ++i)
+    {
+        BOOST_CHECK(mesh.isIsBoundaryPt(i));
+        BOOST_CHECK_EQUAL(mesh.ptsNeighPtsOrdered[i].size(), 3);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(meshClean_nonManifoldGrid)
+{
+    MeshClean mesh(nullptr);
+    createNonManifoldGridMesh(60, 42, mesh);
+    const int nbInputPts = mesh.pts.size();
+    const int nbInputTris = mesh.tris.size();
+
+    mesh.init();
+    BOOST_CHECK_EQUAL(mesh.cleanMesh(10), 0);
+    BOOST_CHECK_GT(mesh.pts.size(), nbInputPts);
+    BOOST_CHECK_EQUAL(mesh.tris.size(), nbInputTris);
+    BOOST_CHECK_EQUAL(mesh.newPtsOldPtId.size(), mesh.pts.size() - nbInputPts);
+
+    // each vertex is on a single fan
+    MeshClean cleanedMesh(nullptr);
+    cleanedMesh.addMesh(mesh);
+    cleanedMesh.init();
+    BOOST_CHECK_EQUAL(cleanedMesh.cleanMesh(), 0);
+    for(int i = 0; i < mesh.pts.size(); ++i)
+    {
+        if(mesh.ptsNeighTrisSortedAsc[i].empty())
+            continue;
+        const int nbNeighPts = mesh.ptsNeighTrisSortedAsc[i].size() + (mesh.isIsBoundaryPt(i) ? 1 : 0);
+        BOOST_CHECK_EQUAL(mesh.ptsNeighPtsOrdered[i].size(), nbNeighPts);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(meshClean_threads)
+{
+    // the result does not depend on the number of threads
+    MeshClean sequentialMesh(nullptr);
+    MeshClean parallelMesh(nullptr);
+    createNonManifoldGridMesh(100, 7, sequentialMesh);
+    createNonManifoldGridMesh(100, 7, parallelMesh);
+
+    const int nbThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    sequentialMesh.init();
+    sequentialMesh.cleanMesh(10);
+    omp_set_num_threads(4);
+    parallelMesh.init();
+    parallelMesh.cleanMesh(10);
+    omp_set_num_threads(nbThreads);
+
+    BOOST_REQUIRE_EQUAL(sequentialMesh.pts.size(), parallelMesh.pts.size());
+    for(int i = 0; i < sequentialMesh.tris.size(); ++i)
+    {
+        for(int k = 0; k < 3; ++k)
+            BOOST_CHECK_EQUAL(sequentialMesh.tris[i].v[k], parallelMesh.tris[i].v[k]);
+    }
+    for(int i = 0; i < sequentialMesh.newPtsOldPtId.size(); ++i)
+        BOOST_CHECK_EQUAL(sequentialMesh.newPtsOldPtId[i], parallelMesh.newPtsOldPtId[i]);
+    for(int i = 0; i < sequentialMesh.pts.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(sequentialMesh.isIsBoundaryPt(i), parallelMesh.isIsBoundaryPt(i));
+        BOOST_CHECK(sequentialMesh.ptsNeighPtsOrdered[i].getData() == parallelMesh.ptsNeighPtsOrdered[i].getData());
+    }
+}
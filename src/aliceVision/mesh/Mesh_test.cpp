@@ -0,0 +1,207 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mesh/meshTestCommon.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE mesh
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace {
+
+/// Jittered grid of (n+1)x(n+1) vertices and 2*n*n triangles
+void createJitteredGridMesh(int n, Mesh& out_mesh)
+{
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<double> jitter(-0.2, 0.2);
+
+    test::createGridMesh(
+      n, [&](int x, int y) { return Point3d(x + jitter(generator), y + jitter(generator), jitter(generator)); }, out_mesh);
+}
+
+/// Triangles of each vertex, from a sequential loop over the triangles
+std::vector<std::vector<int>> getVertexTrianglesReference(const Mesh& mesh)
+{
+    std::vector<std::vector<int>> vertexTriangles(mesh.pts.size());
+    for(int i = 0; i < mesh.tris.size(); ++i)
+        for(int k = 0; k < 3; ++k)
+            vertexTriangles[mesh.tris[i].v[k]].push_back(i);
+    return vertexTriangles;
+}
+
+void checkAdjacency(const Mesh& mesh)
+{
+    const std::vector<std::vector<int>> reference = getVertexTrianglesReference(mesh);
+    const Mesh::VertexTrianglesAdjacency& adjacency = mesh.getVertexTrianglesAdjacency();
+
+    BOOST_REQUIRE_EQUAL(adjacency.offsets.size(), static_cast<std::size_t>(mesh.pts.size()) + 1);
+    BOOST_CHECK_EQUAL(adjacency.triangles.size(), static_cast<std::size_t>(3 * mesh.tris.size()));
+    for(int i = 0; i < mesh.pts.size(); ++i)
+    {
+        const Mesh::TrianglesRange ptTris = adjacency.getTriangles(i);
+        BOOST_CHECK_EQUAL_COLLECTIONS(ptTris.begin(), ptTris.end(), reference[i].begin(), reference[i].end());
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(mesh_vertexTrianglesAdjacency)
+{
+    Mesh mesh;
+    createJitteredGridMesh(40, mesh);
+
+    // a degenerated triangle references its vertex once per corner
+    mesh.tris.push_back(Mesh::triangle(0, 0, 1));
+
+    checkAdjacency(mesh);
+
+    // cached until the triangles change
+    const Mesh::VertexTrianglesAdjacency* adjacency = &mesh.getVertexTrianglesAdjacency();
+    const std::vector<int> triangles = adjacency->triangles;
+    BOOST_CHECK(&mesh.getVertexTrianglesAdjacency() == adjacency);
+    BOOST_CHECK(mesh.getVertexTrianglesAdjacency().triangles == triangles);
+
+    // direct modification of the vertex indexes
+    std::swap(mesh.tris[0].v[0], mesh.tris[mesh.tris.size() - 2].v[1]);
+    mesh.invalidateAdjacency();
+    checkAdjacency(mesh);
+
+    // the methods modifying the triangles invalidate it
+    StaticVector<int> trisIdsToStay;
+    for(int i = 0; i < mesh.tris.size(); i += 3)
+        trisIdsToStay.push_back(i);
+    mesh.letJustTringlesIdsInMesh(trisIdsToStay);
+    checkAdjacency(mesh);
+
+    // the parallel build does not depend on the number of threads
+    const std::vector<int> parallelTriangles = mesh.getVertexTrianglesAdjacency().triangles;
+    const int maxThreads = omp_get_max_threads();
+    omp_set_num_threads(1);
+    mesh.invalidateAdjacency();
+    const std::vector<int> sequentialTriangles = mesh.getVertexTrianglesAdjacency().triangles;
+    omp_set_num_threads(maxThreads);
+    BOOST_CHECK(parallelTriangles == sequentialTriangles);
+}
+
+BOOST_AUTO_TEST_CASE(mesh_ptsNeighPtsOrdered)
+{
+    // closed fan around the vertex 0: the center is the first corner of its triangles
+    const int nbRimPts = 6;
+    Mesh mesh;
+    mesh.pts.push_back(Point3d(0.0, 0.0, 0.0));
+    for(int i = 0; i < nbRimPts; ++i)
+    {
+        const double angle = 2.0 * M_PI * i / nbRimPts;
+        mesh.pts.push_back(Point3d(std::cos(angle), std::sin(angle), 0.0));
+    }
+    for(int i = 0; i < nbRimPts; ++i)
+        mesh.tris.push_back(Mesh::triangle(0, 1 + i, 1 + (i + 1) % nbRimPts));
+
+    StaticVector<StaticVector<int>> ptsNeighPts;
+    mesh.getPtsNeighPtsOrdered(ptsNeighPts);
+    BOOST_REQUIRE_EQUAL(ptsNeighPts.size(), mesh.pts.size());
+
+    // the ring starts from the vertex following the center in its first triangle and never contains the center
+    const std::vector<int> expectedRing = {1, 2, 3, 4, 5, 6};
+    BOOST_CHECK_EQUAL_COLLECTIONS(ptsNeighPts[0].begin(), ptsNeighPts[0].end(), expectedRing.begin(), expectedRing.end());
+
+    // a rim vertex starts from the vertex following it in its first triangle
+    const std::vector<int> expectedRimRing = {2, 0, 6};
+    BOOST_CHECK_EQUAL_COLLECTIONS(ptsNeighPts[1].begin(), ptsNeighPts[1].end(), expectedRimRing.begin(), expectedRimRing.end());
+
+    for(int i = 0; i < ptsNeighPts.size(); ++i)
+        BOOST_CHECK_EQUAL(ptsNeighPts[i].indexOf(i), -1);
+}
+
+BOOST_AUTO_TEST_CASE(mesh_removeFreePointsFromMesh)
+{
+    Mesh mesh;
+    createJitteredGridMesh(10, mesh);
+    const Mesh reference = mesh;
+
+    // free points before, between and after the used ones
+    const std::vector<int> freePtIds = {0, 5, 60, 124};
+    StaticVector<Point3d> pts;
+    std::vector<int> oldPtIdToPtId;
+    for(int i = 0, oldPtId = 0; oldPtId < reference.pts.size(); ++i)
+    {
+        if(std::find(freePtIds.begin(), freePtIds.end(), i) != freePtIds.end())
+        {
+            pts.push_back(Point3d(-1.0, -1.0, -1.0));
+            mesh.colors().push_back(rgb(255, 0, 0));
+            continue;
+        }
+        oldPtIdToPtId.push_back(pts.size());
+        pts.push_back(reference.pts[oldPtId]);
+        mesh.colors().push_back(rgb(oldPtId % 256, 0, 0));
+        ++oldPtId;
+    }
+    pts.push_back(Point3d(-1.0, -1.0, -1.0));
+    mesh.colors().push_back(rgb(255, 0, 0));
+    mesh.pts.swap(pts);
+    for(int i = 0; i < mesh.tris.size(); ++i)
+        for(int k = 0; k < 3; ++k)
+            mesh.tris[i].v[k] = oldPtIdToPtId[reference.tris[i].v[k]];
+    mesh.invalidateAdjacency();
+
+    StaticVector<int> ptIdToNewPtId;
+    mesh.removeFreePointsFromMesh(ptIdToNewPtId);
+
+    // the used points keep their order
+    BOOST_REQUIRE_EQUAL(ptIdToNewPtId.size(), reference.pts.size() + freePtIds.size());
+    for(int ptId : freePtIds)
+        BOOST_CHECK_EQUAL(ptIdToNewPtId[ptId], -1);
+    for(int i = 0; i < oldPtIdToPtId.size(); ++i)
+        BOOST_CHECK_EQUAL(ptIdToNewPtId[oldPtIdToPtId[i]], i);
+
+    BOOST_REQUIRE_EQUAL(mesh.pts.size(), reference.pts.size());
+    BOOST_REQUIRE_EQUAL(mesh.colors().size(), reference.pts.size());
+    for(int i = 0; i < mesh.pts.size(); ++i)
+    {
+        BOOST_CHECK(mesh.pts[i] == reference.pts[i]);
+        BOOST_CHECK_EQUAL(int(mesh.colors()[i].r), i % 256);
+    }
+
+    // the triangles are remapped in place
+    BOOST_REQUIRE_EQUAL(mesh.tris.size(), reference.tris.size());
+    for(int i = 0; i < mesh.tris.size(); ++i)
+        for(int k = 0; k < 3; ++k)
+            BOOST_CHECK_EQUAL(mesh.tris[i].v[k], reference.tris[i].v[k]);
+
+    checkAdjacency(mesh);
+}
+
+BOOST_AUTO_TEST_CASE(mesh_averageEdgeLength)
+{
+    Mesh mesh;
+    createJitteredGridMesh(200, mesh);
+
+    double s = 0.0;
+    for(int i = 0; i < mesh.tris.size(); ++i)
+        s += mesh.computeTriangleMaxEdgeLength(i);
+    BOOST_CHECK_CLOSE(mesh.computeAverageEdgeLength(), s / mesh.tris.size(), 1e-9);
+
+    // same value whatever the number of threads
+    const double averageEdgeLength = mesh.computeAverageEdgeLength();
+    const int maxThreads = omp_get_max_threads();
+    for(int nbThreads : {1, 3, 8})
+    {
+        omp_set_num_threads(nbThreads);
+        BOOST_CHECK_EQUAL(mesh.computeAverageEdgeLength(), averageEdgeLength);
+    }
+    omp_set_num_threads(maxThreads);
+
+    BOOST_CHECK_EQUAL(Mesh().computeAverageEdgeLength(), 0.0);
+}
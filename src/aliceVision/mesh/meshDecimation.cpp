@@ -0,0 +1,844 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "meshDecimation.hpp"
+#include <aliceVision/system/Logger.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/alicevision_omp.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+/**
+ * Rank factor of the cost threshold of a parallel pass: the costs grow as the collapses accumulate the quadrics,
+ * so the cheapest collapses of twice the vertices to remove are considered, the removal ratio bounding the pass.
+ */
+const int costThresholdRankFactor = 2;
+
+/// Symmetric 4x4 quadric error matrix, the error of a point p is [p 1] Q [p 1]^t
+struct Quadric
+{
+    double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+    double b2 = 0.0, bc = 0.0, bd = 0.0;
+    double c2 = 0.0, cd = 0.0;
+    double d2 = 0.0;
+
+    Quadric() = default;
+
+    /// Squared distance to the plane dot(n, p) + d = 0 weighted by w, n being normalized
+    Quadric(const Point3d& n, double d, double w)
+        : a2(w * n.x * n.x), ab(w * n.x * n.y), ac(w * n.x * n.z), ad(w * n.x * d),
+          b2(w * n.y * n.y), bc(w * n.y * n.z), bd(w * n.y * d),
+          c2(w * n.z * n.z), cd(w * n.z * d),
+          d2(w * d * d)
+    {}
+
+    Quadric& operator+=(const Quadric& q)
+    {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+        return *this;
+    }
+
+    Quadric operator+(const Quadric& q) const
+    {
+        Quadric sum = *this;
+        sum += q;
+        return sum;
+    }
+
+    double evaluate(const Point3d& p) const
+    {
+        return a2 * p.x * p.x + 2.0 * ab * p.x * p.y + 2.0 * ac * p.x * p.z + 2.0 * ad * p.x +
+               b2 * p.y * p.y + 2.0 * bc * p.y * p.z + 2.0 * bd * p.y +
+               c2 * p.z * p.z + 2.0 * cd * p.z +
+               d2;
+    }
+
+    /// Position minimizing the error, false if the system is ill-conditioned (flat or linear neighborhood)
+    bool getMinimum(Point3d& out) const
+    {
+        // cofactors of the symmetric 3x3 matrix
+        const double c00 = b2 * c2 - bc * bc;
+        const double c01 = ac * bc - ab * c2;
+        const double c02 = ab * bc - ac * b2;
+        const double det = a2 * c00 + ab * c01 + ac * c02;
+        const double trace = a2 + b2 + c2;
+        if(std::abs(det) <= 1e-10 * trace * trace * trace)
+            return false;
+
+        const double c11 = a2 * c2 - ac * ac;
+        const double c12 = ab * ac - a2 * bc;
+        const double c22 = a2 * b2 - ab * ab;
+        out.x = -(c00 * ad + c01 * bd + c02 * cd) / det;
+        out.y = -(c01 * ad + c11 * bd + c12 * cd) / det;
+        out.z = -(c02 * ad + c12 * bd + c22 * cd) / det;
+        return true;
+    }
+};
+
+/// Edge collapse, the vertex removeId is merged into keepId which is moved to position
+struct Collapse
+{
+    double cost;
+    int removeId;
+    int keepId;
+    Point3d position;
+};
+
+/// Queued edge collapse, outdated if one of its vertices changed since its cost was computed
+struct CollapseCandidate
+{
+    double cost;
+    int a;
+    int b;
+    int stampA;
+    int stampB;
+
+    bool operator>(const CollapseCandidate& other) const { return cost > other.cost; }
+};
+
+/// Buffers of a thread, reused from one patch to the next to avoid allocations
+struct PatchScratch
+{
+    std::vector<std::vector<int>> vertexTriangles;
+    std::vector<int> stamps;
+    std::vector<char> isRemoved;
+    std::vector<CollapseCandidate> queue;
+    double maxCost;
+    std::vector<int> neighbors;
+    std::vector<int> otherNeighbors;
+};
+
+/// Spread the 21 lowest bits of x to every third bit
+std::uint64_t spreadBits(std::uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffff;
+    x = (x | x << 16) & 0x1f0000ff0000ff;
+    x = (x | x << 8) & 0x100f00f00f00f00f;
+    x = (x | x << 4) & 0x10c30c30c30c30c3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+/// Sort chunks in parallel and merge them pairwise
+template <typename T>
+void parallelSort(std::vector<T>& values)
+{
+    const std::size_t size = values.size();
+    const int nbChunks = omp_get_max_threads();
+    if(nbChunks == 1 || size < 65536)
+    {
+        std::sort(values.begin(), values.end());
+        return;
+    }
+
+    const std::size_t chunkSize = (size + nbChunks - 1) / nbChunks;
+
+    #pragma omp parallel for
+    for(int c = 0; c < nbChunks; ++c)
+        std::sort(values.begin() + std::min(c * chunkSize, size), values.begin() + std::min((c + 1) * chunkSize, size));
+
+    for(std::size_t width = chunkSize; width < size; width *= 2)
+    {
+        const int nbMerges = static_cast<int>((size + 2 * width - 1) / (2 * width));
+
+        #pragma omp parallel for
+        for(int m = 0; m < nbMerges; ++m)
+        {
+            const std::size_t first = m * 2 * width;
+            std::inplace_merge(values.begin() + first, values.begin() + std::min(first + width, size),
+                               values.begin() + std::min(first + 2 * width, size));
+        }
+    }
+}
+
+void sortUnique(std::vector<int>& values)
+{
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
+class QuadricDecimater
+{
+public:
+    QuadricDecimater(Mesh& mesh, const DecimationParams& params)
+        : _mesh(mesh)
+        , _params(params)
+    {}
+
+    int decimate(int targetNbVertices);
+
+private:
+    void compact();
+    void initVerticesQuadrics();
+    void computeMortonOrder();
+
+    /**
+     * @brief Decimate the patches of vertices in parallel, the vertices on the patches borders are locked.
+     * @param[in] vertices the vertices of all the patches
+     * @param[in] patchesOffsets the patch i is made of vertices[patchesOffsets[i]] to vertices[patchesOffsets[i+1]]
+     * @param[in] nbToRemove the number of vertices to remove, distributed among the patches
+     * @param[in] useCostThreshold if true, the patches only collapse edges cheaper than the nbToRemove-th cheapest
+     *            collapse of the whole mesh, so that their decimation follows the global collapses order
+     * @return the number of removed vertices
+     */
+    int decimatePatches(const std::vector<int>& vertices, const std::vector<int>& patchesOffsets, int nbToRemove, bool useCostThreshold);
+    int decimatePatch(const int* vertices, int nbVertices, int patchId, int maxNbCollapses, double maxCost, PatchScratch& scratch);
+
+    double computeCostThreshold(const std::vector<int>& vertices, int nbToRemove) const;
+    bool computeCollapse(int a, int b, Collapse& out) const;
+    void pushCandidate(int a, int b, PatchScratch& scratch) const;
+    bool isCollapseValid(const Collapse& collapse, PatchScratch& scratch) const;
+    bool isTriangleFlipped(int triId, int movedPtId, const Point3d& position) const;
+    void applyCollapse(const Collapse& collapse, int patchId, PatchScratch& scratch);
+
+    Mesh& _mesh;
+    const DecimationParams& _params;
+    const Mesh::VertexTrianglesAdjacency* _adjacency = nullptr;
+
+    std::vector<Quadric> _quadrics;
+    std::vector<char> _isBoundary;
+    /// vertices adjacent to a non-manifold edge, never collapsed
+    std::vector<char> _isFrozen;
+    /// vertices on the patches borders, not moved nor removed during a pass
+    std::vector<char> _isLocked;
+    std::vector<int> _vertexPatch;
+    /// index of the vertex in its patch
+    std::vector<int> _localIndex;
+    /// vertices sorted along a Morton curve
+    std::vector<int> _order;
+};
+
+int QuadricDecimater::decimate(int targetNbVertices)
+{
+    const int nbInputVertices = _mesh.pts.size();
+
+    // per-triangle and per-vertex attributes cannot follow the collapses
+    _mesh.uvCoords.clear();
+    _mesh.trisUvIds.clear();
+    _mesh.normals.clear();
+    _mesh.trisNormalsIds.clear();
+    _mesh.trisMtlIds().clear();
+    _mesh.nmtls = 0;
+    _mesh.pointsVisibilities.clear();
+
+    compact();
+    if(_mesh.pts.size() <= targetNbVertices)
+        return nbInputVertices - _mesh.pts.size();
+
+    initVerticesQuadrics();
+    computeMortonOrder();
+
+    for(int pass = 0; pass < _params.maxNbParallelPasses && _mesh.pts.size() > targetNbVertices; ++pass)
+    {
+        // patches small enough to keep all the threads busy but large enough to limit the locked borders,
+        // shifted by half a patch every other pass
+        const int nbVertices = _order.size();
+        const int patchSize = std::max(1, std::min(_params.nbVerticesPerPatch, std::max(2048, nbVertices / (4 * omp_get_max_threads()))));
+        std::vector<int> patchesOffsets(1, 0);
+        for(int offset = (pass % 2 == 0) ? patchSize : patchSize / 2; offset < nbVertices; offset += patchSize)
+            patchesOffsets.push_back(offset);
+        patchesOffsets.push_back(nbVertices);
+
+        const int nbToRemove = std::min(nbVertices - targetNbVertices, static_cast<int>(_params.maxPassRemovalRatio * nbVertices));
+        const int nbRemoved = decimatePatches(_order, patchesOffsets, nbToRemove, true);
+        ALICEVISION_LOG_INFO("Decimation pass " << pass << ": " << nbRemoved << " vertices removed in " << patchesOffsets.size() - 1 << " patches.");
+        if(nbRemoved == 0)
+            break;
+    }
+
+    if(_mesh.pts.size() > targetNbVertices)
+    {
+        // final pass on the borders of the last patches and their neighbors
+        std::vector<char> isBorderRegion(_mesh.pts.size(), 0);
+
+        #pragma omp parallel for
+        for(int i = 0; i < _mesh.pts.size(); ++i)
+        {
+            for(int triId : _adjacency->getTriangles(i))
+            {
+                for(int k = 0; k < 3; ++k)
+                {
+                    const int ptId = _mesh.tris[triId].v[k];
+                    if(_isLocked[ptId] && !_isFrozen[ptId])
+                        isBorderRegion[i] = 1;
+                }
+            }
+        }
+
+        std::vector<int> borderVertices;
+        for(int i = 0; i < _mesh.pts.size(); ++i)
+        {
+            if(isBorderRegion[i])
+                borderVertices.push_back(i);
+        }
+
+        const int nbRemoved = decimatePatches(borderVertices, {0, static_cast<int>(borderVertices.size())}, _mesh.pts.size() - targetNbVertices, false);
+        ALICEVISION_LOG_INFO("Decimation of the patches borders: " << nbRemoved << " vertices removed.");
+    }
+
+    if(_mesh.pts.size() > targetNbVertices)
+    {
+        // the borders did not contain enough valid collapses
+        const int nbRemoved = decimatePatches(_order, {0, static_cast<int>(_order.size())}, _mesh.pts.size() - targetNbVertices, false);
+        ALICEVISION_LOG_INFO("Decimation of the whole mesh: " << nbRemoved << " vertices removed.");
+    }
+
+    if(_mesh.pts.size() > targetNbVertices)
+        ALICEVISION_LOG_WARNING("Decimation stopped at " << _mesh.pts.size() << " vertices, no valid collapse left to reach " << targetNbVertices << " vertices.");
+
+    return nbInputVertices - _mesh.pts.size();
+}
+
+void QuadricDecimater::compact()
+{
+    StaticVectorBool trisToStay;
+    trisToStay.resize(_mesh.tris.size());
+
+    #pragma omp parallel for
+    for(int i = 0; i < _mesh.tris.size(); ++i)
+        trisToStay[i] = _mesh.tris[i].alive;
+
+    _mesh.letJustTringlesIdsInMesh(trisToStay);
+
+    StaticVector<int> ptIdToNewPtId;
+    _mesh.removeFreePointsFromMesh(ptIdToNewPtId);
+    _adjacency = &_mesh.getVertexTrianglesAdjacency();
+
+    const auto remap = [&](auto& values) {
+        if(values.empty())
+            return;
+        std::remove_reference_t<decltype(values)> newValues(_mesh.pts.size());
+        for(int i = 0; i < ptIdToNewPtId.size(); ++i)
+        {
+            if(ptIdToNewPtId[i] != -1)
+                newValues[ptIdToNewPtId[i]] = values[i];
+        }
+        values.swap(newValues);
+    };
+    remap(_quadrics);
+    remap(_isBoundary);
+    remap(_isFrozen);
+    remap(_isLocked);
+
+    // keep the Morton order of the remaining vertices
+    int nbOrdered = 0;
+    for(int ptId : _order)
+    {
+        if(ptIdToNewPtId[ptId] != -1)
+            _order[nbOrdered++] = ptIdToNewPtId[ptId];
+    }
+    _order.resize(nbOrdered);
+
+    _vertexPatch.resize(_mesh.pts.size());
+    _localIndex.resize(_mesh.pts.size());
+}
+
+void QuadricDecimater::initVerticesQuadrics()
+{
+    const int nbPts = _mesh.pts.size();
+    _quadrics.resize(nbPts);
+    _isBoundary.resize(nbPts);
+    _isFrozen.resize(nbPts);
+    _isLocked.assign(nbPts, 0);
+
+    const auto getTriangleNormal = [&](int triId) {
+        const Mesh::triangle& t = _mesh.tris[triId];
+        return cross(_mesh.pts[t.v[1]] - _mesh.pts[t.v[0]], _mesh.pts[t.v[2]] - _mesh.pts[t.v[0]]);
+    };
+
+    #pragma omp parallel
+    {
+        std::vector<int> neighbors;
+
+        #pragma omp for
+        for(int i = 0; i < nbPts; ++i)
+        {
+            const Mesh::TrianglesRange ptTris = _adjacency->getTriangles(i);
+            const Point3d& p = _mesh.pts[i];
+
+            // planes of the adjacent triangles weighted by their area
+            Quadric q;
+            neighbors.clear();
+            for(int triId : ptTris)
+            {
+                const Point3d n = getTriangleNormal(triId);
+                const double doubleArea = n.size();
+                if(doubleArea > 0.0)
+                    q += Quadric(n / doubleArea, -dot(n, p) / doubleArea, 0.5 * doubleArea);
+
+                for(int k = 0; k < 3; ++k)
+                {
+                    if(_mesh.tris[triId].v[k] != i)
+                        neighbors.push_back(_mesh.tris[triId].v[k]);
+                }
+            }
+
+            // each neighbor appears once per triangle of the edge
+            std::sort(neighbors.begin(), neighbors.end());
+            bool isBoundary = false;
+            bool isFrozen = false;
+            for(int first = 0; first < neighbors.size();)
+            {
+                int last = first + 1;
+                while(last < neighbors.size() && neighbors[last] == neighbors[first])
+                    ++last;
+                const int nbEdgeTris = last - first;
+                isFrozen = isFrozen || (nbEdgeTris > 2);
+
+                if(nbEdgeTris == 1)
+                {
+                    // plane orthogonal to the triangle along the border edge
+                    isBoundary = true;
+                    const int neighborId = neighbors[first];
+                    for(int triId : ptTris)
+                    {
+                        if(_mesh.getTriPtIndex(triId, neighborId, false) == -1)
+                            continue;
+                        const Point3d edge = _mesh.pts[neighborId] - p;
+                        const Point3d borderNormal = cross(edge, getTriangleNormal(triId));
+                        const double borderNormalNorm = borderNormal.size();
+                        if(borderNormalNorm > 0.0)
+                        {
+                            const Point3d n = borderNormal / borderNormalNorm;
+                            q += Quadric(n, -dot(n, p), _params.boundaryWeight * dot(edge, edge));
+                        }
+                    }
+                }
+                first = last;
+            }
+
+            _quadrics[i] = q;
+            _isBoundary[i] = isBoundary;
+            _isFrozen[i] = isFrozen;
+        }
+    }
+}
+
+void QuadricDecimater::computeMortonOrder()
+{
+    const int nbPts = _mesh.pts.size();
+
+    Point3d minPt = _mesh.pts[0];
+    Point3d maxPt = _mesh.pts[0];
+    for(int i = 1; i < nbPts; ++i)
+    {
+        const Point3d& p = _mesh.pts[i];
+        minPt = Point3d(std::min(minPt.x, p.x), std::min(minPt.y, p.y), std::min(minPt.z, p.z));
+        maxPt = Point3d(std::max(maxPt.x, p.x), std::max(maxPt.y, p.y), std::max(maxPt.z, p.z));
+    }
+    const double extent = std::max({maxPt.x - minPt.x, maxPt.y - minPt.y, maxPt.z - minPt.z});
+    const double scale = (extent > 0.0) ? double((1 << 21) - 1) / extent : 0.0;
+
+    std::vector<std::pair<std::uint64_t, int>> codes(nbPts);
+
+    #pragma omp parallel for
+    for(int i = 0; i < nbPts; ++i)
+    {
+        const Point3d p = (_mesh.pts[i] - minPt) * scale;
+        codes[i].first = spreadBits(std::uint64_t(p.x)) | (spreadBits(std::uint64_t(p.y)) << 1) | (spreadBits(std::uint64_t(p.z)) << 2);
+        codes[i].second = i;
+    }
+
+    parallelSort(codes);
+
+    _order.resize(nbPts);
+
+    #pragma omp parallel for
+    for(int i = 0; i < nbPts; ++i)
+        _order[i] = codes[i].second;
+}
+
+int QuadricDecimater::decimatePatches(const std::vector<int>& vertices, const std::vector<int>& patchesOffsets, int nbToRemove, bool useCostThreshold)
+{
+    if(vertices.empty())
+        return 0;
+
+    const int nbPatches = patchesOffsets.size() - 1;
+
+    std::fill(_vertexPatch.begin(), _vertexPatch.end(), -1);
+
+    #pragma omp parallel for
+    for(int p = 0; p < nbPatches; ++p)
+    {
+        for(int i = patchesOffsets[p]; i < patchesOffsets[p + 1]; ++i)
+            _vertexPatch[vertices[i]] = p;
+    }
+
+    // a vertex is locked if one of its triangles is shared with another patch
+    #pragma omp parallel for
+    for(int i = 0; i < _mesh.pts.size(); ++i)
+    {
+        bool isLocked = _isFrozen[i] || _vertexPatch[i] == -1;
+        for(int triId : _adjacency->getTriangles(i))
+        {
+            for(int k = 0; k < 3; ++k)
+                isLocked = isLocked || (_vertexPatch[_mesh.tris[triId].v[k]] != _vertexPatch[i]);
+        }
+        _isLocked[i] = isLocked;
+    }
+
+    const double maxCost = useCostThreshold ? computeCostThreshold(vertices, nbToRemove) : std::numeric_limits<double>::max();
+    int nbRemoved = 0;
+
+    #pragma omp parallel reduction(+:nbRemoved)
+    {
+        PatchScratch scratch;
+
+        #pragma omp for schedule(dynamic)
+        for(int p = 0; p < nbPatches; ++p)
+        {
+            // vertices to remove distributed among the patches proportionally to their size
+            const int nbPatchVertices = patchesOffsets[p + 1] - patchesOffsets[p];
+            const int maxNbCollapses = static_cast<long long>(nbToRemove) * nbPatchVertices / vertices.size();
+            nbRemoved += decimatePatch(&vertices[patchesOffsets[p]], nbPatchVertices, p, maxNbCollapses, maxCost, scratch);
+        }
+    }
+    // the collapses moved the triangles corners
+    _mesh.invalidateAdjacency();
+
+    compact();
+    return nbRemoved;
+}
+
+int QuadricDecimater::decimatePatch(const int* vertices, int nbVertices, int patchId, int maxNbCollapses, double maxCost, PatchScratch& scratch)
+{
+    if(maxNbCollapses <= 0)
+        return 0;
+
+    if(scratch.vertexTriangles.size() < nbVertices)
+        scratch.vertexTriangles.resize(nbVertices);
+    scratch.stamps.assign(nbVertices, 0);
+    scratch.isRemoved.assign(nbVertices, 0);
+    scratch.queue.clear();
+    scratch.maxCost = maxCost;
+
+    for(int i = 0; i < nbVertices; ++i)
+    {
+        const Mesh::TrianglesRange ptTris = _adjacency->getTriangles(vertices[i]);
+        scratch.vertexTriangles[i].assign(ptTris.begin(), ptTris.end());
+        _localIndex[vertices[i]] = i;
+    }
+
+    // initial candidates, each edge of the patch once
+    for(int i = 0; i < nbVertices; ++i)
+    {
+        const int ptId = vertices[i];
+        scratch.neighbors.clear();
+        for(int triId : scratch.vertexTriangles[i])
+        {
+            for(int k = 0; k < 3; ++k)
+            {
+                const int neighborId = _mesh.tris[triId].v[k];
+                if(neighborId > ptId && _vertexPatch[neighborId] == patchId)
+                    scratch.neighbors.push_back(neighborId);
+            }
+        }
+        sortUnique(scratch.neighbors);
+
+        for(int neighborId : scratch.neighbors)
+            pushCandidate(ptId, neighborId, scratch);
+    }
+    std::make_heap(scratch.queue.begin(), scratch.queue.end(), std::greater<CollapseCandidate>());
+
+    int nbCollapses = 0;
+    while(nbCollapses < maxNbCollapses && !scratch.queue.empty())
+    {
+        std::pop_heap(scratch.queue.begin(), scratch.queue.end(), std::greater<CollapseCandidate>());
+        const CollapseCandidate candidate = scratch.queue.back();
+        scratch.queue.pop_back();
+
+        // skip the candidates outdated by previous collapses
+        const int indexA = _localIndex[candidate.a];
+        const int indexB = _localIndex[candidate.b];
+        if(scratch.isRemoved[indexA] || scratch.isRemoved[indexB] ||
+           scratch.stamps[indexA] != candidate.stampA || scratch.stamps[indexB] != candidate.stampB)
+            continue;
+
+        Collapse collapse;
+        computeCollapse(candidate.a, candidate.b, collapse);
+        if(!isCollapseValid(collapse, scratch))
+            continue;
+
+        applyCollapse(collapse, patchId, scratch);
+        ++nbCollapses;
+    }
+    return nbCollapses;
+}
+
+bool QuadricDecimater::computeCollapse(int a, int b, Collapse& out) const
+{
+    // locked vertices are handled by the next pass
+    if(_isLocked[a] || _isLocked[b])
+        return false;
+
+    const Quadric q = _quadrics[a] + _quadrics[b];
+    const Point3d& pa = _mesh.pts[a];
+    const Point3d& pb = _mesh.pts[b];
+
+    int keepId = b;
+    int removeId = a;
+    Point3d position;
+    if(_isBoundary[a] != _isBoundary[b])
+    {
+        // the border vertex does not move
+        if(_isBoundary[a])
+            std::swap(keepId, removeId);
+        position = _mesh.pts[keepId];
+    }
+    else if(!q.getMinimum(position) || (position - (pa + pb) * 0.5).size() > (pb - pa).size())
+    {
+        // best of the edge end points and middle
+        const Point3d middle = (pa + pb) * 0.5;
+        const double errorA = q.evaluate(pa);
+        const double errorB = q.evaluate(pb);
+        const double errorMiddle = q.evaluate(middle);
+        if(errorA < errorB && errorA < errorMiddle)
+        {
+            std::swap(keepId, removeId);
+            position = pa;
+        }
+        else
+        {
+            position = (errorB <= errorMiddle) ? pb : middle;
+        }
+    }
+
+    out.cost = q.evaluate(position);
+    out.removeId = removeId;
+    out.keepId = keepId;
+    out.position = position;
+    return true;
+}
+
+void QuadricDecimater::pushCandidate(int a, int b, PatchScratch& scratch) const
+{
+    // the collapse is recomputed when the candidate is dequeued, to keep the queue compact
+    Collapse collapse;
+    if(!computeCollapse(a, b, collapse) || collapse.cost > scratch.maxCost)
+        return;
+    scratch.queue.push_back({collapse.cost, a, b, scratch.stamps[_localIndex[a]], scratch.stamps[_localIndex[b]]});
+}
+
+double QuadricDecimater::computeCostThreshold(const std::vector<int>& vertices, int nbToRemove) const
+{
+    // cheapest collapse of each vertex which can be removed in this pass
+    std::vector<double> costs(vertices.size(), std::numeric_limits<double>::max());
+
+    #pragma omp parallel for
+    for(int i = 0; i < vertices.size(); ++i)
+    {
+        const int ptId = vertices[i];
+        if(_isLocked[ptId])
+            continue;
+        Collapse collapse;
+        for(int triId : _adjacency->getTriangles(ptId))
+        {
+            for(int neighborId : _mesh.tris[triId].v)
+            {
+                if(neighborId != ptId && computeCollapse(ptId, neighborId, collapse))
+                    costs[i] = std::min(costs[i], collapse.cost);
+            }
+        }
+    }
+    costs.erase(std::remove(costs.begin(), costs.end(), std::numeric_limits<double>::max()), costs.end());
+    if(costs.empty())
+        return 0.0;
+
+    // the vertices to remove proportionally to the vertices which can be removed
+    const int nth = std::min<long long>(costThresholdRankFactor * static_cast<long long>(nbToRemove) * costs.size() / vertices.size(), costs.size() - 1);
+    std::nth_element(costs.begin(), costs.begin() + nth, costs.end());
+    return costs[nth];
+}
+
+bool QuadricDecimater::isTriangleFlipped(int triId, int movedPtId, const Point3d& position) const
+{
+    Point3d before[3];
+    Point3d after[3];
+    for(int k = 0; k < 3; ++k)
+    {
+        const int ptId = _mesh.tris[triId].v[k];
+        before[k] = _mesh.pts[ptId];
+        after[k] = (ptId == movedPtId) ? position : before[k];
+    }
+    const Point3d normalBefore = cross(before[1] - before[0], before[2] - before[0]);
+    const Point3d normalAfter = cross(after[1] - after[0], after[2] - after[0]);
+
+    // degenerated triangle
+    const double sqEdgesLength = dot(after[1] - after[0], after[1] - after[0]) + dot(after[2] - after[0], after[2] - after[0]);
+    if(dot(normalAfter, normalAfter) <= 1e-12 * sqEdgesLength * sqEdgesLength)
+        return true;
+
+    return dot(normalBefore, normalAfter) < 0.0;
+}
+
+bool QuadricDecimater::isCollapseValid(const Collapse& collapse, PatchScratch& scratch) const
+{
+    const int removeId = collapse.removeId;
+    const int keepId = collapse.keepId;
+    const std::vector<int>& removeTris = scratch.vertexTriangles[_localIndex[removeId]];
+    const std::vector<int>& keepTris = scratch.vertexTriangles[_localIndex[keepId]];
+
+    int nbEdgeTris = 0;
+    scratch.neighbors.clear();
+    for(int triId : removeTris)
+    {
+        if(_mesh.getTriPtIndex(triId, keepId, false) != -1)
+            ++nbEdgeTris;
+        for(int k = 0; k < 3; ++k)
+        {
+            const int ptId = _mesh.tris[triId].v[k];
+            if(ptId != removeId && ptId != keepId)
+                scratch.neighbors.push_back(ptId);
+        }
+    }
+    if(nbEdgeTris == 0 || nbEdgeTris > 2)
+        return false;
+
+    // an inner edge between two border vertices would pinch the border
+    if(nbEdgeTris == 2 && _isBoundary[removeId] && _isBoundary[keepId])
+        return false;
+
+    scratch.otherNeighbors.clear();
+    for(int triId : keepTris)
+    {
+        for(int k = 0; k < 3; ++k)
+        {
+            const int ptId = _mesh.tris[triId].v[k];
+            if(ptId != removeId && ptId != keepId)
+                scratch.otherNeighbors.push_back(ptId);
+        }
+    }
+    sortUnique(scratch.neighbors);
+    sortUnique(scratch.otherNeighbors);
+
+    // link condition: the only common neighbors are the opposite vertices of the edge triangles
+    int nbCommonNeighbors = 0;
+    for(auto it = scratch.neighbors.begin(), otherIt = scratch.otherNeighbors.begin();
+        it != scratch.neighbors.end() && otherIt != scratch.otherNeighbors.end();)
+    {
+        if(*it < *otherIt)
+            ++it;
+        else if(*otherIt < *it)
+            ++otherIt;
+        else
+        {
+            ++nbCommonNeighbors;
+            ++it;
+            ++otherIt;
+        }
+    }
+    if(nbCommonNeighbors != nbEdgeTris)
+        return false;
+
+    // no triangle flip around the moved vertices
+    for(int triId : removeTris)
+    {
+        if(_mesh.getTriPtIndex(triId, keepId, false) == -1 && isTriangleFlipped(triId, removeId, collapse.position))
+            return false;
+    }
+    if(!(collapse.position == _mesh.pts[keepId]))
+    {
+        for(int triId : keepTris)
+        {
+            if(_mesh.getTriPtIndex(triId, removeId, false) == -1 && isTriangleFlipped(triId, keepId, collapse.position))
+                return false;
+        }
+    }
+    return true;
+}
+
+void QuadricDecimater::applyCollapse(const Collapse& collapse, int patchId, PatchScratch& scratch)
+{
+    const int removeId = collapse.removeId;
+    const int keepId = collapse.keepId;
+    const int removeIndex = _localIndex[removeId];
+    const int keepIndex = _localIndex[keepId];
+    std::vector<int>& removeTris = scratch.vertexTriangles[removeIndex];
+    std::vector<int>& keepTris = scratch.vertexTriangles[keepIndex];
+
+    // the triangles of the removed vertex are inside the patch, their vertices are local
+    for(int triId : removeTris)
+    {
+        Mesh::triangle& t = _mesh.tris[triId];
+        const int k = _mesh.getTriPtIndex(triId, removeId);
+        if(_mesh.getTriPtIndex(triId, keepId, false) != -1)
+        {
+            t.alive = false;
+            for(int ptId : t.v)
+            {
+                if(ptId == removeId)
+                    continue;
+                std::vector<int>& ptTris = scratch.vertexTriangles[_localIndex[ptId]];
+                ptTris.erase(std::find(ptTris.begin(), ptTris.end(), triId));
+            }
+        }
+        else
+        {
+            t.v[k] = keepId;
+            keepTris.push_back(triId);
+        }
+    }
+    removeTris.clear();
+    scratch.isRemoved[removeIndex] = 1;
+
+    _quadrics[keepId] += _quadrics[removeId];
+    _isBoundary[keepId] = _isBoundary[keepId] || _isBoundary[removeId];
+    _mesh.pts[keepId] = collapse.position;
+    ++scratch.stamps[keepIndex];
+
+    // new candidates around the kept vertex
+    scratch.neighbors.clear();
+    for(int triId : keepTris)
+    {
+        for(int ptId : _mesh.tris[triId].v)
+        {
+            if(ptId != keepId && _vertexPatch[ptId] == patchId)
+                scratch.neighbors.push_back(ptId);
+        }
+    }
+    sortUnique(scratch.neighbors);
+
+    for(int neighborId : scratch.neighbors)
+    {
+        const std::size_t queueSize = scratch.queue.size();
+        pushCandidate(keepId, neighborId, scratch);
+        if(scratch.queue.size() != queueSize)
+            std::push_heap(scratch.queue.begin(), scratch.queue.end(), std::greater<CollapseCandidate>());
+    }
+}
+
+} // namespace
+
+int decimateMesh(Mesh& mesh, int targetNbVertices, const DecimationParams& params)
+{
+    system::Timer timer;
+    ALICEVISION_LOG_INFO("Decimate mesh from " << mesh.pts.size() << " to " << targetNbVertices << " vertices.");
+
+    QuadricDecimater decimater(mesh, params);
+    const int nbRemoved = decimater.decimate(targetNbVertices);
+
+    ALICEVISION_LOG_INFO("Mesh decimated to " << mesh.pts.size() << " vertices and " << mesh.tris.size() << " triangles in " << timer.elapsed() << " s.");
+    return nbRemoved;
+}
+
+} // namespace mesh
+} // namespace aliceVision
@@ -0,0 +1,43 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mesh/Mesh.hpp>
+
+namespace aliceVision {
+namespace mesh {
+
+struct DecimationParams
+{
+    /// Approximate number of vertices in each patch decimated by a thread
+    int nbVerticesPerPatch = 50000;
+    /// Maximal ratio of the vertices of a patch removed in a parallel pass, keeps a uniform density between the patches
+    double maxPassRemovalRatio = 0.5;
+    /// Maximal number of parallel passes, the patches borders are shifted from one pass to the next
+    int maxNbParallelPasses = 20;
+    /// Weight of the planes orthogonal to the open borders, to preserve the mesh boundaries
+    double boundaryWeight = 1000.0;
+};
+
+/**
+ * @brief Decimate a mesh with quadric error metric edge collapses (Garland and Heckbert).
+ *
+ * The mesh is split into patches of consecutive vertices along a Morton curve, which are decimated in parallel,
+ * the vertices on the patches borders being locked. Each parallel pass removes at most a ratio of the vertices of
+ * the patches, which are shifted from one pass to the next. A final pass on the remaining borders reaches the exact target.
+ * Collapses preserve the manifold topology, the open borders and the triangles orientation.
+ * Free vertices are removed, texture coordinates, normals, materials and visibilities are dropped.
+ *
+ * @param[in,out] mesh the mesh to decimate
+ * @param[in] targetNbVertices the number of vertices of the decimated mesh
+ * @param[in] params the decimation parameters
+ * @return the number of removed vertices
+ */
+int decimateMesh(Mesh& mesh, int targetNbVertices, const DecimationParams& params = DecimationParams());
+
+} // namespace mesh
+} // namespace aliceVision
@@ -0,0 +1,154 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/meshDecimation.hpp>
+#include <aliceVision/mesh/meshTestCommon.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <utility>
+
+#define BOOST_TEST_MODULE meshDecimation
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace {
+
+/// Regular triangulation of a n x n grid on the plane z = 0
+void createPlaneGridMesh(int n, Mesh& out_mesh)
+{
+    test::createGridMesh(n, [](int x, int y) { return Point3d(x, y, 0.0); }, out_mesh);
+}
+
+/// Unit sphere made of a subdivided octahedron
+void createSphereMesh(int nbSubdivisions, Mesh& out_mesh)
+{
+    out_mesh.pts.push_back(Point3d(1.0, 0.0, 0.0));
+    out_mesh.pts.push_back(Point3d(-1.0, 0.0, 0.0));
+    out_mesh.pts.push_back(Point3d(0.0, 1.0, 0.0));
+    out_mesh.pts.push_back(Point3d(0.0, -1.0, 0.0));
+    out_mesh.pts.push_back(Point3d(0.0, 0.0, 1.0));
+    out_mesh.pts.push_back(Point3d(0.0, 0.0, -1.0));
+    const int faces[8][3] = {{0, 2, 4}, {2, 1, 4}, {1, 3, 4}, {3, 0, 4}, {2, 0, 5}, {1, 2, 5}, {3, 1, 5}, {0, 3, 5}};
+    for(const auto& f : faces)
+        out_mesh.tris.push_back(Mesh::triangle(f[0], f[1], f[2]));
+
+    for(int s = 0; s < nbSubdivisions; ++s)
+    {
+        std::map<std::pair<int, int>, int> middles;
+        const auto getMiddle = [&](int a, int b) {
+            const auto edge = std::make_pair(std::min(a, b), std::max(a, b));
+            const auto it = middles.find(edge);
+            if(it != middles.end())
+                return it->second;
+            out_mesh.pts.push_back((out_mesh.pts[a] + out_mesh.pts[b]).normalize());
+            middles[edge] = out_mesh.pts.size() - 1;
+            return out_mesh.pts.size() - 1;
+        };
+
+        StaticVector<Mesh::triangle> tris;
+        for(int i = 0; i < out_mesh.tris.size(); ++i)
+        {
+            const int* v = out_mesh.tris[i].v;
+            const int ab = getMiddle(v[0], v[1]);
+            const int bc = getMiddle(v[1], v[2]);
+            const int ca = getMiddle(v[2], v[0]);
+            tris.push_back(Mesh::triangle(v[0], ab, ca));
+            tris.push_back(Mesh::triangle(ab, v[1], bc));
+            tris.push_back(Mesh::triangle(ca, bc, v[2]));
+            tris.push_back(Mesh::triangle(ab, bc, ca));
+        }
+        out_mesh.tris.swap(tris);
+    }
+}
+
+/// Check the mesh is a valid oriented manifold and return its Euler characteristic
+int checkManifoldAndGetEulerCharacteristic(const Mesh& mesh)
+{
+    // oriented edges are unique, inner edges appear in both directions
+    std::map<std::pair<int, int>, int> orientedEdges;
+    for(int i = 0; i < mesh.tris.size(); ++i)
+    {
+        const int* v = mesh.tris[i].v;
+        BOOST_CHECK(v[0] != v[1] && v[1] != v[2] && v[2] != v[0]);
+        for(int k = 0; k < 3; ++k)
+            ++orientedEdges[std::make_pair(v[k], v[(k + 1) % 3])];
+    }
+
+    int nbEdges = 0;
+    for(const auto& edge : orientedEdges)
+    {
+        BOOST_CHECK_EQUAL(edge.second, 1);
+        if(edge.first.first < edge.first.second || orientedEdges.count(std::make_pair(edge.first.second, edge.first.first)) == 0)
+            ++nbEdges;
+    }
+    return mesh.pts.size() - nbEdges + mesh.tris.size();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(meshDecimation_plane)
+{
+    Mesh mesh;
+    createPlaneGridMesh(100, mesh);
+
+    DecimationParams params;
+    params.nbVerticesPerPatch = 500;
+    BOOST_CHECK_EQUAL(decimateMesh(mesh, 1000, params), 101 * 101 - 1000);
+
+    BOOST_CHECK_EQUAL(mesh.pts.size(), 1000);
+    BOOST_CHECK_EQUAL(checkManifoldAndGetEulerCharacteristic(mesh), 1);
+
+    // the plane and its borders are preserved
+    double area = 0.0;
+    for(int i = 0; i < mesh.tris.size(); ++i)
+        area += mesh.computeTriangleArea(i);
+    BOOST_CHECK_CLOSE(area, 100.0 * 100.0, 1e-6);
+    for(int i = 0; i < mesh.pts.size(); ++i)
+    {
+        BOOST_CHECK_SMALL(mesh.pts[i].z, 1e-9);
+        BOOST_CHECK(mesh.pts[i].x >= -1e-9 && mesh.pts[i].x <= 100.0 + 1e-9);
+        BOOST_CHECK(mesh.pts[i].y >= -1e-9 && mesh.pts[i].y <= 100.0 + 1e-9);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(meshDecimation_sphere)
+{
+    Mesh mesh;
+    createSphereMesh(6, mesh);
+    const int nbInputVertices = mesh.pts.size();
+
+    DecimationParams params;
+    params.nbVerticesPerPatch = 2000;
+    decimateMesh(mesh, nbInputVertices / 20, params);
+
+    BOOST_CHECK_EQUAL(mesh.pts.size(), nbInputVertices / 20);
+    BOOST_CHECK_EQUAL(checkManifoldAndGetEulerCharacteristic(mesh), 2);
+
+    // vertices stay on the sphere
+    for(int i = 0; i < mesh.pts.size(); ++i)
+        BOOST_CHECK_SMALL(mesh.pts[i].size() - 1.0, 0.01);
+
+    // triangles keep their outward orientation
+    for(int i = 0; i < mesh.tris.size(); ++i)
+        BOOST_CHECK_GT(dot(mesh.computeTriangleNormal(i), mesh.computeTriangleCenterOfGravity(i)), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(meshDecimation_target)
+{
+    Mesh mesh;
+    createPlaneGridMesh(10, mesh);
+    // free vertex
+    mesh.pts.push_back(Point3d(0.0, 0.0, 1.0));
+
+    BOOST_CHECK_EQUAL(decimateMesh(mesh, 1000), 1);
+    BOOST_CHECK_EQUAL(mesh.pts.size(), 11 * 11);
+    BOOST_CHECK_EQUAL(mesh.tris.size(), 2 * 10 * 10);
+}
@@ -0,0 +1,784 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "meshIO.hpp"
+#include <aliceVision/system/Logger.hpp>
+
+#include <boost/endian/conversion.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace aliceVision {
+namespace mesh {
+
+namespace {
+
+/// Number of vertices or triangles converted at once when streaming a binary file
+const int binaryChunkSize = 1 << 18;
+
+/// Number of lines formatted by a thread at once when writing a text file
+const int textBlockSize = 1 << 14;
+
+/// Magic number of the versioned binary mesh format
+const char binMagic[4] = {'A', 'V', 'M', 'B'};
+const std::uint32_t binVersion = 1;
+
+const bool isBigEndianHost = (boost::endian::order::native == boost::endian::order::big);
+
+/// Write a value in little-endian and move the pointer after it
+template <typename T>
+void writeLittleEndian(char*& ptr, T value)
+{
+    std::memcpy(ptr, &value, sizeof(T));
+    if(isBigEndianHost)
+        std::reverse(ptr, ptr + sizeof(T));
+    ptr += sizeof(T);
+}
+
+/// Read a little-endian value and move the pointer after it
+template <typename T>
+T readLittleEndian(const char*& ptr)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, ptr, sizeof(T));
+    if(isBigEndianHost)
+        std::reverse(bytes, bytes + sizeof(T));
+    ptr += sizeof(T);
+    T value;
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+/**
+ * @brief Format lines by blocks in parallel and write them in order.
+ * @param[in] formatLine function writing the line i in a char[128] buffer and returning its length
+ */
+template <typename FormatLine>
+void writeLines(std::ostream& out, int nbLines, const FormatLine& formatLine)
+{
+    const int nbBlocksPerBatch = 64;
+    std::vector<std::string> blocks(nbBlocksPerBatch);
+
+    for(int batchFirstLine = 0; batchFirstLine < nbLines; batchFirstLine += nbBlocksPerBatch * textBlockSize)
+    {
+        const int nbBlocks = std::min(nbBlocksPerBatch, (nbLines - batchFirstLine + textBlockSize - 1) / textBlockSize);
+
+        #pragma omp parallel for
+        for(int b = 0; b < nbBlocks; ++b)
+        {
+            const int firstLine = batchFirstLine + b * textBlockSize;
+            const int lastLine = std::min(firstLine + textBlockSize, nbLines);
+            std::string& block = blocks[b];
+            block.clear();
+            char line[128];
+            for(int i = firstLine; i < lastLine; ++i)
+                block.append(line, formatLine(i, line));
+        }
+
+        for(int b = 0; b < nbBlocks; ++b)
+            out.write(blocks[b].data(), blocks[b].size());
+    }
+}
+
+enum class EPlyType
+{
+    INT8,
+    UINT8,
+    INT16,
+    UINT16,
+    INT32,
+    UINT32,
+    FLOAT32,
+    FLOAT64
+};
+
+EPlyType EPlyType_stringToEnum(const std::string& type)
+{
+    if(type == "char" || type == "int8")
+        return EPlyType::INT8;
+    if(type == "uchar" || type == "uint8")
+        return EPlyType::UINT8;
+    if(type == "short" || type == "int16")
+        return EPlyType::INT16;
+    if(type == "ushort" || type == "uint16")
+        return EPlyType::UINT16;
+    if(type == "int" || type == "int32")
+        return EPlyType::INT32;
+    if(type == "uint" || type == "uint32")
+        return EPlyType::UINT32;
+    if(type == "float" || type == "float32")
+        return EPlyType::FLOAT32;
+    if(type == "double" || type == "float64")
+        return EPlyType::FLOAT64;
+    throw std::out_of_range("Invalid PLY property type " + type);
+}
+
+bool isFloatingPoint(EPlyType type)
+{
+    return type == EPlyType::FLOAT32 || type == EPlyType::FLOAT64;
+}
+
+struct PlyProperty
+{
+    std::string name;
+    /// type of the value, or of the items for a list
+    EPlyType type = EPlyType::FLOAT32;
+    bool isList = false;
+    /// type of the number of items of a list
+    EPlyType countType = EPlyType::UINT8;
+};
+
+struct PlyElement
+{
+    std::string name;
+    std::size_t count = 0;
+    std::vector<PlyProperty> properties;
+
+    /// Index of the first property with one of the names, -1 if none
+    int getPropertyIndex(std::initializer_list<const char*> names) const
+    {
+        for(const char* name : names)
+        {
+            for(int i = 0; i < properties.size(); ++i)
+            {
+                if(properties[i].name == name)
+                    return i;
+            }
+        }
+        return -1;
+    }
+};
+
+/**
+ * @brief Buffered reader of the binary part of a PLY file
+ */
+class PlyBinaryReader
+{
+public:
+    PlyBinaryReader(std::istream& in, bool isBigEndianFile)
+      : _in(in)
+      , _swapBytes(isBigEndianFile != isBigEndianHost)
+      , _buffer(1 << 22)
+    {}
+
+    double read(EPlyType type)
+    {
+        switch(type)
+        {
+            case EPlyType::INT8: return get<std::int8_t>();
+            case EPlyType::UINT8: return get<std::uint8_t>();
+            case EPlyType::INT16: return get<std::int16_t>();
+            case EPlyType::UINT16: return get<std::uint16_t>();
+            case EPlyType::INT32: return get<std::int32_t>();
+            case EPlyType::UINT32: return get<std::uint32_t>();
+            case EPlyType::FLOAT32: return get<float>();
+            case EPlyType::FLOAT64: return get<double>();
+        }
+        throw std::out_of_range("Invalid PLY property type");
+    }
+
+    /// Read a property, skipping the items of a list
+    double readProperty(const PlyProperty& property)
+    {
+        if(!property.isList)
+            return read(property.type);
+
+        const int nbItems = static_cast<int>(read(property.countType));
+        for(int i = 0; i < nbItems; ++i)
+            read(property.type);
+        return nbItems;
+    }
+
+private:
+    template <typename T>
+    T get()
+    {
+        if(_end - _pos < sizeof(T))
+            fill(sizeof(T));
+
+        char bytes[sizeof(T)];
+        std::memcpy(bytes, &_buffer[_pos], sizeof(T));
+        _pos += sizeof(T);
+        if(_swapBytes)
+            std::reverse(bytes, bytes + sizeof(T));
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+    /// Keep the remaining bytes and read the next part of the file
+    void fill(std::size_t minSize)
+    {
+        std::copy(_buffer.begin() + _pos, _buffer.begin() + _end, _buffer.begin());
+        _end -= _pos;
+        _pos = 0;
+        _in.read(&_buffer[_end], _buffer.size() - _end);
+        _end += _in.gcount();
+        if(_end < minSize)
+            ALICEVISION_THROW_ERROR("Unexpected end of PLY file.");
+    }
+
+    std::istream& _in;
+    const bool _swapBytes;
+    std::vector<char> _buffer;
+    std::size_t _pos = 0;
+    std::size_t _end = 0;
+};
+
+/// Convert a PLY color component to [0, 255]
+unsigned char toColorComponent(double value, EPlyType type)
+{
+    if(isFloatingPoint(type))
+        value *= 255.0;
+    return static_cast<unsigned char>(std::min(std::max(value, 0.0), 255.0));
+}
+
+/**
+ * @brief Merge the vertices with the same position, color and texture coordinates, as aiProcess_JoinIdenticalVertices.
+ * The first occurrence of each vertex is kept, in the file order.
+ * @return the number of removed vertices
+ */
+int joinIdenticalVertices(Mesh& mesh)
+{
+    const int nbPts = mesh.pts.size();
+    const bool hasColors = (mesh.colors().size() == static_cast<std::size_t>(nbPts));
+    const bool hasUVs = (mesh.uvCoords.size() == nbPts);
+
+    // -1, 0 or 1 as the position, color and texture coordinates of a are less, equal or greater than the ones of b
+    const auto compare = [&](int a, int b) {
+        const auto compareValues = [](double va, double vb) { return (va < vb) ? -1 : (vb < va) ? 1 : 0; };
+        int c = compareValues(mesh.pts[a].x, mesh.pts[b].x);
+        if(c == 0)
+            c = compareValues(mesh.pts[a].y, mesh.pts[b].y);
+        if(c == 0)
+            c = compareValues(mesh.pts[a].z, mesh.pts[b].z);
+        if(c == 0 && hasColors)
+        {
+            const rgb& ca = mesh.colors()[a];
+            const rgb& cb = mesh.colors()[b];
+            c = compareValues(ca.r, cb.r);
+            if(c == 0)
+                c = compareValues(ca.g, cb.g);
+            if(c == 0)
+                c = compareValues(ca.b, cb.b);
+        }
+        if(c == 0 && hasUVs)
+        {
+            c = compareValues(mesh.uvCoords[a].x, mesh.uvCoords[b].x);
+            if(c == 0)
+                c = compareValues(mesh.uvCoords[a].y, mesh.uvCoords[b].y);
+        }
+        return c;
+    };
+
+    std::vector<int> order(nbPts);
+    for(int i = 0; i < nbPts; ++i)
+        order[i] = i;
+    // identical vertices sorted by index, the first one of a run is the first occurrence
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        const int c = compare(a, b);
+        return (c != 0) ? (c < 0) : (a < b);
+    });
+
+    // each vertex refers to the first occurrence of its identical vertices
+    std::vector<int> firstPtId(nbPts);
+    int nbRemoved = 0;
+    for(int i = 0; i < nbPts; ++i)
+    {
+        const bool isIdentical = (i > 0 && compare(order[i - 1], order[i]) == 0);
+        firstPtId[order[i]] = isIdentical ? firstPtId[order[i - 1]] : order[i];
+        if(isIdentical)
+            ++nbRemoved;
+    }
+    if(nbRemoved == 0)
+        return 0;
+
+    std::vector<int> newPtId(nbPts, -1);
+    int nbNewPts = 0;
+    for(int i = 0; i < nbPts; ++i)
+    {
+        if(firstPtId[i] != i)
+            continue;
+        newPtId[i] = nbNewPts;
+        mesh.pts[nbNewPts] = mesh.pts[i];
+        if(hasColors)
+            mesh.colors()[nbNewPts] = mesh.colors()[i];
+        if(hasUVs)
+            mesh.uvCoords[nbNewPts] = mesh.uvCoords[i];
+        ++nbNewPts;
+    }
+    mesh.pts.resize(nbNewPts);
+    if(hasColors)
+        mesh.colors().resize(nbNewPts);
+    if(hasUVs)
+        mesh.uvCoords.resize(nbNewPts);
+
+    for(int i = 0; i < mesh.tris.size(); ++i)
+    {
+        for(int k = 0; k < 3; ++k)
+            mesh.tris[i].v[k] = newPtId[firstPtId[mesh.tris[i].v[k]]];
+    }
+
+    return nbRemoved;
+}
+
+} // namespace
+
+void saveMeshAsPly(const Mesh& mesh, const std::string& filepath)
+{
+    std::ofstream out(filepath, std::ios::binary);
+    if(!out)
+        ALICEVISION_THROW_ERROR("Unable to create the mesh file: " << filepath);
+
+    const bool hasColors = !mesh.colors().empty() && mesh.colors().size() == mesh.pts.size();
+
+    out << "ply\n"
+        << "format binary_little_endian 1.0\n"
+        << "comment Generated by AliceVision\n"
+        << "element vertex " << mesh.pts.size() << "\n"
+        << "property float x\n"
+        << "property float y\n"
+        << "property float z\n";
+    if(hasColors)
+    {
+        out << "property uchar red\n"
+            << "property uchar green\n"
+            << "property uchar blue\n";
+    }
+    out << "element face " << mesh.tris.size() << "\n"
+        << "property list uchar int vertex_indices\n"
+        << "end_header\n";
+
+    std::vector<char> buffer;
+
+    const std::size_t vertexSize = 3 * sizeof(float) + (hasColors ? 3 : 0);
+    for(int first = 0; first < mesh.pts.size(); first += binaryChunkSize)
+    {
+        const int last = std::min(first + binaryChunkSize, mesh.pts.size());
+        buffer.resize((last - first) * vertexSize);
+
+        #pragma omp parallel for
+        for(int i = first; i < last; ++i)
+        {
+            char* ptr = &buffer[(i - first) * vertexSize];
+            const Point3d& p = mesh.pts[i];
+            writeLittleEndian(ptr, static_cast<float>(p.x));
+            writeLittleEndian(ptr, static_cast<float>(-p.y));
+            writeLittleEndian(ptr, static_cast<float>(-p.z));
+            if(hasColors)
+            {
+                const rgb& c = mesh.colors()[i];
+                writeLittleEndian(ptr, c.r);
+                writeLittleEndian(ptr, c.g);
+                writeLittleEndian(ptr, c.b);
+            }
+        }
+        out.write(buffer.data(), buffer.size());
+    }
+
+    const std::size_t faceSize = 1 + 3 * sizeof(std::int32_t);
+    for(int first = 0; first < mesh.tris.size(); first += binaryChunkSize)
+    {
+        const int last = std::min(first + binaryChunkSize, mesh.tris.size());
+        buffer.resize((last - first) * faceSize);
+
+        #pragma omp parallel for
+        for(int i = first; i < last; ++i)
+        {
+            char* ptr = &buffer[(i - first) * faceSize];
+            writeLittleEndian(ptr, std::uint8_t(3));
+            for(int k = 0; k < 3; ++k)
+                writeLittleEndian(ptr, static_cast<std::int32_t>(mesh.tris[i].v[k]));
+        }
+        out.write(buffer.data(), buffer.size());
+    }
+
+    if(!out)
+        ALICEVISION_THROW_ERROR("Failed to write the mesh file: " << filepath);
+}
+
+void saveMeshAsObj(const Mesh& mesh, const std::string& filepath)
+{
+    std::ofstream out(filepath, std::ios::binary);
+    if(!out)
+        ALICEVISION_THROW_ERROR("Unable to create the mesh file: " << filepath);
+
+    out << "# Generated by AliceVision\n";
+
+    writeLines(out, mesh.pts.size(), [&](int i, char* line) {
+        const Point3d& p = mesh.pts[i];
+        return std::snprintf(line, 128, "v %.9g %.9g %.9g\n", p.x, -p.y, -p.z);
+    });
+
+    // OBJ indexes start at 1
+    writeLines(out, mesh.tris.size(), [&](int i, char* line) {
+        const Mesh::triangle& t = mesh.tris[i];
+        return std::snprintf(line, 128, "f %d %d %d\n", t.v[0] + 1, t.v[1] + 1, t.v[2] + 1);
+    });
+
+    if(!out)
+        ALICEVISION_THROW_ERROR("Failed to write the mesh file: " << filepath);
+}
+
+bool loadMeshFromPly(Mesh& mesh, const std::string& filepath)
+{
+    std::ifstream in(filepath, std::ios::binary);
+    if(!in)
+        ALICEVISION_THROW_ERROR("Unable to open the mesh file: " << filepath);
+
+    // header
+    std::vector<PlyElement> elements;
+    bool isBigEndianFile = false;
+    bool isFormatSupported = false;
+    bool isHeaderComplete = false;
+    std::string line;
+    for(int lineIndex = 0; std::getline(in, line); ++lineIndex)
+    {
+        if(!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        std::istringstream lineStream(line);
+        std::string keyword;
+        lineStream >> keyword;
+
+        if(lineIndex == 0)
+        {
+            if(keyword != "ply")
+                return false;
+        }
+        else if(keyword == "format")
+        {
+            std::string format;
+            lineStream >> format;
+            isFormatSupported = (format == "binary_little_endian" || format == "binary_big_endian");
+            isBigEndianFile = (format == "binary_big_endian");
+        }
+        else if(keyword == "element")
+        {
+            PlyElement element;
+            lineStream >> element.name >> element.count;
+            elements.push_back(element);
+        }
+        else if(keyword == "property")
+        {
+            if(elements.empty())
+                ALICEVISION_THROW_ERROR("Invalid PLY header, property without element: " << filepath);
+
+            PlyProperty property;
+            std::string type;
+            lineStream >> type;
+            try
+            {
+                if(type == "list")
+                {
+                    std::string countType;
+                    lineStream >> countType >> type;
+                    property.isList = true;
+                    property.countType = EPlyType_stringToEnum(countType);
+                }
+                property.type = EPlyType_stringToEnum(type);
+            }
+            catch(const std::out_of_range&)
+            {
+                // unknown type, left to Assimp
+                ALICEVISION_LOG_DEBUG("Unsupported PLY property type " << type << ": " << filepath);
+                return false;
+            }
+            lineStream >> property.name;
+            elements.back().properties.push_back(property);
+        }
+        else if(keyword == "end_header")
+        {
+            isHeaderComplete = true;
+            break;
+        }
+    }
+
+    if(!isHeaderComplete)
+        ALICEVISION_THROW_ERROR("Invalid PLY header: " << filepath);
+
+    if(!isFormatSupported)
+        return false;
+
+    for(const PlyElement& element : elements)
+    {
+        if(element.name == "face" && element.getPropertyIndex({"texcoord"}) != -1)
+            return false;
+    }
+
+    // data
+    PlyBinaryReader reader(in, isBigEndianFile);
+    std::vector<double> values;
+    std::vector<int> faceIndexes;
+    bool hasUVs = false;
+
+    for(const PlyElement& element : elements)
+    {
+        values.resize(element.properties.size());
+
+        if(element.name == "vertex")
+        {
+            const int x = element.getPropertyIndex({"x"});
+            const int y = element.getPropertyIndex({"y"});
+            const int z = element.getPropertyIndex({"z"});
+            if(x == -1 || y == -1 || z == -1)
+                ALICEVISION_THROW_ERROR("Invalid PLY file, vertices without coordinates: " << filepath);
+
+            const int r = element.getPropertyIndex({"red", "diffuse_red"});
+            const int g = element.getPropertyIndex({"green", "diffuse_green"});
+            const int b = element.getPropertyIndex({"blue", "diffuse_blue"});
+            const bool hasColors = (r != -1 && g != -1 && b != -1);
+
+            const int u = element.getPropertyIndex({"s", "u", "texture_u", "texture_s"});
+            const int v = element.getPropertyIndex({"t", "v", "texture_v", "texture_t"});
+            hasUVs = (u != -1 && v != -1);
+
+            mesh.pts.reserve(mesh.pts.size() + element.count);
+            for(std::size_t i = 0; i < element.count; ++i)
+            {
+                for(int p = 0; p < element.properties.size(); ++p)
+                    values[p] = reader.readProperty(element.properties[p]);
+
+                mesh.pts.push_back(Point3d(values[x], -values[y], -values[z]));
+                if(hasColors)
+                {
+                    mesh.colors().push_back(rgb(toColorComponent(values[r], element.properties[r].type),
+                                                toColorComponent(values[g], element.properties[g].type),
+                                                toColorComponent(values[b], element.properties[b].type)));
+                }
+                if(hasUVs)
+                    mesh.uvCoords.push_back(Point2d(values[u], values[v]));
+            }
+        }
+        else if(element.name == "face")
+        {
+            const int indexes = element.getPropertyIndex({"vertex_indices", "vertex_index"});
+            if(indexes == -1 || !element.properties[indexes].isList)
+                ALICEVISION_THROW_ERROR("Invalid PLY file, faces without vertex indices: " << filepath);
+            const PlyProperty& indexesProperty = element.properties[indexes];
+
+            mesh.tris.reserve(mesh.tris.size() + element.count);
+            for(std::size_t i = 0; i < element.count; ++i)
+            {
+                for(int p = 0; p < element.properties.size(); ++p)
+                {
+                    if(p != indexes)
+                    {
+                        reader.readProperty(element.properties[p]);
+                        continue;
+                    }
+                    faceIndexes.resize(static_cast<int>(reader.read(indexesProperty.countType)));
+                    for(int& index : faceIndexes)
+                        index = static_cast<int>(reader.read(indexesProperty.type));
+                }
+
+                // split polygons in triangles fans
+                for(int k = 1; k + 1 < faceIndexes.size(); ++k)
+                    mesh.tris.push_back(Mesh::triangle(faceIndexes[0], faceIndexes[k], faceIndexes[k + 1]));
+            }
+        }
+        else
+        {
+            for(std::size_t i = 0; i < element.count; ++i)
+            {
+                for(const PlyProperty& property : element.properties)
+                    reader.readProperty(property);
+            }
+        }
+    }
+
+    const int nbPts = mesh.pts.size();
+    for(int i = 0; i < mesh.tris.size(); ++i)
+    {
+        for(int k = 0; k < 3; ++k)
+        {
+            const int ptId = mesh.tris[i].v[k];
+            if(ptId < 0 || ptId >= nbPts)
+                ALICEVISION_THROW_ERROR("Invalid PLY file, vertex index " << ptId << " out of range: " << filepath);
+        }
+    }
+
+    const int nbJoinedPts = joinIdenticalVertices(mesh);
+    if(nbJoinedPts > 0)
+        ALICEVISION_LOG_DEBUG(nbJoinedPts << " identical vertices joined: " << filepath);
+
+    // remove the degenerate triangles, as aiProcess_FindDegenerates
+    int nbTris = 0;
+    for(int i = 0; i < mesh.tris.size(); ++i)
+    {
+        const Mesh::triangle& t = mesh.tris[i];
+        if(mesh.pts[t.v[0]] == mesh.pts[t.v[1]] || mesh.pts[t.v[1]] == mesh.pts[t.v[2]] || mesh.pts[t.v[2]] == mesh.pts[t.v[0]])
+            continue;
+        mesh.tris[nbTris++] = t;
+    }
+    mesh.tris.resize(nbTris);
+
+    mesh.trisMtlIds().resize(nbTris, 0);
+    mesh.trisUvIds.reserve(nbTris);
+    for(int i = 0; i < nbTris; ++i)
+    {
+        const Mesh::triangle& t = mesh.tris[i];
+        mesh.trisUvIds.push_back(hasUVs ? Voxel(t.v[0], t.v[1], t.v[2]) : Voxel());
+    }
+    mesh.invalidateAdjacency();
+
+    return true;
+}
+
+void saveMeshAsBin(const Mesh& mesh, const std::string& filepath)
+{
+    std::ofstream out(filepath, std::ios::binary);
+    if(!out)
+        ALICEVISION_THROW_ERROR("Unable to create the mesh file: " << filepath);
+
+    std::vector<char> buffer(sizeof(binMagic) + sizeof(binVersion) + sizeof(std::uint32_t));
+    char* ptr = buffer.data();
+    std::copy(binMagic, binMagic + sizeof(binMagic), ptr);
+    ptr += sizeof(binMagic);
+    writeLittleEndian(ptr, binVersion);
+    writeLittleEndian(ptr, static_cast<std::uint32_t>(mesh.pts.size()));
+    out.write(buffer.data(), buffer.size());
+
+    const std::size_t pointSize = 3 * sizeof(double);
+    for(int first = 0; first < mesh.pts.size(); first += binaryChunkSize)
+    {
+        const int last = std::min(first + binaryChunkSize, mesh.pts.size());
+        buffer.resize((last - first) * pointSize);
+        ptr = buffer.data();
+        for(int i = first; i < last; ++i)
+        {
+            writeLittleEndian(ptr, mesh.pts[i].x);
+            writeLittleEndian(ptr, mesh.pts[i].y);
+            writeLittleEndian(ptr, mesh.pts[i].z);
+        }
+        out.write(buffer.data(), buffer.size());
+    }
+
+    buffer.resize(sizeof(std::uint32_t));
+    ptr = buffer.data();
+    writeLittleEndian(ptr, static_cast<std::uint32_t>(mesh.tris.size()));
+    out.write(buffer.data(), buffer.size());
+
+    const std::size_t triangleSize = 3 * sizeof(std::int32_t) + 1;
+    for(int first = 0; first < mesh.tris.size(); first += binaryChunkSize)
+    {
+        const int last = std::min(first + binaryChunkSize, mesh.tris.size());
+        buffer.resize((last - first) * triangleSize);
+        ptr = buffer.data();
+        for(int i = first; i < last; ++i)
+        {
+            const Mesh::triangle& t = mesh.tris[i];
+            for(int k = 0; k < 3; ++k)
+                writeLittleEndian(ptr, static_cast<std::int32_t>(t.v[k]));
+            writeLittleEndian(ptr, static_cast<std::uint8_t>(t.alive));
+        }
+        out.write(buffer.data(), buffer.size());
+    }
+
+    if(!out)
+        ALICEVISION_THROW_ERROR("Failed to write the mesh file: " << filepath);
+}
+
+bool loadMeshFromBin(Mesh& mesh, const std::string& filepath)
+{
+    std::ifstream in(filepath, std::ios::binary);
+    if(!in)
+        return false;
+
+    char magic[sizeof(binMagic)];
+    if(!in.read(magic, sizeof(magic)))
+        return false;
+
+    if(!std::equal(magic, magic + sizeof(magic), binMagic))
+    {
+        // unversioned file, raw dump of the points and triangles
+        in.seekg(0);
+        int npts = 0;
+        if(!in.read(reinterpret_cast<char*>(&npts), sizeof(int)) || npts < 0)
+            return false;
+        mesh.pts = StaticVector<Point3d>();
+        mesh.pts.resize(npts);
+        if(!in.read(reinterpret_cast<char*>(mesh.pts.getDataWritable().data()), npts * sizeof(Point3d)))
+            return false;
+
+        int ntris = 0;
+        if(!in.read(reinterpret_cast<char*>(&ntris), sizeof(int)) || ntris < 0)
+            return false;
+        mesh.tris = StaticVector<Mesh::triangle>();
+        mesh.tris.resize(ntris);
+        if(!in.read(reinterpret_cast<char*>(mesh.tris.getDataWritable().data()), ntris * sizeof(Mesh::triangle)))
+            return false;
+
+        mesh.invalidateAdjacency();
+        return true;
+    }
+
+    std::vector<char> buffer(sizeof(binVersion) + sizeof(std::uint32_t));
+    if(!in.read(buffer.data(), buffer.size()))
+        return false;
+    const char* ptr = buffer.data();
+    const std::uint32_t version = readLittleEndian<std::uint32_t>(ptr);
+    if(version != binVersion)
+        ALICEVISION_THROW_ERROR("Unsupported binary mesh version " << version << ": " << filepath);
+    const std::uint32_t npts = readLittleEndian<std::uint32_t>(ptr);
+
+    mesh.pts = StaticVector<Point3d>();
+    mesh.pts.resize(npts);
+    const std::size_t pointSize = 3 * sizeof(double);
+    for(int first = 0; first < mesh.pts.size(); first += binaryChunkSize)
+    {
+        const int last = std::min(first + binaryChunkSize, mesh.pts.size());
+        buffer.resize((last - first) * pointSize);
+        if(!in.read(buffer.data(), buffer.size()))
+            return false;
+        ptr = buffer.data();
+        for(int i = first; i < last; ++i)
+        {
+            mesh.pts[i].x = readLittleEndian<double>(ptr);
+            mesh.pts[i].y = readLittleEndian<double>(ptr);
+            mesh.pts[i].z = readLittleEndian<double>(ptr);
+        }
+    }
+
+    buffer.resize(sizeof(std::uint32_t));
+    if(!in.read(buffer.data(), buffer.size()))
+        return false;
+    ptr = buffer.data();
+    const std::uint32_t ntris = readLittleEndian<std::uint32_t>(ptr);
+
+    mesh.tris = StaticVector<Mesh::triangle>();
+    mesh.tris.resize(ntris);
+    const std::size_t triangleSize = 3 * sizeof(std::int32_t) + 1;
+    for(int first = 0; first < mesh.tris.size(); first += binaryChunkSize)
+    {
+        const int last = std::min(first + binaryChunkSize, mesh.tris.size());
+        buffer.resize((last - first) * triangleSize);
+        if(!in.read(buffer.data(), buffer.size()))
+            return false;
+        ptr = buffer.data();
+        for(int i = first; i < last; ++i)
+        {
+            Mesh::triangle& t = mesh.tris[i];
+            for(int k = 0; k < 3; ++k)
+                t.v[k] = readLittleEndian<std::int32_t>(ptr);
+            t.alive = (readLittleEndian<std::uint8_t>(ptr) != 0);
+        }
+    }
+
+    mesh.invalidateAdjacency();
+    return true;
+}
+
+} // namespace mesh
+} // namespace aliceVision
@@ -0,0 +1,64 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mesh/Mesh.hpp>
+
+#include <string>
+
+namespace aliceVision {
+namespace mesh {
+
+/**
+ * @brief Save a mesh in binary PLY, streamed from the mesh data without intermediate scene.
+ * Vertices are written with their per-vertex colors if any.
+ * @note As with Assimp, the y and z axes are flipped.
+ * @param[in] mesh the mesh to save
+ * @param[in] filepath the output PLY file path
+ */
+void saveMeshAsPly(const Mesh& mesh, const std::string& filepath);
+
+/**
+ * @brief Save the vertices and triangles of a mesh in OBJ (without material), the lines are formatted in parallel.
+ * @note As with Assimp, the y and z axes are flipped.
+ * @param[in] mesh the mesh to save
+ * @param[in] filepath the output OBJ file path
+ */
+void saveMeshAsObj(const Mesh& mesh, const std::string& filepath);
+
+/**
+ * @brief Load a binary PLY file, streamed into the mesh data without intermediate scene.
+ * Loads the vertices, the per-vertex colors and texture coordinates, and triangulates the faces.
+ * As with the Assimp loader, the vertices with the same position, color and texture coordinates are joined
+ * and the faces with identical vertices are removed.
+ * @note As with Assimp, the y and z axes are flipped.
+ * @param[out] mesh the loaded mesh, should be empty
+ * @param[in] filepath the input PLY file path
+ * @return false if the file is not supported (ascii PLY, per-face texture coordinates or unknown property type),
+ *         nothing is loaded in this case
+ */
+bool loadMeshFromPly(Mesh& mesh, const std::string& filepath);
+
+/**
+ * @brief Save the vertices and triangles of a mesh in the AliceVision binary mesh format.
+ * The data are written in little-endian with explicit sizes, so the files do not depend on the platform.
+ * @param[in] mesh the mesh to save
+ * @param[in] filepath the output file path
+ */
+void saveMeshAsBin(const Mesh& mesh, const std::string& filepath);
+
+/**
+ * @brief Load the vertices and triangles of a mesh from the AliceVision binary mesh format.
+ * Files written before the format was versioned (raw memory dump) are still supported.
+ * @param[out] mesh the loaded mesh
+ * @param[in] filepath the input file path
+ * @return false if the file cannot be opened or is truncated
+ */
+bool loadMeshFromBin(Mesh& mesh, const std::string& filepath);
+
+} // namespace mesh
+} // namespace aliceVision
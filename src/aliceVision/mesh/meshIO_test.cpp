@@ -0,0 +1,291 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mesh/meshIO.hpp>
+#include <aliceVision/mesh/meshTestCommon.hpp>
+
+#include <boost/endian/conversion.hpp>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#define BOOST_TEST_MODULE meshIO
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mesh;
+
+namespace bfs = boost::filesystem;
+
+namespace {
+
+/// Regular triangulation of a n x n grid with colors
+void createColoredGridMesh(int n, Mesh& out_mesh)
+{
+    test::createGridMesh(
+      n, n, [](int x, int y) { return Point3d(x * 0.5, y * 0.25 - 1.0, 0.125 * ((x + y) % 3)); },
+      [](int x, int y) { return rgb(x % 256, y % 256, (x * y) % 256); }, out_mesh);
+}
+
+void checkSameTriangles(const Mesh& a, const Mesh& b)
+{
+    BOOST_REQUIRE_EQUAL(a.tris.size(), b.tris.size());
+    for(int i = 0; i < a.tris.size(); ++i)
+    {
+        for(int k = 0; k < 3; ++k)
+            BOOST_CHECK_EQUAL(a.tris[i].v[k], b.tris[i].v[k]);
+    }
+}
+
+template <typename T>
+void writeBigEndian(std::ostream& out, T value)
+{
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    if(boost::endian::order::native == boost::endian::order::little)
+        std::reverse(bytes, bytes + sizeof(T));
+    out.write(bytes, sizeof(T));
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(meshIO_ply)
+{
+    Mesh mesh;
+    createColoredGridMesh(300, mesh);
+
+    const std::string filepath = (bfs::temp_directory_path() / bfs::unique_path("meshIO_%%%%%%.ply")).string();
+    saveMeshAsPly(mesh, filepath);
+
+    Mesh loadedMesh;
+    BOOST_REQUIRE(loadMeshFromPly(loadedMesh, filepath));
+    bfs::remove(filepath);
+
+    BOOST_REQUIRE_EQUAL(loadedMesh.pts.size(), mesh.pts.size());
+    BOOST_REQUIRE_EQUAL(loadedMesh.colors().size(), mesh.colors().size());
+    for(int i = 0; i < mesh.pts.size(); ++i)
+    {
+        BOOST_CHECK_SMALL((loadedMesh.pts[i] - mesh.pts[i]).size(), 1e-6);
+        BOOST_CHECK_EQUAL(loadedMesh.colors()[i].r, mesh.colors()[i].r);
+        BOOST_CHECK_EQUAL(loadedMesh.colors()[i].g, mesh.colors()[i].g);
+        BOOST_CHECK_EQUAL(loadedMesh.colors()[i].b, mesh.colors()[i].b);
+    }
+    checkSameTriangles(loadedMesh, mesh);
+    BOOST_CHECK_EQUAL(loadedMesh.trisMtlIds().size(), mesh.tris.size());
+    BOOST_CHECK(loadedMesh.uvCoords.empty());
+}
+
+BOOST_AUTO_TEST_CASE(meshIO_plyBigEndianPolygons)
+{
+    const std::string filepath = (bfs::temp_directory_path() / bfs::unique_path("meshIO_%%%%%%.ply")).string();
+    {
+        std::ofstream out(filepath, std::ios::binary);
+        out << "ply\r\n"
+            << "format binary_big_endian 1.0\r\n"
+            << "comment quad, degenerate triangle and texture coordinates\r\n"
+            << "element vertex 5\r\n"
+            << "property double x\r\n"
+            << "property double y\r\n"
+            << "property double z\r\n"
+            << "property float s\r\n"
+            << "property float t\r\n"
+            << "element face 2\r\n"
+            << "property uchar flags\r\n"
+            << "property list uint uint vertex_index\r\n"
+            << "element material 1\r\n"
+            << "property list uchar char name\r\n"
+            << "end_header\r\n";
+        const double coords[5][3] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}, {1, 1, 0}};
+        for(int i = 0; i < 5; ++i)
+        {
+            for(int k = 0; k < 3; ++k)
+                writeBigEndian(out, coords[i][k]);
+            writeBigEndian(out, static_cast<float>(coords[i][0]));
+            writeBigEndian(out, static_cast<float>(coords[i][1]));
+        }
+        // quad
+        writeBigEndian(out, std::uint8_t(0));
+        writeBigEndian(out, std::uint32_t(4));
+        for(std::uint32_t v : {0, 1, 2, 3})
+            writeBigEndian(out, v);
+        // vertices 2 and 4 are identical
+        writeBigEndian(out, std::uint8_t(0));
+        writeBigEndian(out, std::uint32_t(3));
+        for(std::uint32_t v : {1, 2, 4})
+            writeBigEndian(out, v);
+        // material
+        writeBigEndian(out, std::uint8_t(2));
+        out << "m0";
+    }
+
+    Mesh mesh;
+    BOOST_REQUIRE(loadMeshFromPly(mesh, filepath));
+    bfs::remove(filepath);
+
+    // the vertex 4 is joined with the vertex 2, as with aiProcess_JoinIdenticalVertices
+    BOOST_REQUIRE_EQUAL(mesh.pts.size(), 4);
+    BOOST_CHECK_EQUAL(mesh.pts[2].x, 1.0);
+    BOOST_CHECK_EQUAL(mesh.pts[2].y, -1.0);
+    BOOST_REQUIRE_EQUAL(mesh.tris.size(), 2);
+    BOOST_CHECK_EQUAL(mesh.tris[1].v[0], 0);
+    BOOST_CHECK_EQUAL(mesh.tris[1].v[1], 2);
+    BOOST_CHECK_EQUAL(mesh.tris[1].v[2], 3);
+    BOOST_REQUIRE_EQUAL(mesh.uvCoords.size(), 4);
+    BOOST_CHECK_EQUAL(mesh.uvCoords[3].y, 1.0);
+    BOOST_REQUIRE_EQUAL(mesh.trisUvIds.size(), 2);
+    BOOST_CHECK_EQUAL(mesh.trisUvIds[1].z, 3);
+}
+
+BOOST_AUTO_TEST_CASE(meshIO_plyJoinIdenticalVertices)
+{
+    // two triangles sharing an edge, each one with its own vertices
+    Mesh mesh;
+    const Point3d coords[6] = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+    for(const Point3d& p : coords)
+    {
+        mesh.pts.push_back(p);
+        mesh.colors().push_back(rgb(10, 20, 30));
+    }
+    // same position, another color
+    mesh.colors()[4] = rgb(10, 20, 31);
+    mesh.tris.push_back(Mesh::triangle(0, 1, 2));
+    mesh.tris.push_back(Mesh::triangle(3, 4, 5));
+
+    const std::string filepath = (bfs::temp_directory_path() / bfs::unique_path("meshIO_%%%%%%.ply")).string();
+    saveMeshAsPly(mesh, filepath);
+
+    Mesh loadedMesh;
+    BOOST_REQUIRE(loadMeshFromPly(loadedMesh, filepath));
+    bfs::remove(filepath);
+
+    // only the vertices identical in position and color are joined, the first occurrences keep their order
+    BOOST_REQUIRE_EQUAL(loadedMesh.pts.size(), 5);
+    BOOST_REQUIRE_EQUAL(loadedMesh.colors().size(), 5);
+    BOOST_CHECK_EQUAL(loadedMesh.colors()[3].b, 31);
+    BOOST_CHECK_SMALL((loadedMesh.pts[4] - coords[5]).size(), 1e-6);
+
+    Mesh expectedMesh;
+    expectedMesh.tris.push_back(Mesh::triangle(0, 1, 2));
+    expectedMesh.tris.push_back(Mesh::triangle(0, 3, 4));
+    checkSameTriangles(loadedMesh, expectedMesh);
+}
+
+BOOST_AUTO_TEST_CASE(meshIO_plyUnsupportedType)
+{
+    const std::string filepath = (bfs::temp_directory_path() / bfs::unique_path("meshIO_%%%%%%.ply")).string();
+    {
+        std::ofstream out(filepath, std::ios::binary);
+        out << "ply\nformat binary_little_endian 1.0\nelement vertex 0\nproperty float x\nproperty float y\nproperty float z\n"
+            << "property int64 id\nend_header\n";
+    }
+
+    // left to Assimp instead of failing
+    Mesh mesh;
+    BOOST_CHECK(!loadMeshFromPly(mesh, filepath));
+    BOOST_CHECK(mesh.pts.empty());
+    bfs::remove(filepath);
+}
+
+BOOST_AUTO_TEST_CASE(meshIO_plyAscii)
+{
+    const std::string filepath = (bfs::temp_directory_path() / bfs::unique_path("meshIO_%%%%%%.ply")).string();
+    {
+        std::ofstream out(filepath);
+        out << "ply\nformat ascii 1.0\nelement vertex 0\nproperty float x\nproperty float y\nproperty float z\nend_header\n";
+    }
+
+    // left to Assimp
+    Mesh mesh;
+    BOOST_CHECK(!loadMeshFromPly(mesh, filepath));
+    BOOST_CHECK(mesh.pts.empty());
+    bfs::remove(filepath);
+}
+
+BOOST_AUTO_TEST_CASE(meshIO_obj)
+{
+    Mesh mesh;
+    createColoredGridMesh(400, mesh);
+
+    const std::string filepath = (bfs::temp_directory_path() / bfs::unique_path("meshIO_%%%%%%.obj")).string();
+    saveMeshAsObj(mesh, filepath);
+
+    Mesh loadedMesh;
+    std::ifstream in(filepath);
+    std::string line;
+    while(std::getline(in, line))
+    {
+        std::istringstream lineStream(line);
+        std::string keyword;
+        lineStream >> keyword;
+        if(keyword == "v")
+        {
+            Point3d p;
+            lineStream >> p.x >> p.y >> p.z;
+            loadedMesh.pts.push_back(Point3d(p.x, -p.y, -p.z));
+        }
+        else if(keyword == "f")
+        {
+            Mesh::triangle t;
+            lineStream >> t.v[0] >> t.v[1] >> t.v[2];
+            loadedMesh.tris.push_back(Mesh::triangle(t.v[0] - 1, t.v[1] - 1, t.v[2] - 1));
+        }
+    }
+    in.close();
+    bfs::remove(filepath);
+
+    BOOST_REQUIRE_EQUAL(loadedMesh.pts.size(), mesh.pts.size());
+    for(int i = 0; i < mesh.pts.size(); ++i)
+        BOOST_CHECK_SMALL((loadedMesh.pts[i] - mesh.pts[i]).size(), 1e-6);
+    checkSameTriangles(loadedMesh, mesh);
+}
+
+BOOST_AUTO_TEST_CASE(meshIO_bin)
+{
+    Mesh mesh;
+    createColoredGridMesh(100, mesh);
+    mesh.tris[7].alive = false;
+
+    const std::string filepath = (bfs::temp_directory_path() / bfs::unique_path("meshIO_%%%%%%.bin")).string();
+    saveMeshAsBin(mesh, filepath);
+
+    Mesh loadedMesh;
+    BOOST_REQUIRE(loadMeshFromBin(loadedMesh, filepath));
+
+    BOOST_REQUIRE_EQUAL(loadedMesh.pts.size(), mesh.pts.size());
+    for(int i = 0; i < mesh.pts.size(); ++i)
+        BOOST_CHECK(loadedMesh.pts[i] == mesh.pts[i]);
+    checkSameTriangles(loadedMesh, mesh);
+    BOOST_CHECK(!loadedMesh.tris[7].alive);
+    BOOST_CHECK(loadedMesh.tris[8].alive);
+
+    // truncated file
+    bfs::resize_file(filepath, bfs::file_size(filepath) - 1);
+    BOOST_CHECK(!loadMeshFromBin(loadedMesh, filepath));
+
+    // unversioned file
+    {
+        std::ofstream out(filepath, std::ios::binary);
+        const int npts = mesh.pts.size();
+        const int ntris = mesh.tris.size();
+        out.write(reinterpret_cast<const char*>(&npts), sizeof(int));
+        out.write(reinterpret_cast<const char*>(&mesh.pts[0]), npts * sizeof(Point3d));
+        out.write(reinterpret_cast<const char*>(&ntris), sizeof(int));
+        out.write(reinterpret_cast<const char*>(&mesh.tris[0]), ntris * sizeof(Mesh::triangle));
+    }
+    Mesh legacyMesh;
+    BOOST_REQUIRE(loadMeshFromBin(legacyMesh, filepath));
+    bfs::remove(filepath);
+
+    BOOST_REQUIRE_EQUAL(legacyMesh.pts.size(), mesh.pts.size());
+    BOOST_CHECK(legacyMesh.pts[42] == mesh.pts[42]);
+    checkSameTriangles(legacyMesh, mesh);
+}
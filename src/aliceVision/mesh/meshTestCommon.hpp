@@ -0,0 +1,63 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <aliceVision/mesh/Mesh.hpp>
+
+#include <functional>
+
+namespace aliceVision {
+namespace mesh {
+namespace test {
+
+/**
+ * @brief Regular triangulation of a nx x ny grid: (nx+1)*(ny+1) vertices and 2*nx*ny triangles
+ * @param[in] nx number of cells along x
+ * @param[in] ny number of cells along y
+ * @param[in] getPoint position of the grid vertex (x, y), e.g. with some jitter
+ * @param[in] getColor color of the grid vertex (x, y), no colors if empty
+ * @param[out] out_mesh grid vertices are appended in row-major order
+ */
+inline void createGridMesh(int nx, int ny,
+                           const std::function<Point3d(int x, int y)>& getPoint,
+                           const std::function<rgb(int x, int y)>& getColor,
+                           Mesh& out_mesh)
+{
+    const int firstPtId = out_mesh.pts.size();
+    for(int y = 0; y <= ny; ++y)
+    {
+        for(int x = 0; x <= nx; ++x)
+        {
+            out_mesh.pts.push_back(getPoint(x, y));
+            if(getColor)
+                out_mesh.colors().push_back(getColor(x, y));
+        }
+    }
+
+    for(int y = 0; y < ny; ++y)
+    {
+        for(int x = 0; x < nx; ++x)
+        {
+            const int a = firstPtId + y * (nx + 1) + x;
+            const int b = a + 1;
+            const int c = a + nx + 1;
+            const int d = c + 1;
+            out_mesh.tris.push_back(Mesh::triangle(a, b, d));
+            out_mesh.tris.push_back(Mesh::triangle(a, d, c));
+        }
+    }
+}
+
+/// Regular triangulation of a n x n grid without colors
+inline void createGridMesh(int n, const std::function<Point3d(int x, int y)>& getPoint, Mesh& out_mesh)
+{
+    createGridMesh(n, n, getPoint, nullptr, out_mesh);
+}
+
+} // namespace test
+} // namespace mesh
+} // namespace aliceVision
@@ -14,6 +14,15 @@
 #include <boost/filesystem.hpp>
 #include <boost/regex.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
 namespace fs = boost::filesystem;
 
 namespace aliceVision {
@@ -165,13 +174,21 @@ void weightTileBorder(int a, int b, int c, int d,
     }
 }
 
-void addTileMapWeighted(int rc,
-                         const MultiViewParams& mp, 
-                         const TileParams& tileParams,
-                         const ROI& roi, 
-                         int downscale,
-                         image::Image<float>& in_tileMap,
-                         image::Image<float>& inout_map)
+/**
+ * @brief Weight the borders of a tile map according to the tiles intersection areas
+ * @param[in] rc the related R camera index
+ * @param[in] mp the multi-view parameters
+ * @param[in] tileParams tile workflow parameters
+ * @param[in] roi the 2d region of interest without any downscale apply
+ * @param[in] downscale the depth/sim map downscale factor
+ * @param[in,out] inout_tileMap the tile map to weight
+ */
+void weightTileMap(int rc,
+                   const MultiViewParams& mp,
+                   const TileParams& tileParams,
+                   const ROI& roi,
+                   int downscale,
+                   image::Image<float>& inout_tileMap)
 {
     // get downscaled ROI
     const ROI downscaledRoi = downscaleROI(roi, downscale);
@@ -193,7 +210,7 @@ void addTileMapWeighted(int rc,
         const Point2d lu(0, 0);
         const int b = (firstRow) ? 1 : 0;
         const int d = (firstColumn) ? 1 : 0;
-        weightTileBorder(0, b, 1, d, tilePadding, tilePadding, lu, in_tileMap);
+        weightTileBorder(0, b, 1, d, tilePadding, tilePadding, lu, inout_tileMap);
     }
 
     // weight the bottom left corner
@@ -202,7 +219,7 @@ void addTileMapWeighted(int rc,
         const Point2d lu(0, tileHeight - tilePadding);
         const int a = (firstColumn) ? 1 : 0;
         const int c = (lastRow) ? 1 : 0;
-        weightTileBorder(a, 1, c, 0, tilePadding, tilePadding, lu, in_tileMap);
+        weightTileBorder(a, 1, c, 0, tilePadding, tilePadding, lu, inout_tileMap);
     }
 
     // weight the top right corner
@@ -211,7 +228,7 @@ void addTileMapWeighted(int rc,
         const Point2d lu(tileWidth - tilePadding, 0);
         const int a = (firstRow) ? 1 : 0;
         const int c = (lastColumn) ? 1 : 0;
-        weightTileBorder(a, 0, c, 1, tilePadding, tilePadding, lu, in_tileMap);
+        weightTileBorder(a, 0, c, 1, tilePadding, tilePadding, lu, inout_tileMap);
     }
 
     // weight the bottom right corner
@@ -220,36 +237,50 @@ void addTileMapWeighted(int rc,
         const Point2d lu(tileWidth - tilePadding, tileHeight - tilePadding);
         const int b = (lastColumn) ? 1 : 0;
         const int d = (lastRow) ? 1 : 0;
-        weightTileBorder(1, b, 0, d, tilePadding, tilePadding, lu, in_tileMap);
+        weightTileBorder(1, b, 0, d, tilePadding, tilePadding, lu, inout_tileMap);
     }
 
     // weight the top border
     if(!firstRow)
     {
         const Point2d lu(tilePadding, 0);
-        weightTileBorder(0, 0, 1, 1, tileWidth - 2 * tilePadding, tilePadding, lu, in_tileMap);
+        weightTileBorder(0, 0, 1, 1, tileWidth - 2 * tilePadding, tilePadding, lu, inout_tileMap);
     }
 
     // weight the bottom border
     if(!lastRow)
     {
         const Point2d lu(tilePadding, tileHeight - tilePadding);
-        weightTileBorder(1, 1, 0, 0, tileWidth - 2 * tilePadding, tilePadding, lu, in_tileMap);
+        weightTileBorder(1, 1, 0, 0, tileWidth - 2 * tilePadding, tilePadding, lu, inout_tileMap);
     }
 
     // weight the left border
     if(!firstColumn)
     {
         const Point2d lu(0, tilePadding);
-        weightTileBorder(0, 1, 1, 0, tilePadding, tileHeight - 2 * tilePadding, lu, in_tileMap);
+        weightTileBorder(0, 1, 1, 0, tilePadding, tileHeight - 2 * tilePadding, lu, inout_tileMap);
     }
 
     // weight the right border
     if(!lastColumn)
     {
         const Point2d lu(tileWidth - tilePadding, tilePadding);
-        weightTileBorder(1, 0, 0, 1, tilePadding, tileHeight - 2 * tilePadding, lu, in_tileMap);
+        weightTileBorder(1, 0, 0, 1, tilePadding, tileHeight - 2 * tilePadding, lu, inout_tileMap);
     }
+}
+
+void addTileMapWeighted(int rc,
+                         const MultiViewParams& mp, 
+                         const TileParams& tileParams,
+                         const ROI& roi, 
+                         int downscale,
+                         image::Image<float>& in_tileMap,
+                         image::Image<float>& inout_map)
+{
+    weightTileMap(rc, mp, tileParams, roi, downscale, in_tileMap);
+
+    // get downscaled ROI
+    const ROI downscaledRoi = downscaleROI(roi, downscale);
 
     // add weighted tile to the depth/sim map
     for(int x = downscaledRoi.x.begin; x < downscaledRoi.x.end; ++x)
@@ -264,6 +295,274 @@ void addTileMapWeighted(int rc,
     }
 }
 
+namespace {
+
+/*
+ * Depth/sim map tiles container
+ *
+ * All the tiles of a view are appended to a single file instead of one pair of EXR files per tile:
+ *  - file header: magic, map size and downscale
+ *  - then one record per tile: record header followed by the tile depth values and the tile similarity values
+ *    (float, row major, downscaled tile size)
+ *
+ * Tiles are stored already weighted for the blending, so that a map is rebuilt by summing the tiles.
+ * There is no region read: the tiles are merged into the full maps of the view at the end of the depth map
+ * estimation (mergeDepthSimMapTiles), and the filtering and meshing steps read these merged maps.
+ * A tile written again (e.g. after an interrupted computation) replaces the previous one.
+ * Offsets are 64 bits, the container of a large view can exceed 2GB.
+ */
+
+const char tilesFileMagic[8] = {'A', 'V', 'T', 'I', 'L', 'E', 'S', '1'};
+
+struct TilesFileHeader
+{
+    char magic[8];
+    std::int32_t width;     // map width at scale / step
+    std::int32_t height;    // map height at scale / step
+    std::int32_t downscale; // scale * step
+    std::int32_t reserved;
+};
+
+struct TileRecordHeader
+{
+    std::int32_t roiBeginX; // tile ROI without any downscale apply
+    std::int32_t roiEndX;
+    std::int32_t roiBeginY;
+    std::int32_t roiEndY;
+    std::int32_t nbDepthValues;
+    std::int32_t reserved;
+};
+
+struct FileCloser
+{
+    void operator()(std::FILE* file) const { std::fclose(file); }
+};
+
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+/// Tiles of a view can be written from several threads
+std::mutex tilesFileMutex;
+
+/**
+ * @brief Set the position of a file with a 64 bits offset (long is 32 bits on Windows)
+ */
+int seekFile(std::FILE* file, std::int64_t offset, int origin)
+{
+#ifdef _WIN32
+    return _fseeki64(file, offset, origin);
+#else
+    return fseeko(file, static_cast<off_t>(offset), origin);
+#endif
+}
+
+/**
+ * @brief Get the position of a file as a 64 bits offset
+ */
+std::int64_t tellFile(std::FILE* file)
+{
+#ifdef _WIN32
+    return _ftelli64(file);
+#else
+    return static_cast<std::int64_t>(ftello(file));
+#endif
+}
+
+/**
+ * @brief Size in bytes of the depth and similarity values of a tile record
+ */
+std::int64_t getTileDataSize(const TileRecordHeader& record, int downscale)
+{
+    const ROI tileRoi = downscaleROI(ROI(record.roiBeginX, record.roiEndX, record.roiBeginY, record.roiEndY), downscale);
+    return std::int64_t(2 * sizeof(float)) * tileRoi.width() * tileRoi.height();
+}
+
+/**
+ * @brief Read the header of a tiles container
+ * @return false if the file does not exist or is not a tiles container
+ */
+bool readTilesFileHeader(std::FILE* file, TilesFileHeader& out_header)
+{
+    return (std::fread(&out_header, sizeof(TilesFileHeader), 1, file) == 1) &&
+           (std::memcmp(out_header.magic, tilesFileMagic, sizeof(tilesFileMagic)) == 0);
+}
+
+/**
+ * @brief Index the tile records of a tiles container
+ * @param[in] file the tiles container, after its header
+ * @param[out] out_records the last record of each tile ROI, with the offset of its data
+ */
+void indexTileRecords(std::FILE* file, std::vector<std::pair<TileRecordHeader, std::int64_t>>& out_records, int downscale)
+{
+    std::map<std::tuple<int, int, int, int>, std::size_t> recordIndexPerRoi;
+
+    const std::int64_t recordsOffset = tellFile(file);
+    seekFile(file, 0, SEEK_END);
+    const std::int64_t fileSize = tellFile(file);
+    seekFile(file, recordsOffset, SEEK_SET);
+
+    TileRecordHeader record;
+    while(std::fread(&record, sizeof(TileRecordHeader), 1, file) == 1)
+    {
+        const std::int64_t dataOffset = tellFile(file);
+        const std::int64_t dataSize = getTileDataSize(record, downscale);
+
+        // last record truncated by an interrupted write, the previous record of the tile remains valid
+        if(dataOffset + dataSize > fileSize || seekFile(file, dataSize, SEEK_CUR) != 0)
+            break;
+
+        const auto key = std::make_tuple(record.roiBeginX, record.roiEndX, record.roiBeginY, record.roiEndY);
+        const auto it = recordIndexPerRoi.find(key);
+        if(it == recordIndexPerRoi.end())
+        {
+            recordIndexPerRoi.emplace(key, out_records.size());
+            out_records.emplace_back(record, dataOffset);
+        }
+        else
+        {
+            out_records.at(it->second) = std::make_pair(record, dataOffset);
+        }
+    }
+}
+
+/**
+ * @brief Append a tile to the tiles container of a view
+ */
+void writeTileToTilesFile(int rc,
+                          const MultiViewParams& mp,
+                          const TileParams& tileParams,
+                          const ROI& roi,
+                          const image::Image<float>& depthMap,
+                          const image::Image<float>& simMap,
+                          int scaleStep,
+                          const std::string& tilesFilePath)
+{
+    const ROI downscaledROI = downscaleROI(roi, scaleStep);
+    const int tileWidth = downscaledROI.width();
+    const int tileHeight = downscaledROI.height();
+
+    TilesFileHeader header;
+    std::memcpy(header.magic, tilesFileMagic, sizeof(tilesFileMagic));
+    header.width = divideRoundUp(mp.getWidth(rc), scaleStep);
+    header.height = divideRoundUp(mp.getHeight(rc), scaleStep);
+    header.downscale = scaleStep;
+    header.reserved = 0;
+
+    TileRecordHeader record;
+    record.roiBeginX = roi.x.begin;
+    record.roiEndX = roi.x.end;
+    record.roiBeginY = roi.y.begin;
+    record.roiEndY = roi.y.end;
+    record.nbDepthValues = std::count_if(depthMap.data(), depthMap.data() + depthMap.size(), [](float v) { return v > 0.0f; });
+    record.reserved = 0;
+
+    // weight the tile once, the blending is then a simple sum
+    image::Image<float> weightMap(tileWidth, tileHeight, true, 1.0f);
+    weightTileMap(rc, mp, tileParams, roi, scaleStep, weightMap);
+
+    // whole record in one buffer, written with a single call
+    const std::size_t tileSize = std::size_t(tileWidth) * tileHeight;
+    std::vector<char> buffer(sizeof(TileRecordHeader) + 2 * tileSize * sizeof(float));
+    std::memcpy(buffer.data(), &record, sizeof(TileRecordHeader));
+    float* depthData = reinterpret_cast<float*>(buffer.data() + sizeof(TileRecordHeader));
+    float* simData = depthData + tileSize;
+    for(std::size_t i = 0; i < tileSize; ++i)
+    {
+        depthData[i] = depthMap(i) * weightMap(i);
+        simData[i] = (simMap.size() > 0) ? simMap(i) * weightMap(i) : 0.0f;
+    }
+
+    std::lock_guard<std::mutex> lock(tilesFileMutex);
+
+    // start a new container if there is none or if it has been written with other dimensions
+    bool newFile = true;
+    {
+        FilePtr file(std::fopen(tilesFilePath.c_str(), "rb"));
+        TilesFileHeader existingHeader;
+        if(file && readTilesFileHeader(file.get(), existingHeader))
+        {
+            newFile = (existingHeader.width != header.width) ||
+                      (existingHeader.height != header.height) ||
+                      (existingHeader.downscale != header.downscale);
+        }
+    }
+
+    FilePtr file(std::fopen(tilesFilePath.c_str(), newFile ? "wb" : "ab"));
+    if(!file)
+        ALICEVISION_THROW_ERROR("Cannot open depth/sim map tiles file: " << tilesFilePath);
+
+    if((newFile && std::fwrite(&header, sizeof(TilesFileHeader), 1, file.get()) != 1) ||
+       std::fwrite(buffer.data(), buffer.size(), 1, file.get()) != 1)
+    {
+        ALICEVISION_THROW_ERROR("Cannot write depth/sim map tile in file: " << tilesFilePath);
+    }
+}
+
+/**
+ * @brief Sum the weighted tiles of a tiles container
+ * @param[in] tilesFilePath the tiles container path
+ * @param[in,out] out_depthMap the depth map at scale / step, initialized with zeros (nullptr to skip)
+ * @param[in,out] out_simMap the similarity map at scale / step, initialized with zeros (nullptr to skip)
+ * @param[out] out_nbDepthValues the total number of depth values of the tiles (optional)
+ * @return false if the file is not a tiles container
+ */
+bool readTilesFile(const std::string& tilesFilePath,
+                   image::Image<float>* out_depthMap,
+                   image::Image<float>* out_simMap,
+                   int* out_nbDepthValues = nullptr)
+{
+    FilePtr file(std::fopen(tilesFilePath.c_str(), "rb"));
+    TilesFileHeader header;
+    if(!file || !readTilesFileHeader(file.get(), header))
+        return false;
+
+    std::vector<std::pair<TileRecordHeader, std::int64_t>> records;
+    indexTileRecords(file.get(), records, header.downscale);
+
+    if(out_nbDepthValues != nullptr)
+    {
+        *out_nbDepthValues = 0;
+        for(const auto& record : records)
+            *out_nbDepthValues += record.first.nbDepthValues;
+    }
+
+    std::vector<float> tileData;
+
+    for(const auto& record : records)
+    {
+        const TileRecordHeader& r = record.first;
+        const ROI tileRoi = downscaleROI(ROI(r.roiBeginX, r.roiEndX, r.roiBeginY, r.roiEndY), header.downscale);
+        const std::size_t tileSize = std::size_t(tileRoi.width()) * tileRoi.height();
+        tileData.resize(tileSize);
+
+        for(int mapIndex = 0; mapIndex < 2; ++mapIndex)
+        {
+            image::Image<float>* map = (mapIndex == 0) ? out_depthMap : out_simMap;
+            if(map == nullptr)
+                continue;
+
+            const std::int64_t mapOffset = std::int64_t(sizeof(float)) * mapIndex * tileSize;
+            if(seekFile(file.get(), record.second + mapOffset, SEEK_SET) != 0 ||
+               std::fread(tileData.data(), sizeof(float), tileSize, file.get()) != tileSize)
+            {
+                ALICEVISION_THROW_ERROR("Cannot read depth/sim map tile in file: " << tilesFilePath);
+            }
+
+            // the tile may exceed the map if the image size changed since it was written
+            const ROI readRoi = intersect(tileRoi, ROI(0, map->Width(), 0, map->Height()));
+            for(int y = readRoi.y.begin; y < readRoi.y.end; ++y)
+            {
+                const float* row = &tileData[std::size_t(y - tileRoi.y.begin) * tileRoi.width()];
+                for(int x = readRoi.x.begin; x < readRoi.x.end; ++x)
+                    (*map)(y, x) += row[x - tileRoi.x.begin];
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace
+
 void readMapFromTiles(int rc, 
                       const MultiViewParams& mp, 
                       EFileType fileType,
@@ -329,6 +628,50 @@ void readMapFromTiles(int rc,
     }
 }
 
+/**
+ * @brief Read the depth and/or similarity maps from the tiles of a view
+ *        (tiles container, or one file per tile for results written by older versions)
+ * @param[in] rc the related R camera index
+ * @param[in] mp the multi-view parameters
+ * @param[out] out_depthMap the depth map (nullptr to skip)
+ * @param[out] out_simMap the similarity map (nullptr to skip)
+ * @param[in] scale the depth/sim map downscale factor
+ * @param[in] step the depth/sim map step factor
+ * @param[in] customSuffix the filename custom suffix
+ */
+void readMapsFromTiles(int rc,
+                       const MultiViewParams& mp,
+                       image::Image<float>* out_depthMap,
+                       image::Image<float>* out_simMap,
+                       int scale,
+                       int step,
+                       const std::string& customSuffix)
+{
+    const std::string tilesFilePath = getFileNameFromIndex(mp, rc, EFileType::depthSimMapTiles, scale, customSuffix);
+
+    if(fs::exists(tilesFilePath))
+    {
+        const int scaleStep = std::max(scale, 1) * step; // avoid 0 special case (reserved for depth map filtering)
+        const int width  = divideRoundUp(mp.getWidth(rc) , scaleStep);
+        const int height = divideRoundUp(mp.getHeight(rc), scaleStep);
+
+        // maps should be initialized, additive process
+        if(out_depthMap != nullptr)
+            out_depthMap->resize(width, height, true, 0.f);
+        if(out_simMap != nullptr)
+            out_simMap->resize(width, height, true, 0.f);
+
+        if(readTilesFile(tilesFilePath, out_depthMap, out_simMap))
+            return;
+    }
+
+    // one file per tile
+    if(out_depthMap != nullptr)
+        readMapFromTiles(rc, mp, EFileType::depthMap, *out_depthMap, scale, step, customSuffix);
+    if(out_simMap != nullptr)
+        readMapFromTiles(rc, mp, EFileType::simMap, *out_simMap, scale, step, customSuffix);
+}
+
 void writeDepthSimMap(int rc, 
                       const MultiViewParams& mp, 
                       const TileParams& tileParams, 
@@ -355,23 +698,18 @@ void writeDepthSimMap(int rc,
     const oiio::ROI displayRoi(0, imageWidth, 0, imageHeight);
     const oiio::ROI pixelRoi(downscaledROI.x.begin, downscaledROI.x.end, downscaledROI.y.begin, downscaledROI.y.end, 0, 1, 0, 1);
 
-    // output map path
-    std::string depthMapPath;
-    std::string simMapPath;
-
     if(downscaledROI.width() != imageWidth || downscaledROI.height() != imageHeight) // is a tile
     {
-        // tiled depth/sim map
-        depthMapPath = getFileNameFromIndex(mp, rc, EFileType::depthMap, scale, customSuffix, roi.x.begin, roi.y.begin);
-        simMapPath = getFileNameFromIndex(mp, rc, EFileType::simMap, scale, customSuffix, roi.x.begin, roi.y.begin);
-    }
-    else
-    {
-        // fullsize depth/sim map
-        depthMapPath = getFileNameFromIndex(mp, rc, EFileType::depthMap, scale, customSuffix);
-        simMapPath = getFileNameFromIndex(mp, rc, EFileType::simMap, scale, customSuffix);
+        // all the tiles of the view go to a single tiles container
+        const std::string tilesFilePath = getFileNameFromIndex(mp, rc, EFileType::depthSimMapTiles, scale, customSuffix);
+        writeTileToTilesFile(rc, mp, tileParams, roi, depthMap, simMap, scaleStep, tilesFilePath);
+        return;
     }
 
+    // fullsize depth/sim map
+    const std::string depthMapPath = getFileNameFromIndex(mp, rc, EFileType::depthMap, scale, customSuffix);
+    const std::string simMapPath = getFileNameFromIndex(mp, rc, EFileType::simMap, scale, customSuffix);
+
     oiio::ParamValueList metadata = image::getMetadataFromMap(mp.getMetadata(rc));
 
     // downscale metadata
@@ -515,8 +853,7 @@ void readDepthSimMap(int rc,
     }
     else
     {
-        readMapFromTiles(rc, mp, EFileType::depthMap, out_depthMap, scale, step, customSuffix);
-        readMapFromTiles(rc, mp, EFileType::simMap, out_simMap, scale, step, customSuffix);
+        readMapsFromTiles(rc, mp, &out_depthMap, &out_simMap, scale, step, customSuffix);
     }
 }
 
@@ -535,7 +872,7 @@ void readDepthMap(int rc,
     }
     else
     {
-        readMapFromTiles(rc, mp, EFileType::depthMap, out_depthMap, scale, step, customSuffix);
+        readMapsFromTiles(rc, mp, &out_depthMap, nullptr, scale, step, customSuffix);
     }
 }
 
@@ -554,7 +891,7 @@ void readSimMap(int rc,
     }
     else
     {
-        readMapFromTiles(rc, mp, EFileType::simMap, out_simMap, scale, step, customSuffix);
+        readMapsFromTiles(rc, mp, nullptr, &out_simMap, scale, step, customSuffix);
     }
 }
 
@@ -565,6 +902,7 @@ unsigned long getNbDepthValuesFromDepthMap(int rc,
                                            const std::string& customSuffix)
 {
     const std::string depthMapPath = getFileNameFromIndex(mp, rc, EFileType::depthMap, scale, customSuffix);
+    const std::string tilesFilePath = getFileNameFromIndex(mp, rc, EFileType::depthSimMapTiles, scale, customSuffix);
     int nbDepthValues = -1;
 
     // get nbDepthValues from metadata
@@ -573,6 +911,11 @@ unsigned long getNbDepthValuesFromDepthMap(int rc,
         const oiio::ParamValueList metadata = image::readImageMetadata(depthMapPath);
         nbDepthValues = metadata.get_int("AliceVision:nbDepthValues", -1);
     }
+    else if (fs::exists(tilesFilePath)) // tiles container, only the record headers are read
+    {
+        if(!readTilesFile(tilesFilePath, nullptr, nullptr, &nbDepthValues))
+            nbDepthValues = -1;
+    }
     else // tilled
     {
         std::vector<std::string> mapTilePathList;
@@ -615,6 +958,22 @@ void deleteDepthSimMapTiles(int rc,
                             int step,
                             const std::string& customSuffix)
 {
+  // delete the tiles container
+  const std::string tilesFilePath = getFileNameFromIndex(mp, rc, EFileType::depthSimMapTiles, scale, customSuffix);
+  if(fs::exists(tilesFilePath))
+  {
+    try
+    {
+      fs::remove(tilesFilePath);
+    }
+    catch (const std::exception& e)
+    {
+      ALICEVISION_LOG_WARNING("Cannot delete depth/sim map tiles file (rc: " << rc << "): " << fs::path(tilesFilePath).filename().string() << std::endl);
+    }
+    return;
+  }
+
+  // one file per tile
   std::vector<std::string> depthMapTilePathList;
   std::vector<std::string> simMapTilePathList;
 
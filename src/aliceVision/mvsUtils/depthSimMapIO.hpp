@@ -8,6 +8,7 @@
 
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 #include <aliceVision/mvsUtils/TileParams.hpp>
+#include <aliceVision/mvsData/ROI.hpp>
 #include <aliceVision/image/Image.hpp>
 
 #include <string>
@@ -0,0 +1,220 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2023 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mvsUtils/depthSimMapIO.hpp>
+#include <aliceVision/mvsUtils/fileIO.hpp>
+#include <aliceVision/sfmData/SfMData.hpp>
+#include <aliceVision/camera/camera.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <cmath>
+#include <fstream>
+
+#define BOOST_TEST_MODULE depthSimMapIO
+
+#include <boost/test/unit_test.hpp>
+
+using namespace aliceVision;
+using namespace aliceVision::mvsUtils;
+
+namespace fs = boost::filesystem;
+
+namespace {
+
+const int imageWidth = 300;
+const int imageHeight = 200;
+
+/// Single view of imageWidth x imageHeight pixels
+sfmData::SfMData createSfmData()
+{
+    sfmData::SfMData sfmData;
+    sfmData.views[0] = std::make_shared<sfmData::View>("", 0, 0, 0, imageWidth, imageHeight);
+    sfmData.intrinsics[0] = camera::createIntrinsic(camera::EINTRINSIC::PINHOLE_CAMERA, imageWidth, imageHeight, 250.0, 250.0, 0.0, 0.0);
+    sfmData.setPose(*sfmData.views.at(0), sfmData::CameraPose(geometry::Pose3(Mat3::Identity(), Vec3::Zero())));
+    return sfmData;
+}
+
+/// Temporary depth maps folder removed at the end of the test
+struct TmpFolder
+{
+    TmpFolder()
+        : path(fs::temp_directory_path() / fs::unique_path())
+    {
+        fs::create_directories(path);
+    }
+
+    ~TmpFolder()
+    {
+        fs::remove_all(path);
+    }
+
+    fs::path path;
+};
+
+/// Depth value of a pixel of the map at scale / step, unique per pixel
+float depthAt(int x, int y, float offset = 0.f)
+{
+    return 1.f + x + 1000.f * y + offset;
+}
+
+/**
+ * @brief Write the tiles of the view, cropped from the depth map given by depthAt
+ * @return the maps blended in memory, as read back from one file per tile by previous versions
+ */
+void writeTiles(const MultiViewParams& mp,
+                const TileParams& tileParams,
+                const std::vector<ROI>& tileRoiList,
+                int scale,
+                float offset,
+                image::Image<float>& out_depthMap,
+                image::Image<float>& out_simMap)
+{
+    out_depthMap.resize(divideRoundUp(imageWidth, scale), divideRoundUp(imageHeight, scale), true, 0.f);
+    out_simMap.resize(out_depthMap.Width(), out_depthMap.Height(), true, 0.f);
+
+    for(const ROI& roi : tileRoiList)
+    {
+        const ROI downscaledRoi = downscaleROI(roi, scale);
+        image::Image<float> tileDepthMap(downscaledRoi.width(), downscaledRoi.height());
+        image::Image<float> tileSimMap(downscaledRoi.width(), downscaledRoi.height(), true, 0.5f);
+        for(int y = 0; y < tileDepthMap.Height(); ++y)
+            for(int x = 0; x < tileDepthMap.Width(); ++x)
+                tileDepthMap(y, x) = depthAt(downscaledRoi.x.begin + x, downscaledRoi.y.begin + y, offset);
+
+        writeDepthSimMap(0, mp, tileParams, roi, tileDepthMap, tileSimMap, scale, 1, "_test");
+
+        addTileMapWeighted(0, mp, tileParams, roi, scale, tileDepthMap, out_depthMap);
+        addTileMapWeighted(0, mp, tileParams, roi, scale, tileSimMap, out_simMap);
+    }
+}
+
+void checkMapsClose(const image::Image<float>& map, const image::Image<float>& reference)
+{
+    BOOST_REQUIRE_EQUAL(map.Width(), reference.Width());
+    BOOST_REQUIRE_EQUAL(map.Height(), reference.Height());
+
+    int nbDifferences = 0;
+    for(int i = 0; i < map.size(); ++i)
+    {
+        if(std::abs(map(i) - reference(i)) > 1e-6f * std::max(1.f, std::abs(reference(i))))
+            ++nbDifferences;
+    }
+    BOOST_CHECK_EQUAL(nbDifferences, 0);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(depthSimMapIO_tilesRoundTrip)
+{
+    TmpFolder tmp;
+    const sfmData::SfMData sfmData = createSfmData();
+    const MultiViewParams mp(sfmData, "", tmp.path.string(), "", false);
+
+    TileParams tileParams;
+    tileParams.bufferWidth = 128;
+    tileParams.bufferHeight = 128;
+    tileParams.padding = 16;
+
+    std::vector<ROI> tileRoiList;
+    getTileRoiList(tileParams, imageWidth, imageHeight, 1, tileRoiList);
+    BOOST_REQUIRE_GT(tileRoiList.size(), 4);
+
+    image::Image<float> expectedDepthMap;
+    image::Image<float> expectedSimMap;
+    writeTiles(mp, tileParams, tileRoiList, 1, 0.f, expectedDepthMap, expectedSimMap);
+
+    // all the tiles go to a single container
+    const std::string tilesFilePath = getFileNameFromIndex(mp, 0, EFileType::depthSimMapTiles, 1, "_test");
+    BOOST_CHECK(fs::exists(tilesFilePath));
+    BOOST_CHECK(!fs::exists(getFileNameFromIndex(mp, 0, EFileType::depthMap, 1, "_test")));
+
+    image::Image<float> depthMap;
+    image::Image<float> simMap;
+    readDepthSimMap(0, mp, depthMap, simMap, 1, 1, "_test");
+    checkMapsClose(depthMap, expectedDepthMap);
+    checkMapsClose(simMap, expectedSimMap);
+
+    // pixels covered by a single tile are not weighted
+    BOOST_CHECK_EQUAL(depthMap(0, 0), depthAt(0, 0));
+    BOOST_CHECK_EQUAL(depthMap(imageHeight - 1, imageWidth - 1), depthAt(imageWidth - 1, imageHeight - 1));
+
+    // depth or similarity map alone
+    image::Image<float> depthMapOnly;
+    image::Image<float> simMapOnly;
+    readDepthMap(0, mp, depthMapOnly, 1, 1, "_test");
+    readSimMap(0, mp, simMapOnly, 1, 1, "_test");
+    checkMapsClose(depthMapOnly, expectedDepthMap);
+    checkMapsClose(simMapOnly, expectedSimMap);
+
+    // number of depth values from the record headers, overlapping pixels are counted per tile
+    unsigned long nbDepthValues = 0;
+    for(const ROI& roi : tileRoiList)
+        nbDepthValues += roi.width() * roi.height();
+    BOOST_CHECK_EQUAL(getNbDepthValuesFromDepthMap(0, mp, 1, 1, "_test"), nbDepthValues);
+
+    deleteDepthSimMapTiles(0, mp, 1, 1, "_test");
+    BOOST_CHECK(!fs::exists(tilesFilePath));
+}
+
+BOOST_AUTO_TEST_CASE(depthSimMapIO_tilesOffsets)
+{
+    TmpFolder tmp;
+    const sfmData::SfMData sfmData = createSfmData();
+    const MultiViewParams mp(sfmData, "", tmp.path.string(), "", false);
+
+    TileParams tileParams;
+    tileParams.bufferWidth = 96;
+    tileParams.bufferHeight = 96;
+    tileParams.padding = 16;
+
+    // downscaled tiles, the last ones are not multiple of the downscale
+    const int scale = 2;
+    std::vector<ROI> tileRoiList;
+    getTileRoiList(tileParams, imageWidth, imageHeight, scale, tileRoiList);
+
+    image::Image<float> depthMap;
+    image::Image<float> simMap;
+    image::Image<float> firstDepthMap;
+    image::Image<float> firstSimMap;
+    writeTiles(mp, tileParams, tileRoiList, scale, 0.f, firstDepthMap, firstSimMap);
+
+    // each record follows the previous one
+    const std::string tilesFilePath = getFileNameFromIndex(mp, 0, EFileType::depthSimMapTiles, scale, "_test");
+    {
+        std::uintmax_t expectedFileSize = 24; // file header
+        for(const ROI& roi : tileRoiList)
+        {
+            const ROI downscaledRoi = downscaleROI(roi, scale);
+            expectedFileSize += 24 + 2 * sizeof(float) * downscaledRoi.width() * downscaledRoi.height();
+        }
+        BOOST_CHECK_EQUAL(fs::file_size(tilesFilePath), expectedFileSize);
+    }
+
+    // tiles written again replace the previous ones
+    image::Image<float> expectedDepthMap;
+    image::Image<float> expectedSimMap;
+    writeTiles(mp, tileParams, tileRoiList, scale, 0.25f, expectedDepthMap, expectedSimMap);
+
+    readDepthSimMap(0, mp, depthMap, simMap, scale, 1, "_test");
+    BOOST_CHECK_EQUAL(depthMap.Width(), divideRoundUp(imageWidth, scale));
+    BOOST_CHECK_EQUAL(depthMap.Height(), divideRoundUp(imageHeight, scale));
+    checkMapsClose(depthMap, expectedDepthMap);
+    checkMapsClose(simMap, expectedSimMap);
+    BOOST_CHECK_EQUAL(depthMap(0, 0), depthAt(0, 0, 0.25f));
+
+    // a record truncated by an interrupted write is ignored
+    {
+        std::ofstream file(tilesFilePath, std::ios::binary | std::ios::app);
+        const std::int32_t record[6] = {0, tileRoiList.front().x.end, 0, tileRoiList.front().y.end, 1, 0};
+        file.write(reinterpret_cast<const char*>(record), sizeof(record));
+        const float partialData[3] = {-1.f, -1.f, -1.f};
+        file.write(reinterpret_cast<const char*>(partialData), sizeof(partialData));
+    }
+    readDepthSimMap(0, mp, depthMap, simMap, scale, 1, "_test");
+    checkMapsClose(depthMap, expectedDepthMap);
+    checkMapsClose(simMap, expectedSimMap);
+}
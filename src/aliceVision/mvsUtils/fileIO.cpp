@@ -298,6 +298,16 @@ std::string getFileNameFromViewId(const MultiViewParams& mp, int viewId, EFileTy
           ext = "obj";
           break;
       }
+      case EFileType::depthSimMapTiles:
+      {
+          if(scale == 0)
+              folder = mp.getDepthMapsFilterFolder();
+          else
+              folder = mp.getDepthMapsFolder();
+          suffix = "_depthSimMapTiles";
+          ext = "bin";
+          break;
+      }
   }
   if(scale > 1)
   {
@@ -352,30 +362,38 @@ template<class Image>
 void loadImage(const std::string& path, const MultiViewParams& mp, int camId, Image& img,
                image::EImageColorSpace colorspace, ECorrectEV correctEV)
 {
-    // check image size
-    auto checkImageSize = [&path, &mp, camId, &img](){
-        if((mp.getOriginalWidth(camId) != img.Width()) || (mp.getOriginalHeight(camId) != img.Height()))
-        {
-            std::stringstream s;
-            s << "Bad image dimension for camera : " << camId << "\n";
-            s << "\t- image path : " << path << "\n";
-            s << "\t- expected dimension : " << mp.getOriginalWidth(camId) << "x" << mp.getOriginalHeight(camId) << "\n";
-            s << "\t- real dimension : " << img.Width() << "x" << img.Height() << "\n";
-            throw std::runtime_error(s.str());
-        }
-    };
-
-    if(correctEV == ECorrectEV::NO_CORRECTION)
+    // scale choosed by the user and apply during the process
+    // the image is downscaled while decoding (box filter applied after the conversion to the working color space),
+    // so the full resolution is never allocated.
+    // with exposure correction, pixels are averaged in linear color space, which commutes with the exposure scale.
+    const int processScale = std::max(1, mp.getProcessDownscale());
+    if(processScale > 1)
     {
-        image::readImage(path, img, colorspace);
-        checkImageSize();
+        ALICEVISION_LOG_DEBUG("Downscale (x" << processScale << ") image: " << mp.getViewId(camId) << ".");
     }
+
+    image::ImageReadOptions options;
+    options.downscale = processScale;
     // if exposure correction, apply it in linear colorspace and then convert colorspace
-    else
+    options.workingColorSpace = (correctEV == ECorrectEV::NO_CORRECTION) ? colorspace : image::EImageColorSpace::LINEAR;
+    image::readImage(path, img, options);
+
+    // check image size on the decoded pixels, as the file header may not give the decoded size (e.g. RAW images)
+    const int expectedWidth = mp.getOriginalWidth(camId) / processScale;
+    const int expectedHeight = mp.getOriginalHeight(camId) / processScale;
+    if((img.Width() != expectedWidth) || (img.Height() != expectedHeight))
     {
-        image::readImage(path, img, image::EImageColorSpace::LINEAR);
-        checkImageSize();
+        std::stringstream s;
+        s << "Bad image dimension for camera : " << camId << "\n";
+        s << "\t- image path : " << path << "\n";
+        s << "\t- expected dimension : " << mp.getOriginalWidth(camId) << "x" << mp.getOriginalHeight(camId);
+        s << " (" << expectedWidth << "x" << expectedHeight << " after downscale x" << processScale << ")\n";
+        s << "\t- real dimension : " << img.Width() << "x" << img.Height() << " after downscale x" << processScale << "\n";
+        throw std::runtime_error(s.str());
+    }
 
+    if(correctEV != ECorrectEV::NO_CORRECTION)
+    {
         const auto metadata = image::readImageMetadata(path);
 
         float exposureCompensation = metadata.get_float("AliceVision:EVComp", -1);
@@ -395,17 +413,6 @@ void loadImage(const std::string& path, const MultiViewParams& mp, int camId, Im
             imageAlgo::colorconvert(img, image::EImageColorSpace::LINEAR, colorspace);
         }
     }
-
-    // scale choosed by the user and apply during the process
-    const int processScale = mp.getProcessDownscale();
-
-    if(processScale > 1)
-    {
-        ALICEVISION_LOG_DEBUG("Downscale (x" << processScale << ") image: " << mp.getViewId(camId) << ".");
-        Image bmpr;
-        imageAlgo::resizeImage(processScale, img, bmpr);
-        img.swap(bmpr);
-    }
 }
 
 template void loadImage<image::Image<image::RGBfColor>>(const std::string& path, const MultiViewParams& mp, int camId,
@@ -124,7 +124,7 @@ struct BoundingBox
         return true;
     }
 
-    BoundingBox dilate(int units) 
+    BoundingBox dilate(int units) const
     {
         BoundingBox b;
         
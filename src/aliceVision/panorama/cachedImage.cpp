@@ -37,12 +37,18 @@ bool CachedImage<image::RGBAfColor>::writeImage(const std::string& path, const i
         for(int j = 0; j < row.size(); j++)
         {
 
-            if(!row[j]->acquire())
+            if(j + 1 < row.size())
+            {
+                row[j + 1]->prefetch();
+            }
+
+            image::CachedTileLock lock(row[j]);
+            if(!lock.isAcquired())
             {
                 return false;
             }
 
-            unsigned char* ptr = row[j]->getDataPointer();
+            unsigned char* ptr = lock.getDataPointer();
 
             out->write_tile(j * _tileSize, i * _tileSize, 0, oiio::TypeDesc::FLOAT, ptr);
         }
@@ -86,12 +92,18 @@ bool CachedImage<image::RGBfColor>::writeImage(const std::string& path, const im
         for(int j = 0; j < row.size(); j++)
         {
 
-            if(!row[j]->acquire())
+            if(j + 1 < row.size())
+            {
+                row[j + 1]->prefetch();
+            }
+
+            image::CachedTileLock lock(row[j]);
+            if(!lock.isAcquired())
             {
                 return false;
             }
 
-            unsigned char* ptr = row[j]->getDataPointer();
+            unsigned char* ptr = lock.getDataPointer();
 
             out->write_tile(j * _tileSize, i * _tileSize, 0, oiio::TypeDesc::FLOAT, ptr);
         }
@@ -129,12 +141,18 @@ bool CachedImage<IndexT>::writeImage(const std::string& path, const image::EStor
         for(int j = 0; j < row.size(); j++)
         {
 
-            if(!row[j]->acquire())
+            if(j + 1 < row.size())
+            {
+                row[j + 1]->prefetch();
+            }
+
+            image::CachedTileLock lock(row[j]);
+            if(!lock.isAcquired())
             {
                 return false;
             }
 
-            unsigned char* ptr = row[j]->getDataPointer();
+            unsigned char* ptr = lock.getDataPointer();
 
             out->write_tile(j * _tileSize, i * _tileSize, 0, oiio::TypeDesc::UINT32, ptr);
         }
@@ -172,12 +190,18 @@ bool CachedImage<float>::writeImage(const std::string& path, const image::EStora
         for(int j = 0; j < row.size(); j++)
         {
 
-            if(!row[j]->acquire())
+            if(j + 1 < row.size())
+            {
+                row[j + 1]->prefetch();
+            }
+
+            image::CachedTileLock lock(row[j]);
+            if(!lock.isAcquired())
             {
                 return false;
             }
 
-            unsigned char* ptr = row[j]->getDataPointer();
+            unsigned char* ptr = lock.getDataPointer();
 
             out->write_tile(j * _tileSize, i * _tileSize, 0, oiio::TypeDesc::FLOAT, ptr);
         }
@@ -215,12 +239,18 @@ bool CachedImage<unsigned char>::writeImage(const std::string& path, const image
         for(int j = 0; j < row.size(); j++)
         {
 
-            if(!row[j]->acquire())
+            if(j + 1 < row.size())
+            {
+                row[j + 1]->prefetch();
+            }
+
+            image::CachedTileLock lock(row[j]);
+            if(!lock.isAcquired())
             {
                 return false;
             }
 
-            unsigned char* ptr = row[j]->getDataPointer();
+            unsigned char* ptr = lock.getDataPointer();
 
             out->write_tile(j * _tileSize, i * _tileSize, 0, oiio::TypeDesc::UINT8, ptr);
         }
@@ -50,7 +50,7 @@ public:
                 int tile_width = manager->getTileWidth();
                 if(j == countWidth - 1)
                 {
-                    tile_width = width - (i * tile_width);
+                    tile_width = width - (j * tile_width);
                 }
 
                 image::CachedTile::smart_pointer tile = manager->requireNewCachedTile<T>(tile_width, tile_height);
@@ -93,12 +93,16 @@ public:
                     continue;
                 }
 
-                if(!ptr->acquire())
+                // Read the next tile from disk while this one is processed
+                prefetchTile(i, j + 1);
+
+                image::CachedTileLock lock(ptr);
+                if(!lock.isAcquired())
                 {
                     continue;
                 }
 
-                T* data = (T*)ptr->getDataPointer();
+                T* data = (T*)lock.getDataPointer();
 
                 std::transform(data, data + ptr->getTileWidth() * ptr->getTileHeight(), data, f);
             }
@@ -135,18 +139,23 @@ public:
                     continue;
                 }
 
-                if(!ptr->acquire())
+                prefetchTile(i, j + 1);
+                other.prefetchTile(i, j + 1);
+
+                image::CachedTileLock lock(ptr);
+                if(!lock.isAcquired())
                 {
                     continue;
                 }
 
-                if(!ptrOther->acquire())
+                image::CachedTileLock lockOther(ptrOther);
+                if(!lockOther.isAcquired())
                 {
                     continue;
                 }
 
-                T* data = (T*)ptr->getDataPointer();
-                T2* dataOther = (T2*)ptrOther->getDataPointer();
+                T* data = (T*)lock.getDataPointer();
+                T2* dataOther = (T2*)lockOther.getDataPointer();
 
                 std::transform(data, data + ptr->getTileWidth() * ptr->getTileHeight(), dataOther, data, f);
             }
@@ -181,18 +190,22 @@ public:
                     continue;
                 }
 
-                if (!ptr->acquire())
+                source.prefetchTile(i, j + 1);
+
+                image::CachedTileLock lock(ptr);
+                if (!lock.isAcquired())
                 {
                     continue;
                 }
 
-                if (!ptrSource->acquire())
+                image::CachedTileLock lockSource(ptrSource);
+                if (!lockSource.isAcquired())
                 {
                     continue;
                 }
 
-                T * data = (T*)ptr->getDataPointer();
-                T * dataSource = (T*)ptrSource->getDataPointer();
+                T * data = (T*)lock.getDataPointer();
+                T * dataSource = (T*)lockSource.getDataPointer();
                 
                 std::memcpy(data, dataSource, _tileSize * _tileSize * sizeof(T));
             }
@@ -271,12 +284,13 @@ public:
                     continue;
                 }
 
-                if(!ptr->acquire())
+                image::CachedTileLock lock(ptr);
+                if(!lock.isAcquired())
                 {
                     continue;
                 }
 
-                T* data = (T*)ptr->getDataPointer();
+                T* data = (T*)lock.getDataPointer();
 
                 for(int y = 0; y < _tileSize; y++)
                 {
@@ -364,12 +378,13 @@ public:
                     continue;
                 }
 
-                if(!ptr->acquire())
+                image::CachedTileLock lock(ptr);
+                if(!lock.isAcquired())
                 {
                     continue;
                 }
 
-                T* data = (T*)ptr->getDataPointer();
+                T* data = (T*)lock.getDataPointer();
 
                 for(int y = 0; y < _tileSize; y++)
                 {
@@ -396,13 +411,14 @@ public:
             return false;
         }
 
-        if(!tile->acquire())
+        image::CachedTileLock lock(tile);
+        if(!lock.isAcquired())
         {
             return false;
         }
 
         ret.resize(tile->getTileWidth(), tile->getTileHeight());
-        T * data = (T*)tile->getDataPointer();
+        T * data = (T*)lock.getDataPointer();
         for (int i = 0; i < tile->getTileHeight(); i++)
         {
             for (int j = 0; j < tile->getTileWidth(); j++)
@@ -417,27 +433,28 @@ public:
 
     static bool setTileWithImage(image::CachedTile::smart_pointer tile, const image::Image<T> & ret) 
     {
-        if (ret.Width() != tile->getTileWidth())
+        if(!tile)
         {
             return false;
         }
 
-        if (ret.Height() != tile->getTileHeight())
+        if (ret.Width() != tile->getTileWidth())
         {
             return false;
         }
 
-        if(!tile)
+        if (ret.Height() != tile->getTileHeight())
         {
             return false;
         }
 
-        if(!tile->acquire())
+        image::CachedTileLock lock(tile);
+        if(!lock.isAcquired())
         {
             return false;
         }
 
-        T * data = (T*)tile->getDataPointer();
+        T * data = (T*)lock.getDataPointer();
         for (int i = 0; i < tile->getTileHeight(); i++)
         {
             for (int j = 0; j < tile->getTileWidth(); j++)
@@ -465,6 +482,23 @@ public:
         return true;
     }
 
+    /**
+     * Ask the cache to read a tile back in the background
+     * Out of bounds coordinates are ignored.
+     */
+    void prefetchTile(int i, int j)
+    {
+        if(i < 0 || i >= _tilesArray.size() || j < 0 || j >= _tilesArray[i].size())
+        {
+            return;
+        }
+
+        if(_tilesArray[i][j])
+        {
+            _tilesArray[i][j]->prefetch();
+        }
+    }
+
     std::vector<RowType>& getTiles() { return _tilesArray; }
 
     int getWidth() const { return _width; }
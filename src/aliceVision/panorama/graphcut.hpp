@@ -4,6 +4,9 @@
 #include <boost/graph/boykov_kolmogorov_max_flow.hpp>
 
 #include <aliceVision/image/all.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/system/Timer.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 #include "distance.hpp"
 #include "boundingBox.hpp"
@@ -63,6 +66,30 @@ public:
         _graph.m_vertices[numNodes + 1].m_out_edges.reserve(numNodes);
     }
 
+    /**
+     * @brief Remove all edges and set a new number of nodes.
+     * The per vertex edge storage is kept to avoid reallocations when the graph is reused.
+     * @param numNodes the number of nodes (source and sink excluded)
+     */
+    void reset(size_t numNodes)
+    {
+        for(auto& vertex : _graph.m_vertices)
+        {
+            vertex.m_out_edges.clear();
+        }
+
+        _graph.m_vertices.resize(numNodes + 2);
+        _S = NodeType(numNodes);
+        _T = NodeType(numNodes + 1);
+
+        for(size_t id = 0; id < numNodes; id++)
+        {
+            _graph.m_vertices[id].m_out_edges.reserve(9);
+        }
+        _graph.m_vertices[numNodes].m_out_edges.reserve(numNodes);
+        _graph.m_vertices[numNodes + 1].m_out_edges.reserve(numNodes);
+    }
+
     inline void addNodeToSource(NodeType n, ValueType source)
     {
         assert(source >= 0);
@@ -105,17 +132,33 @@ public:
     void printStats() const;
     void printColorStats() const;
 
+    /**
+     * @brief Estimate the memory used by a graph of a given number of nodes
+     * Each node reserves 9 out edges, plus its reverse edge stored by the source and the sink.
+     * An out edge stores its target and a pointer to its heap allocated properties.
+     * @param numNodes the number of nodes (source and sink excluded)
+     * @return a memory size in bytes
+     */
+    static size_t estimateMemory(size_t numNodes)
+    {
+        const size_t edgeSize = sizeof(vertex_descriptor) + sizeof(void*) + sizeof(Edge);
+        const size_t nodeSize = sizeof(std::vector<vertex_descriptor>) + 11 * edgeSize + sizeof(boost::default_color_type) +
+                                sizeof(edge_descriptor) + sizeof(vertex_size_type);
+
+        return (numNodes + 2) * nodeSize;
+    }
+
     inline ValueType compute()
     {
         vertex_size_type nbVertices(boost::num_vertices(_graph));
-        _color.resize(nbVertices, boost::white_color);
-        std::vector<edge_descriptor> pred(nbVertices);
-        std::vector<vertex_size_type> dist(nbVertices);
+        _color.assign(nbVertices, boost::white_color);
+        _pred.resize(nbVertices);
+        _dist.assign(nbVertices, 0);
 
         ValueType v = boost::boykov_kolmogorov_max_flow(_graph, boost::get(&Edge::capacity, _graph),
                                                         boost::get(&Edge::residual, _graph),
-                                                        boost::get(&Edge::reverse, _graph), &pred[0], &_color[0],
-                                                        &dist[0], boost::get(boost::vertex_index, _graph), _S, _T);
+                                                        boost::get(&Edge::reverse, _graph), &_pred[0], &_color[0],
+                                                        &_dist[0], boost::get(boost::vertex_index, _graph), _S, _T);
 
         return v;
     }
@@ -128,8 +171,10 @@ public:
 protected:
     Graph _graph;
     std::vector<boost::default_color_type> _color;
-    const NodeType _S; //< emptyness
-    const NodeType _T; //< fullness
+    std::vector<edge_descriptor> _pred;
+    std::vector<vertex_size_type> _dist;
+    NodeType _S; //< emptyness
+    NodeType _T; //< fullness
 };
 
 
@@ -474,15 +519,119 @@ public:
         return true;
     }
 
-    bool processInput(double & newCost, InputData & input)
-    {       
-
-        //Get bounding box of input in panorama
+    /**
+     * @brief Get the region of the labels read and modified when processing an input
+     * @param input the input
+     * @return the bounding box in the panorama (may go beyond its right border)
+     */
+    BoundingBox getInputLocalBoundingBox(const InputData & input) const
+    {
         //Dilate to have some pixels outside of the input
         BoundingBox localBbox = input.rect.dilate(3);
         localBbox.clampLeft();
         localBbox.clampTop();
         localBbox.clampBottom(_labels.Height() - 1);
+
+        return localBbox;
+    }
+
+    /**
+     * @brief Check if two regions of the panorama overlap, considering the horizontal loop
+     */
+    bool overlapsInPanorama(const BoundingBox & first, const BoundingBox & second) const
+    {
+        if (first.top > second.getBottom() || second.top > first.getBottom())
+        {
+            return false;
+        }
+
+        if (first.width >= _outputWidth || second.width >= _outputWidth)
+        {
+            return true;
+        }
+
+        for (int shift = -1; shift <= 1; shift++)
+        {
+            BoundingBox shifted = second;
+            shifted.left += shift * _outputWidth;
+
+            if (!first.intersectionWith(shifted).isEmpty())
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @brief Group the inputs so that the inputs of a group modify disjoint regions of the labels
+     * Inputs of a group can then be processed concurrently.
+     * @param batches the list of groups
+     */
+    void computeIndependentBatches(std::vector<std::vector<InputData*>> & batches)
+    {
+        std::vector<std::vector<BoundingBox>> batchesBbox;
+
+        for (auto & info : _inputs)
+        {
+            const BoundingBox localBbox = getInputLocalBoundingBox(info.second);
+
+            //Greedy coloring: put the input in the first group it does not conflict with
+            size_t idBatch = 0;
+            for (; idBatch < batches.size(); idBatch++)
+            {
+                bool conflict = false;
+                for (const BoundingBox & other : batchesBbox[idBatch])
+                {
+                    if (overlapsInPanorama(localBbox, other))
+                    {
+                        conflict = true;
+                        break;
+                    }
+                }
+
+                if (!conflict)
+                {
+                    break;
+                }
+            }
+
+            if (idBatch == batches.size())
+            {
+                batches.emplace_back();
+                batchesBbox.emplace_back();
+            }
+
+            batches[idBatch].push_back(&info.second);
+            batchesBbox[idBatch].push_back(localBbox);
+        }
+    }
+
+    /**
+     * @brief Estimate the memory used by processInput for an input
+     * @param input the input
+     * @return a memory size in bytes
+     */
+    size_t estimateInputMemory(const InputData & input) const
+    {
+        const BoundingBox localBbox = getInputLocalBoundingBox(input);
+        const size_t area = size_t(localBbox.width) * size_t(localBbox.height);
+
+        // Labels, overlapping observations (assuming two per pixel), distance map,
+        // and the alpha expansion mask, ids and colors
+        const size_t pixelSize = sizeof(IndexT) + sizeof(PixelInfo) + 2 * sizeof(IndexedColor) + sizeof(int) +
+                                 sizeof(unsigned char) + sizeof(int) + 2 * sizeof(image::RGBfColor);
+
+        // At most one graph node per pixel
+        return area * pixelSize + MaxFlow_AdjList::estimateMemory(area);
+    }
+
+    bool processInput(double & newCost, InputData & input, MaxFlow_AdjList & graph)
+    {       
+
+        //Get bounding box of input in panorama
+        BoundingBox localBbox = getInputLocalBoundingBox(input);
         
         //Output must keep a margin also
         BoundingBox outputBbox = input.rect;
@@ -541,7 +690,7 @@ public:
         }
         
         double oldCost = cost(localLabels, graphCutInput, input.id);
-        if (!alphaExpansion(localLabels, distanceMap, graphCutInput, input.id)) 
+        if (!alphaExpansion(localLabels, distanceMap, graphCutInput, input.id, graph)) 
         {
             return false;
         }
@@ -575,30 +724,82 @@ public:
             costs[info.first] = std::numeric_limits<double>::max();
         }
 
+        // Inputs modifying disjoint parts of the labels are expanded concurrently
+        std::vector<std::vector<InputData*>> batches;
+        computeIndependentBatches(batches);
+        ALICEVISION_LOG_INFO("GraphCut: " << _inputs.size() << " labels in " << batches.size() << " independent batches");
+
+        // Each concurrent expansion keeps its own graph and buffers: bound their count by the available memory
+        size_t inputMaxMemoryConsumption = 0;
+        for (const auto & info : _inputs)
+        {
+            inputMaxMemoryConsumption = std::max(inputMaxMemoryConsumption, estimateInputMemory(info.second));
+        }
+
+        const system::MemoryInfo memoryInformation = system::getMemoryInfo();
+        int nbThreads = omp_get_max_threads();
+        if (inputMaxMemoryConsumption > 0)
+        {
+            const size_t nbThreadsInMemory = size_t((0.9 * memoryInformation.availableRam) / inputMaxMemoryConsumption);
+            nbThreads = int(std::max(size_t(1), std::min(size_t(nbThreads), nbThreadsInMemory)));
+        }
+
+        ALICEVISION_LOG_INFO("GraphCut: input max memory consumption " << inputMaxMemoryConsumption / (1024 * 1024) << " MB, " << nbThreads << " concurrent expansions");
+
+        // One graph per thread, reused between expansions to avoid reallocations
+        std::vector<std::unique_ptr<MaxFlow_AdjList>> graphs;
+        for (int idThread = 0; idThread < nbThreads; idThread++)
+        {
+            graphs.emplace_back(new MaxFlow_AdjList(0));
+        }
+
         for (int i = 0; i < 10; i++)
         {
             ALICEVISION_LOG_INFO("GraphCut processing iteration #" << i);
+            system::Timer timer;
 
             // For each possible label, try to extends its domination on the label's world
             bool hasChange = false;
+            bool hasFailed = false;
 
-            int pos = 0;
-            for (auto & info : _inputs)
-            {   
-                double cost;
-                if (!processInput(cost, info.second)) 
+            for (const std::vector<InputData*> & batch : batches)
+            {
+                #pragma omp parallel for num_threads(nbThreads) schedule(dynamic) reduction(||:hasChange)
+                for (int pos = 0; pos < batch.size(); pos++)
                 {
-                    return false;
+                    InputData & input = *batch[pos];
+
+                    double cost;
+                    if (!processInput(cost, input, *graphs[omp_get_thread_num()]))
+                    {
+                        #pragma omp critical
+                        hasFailed = true;
+                        continue;
+                    }
+
+                    // Each input only updates its own entry
+                    double & previousCost = costs.at(input.id);
+                    if (previousCost != cost)
+                    {
+                        previousCost = cost;
+                        hasChange = true;
+                    }
                 }
-                
 
-                if (costs[info.first] != cost)
+                if (hasFailed)
                 {
-                    costs[info.first] = cost;
-                    hasChange = true;
+                    return false;
                 }
             }
 
+            double totalCost = 0.0;
+            for (const auto & cost : costs)
+            {
+                totalCost += cost.second;
+            }
+
+            ALICEVISION_LOG_INFO("GraphCut iteration #" << i << ": cost " << totalCost << ", time " << system::prettyTime(timer.elapsedMs()));
+
             if (!hasChange)
             {
                 break;
@@ -737,7 +938,7 @@ public:
         return cost;
     }
 
-    bool alphaExpansion(image::Image<IndexT> & labels, const image::Image<int> & distanceMap, const image::Image<PixelInfo> & input, IndexT currentLabel)
+    bool alphaExpansion(image::Image<IndexT> & labels, const image::Image<int> & distanceMap, const image::Image<PixelInfo> & input, IndexT currentLabel, MaxFlow_AdjList & gc)
     {
         image::Image<unsigned char> mask(labels.Width(), labels.Height(), true, 0);
         image::Image<int> ids(labels.Width(), labels.Height(), true, -1);
@@ -819,7 +1020,7 @@ public:
         }  
 
         //Create graph
-        MaxFlow_AdjList gc(count);
+        gc.reset(count);
         size_t countValid = 0;
 
         for(int y = 0; y < labels.Height(); y++)
@@ -280,30 +280,27 @@ int aliceVision_main(int argc, char** argv)
             groupedExposures.push_back(getExposures(exposuresSetting));
         }
 
-        size_t group_pos = 0;
         hdr::Sampling sampling;
+        bool succeeded = true;
+        v_luminanceInfos.resize(groupedViews.size());
 
         ALICEVISION_LOG_INFO("Analyzing samples for each group");
-        for (auto& group : groupedViews)
+        #pragma omp parallel for schedule(dynamic)
+        for (int group_pos = 0; group_pos < groupedViews.size(); ++group_pos)
         {
+            const auto& group = groupedViews[group_pos];
+
             // Read from file
             const std::string samplesFilepath = (fs::path(samplesFolder) / (std::to_string(group_pos) + "_samples.dat")).string();
-            std::ifstream fileSamples(samplesFilepath, std::ios::binary);
-            if (!fileSamples.is_open())
+            std::vector<hdr::ImageSample> samples;
+            if (!hdr::readSamples(samplesFilepath, samples))
             {
-                ALICEVISION_LOG_ERROR("Impossible to read samples from file " << samplesFilepath);
-                return EXIT_FAILURE;
-            }
-
-            std::size_t size;
-            fileSamples.read((char*)&size, sizeof(size));
-
-            std::vector<hdr::ImageSample> samples(size);
-            for (std::size_t i = 0; i < size; ++i)
-            {
-                fileSamples >> samples[i];
+                #pragma omp critical
+                succeeded = false;
+                continue;
             }
 
+            #pragma omp critical
             sampling.analyzeSource(samples, channelQuantization, group_pos);
 
             std::map<int, luminanceInfo> luminanceInfos;
@@ -320,9 +317,12 @@ int aliceVision_main(int argc, char** argv)
                 }
             }
 
-            v_luminanceInfos.push_back(luminanceInfos);
+            v_luminanceInfos[group_pos] = luminanceInfos;
+        }
 
-            ++group_pos;
+        if (!succeeded)
+        {
+            return EXIT_FAILURE;
         }
 
         if (!byPass)
@@ -331,35 +331,27 @@ int aliceVision_main(int argc, char** argv)
             sampling.filter(maxTotalPoints);
 
             ALICEVISION_LOG_INFO("Extracting samples for each group");
-            group_pos = 0;
+            calibrationSamples.resize(groupedViews.size());
 
-            std::size_t total = 0;
-            for (auto& group : groupedViews)
+            #pragma omp parallel for schedule(dynamic)
+            for (int group_pos = 0; group_pos < groupedViews.size(); ++group_pos)
             {
                 // Read from file
                 const std::string samplesFilepath = (fs::path(samplesFolder) / (std::to_string(group_pos) + "_samples.dat")).string();
-                std::ifstream fileSamples(samplesFilepath, std::ios::binary);
-                if (!fileSamples.is_open())
+                std::vector<hdr::ImageSample> samples;
+                if (!hdr::readSamples(samplesFilepath, samples))
                 {
-                    ALICEVISION_LOG_ERROR("Impossible to read samples from file " << samplesFilepath);
-                    return EXIT_FAILURE;
+                    #pragma omp critical
+                    succeeded = false;
+                    continue;
                 }
 
-                std::size_t size = 0;
-                fileSamples.read((char*)&size, sizeof(size));
-
-                std::vector<hdr::ImageSample> samples(size);
-                for (int i = 0; i < size; ++i)
-                {
-                    fileSamples >> samples[i];
-                }
-
-                std::vector<hdr::ImageSample> out_samples;
-                sampling.extractUsefulSamples(out_samples, samples, group_pos);
-
-                calibrationSamples.push_back(out_samples);
+                sampling.extractUsefulSamples(calibrationSamples[group_pos], samples, group_pos);
+            }
 
-                ++group_pos;
+            if (!succeeded)
+            {
+                return EXIT_FAILURE;
             }
 
             // Define calibration weighting curve from name
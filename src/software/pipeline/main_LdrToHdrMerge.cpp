@@ -288,22 +288,12 @@ int aliceVision_main(int argc, char** argv)
     {
         const std::vector<std::shared_ptr<sfmData::View>>& group = groupedViews[g];
 
-        std::vector<image::Image<image::RGBfColor>> images(group.size());
         std::shared_ptr<sfmData::View> targetView = targetViews[g];
         std::vector<sfmData::ExposureSetting> exposuresSetting(group.size());
 
-        // Load all images of the group
+        // Exposures only depend on metadata, check them before loading any image
         for(std::size_t i = 0; i < group.size(); ++i)
         {
-            const std::string filepath = group[i]->getImagePath();
-            ALICEVISION_LOG_INFO("Load " << filepath);
-
-            image::ImageReadOptions options;
-            options.workingColorSpace = workingColorSpace;
-            options.rawColorInterpretation = image::ERawColorInterpretation_stringToEnum(group[i]->getRawColorInterpretation());
-            options.colorProfileFileName = group[i]->getColorProfileFileName();
-            image::readImage(filepath, images[i], options);
-
             exposuresSetting[i] = group[i]->getCameraExposureSetting(/*targetView->getMetadataISO(), targetView->getMetadataFNumber()*/);
         }
         if(!sfmData::hasComparableExposures(exposuresSetting))
@@ -312,23 +302,62 @@ int aliceVision_main(int argc, char** argv)
         }
         std::vector<double> exposures = getExposures(exposuresSetting);
 
-        // Merge HDR images
+        // Stream the brackets: only the current one is kept in memory with the merge accumulators
         image::Image<image::RGBfColor> HDRimage;
-        if(images.size() > 1)
+        image::Image<image::RGBfColor> bracket;
+        image::Image<float> clampedMask;
+        hdr::hdrMerge merge;
+        sfmData::ExposureSetting targetCameraSetting = targetView->getCameraExposureSetting();
+
+        if(group.size() > 1)
         {
-            hdr::hdrMerge merge;
-            sfmData::ExposureSetting targetCameraSetting = targetView->getCameraExposureSetting();
             ALICEVISION_LOG_INFO("[" << g - rangeStart << "/" << rangeSize << "] Merge " << group.size() << " LDR images " << g << "/" << groupedViews.size());
-            merge.process(images, exposures, fusionWeight, response, HDRimage, targetCameraSetting.getExposure());
-            if(highlightCorrectionFactor > 0.0f)
+        }
+
+        for(std::size_t i = 0; i < group.size(); ++i)
+        {
+            const std::string filepath = group[i]->getImagePath();
+            ALICEVISION_LOG_INFO("Load " << filepath);
+
+            image::ImageReadOptions options;
+            options.workingColorSpace = workingColorSpace;
+            options.rawColorInterpretation = image::ERawColorInterpretation_stringToEnum(group[i]->getRawColorInterpretation());
+            options.colorProfileFileName = group[i]->getColorProfileFileName();
+
+            if(group.size() == 1)
             {
-                merge.postProcessHighlight(images, exposures, fusionWeight, response, HDRimage, targetCameraSetting.getExposure(), highlightCorrectionFactor, highlightTargetLux);
+                // Nothing to merge
+                image::readImage(filepath, HDRimage, options);
+                break;
+            }
+
+            image::readImage(filepath, bracket, options);
+
+            if(i == 0)
+            {
+                merge.init(bracket.Width(), bracket.Height(), group.size(), fusionWeight, response);
+
+                // Highlights are detected on the shortest exposure
+                if(highlightCorrectionFactor > 0.0f)
+                {
+                    hdr::hdrMerge::computeClampedMask(bracket, clampedMask);
+                }
+            }
+
+            if(!merge.accumulate(bracket, i, exposures[i]))
+            {
+                ALICEVISION_LOG_ERROR("Brackets of group " << g << " do not have the same size.");
+                return EXIT_FAILURE;
             }
         }
-        else if(images.size() == 1)
+
+        if(group.size() > 1)
         {
-            // Nothing to do
-            HDRimage = images[0];
+            merge.finalize(HDRimage, targetCameraSetting.getExposure());
+            if(highlightCorrectionFactor > 0.0f)
+            {
+                hdr::hdrMerge::postProcessHighlight(clampedMask, HDRimage, targetCameraSetting.getExposure(), highlightCorrectionFactor, highlightTargetLux);
+            }
         }
 
         const std::string hdrImagePath = getHdrImagePath(outputPath, g);
@@ -9,6 +9,8 @@
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/cmdline.hpp>
 #include <aliceVision/system/main.hpp>
+#include <aliceVision/system/MemoryInfo.hpp>
+#include <aliceVision/alicevision_omp.hpp>
 
 // SFMData
 #include <aliceVision/sfmData/SfMData.hpp>
@@ -41,7 +43,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 0
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 using namespace aliceVision::hdr;
@@ -91,6 +93,8 @@ int aliceVision_main(int argc, char** argv)
          "Radius of the patch used to analyze the sample statistics.")
         ("maxCountSample", po::value<size_t>(&params.maxCountSample)->default_value(params.maxCountSample),
          "Max number of samples per image group.")
+        ("subsampling", po::value<int>(&params.subsampling)->default_value(params.subsampling),
+         "Step of the pixel grid where samples are searched, to reduce memory and time on large images.")
         ("debug", po::value<bool>(&debug)->default_value(debug),
          "Export debug files.")
         ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
@@ -189,7 +193,27 @@ int aliceVision_main(int argc, char** argv)
     }
     ALICEVISION_LOG_DEBUG("Range to compute: rangeStart=" << rangeStart << ", rangeSize=" << rangeSize);
 
-    for(std::size_t groupIdx = rangeStart; groupIdx < rangeStart + rangeSize; ++groupIdx)
+    // How many groups can be sampled simultaneously without swapping: one bracket and the candidate samples of all brackets
+    const std::size_t subsampling = std::max(1, params.subsampling);
+    const std::size_t groupMemoryConsumption = width * height * sizeof(image::RGBfColor) +
+        ((width + subsampling - 1) / subsampling) * ((height + subsampling - 1) / subsampling) *
+        (sizeof(hdr::ImageSample) + usedNbBrackets * sizeof(hdr::PixelDescription));
+
+    const system::MemoryInfo memoryInformation = system::getMemoryInfo();
+    const std::size_t maxMemory = std::min(memoryInformation.availableRam, hwc.getUserMaxMemoryAvailable());
+
+    std::size_t nbThreads = std::max(std::size_t(1), std::size_t((0.9 * maxMemory) / groupMemoryConsumption));
+    nbThreads = std::min(static_cast<std::size_t>(hwc.getMaxThreads()), nbThreads);
+    nbThreads = std::max(std::size_t(1), std::min(std::size_t(rangeSize), nbThreads));
+
+    ALICEVISION_LOG_INFO("Group max memory consumption: " << groupMemoryConsumption / (1024 * 1024) << " MB");
+    ALICEVISION_LOG_INFO("# groups sampled in parallel: " << nbThreads);
+
+    // With several groups in parallel, the loops inside the sampling of each group run sequentially
+    bool succeeded = true;
+
+#pragma omp parallel for num_threads(nbThreads) schedule(dynamic)
+    for(int groupIdx = rangeStart; groupIdx < rangeStart + rangeSize; ++groupIdx)
     {
         auto & group = groupedViews[groupIdx];
         ALICEVISION_LOG_INFO("Extracting samples from group " << groupIdx);
@@ -215,7 +239,10 @@ int aliceVision_main(int argc, char** argv)
         }
         if(!sfmData::hasComparableExposures(exposuresSetting))
         {
-            ALICEVISION_THROW_ERROR("Camera exposure settings are inconsistent.");
+            ALICEVISION_LOG_ERROR("Camera exposure settings are inconsistent in group " << groupIdx << ".");
+#pragma omp critical
+            succeeded = false;
+            continue;
         }
         std::vector<double> exposures = getExposures(exposuresSetting);
 
@@ -227,7 +254,18 @@ int aliceVision_main(int argc, char** argv)
         const bool simplifiedSampling = byPass || (calibrationMethod == ECalibrationMethod::LINEAR);
 
         std::vector<hdr::ImageSample> out_samples;
-        const bool res = hdr::Sampling::extractSamplesFromImages(out_samples, paths, viewIds, exposures, width, height, channelQuantization, imgReadOptions, params, simplifiedSampling);
+        bool res = false;
+        try
+        {
+            res = hdr::Sampling::extractSamplesFromImages(out_samples, paths, viewIds, exposures, width, height, channelQuantization, imgReadOptions, params, simplifiedSampling);
+        }
+        catch(const std::exception& e)
+        {
+            ALICEVISION_LOG_ERROR(e.what());
+#pragma omp critical
+            succeeded = false;
+            continue;
+        }
         if (!res)
         {
             ALICEVISION_LOG_ERROR("Error while extracting samples from group " << groupIdx);
@@ -274,21 +312,12 @@ int aliceVision_main(int argc, char** argv)
 
         // Store to file
         const std::string samplesFilepath = (fs::path(outputFolder) / (std::to_string(groupIdx) + "_samples.dat")).string();
-        std::ofstream fileSamples(samplesFilepath, std::ios::binary);
-        if (!fileSamples.is_open())
-        {
-            ALICEVISION_LOG_ERROR("Impossible to write samples");
-            return EXIT_FAILURE;
-        }
-
-        const std::size_t size = out_samples.size();
-        fileSamples.write((const char *)&size, sizeof(size));
-
-        for(std::size_t i = 0; i < out_samples.size(); ++i)
+        if (!hdr::writeSamples(samplesFilepath, out_samples))
         {
-            fileSamples << out_samples[i];
+#pragma omp critical
+            succeeded = false;
         }
     }
 
-    return EXIT_SUCCESS;
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -24,7 +24,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 2
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -52,6 +52,7 @@ int aliceVision_main(int argc, char* argv[])
     int pixSizeBall = 0;
     int pixSizeBallWithLowSimilarity = 0;
     int nNearestCams = 10;
+    int depthMapsCacheSize = 4096;
     bool computeNormalMaps = false;
 
     po::options_description requiredParams("Required parameters");
@@ -85,6 +86,8 @@ int aliceVision_main(int argc, char* argv[])
             "Filter ball size (in px) when the similarity is weak or ambiguous.")
         ("nNearestCams", po::value<int>(&nNearestCams)->default_value(nNearestCams),
             "Number of nearest cameras.")
+        ("depthMapsCacheSize", po::value<int>(&depthMapsCacheSize)->default_value(depthMapsCacheSize),
+            "Maximal size (in MB) of the neighbour depth maps kept in memory to be reused by the other cameras.")
         ("computeNormalMaps", po::value<bool>(&computeNormalMaps)->default_value(computeNormalMaps),
             "Compute normal maps per depth map");
 
@@ -139,7 +142,8 @@ int aliceVision_main(int argc, char* argv[])
 
     {
         fuseCut::Fuser fs(mp);
-        fs.filterGroups(cams, pixToleranceFactor, pixSizeBall, pixSizeBallWithLowSimilarity, nNearestCams);
+        fs.filterGroups(cams, pixToleranceFactor, pixSizeBall, pixSizeBallWithLowSimilarity, nNearestCams,
+                        std::size_t(std::max(depthMapsCacheSize, 0)) * 1024 * 1024);
         fs.filterDepthMaps(cams, minNumOfConsistentCams, minNumOfConsistentCamsWithLowSimilarity);
     }
 
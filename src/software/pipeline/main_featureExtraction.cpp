@@ -25,6 +25,9 @@
 #include <boost/filesystem.hpp>
 
 #include <string>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
 #include <iostream>
 #include <functional>
 #include <memory>
@@ -32,7 +35,7 @@
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -56,6 +59,9 @@ int aliceVision_main(int argc, char **argv)
   int rangeSize = 1;
   int maxThreads = 0;
   bool forceCpuExtraction = false;
+  std::string featureCacheFolder;
+  int featureCacheMaxSize = 10 * 1024;
+  int featureCacheMaxAge = 30;
 
   po::options_description requiredParams("Required parameters");
   requiredParams.add_options()
@@ -85,6 +91,14 @@ int aliceVision_main(int argc, char **argv)
       "Use only CPU feature extraction methods.")
     ("masksFolder", po::value<std::string>(&masksFolder),
       "Masks folder.")
+    ("featureCacheFolder", po::value<std::string>(&featureCacheFolder)->default_value(featureCacheFolder),
+      "Folder of the feature cache, shared between projects: images already described with the same parameters "
+      "reuse their features, even if they were moved or renamed (no cache if empty).")
+    ("featureCacheMaxSize", po::value<int>(&featureCacheMaxSize)->default_value(featureCacheMaxSize),
+      "Maximal size of the feature cache folder in MB, the least recently used features are removed beyond.")
+    ("featureCacheMaxAge", po::value<int>(&featureCacheMaxAge)->default_value(featureCacheMaxAge),
+      "Number of days after which unused features are removed from the cache, "
+      "such as the features of describer parameters no longer in use.")
     ("rangeStart", po::value<int>(&rangeStart)->default_value(rangeStart),
       "Range image index start.")
     ("rangeSize", po::value<int>(&rangeSize)->default_value(rangeSize),
@@ -135,6 +149,19 @@ int aliceVision_main(int argc, char **argv)
   extractor.setMasksFolder(masksFolder);
   extractor.setOutputFolder(outputFolder);
 
+  if(!featureCacheFolder.empty())
+  {
+    // every parameter changing the extracted features is part of the cache keys
+    std::stringstream parameters;
+    parameters << std::setprecision(17) << featDescConfig.descPreset << " " << featDescConfig.quality << " "
+               << featDescConfig.gridFiltering << " " << featDescConfig.maxNbFeatures << " "
+               << featDescConfig.contrastFiltering << " " << featDescConfig.relativePeakThreshold;
+
+    extractor.setFeatureCache(std::make_shared<feature::FeatureCache>(
+        featureCacheFolder, std::uintmax_t(featureCacheMaxSize) * 1024 * 1024, parameters.str(),
+        std::time_t(featureCacheMaxAge) * 24 * 3600));
+  }
+
   // set maxThreads
   HardwareContext hwc = cmdline.getHardwareContext();
   hwc.setUserCoresLimit(maxThreads);
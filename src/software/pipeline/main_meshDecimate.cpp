@@ -8,23 +8,17 @@
 #include <aliceVision/system/Logger.hpp>
 #include <aliceVision/system/main.hpp>
 #include <aliceVision/system/Timer.hpp>
+#include <aliceVision/mesh/Mesh.hpp>
+#include <aliceVision/mesh/meshDecimation.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
 
-#include <OpenMesh/Core/IO/reader/OBJReader.hh>
-#include <OpenMesh/Core/IO/writer/OBJWriter.hh>
-#include <OpenMesh/Core/IO/MeshIO.hh>
-#include <OpenMesh/Core/Mesh/TriMesh_ArrayKernelT.hh>
-#include <OpenMesh/Core/Geometry/VectorT.hh>
-#include <OpenMesh/Tools/Decimater/DecimaterT.hh>
-#include <OpenMesh/Tools/Decimater/ModQuadricT.hh>
-
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 1
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 1
 
 using namespace aliceVision;
 
@@ -42,13 +36,14 @@ int aliceVision_main(int argc, char* argv[])
     int minVertices = 0;
     int maxVertices = 0;
     bool flipNormals = false;
+    mesh::DecimationParams decimationParams;
 
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
         ("input,i", po::value<std::string>(&inputMeshPath)->required(),
-            "Input Mesh (OBJ file format).")
+            "Input Mesh (OBJ, PLY or any format supported by Assimp).")
         ("output,o", po::value<std::string>(&outputMeshPath)->required(),
-            "Output mesh (OBJ file format).");
+            "Output mesh (OBJ, PLY or any format supported by Assimp).");
 
     po::options_description optionalParams("Optional parameters");
     optionalParams.add_options()
@@ -61,7 +56,13 @@ int aliceVision_main(int argc, char* argv[])
         ("maxVertices", po::value<int>(&maxVertices)->default_value(maxVertices),
             "Max number of output vertices.")
         ("flipNormals", po::value<bool>(&flipNormals)->default_value(flipNormals),
-            "Option to flip face normals. It can be needed as it depends on the vertices order in triangles and the convention change from one software to another.");
+            "Option to flip face normals. It can be needed as it depends on the vertices order in triangles and the convention change from one software to another.")
+        ("nbVerticesPerPatch", po::value<int>(&decimationParams.nbVerticesPerPatch)->default_value(decimationParams.nbVerticesPerPatch),
+            "Number of vertices of the patches decimated in parallel.")
+        ("maxPassRemovalRatio", po::value<double>(&decimationParams.maxPassRemovalRatio)->default_value(decimationParams.maxPassRemovalRatio),
+            "Maximal ratio of the vertices of a patch removed in each parallel pass.")
+        ("maxNbParallelPasses", po::value<int>(&decimationParams.maxNbParallelPasses)->default_value(decimationParams.maxNbParallelPasses),
+            "Maximal number of parallel passes before the final decimation of the patches borders.");
 
     CmdLine cmdline("AliceVision meshDecimate");
                   
@@ -77,23 +78,12 @@ int aliceVision_main(int argc, char* argv[])
     if(!bfs::is_directory(outDirectory))
         bfs::create_directory(outDirectory);
 
-    // Mesh type
-    typedef OpenMesh::TriMesh_ArrayKernelT<>                      Mesh;
-    // Decimater type
-    typedef OpenMesh::Decimater::DecimaterT< Mesh >               Decimater;
-    // Decimation Module Handle type
-    typedef OpenMesh::Decimater::ModQuadricT< Mesh >::Handle HModQuadric;
-
-    Mesh mesh;
-    if(!OpenMesh::IO::read_mesh(mesh, inputMeshPath))
-    {
-        ALICEVISION_LOG_ERROR("Unable to read input mesh from the file: " << inputMeshPath);
-        return EXIT_FAILURE;
-    }
+    mesh::Mesh mesh;
+    mesh.load(inputMeshPath);
 
     ALICEVISION_LOG_INFO("Mesh file: \"" << inputMeshPath << "\" loaded.");
 
-    int nbInputPoints = mesh.n_vertices();
+    int nbInputPoints = mesh.pts.size();
     int nbOutputPoints = 0;
     if(fixedNbVertices != 0)
     {
@@ -117,35 +107,17 @@ int aliceVision_main(int argc, char* argv[])
         }
     }
 
-    ALICEVISION_LOG_INFO("Input mesh: " << nbInputPoints << " vertices and " << mesh.n_faces() << " facets.");
+    ALICEVISION_LOG_INFO("Input mesh: " << nbInputPoints << " vertices and " << mesh.tris.size() << " facets.");
     ALICEVISION_LOG_INFO("Target output mesh: " << nbOutputPoints << " vertices.");
 
-    {
-        // a decimater object, connected to a mesh
-        Decimater   decimater(mesh);
-        // use a quadric module
-        HModQuadric hModQuadric;
-        // register module at the decimater
-        decimater.add(hModQuadric);
-
-        // the way to access the module
-        std::cout << decimater.module(hModQuadric).name() << std::endl;
-
-        /*
-         * since we need exactly one priority module (non-binary)
-         * we have to call set_binary(false) for our priority module
-         * in the case of HModQuadric, unset_max_err() calls set_binary(false) internally
-         */
-        decimater.module(hModQuadric).unset_max_err();
-        // let the decimater initialize the mesh and the modules
-        decimater.initialize();
-        // do decimation
-        size_t removedVertices = decimater.decimate_to(nbOutputPoints);
-        decimater.mesh().garbage_collection();
-    }
-    ALICEVISION_LOG_INFO("Output mesh: " << mesh.n_vertices() << " vertices and " << mesh.n_faces() << " facets.");
+    mesh::decimateMesh(mesh, nbOutputPoints, decimationParams);
+
+    if(flipNormals)
+        mesh.invertTriangleOrientations();
+
+    ALICEVISION_LOG_INFO("Output mesh: " << mesh.pts.size() << " vertices and " << mesh.tris.size() << " facets.");
 
-    if(mesh.n_faces() == 0)
+    if(mesh.tris.empty())
     {
         ALICEVISION_LOG_ERROR("Failed: the output mesh is empty.");
         return EXIT_FAILURE;
@@ -153,11 +125,7 @@ int aliceVision_main(int argc, char* argv[])
 
     ALICEVISION_LOG_INFO("Save mesh.");
     // Save output mesh
-    if(!OpenMesh::IO::write_mesh(mesh, outputMeshPath))
-    {
-        ALICEVISION_LOG_ERROR("Failed to save mesh \"" << outputMeshPath << "\".");
-        return EXIT_FAILURE;
-    }
+    mesh.save(outputMeshPath);
     ALICEVISION_LOG_INFO("Mesh file: \"" << outputMeshPath << "\" saved.");
 
     ALICEVISION_LOG_INFO("Task done in (s): " + std::to_string(timer.elapsed()));
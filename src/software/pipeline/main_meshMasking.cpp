@@ -82,7 +82,7 @@ struct MaskCache
                         if (intrinsic->isValid() && intrinsic->hasDistortion())
                         {
                             image::Image<unsigned char> mask_ud;
-                            camera::UndistortImage(*mask, intrinsic.get(), mask_ud, (unsigned char)0);
+                            camera::UndistortImage(*mask, intrinsic.get(), _undistortionMaps, mask_ud, (unsigned char)0);
                             mask->swap(mask_ud);
                         }
                     }
@@ -147,6 +147,8 @@ private:
     mvsUtils::MultiViewParams _mp;
     std::vector<std::string> _masksFolders;
     bool _undistortMasks;
+    /// masks of views sharing an intrinsic reuse the same undistortion map
+    camera::UndistortionMapCache _undistortionMaps;
     int _maxSize;
     std::vector<Item> _cache;
 };
@@ -11,10 +11,12 @@
 #include <aliceVision/fuseCut/LargeScale.hpp>
 #include <aliceVision/fuseCut/ReconstructionPlan.hpp>
 #include <aliceVision/fuseCut/DelaunayGraphCut.hpp>
+#include <aliceVision/fuseCut/PartitionedMeshing.hpp>
 #include <aliceVision/mesh/meshPostProcessing.hpp>
 #include <aliceVision/mvsData/Point3d.hpp>
 #include <aliceVision/mvsData/StaticVector.hpp>
 #include <aliceVision/mvsUtils/common.hpp>
+#include <aliceVision/mvsUtils/depthSimMapIO.hpp>
 #include <aliceVision/mvsUtils/MultiViewParams.hpp>
 #include <aliceVision/mvsUtils/fileIO.hpp>
 #include <aliceVision/system/cmdline.hpp>
@@ -27,12 +29,16 @@
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 
+#include <atomic>
 #include <cmath>
+#include <exception>
+#include <memory>
+#include <mutex>
 
 // These constants define the current software version.
 // They must be updated when the command line is changed.
 #define ALICEVISION_SOFTWARE_VERSION_MAJOR 4
-#define ALICEVISION_SOFTWARE_VERSION_MINOR 0
+#define ALICEVISION_SOFTWARE_VERSION_MINOR 2
 
 using namespace aliceVision;
 
@@ -130,6 +136,24 @@ void removeLandmarksWithoutObservations(sfmData::SfMData& sfmData)
   }
 }
 
+/// Save the dense point cloud of \p delaunayGC, before the cut and the filtering, to \p filepath.
+void exportRawDensePointCloud(fuseCut::DelaunayGraphCut& delaunayGC,
+                              const sfmData::SfMData& sfmData,
+                              const mvsUtils::MultiViewParams& mp,
+                              bool colorizeOutput,
+                              const std::string& filepath)
+{
+  ALICEVISION_LOG_INFO("Save dense point cloud before cut and filtering.");
+  StaticVector<StaticVector<int>> ptsCams;
+  delaunayGC.createPtsCams(ptsCams);
+  sfmData::SfMData densePointCloud;
+  createDenseSfMData(sfmData, mp, delaunayGC._verticesCoords, ptsCams, densePointCloud);
+  removeLandmarksWithoutObservations(densePointCloud);
+  if(colorizeOutput)
+    sfmData::colorizeTracks(densePointCloud);
+  sfmDataIO::Save(densePointCloud, filepath, sfmDataIO::ESfMData::ALL_DENSE);
+}
+
 /// BoundingBox Structure stocking ordered values from the command line
 struct BoundingBox
 {
@@ -246,6 +270,144 @@ inline std::istream& operator>>(std::istream& in, BoundingBox& out_bbox)
     return in;
 }
 
+/**
+ * @brief Mesh the hexahedron \p hexah partition by partition, then stitch the partitions meshes.
+ *
+ * There are enough partitions to load the depth maps with the minimal step, each partition being fused with
+ * \p fuseParams, so the memory of a partition does not depend on the size of the scene.
+ * Without depth maps, the partitions split the SfM landmarks the same way.
+ */
+mesh::Mesh* meshPartitions(mvsUtils::MultiViewParams& mp,
+                           const Point3d hexah[8],
+                           const sfmData::SfMData& sfmData,
+                           bool addLandmarksToTheDensePointCloud,
+                           bool meshingFromDepthMaps,
+                           const fuseCut::FuseParams& fuseParams,
+                           double overlap,
+                           int nbParallelPartitions,
+                           int maxNbConnectedHelperPoints,
+                           bool exportDebugTetrahedralization,
+                           bool saveRawDensePointCloud,
+                           bool colorizeOutput,
+                           const fs::path& outDirectory,
+                           const fs::path& tmpDirectory,
+                           StaticVector<StaticVector<int>>& out_ptsCams)
+{
+    // without depth maps, all the cameras are used as in a single block
+    const auto getCams = [&](const Point3d partitionHexah[8]) {
+        if(meshingFromDepthMaps)
+            return mp.findCamsWhichIntersectsHexahedron(partitionHexah);
+        StaticVector<int> cams;
+        cams.resize(mp.getNbCameras());
+        for(int i = 0; i < cams.size(); ++i)
+            cams[i] = i;
+        return cams;
+    };
+
+    double nbInputPoints = 0.0;
+    if(meshingFromDepthMaps)
+    {
+        const StaticVector<int> cams = getCams(hexah);
+
+        unsigned long nbDepthValues = 0;
+        #pragma omp parallel for reduction(+:nbDepthValues)
+        for(int i = 0; i < cams.size(); ++i)
+            nbDepthValues += mvsUtils::getNbDepthValuesFromDepthMap(cams[i], mp);
+
+        nbInputPoints = double(nbDepthValues) / double(fuseParams.minStep * fuseParams.minStep);
+        ALICEVISION_LOG_INFO("Partitioning: " << nbDepthValues << " depth values.");
+    }
+    else
+    {
+        nbInputPoints = sfmData.getLandmarks().size();
+        ALICEVISION_LOG_INFO("Partitioning: " << sfmData.getLandmarks().size() << " landmarks.");
+    }
+    const int nbPartitions = std::max(1, int(std::ceil(nbInputPoints / fuseParams.maxInputPoints)));
+
+    const fuseCut::HexahedronPartitioning partitioning(hexah, nbPartitions, overlap);
+    ALICEVISION_LOG_INFO("Partitioning: " << partitioning.getNbPartitions() << " partitions (" << partitioning.getDimensions() << ").");
+
+    std::vector<mesh::Mesh*> partitionsMeshes(partitioning.getNbPartitions(), nullptr);
+    std::vector<StaticVector<StaticVector<int>>> partitionsPtsCams(partitioning.getNbPartitions());
+
+    // the first error stops the meshing, it is rethrown once all the partitions are done
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::atomic<bool> failed(false);
+
+    #pragma omp parallel for num_threads(std::max(nbParallelPartitions, 1)) schedule(dynamic)
+    for(int p = 0; p < partitioning.getNbPartitions(); ++p)
+    {
+        if(failed)
+            continue;
+
+        try
+        {
+            Point3d partitionHexah[8];
+            partitioning.getPartitionHexahedron(p, partitionHexah);
+
+            const StaticVector<int> partitionCams = getCams(partitionHexah);
+            if(partitionCams.empty())
+            {
+                ALICEVISION_LOG_INFO("Partition " << p << ": no camera.");
+                continue;
+            }
+
+            ALICEVISION_LOG_INFO("Partition " << p << ": mesh from " << partitionCams.size() << " cameras.");
+            const fs::path partitionDirectory = tmpDirectory / ("partition" + std::to_string(p));
+            fs::create_directories(partitionDirectory);
+            const std::string partitionFolder = partitionDirectory.string() + "/";
+
+            std::unique_ptr<fuseCut::DelaunayGraphCut> delaunayGC;
+            // geogram initialization is not thread safe
+            #pragma omp critical(meshPartitionsInit)
+            delaunayGC.reset(new fuseCut::DelaunayGraphCut(mp));
+
+            delaunayGC->createDensePointCloud(partitionHexah, partitionCams, addLandmarksToTheDensePointCloud ? &sfmData : nullptr,
+                                              meshingFromDepthMaps ? &fuseParams : nullptr);
+            if(saveRawDensePointCloud)
+            {
+                // the SfMData export is not thread safe
+                #pragma omp critical(meshPartitionsSave)
+                exportRawDensePointCloud(*delaunayGC, sfmData, mp, colorizeOutput,
+                                         (outDirectory / ("densePointCloud_raw_partition" + std::to_string(p) + ".abc")).string());
+            }
+            delaunayGC->createGraphCut(partitionHexah, partitionCams, partitionFolder, partitionFolder + "SpaceCamsTracks/", false,
+                                       exportDebugTetrahedralization);
+            delaunayGC->graphCutPostProcessing(partitionHexah, partitionFolder);
+
+            mesh::Mesh* mesh = delaunayGC->createMesh(maxNbConnectedHelperPoints);
+            delaunayGC->createPtsCams(partitionsPtsCams[p]);
+            delaunayGC.reset();
+
+            mesh::meshPostProcessing(mesh, partitionsPtsCams[p], mp, partitionFolder, nullptr, partitionHexah);
+            partitionsMeshes[p] = mesh;
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if(!error)
+                error = std::current_exception();
+            failed = true;
+        }
+    }
+
+    if(error)
+    {
+        for(mesh::Mesh* mesh : partitionsMeshes)
+            delete mesh;
+        std::rethrow_exception(error);
+    }
+
+    // weld the seams vertices closer than half their boundary edges length
+    const double weldDistanceFactor = 0.5;
+    mesh::Mesh* mesh = fuseCut::stitchPartitionsMeshes(partitioning, partitionsMeshes, partitionsPtsCams, weldDistanceFactor, out_ptsCams);
+
+    for(mesh::Mesh* partitionMesh : partitionsMeshes)
+        delete partitionMesh;
+
+    return mesh;
+}
 
 int aliceVision_main(int argc, char* argv[])
 {
@@ -283,6 +445,8 @@ int aliceVision_main(int argc, char* argv[])
     double fullWeight = 1.0;
     bool exportDebugTetrahedralization = false;
     int maxNbConnectedHelperPoints = 50;
+    double partitioningOverlap = 0.1;
+    int partitioningNbParallelPartitions = 1;
 
     po::options_description requiredParams("Required parameters");
     requiredParams.add_options()
@@ -318,6 +482,10 @@ int aliceVision_main(int argc, char* argv[])
             "Partitioning: 'singleBlock' or 'auto'.")
         ("repartition", po::value<ERepartitionMode>(&repartitionMode)->default_value(repartitionMode),
             "Repartition: 'multiResolution' or 'regularGrid'.")
+        ("partitioningOverlap", po::value<double>(&partitioningOverlap)->default_value(partitioningOverlap),
+            "With partitioning 'auto', overlap added on each side of a partition, relative to the partition size.")
+        ("partitioningNbParallelPartitions", po::value<int>(&partitioningNbParallelPartitions)->default_value(partitioningNbParallelPartitions),
+            "With partitioning 'auto', number of partitions meshed in parallel. The memory usage is multiplied accordingly.")
         ("estimateSpaceFromSfM", po::value<bool>(&estimateSpaceFromSfM)->default_value(estimateSpaceFromSfM),
             "Estimate the 3d space from the SfM.")
         ("addLandmarksToTheDensePointCloud", po::value<bool>(&addLandmarksToTheDensePointCloud)->default_value(addLandmarksToTheDensePointCloud),
@@ -349,6 +517,11 @@ int aliceVision_main(int argc, char* argv[])
             "minAngleThreshold")
         ("refineFuse", po::value<bool>(&fuseParams.refineFuse)->default_value(fuseParams.refineFuse),
             "refineFuse")
+        ("streamingFuse", po::value<bool>(&fuseParams.streamingFuse)->default_value(fuseParams.streamingFuse),
+            "Fuse the depth maps points in a voxel hash while loading them, so that the memory only depends on maxPoints "
+            "(maxInputPoints is not used, depth values are loaded with minStep).")
+        ("streamingFuseMaxPointsFactor", po::value<float>(&fuseParams.streamingFuseMaxPointsFactor)->default_value(fuseParams.streamingFuseMaxPointsFactor),
+            "With streamingFuse, maximal number of points kept in memory, relative to maxPoints.")
         ("helperPointsGridSize", po::value<int>(&helperPointsGridSize)->default_value(helperPointsGridSize),
             "Helper points grid size.")
         ("densifyNbFront", po::value<int>(&densifyNbFront)->default_value(densifyNbFront),
@@ -366,7 +539,7 @@ int aliceVision_main(int argc, char* argv[])
         ("fullWeight", po::value<double>(&fullWeight)->default_value(fullWeight),
             "Weighting of the FULL cells.")
         ("saveRawDensePointCloud", po::value<bool>(&saveRawDensePointCloud)->default_value(saveRawDensePointCloud),
-            "Save dense point cloud before cut and filtering.")
+            "Save dense point cloud before cut and filtering. With partitioning 'auto', one file is saved per partition.")
         ("voteFilteringForWeaklySupportedSurfaces", po::value<bool>(&voteFilteringForWeaklySupportedSurfaces)->default_value(voteFilteringForWeaklySupportedSurfaces),
             "Improve support of weakly supported surfaces with a tetrahedra fullness score filtering.")
         ("invertTetrahedronBasedOnNeighborsNbIterations", po::value<int>(&invertTetrahedronBasedOnNeighborsNbIterations)->default_value(invertTetrahedronBasedOnNeighborsNbIterations),
@@ -395,8 +568,7 @@ int aliceVision_main(int argc, char* argv[])
     if(depthMapsFolder.empty())
     {
       if(depthMapsFolder.empty() &&
-         repartitionMode == eRepartitionMultiResolution &&
-         partitioningMode == ePartitioningSingleBlock)
+         repartitionMode == eRepartitionMultiResolution)
       {
         meshingFromDepthMaps = false;
         addLandmarksToTheDensePointCloud = true;
@@ -405,7 +577,7 @@ int aliceVision_main(int argc, char* argv[])
       {
         ALICEVISION_LOG_ERROR("Invalid input options:\n"
                               "- Meshing from depth maps require --depthMapsFolder option.\n"
-                              "- Meshing from SfM require option --partitioning set to 'singleBlock' and option --repartition set to 'multiResolution'.");
+                              "- Meshing from SfM require option --repartition set to 'multiResolution'.");
         return EXIT_FAILURE;
       }
     }
@@ -454,34 +626,40 @@ int aliceVision_main(int argc, char* argv[])
     {
         case eRepartitionMultiResolution:
         {
+            std::array<Point3d, 8> hexah;
+
+            float minPixSize;
+            fuseCut::Fuser fs(mp);
+
+            if (boundingBox.isInitialized())
+                boundingBox.toHexahedron(&hexah[0]);
+            else if(meshingFromDepthMaps && (!estimateSpaceFromSfM || sfmData.getLandmarks().empty()))
+              fs.divideSpaceFromDepthMaps(&hexah[0], minPixSize);
+            else
+              fs.divideSpaceFromSfM(sfmData, &hexah[0], estimateSpaceMinObservations, estimateSpaceMinObservationAngle);
+
+            {
+                const double length = hexah[0].x - hexah[1].x;
+                const double width = hexah[0].y - hexah[3].y;
+                const double height = hexah[0].z - hexah[4].z;
+
+                ALICEVISION_LOG_INFO("bounding Box : length: " << length << ", width: " << width << ", height: " << height);
+            }
+
             switch(partitioningMode)
             {
                 case ePartitioningAuto:
                 {
-                    throw std::invalid_argument("Meshing mode: 'multiResolution', partitioning: 'auto' is not yet implemented.");
+                    ALICEVISION_LOG_INFO("Meshing mode: multi-resolution, partitioning: auto.");
+                    mesh = meshPartitions(mp, &hexah[0], sfmData, addLandmarksToTheDensePointCloud, meshingFromDepthMaps, fuseParams,
+                                          partitioningOverlap, partitioningNbParallelPartitions, maxNbConnectedHelperPoints,
+                                          exportDebugTetrahedralization, saveRawDensePointCloud, colorizeOutput, outDirectory,
+                                          tmpDirectory, ptsCams);
+                    break;
                 }
                 case ePartitioningSingleBlock:
                 {
                     ALICEVISION_LOG_INFO("Meshing mode: multi-resolution, partitioning: single block.");
-                    std::array<Point3d, 8> hexah;
-
-                    float minPixSize;
-                    fuseCut::Fuser fs(mp);
-
-                    if (boundingBox.isInitialized())
-                        boundingBox.toHexahedron(&hexah[0]);
-                    else if(meshingFromDepthMaps && (!estimateSpaceFromSfM || sfmData.getLandmarks().empty()))
-                      fs.divideSpaceFromDepthMaps(&hexah[0], minPixSize);
-                    else
-                      fs.divideSpaceFromSfM(sfmData, &hexah[0], estimateSpaceMinObservations, estimateSpaceMinObservationAngle);
-
-                    {
-                        const double length = hexah[0].x - hexah[1].x;
-                        const double width = hexah[0].y - hexah[3].y;
-                        const double height = hexah[0].z - hexah[4].z;
-
-                        ALICEVISION_LOG_INFO("bounding Box : length: " << length << ", width: " << width << ", height: " << height);
-                    }
 
                     StaticVector<int> cams;
                     if(meshingFromDepthMaps)
@@ -501,17 +679,7 @@ int aliceVision_main(int argc, char* argv[])
                     fuseCut::DelaunayGraphCut delaunayGC(mp);
                     delaunayGC.createDensePointCloud(&hexah[0], cams, addLandmarksToTheDensePointCloud ? &sfmData : nullptr, meshingFromDepthMaps ? &fuseParams : nullptr);
                     if(saveRawDensePointCloud)
-                    {
-                      ALICEVISION_LOG_INFO("Save dense point cloud before cut and filtering.");
-                      StaticVector<StaticVector<int>> ptsCams;
-                      delaunayGC.createPtsCams(ptsCams);
-                      sfmData::SfMData densePointCloud;
-                      createDenseSfMData(sfmData, mp, delaunayGC._verticesCoords, ptsCams, densePointCloud);
-                      removeLandmarksWithoutObservations(densePointCloud);
-                      if(colorizeOutput)
-                        sfmData::colorizeTracks(densePointCloud);
-                      sfmDataIO::Save(densePointCloud, (outDirectory/"densePointCloud_raw.abc").string(), sfmDataIO::ESfMData::ALL_DENSE);
-                    }
+                      exportRawDensePointCloud(delaunayGC, sfmData, mp, colorizeOutput, (outDirectory/"densePointCloud_raw.abc").string());
 
                     delaunayGC.createGraphCut(&hexah[0], cams, outDirectory.string() + "/",
                                               outDirectory.string() + "/SpaceCamsTracks/", false,
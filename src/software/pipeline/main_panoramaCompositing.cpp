@@ -124,8 +124,64 @@ std::unique_ptr<PanoramaMap> buildMap(const sfmData::SfMData& sfmData, const std
     return ret;
 }
 
+/**
+ * @brief Estimate the memory used by processImage for a given reference bounding box
+ * @note This is a per pixel cost multiplied by the area of the reference bounding box dilated by the
+ *       panorama border (the area processed by the multiband compositer, an upper bound for the others),
+ *       plus the full size warped inputs of the largest overlapping view, which processImage loads entirely.
+ *       It does not account for the additional views listed in the visibility map.
+ * @param referenceBoundingBox the output region
+ * @param panoramaMap the map of inputs
+ * @param compositerType the compositer type
+ * @return a memory size in bytes
+ */
+size_t estimateRegionMemory(const PanoramaMap& panoramaMap, const std::string& compositerType,
+                            const BoundingBox& referenceBoundingBox)
+{
+    const BoundingBox panoramaBoundingBox = referenceBoundingBox.divide(panoramaMap.getScale())
+                                                .dilate(panoramaMap.getBorderSize())
+                                                .multiply(panoramaMap.getScale());
+    const size_t area = size_t(panoramaBoundingBox.width) * size_t(panoramaBoundingBox.height);
+
+    // Output image, visibility map (list header and a single view) and seams labels
+    size_t pixelSize = sizeof(image::RGBAfColor) + sizeof(std::vector<IndexT>) + 2 * sizeof(IndexT);
+
+    if(compositerType == "multiband")
+    {
+        // Color and weights laplacian pyramids (geometric series bounded by twice the first level)
+        pixelSize += 2 * (sizeof(image::RGBfColor) + sizeof(float));
+    }
+
+    // One input image cropped to an intersection: color, mask and seams weights
+    pixelSize += sizeof(image::RGBfColor) + sizeof(unsigned char) + sizeof(float);
+
+    // The inputs are loaded at full size: color and mask, and for the alpha compositer
+    // the weights and their copy for each intersection
+    size_t inputPixelSize = sizeof(image::RGBfColor) + sizeof(unsigned char);
+    if(compositerType == "alpha")
+    {
+        inputPixelSize += 2 * sizeof(float);
+    }
+
+    size_t inputMaxArea = 0;
+    std::vector<IndexT> overlappingViews;
+    if(panoramaMap.getOverlaps(overlappingViews, referenceBoundingBox))
+    {
+        for(IndexT viewCurrent : overlappingViews)
+        {
+            BoundingBox bbox;
+            if(panoramaMap.getBoundingBox(bbox, viewCurrent))
+            {
+                inputMaxArea = std::max(inputMaxArea, size_t(bbox.width) * size_t(bbox.height));
+            }
+        }
+    }
+
+    return area * pixelSize + inputMaxArea * inputPixelSize;
+}
+
 bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmData, const std::string& compositerType,
-                  const std::string& warpingFolder, const std::string& labelsFilePath, const std::string& outputFolder,
+                  const std::string& warpingFolder, const image::Image<IndexT>& panoramaLabels, const std::string& outputFolder,
                   const image::EStorageDataType& storageDataType, IndexT viewReference,
                   const BoundingBox& referenceBoundingBox, bool showBorders, bool showSeams)
 {
@@ -251,9 +307,6 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
     image::Image<IndexT> referenceLabels;
     if(needSeams)
     {
-        image::Image<IndexT> panoramaLabels;
-        image::readImageDirect(labelsFilePath, panoramaLabels);
-
         const double scaleX = double(panoramaLabels.Width()) / double(panoramaMap.getWidth());
         const double scaleY = double(panoramaLabels.Height()) / double(panoramaMap.getHeight());
 
@@ -409,6 +462,28 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
         }
 
         ALICEVISION_LOG_TRACE("Effective processing");
+
+        // Load the input once for all its intersections with the reference view
+        const std::string imagePath = (fs::path(warpingFolder) / (warpedPath + ".exr")).string();
+        ALICEVISION_LOG_TRACE("Load image with path " << imagePath);
+        image::Image<image::RGBfColor> source;
+        image::readImage(imagePath, source, image::EImageColorSpace::NO_CONVERSION);
+
+        // Load mask
+        const std::string maskPath = (fs::path(warpingFolder) / (warpedPath + "_mask.exr")).string();
+        ALICEVISION_LOG_TRACE("Load mask with path " << maskPath);
+        image::Image<unsigned char> mask;
+        image::readImageDirect(maskPath, mask);
+
+        // Load weights image if needed
+        image::Image<float> inputWeights;
+        if(needWeights)
+        {
+            const std::string weightsPath = (fs::path(warpingFolder) / (warpedPath + "_weight.exr")).string();
+            ALICEVISION_LOG_TRACE("Load weights with path " << weightsPath);
+            image::readImage(weightsPath, inputWeights, image::EImageColorSpace::NO_CONVERSION);
+        }
+
         for(int indexIntersection = 0; indexIntersection < intersections.size(); indexIntersection++)
         {
             if(hasFailed)
@@ -419,25 +494,10 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
             const BoundingBox& bbox = currentBoundingBoxes[indexIntersection];
             const BoundingBox& bboxIntersect = intersections[indexIntersection];
 
-            // Load image
-            const std::string imagePath = (fs::path(warpingFolder) / (warpedPath + ".exr")).string();
-            ALICEVISION_LOG_TRACE("Load image with path " << imagePath);
-            image::Image<image::RGBfColor> source;
-            image::readImage(imagePath, source, image::EImageColorSpace::NO_CONVERSION);
-
-            // Load mask
-            const std::string maskPath = (fs::path(warpingFolder) / (warpedPath + "_mask.exr")).string();
-            ALICEVISION_LOG_TRACE("Load mask with path " << maskPath);
-            image::Image<unsigned char> mask;
-            image::readImageDirect(maskPath, mask);
-
-            // Load weights image if needed
             image::Image<float> weights;
             if(needWeights)
             {
-                const std::string weightsPath = (fs::path(warpingFolder) / (warpedPath + "_weight.exr")).string();
-                ALICEVISION_LOG_TRACE("Load weights with path " << weightsPath);
-                image::readImage(weightsPath, weights, image::EImageColorSpace::NO_CONVERSION);
+                weights = inputWeights;
             }
 
             if(needSeams)
@@ -470,9 +530,6 @@ bool processImage(const PanoramaMap& panoramaMap, const sfmData::SfMData& sfmDat
                 source.block(cutBoundingBox.top, cutBoundingBox.left, cutBoundingBox.height, cutBoundingBox.width);
             submask = mask.block(cutBoundingBox.top, cutBoundingBox.left, cutBoundingBox.height, cutBoundingBox.width);
 
-            source = image::Image<image::RGBfColor>();
-            mask = image::Image<unsigned char>();
-
             if(!compositer->append(subsource, submask, weights,
                                    referenceBoundingBox.left - panoramaBoundingBox.left + bboxIntersect.left -
                                        referenceBoundingBox.left,
@@ -741,15 +798,10 @@ int aliceVision_main(int argc, char** argv)
         return EXIT_SUCCESS;
     }
 
-    const std::vector<IndexT>& chunk = chunks[rangeIteration];
-
-    bool succeeded = true;
-
-    for(std::size_t posReference = 0; posReference < chunk.size(); posReference++)
+    // Collect the output regions of this chunk
+    std::vector<std::pair<IndexT, BoundingBox>> regions;
+    for(const IndexT viewReference : chunks[rangeIteration])
     {
-        ALICEVISION_LOG_INFO("processing input region " << posReference + 1 << "/" << chunk.size());
-
-        const IndexT viewReference = chunk[posReference];
         if(!sfmData.isPoseAndIntrinsicDefined(viewReference))
             continue;
 
@@ -760,9 +812,61 @@ int aliceVision_main(int argc, char** argv)
             return EXIT_FAILURE;
         }
 
-        if(!processImage(*panoramaMap, sfmData, compositerType, warpingFolder, labelsFilepath, outputFolder,
+        regions.emplace_back(viewReference, referenceBoundingBox);
+    }
+
+    // Largest regions first, to balance the load between threads
+    std::sort(regions.begin(), regions.end(),
+              [](const std::pair<IndexT, BoundingBox>& a, const std::pair<IndexT, BoundingBox>& b) {
+                  return size_t(a.second.width) * size_t(a.second.height) >
+                         size_t(b.second.width) * size_t(b.second.height);
+              });
+
+    // The seams labels are shared by all regions
+    image::Image<IndexT> panoramaLabels;
+    if(compositerType == "multiband")
+    {
+        image::readImageDirect(labelsFilepath, panoramaLabels);
+    }
+
+    // How many regions can be composited simultaneously without swapping
+    std::size_t regionMaxMemoryConsumption = 0;
+    for(const auto& region : regions)
+    {
+        regionMaxMemoryConsumption = std::max(regionMaxMemoryConsumption,
+                                              estimateRegionMemory(*panoramaMap, compositerType, region.second));
+    }
+
+    const system::MemoryInfo memoryInformation = system::getMemoryInfo();
+    const std::size_t maxMemory = std::min(memoryInformation.availableRam, hwc.getUserMaxMemoryAvailable());
+    const std::size_t labelsMemory = std::size_t(panoramaLabels.Width()) * std::size_t(panoramaLabels.Height()) * sizeof(IndexT);
+    const std::size_t memoryAvailable = (maxMemory > labelsMemory) ? maxMemory - labelsMemory : 0;
+
+    std::size_t nbThreads = 1;
+    if(regionMaxMemoryConsumption > 0)
+    {
+        nbThreads = std::max(std::size_t(1), std::size_t((0.9 * memoryAvailable) / regionMaxMemoryConsumption));
+    }
+    nbThreads = std::min(static_cast<std::size_t>(hwc.getMaxThreads()), nbThreads);
+    nbThreads = std::max(std::size_t(1), std::min(regions.size(), nbThreads));
+
+    ALICEVISION_LOG_INFO("Region max memory consumption: " << regionMaxMemoryConsumption / (1024 * 1024) << " MB");
+    ALICEVISION_LOG_INFO("# regions composited in parallel: " << nbThreads);
+
+    bool succeeded = true;
+
+#pragma omp parallel for num_threads(nbThreads) schedule(dynamic)
+    for(int posReference = 0; posReference < regions.size(); posReference++)
+    {
+        ALICEVISION_LOG_INFO("processing input region " << posReference + 1 << "/" << regions.size());
+
+        const IndexT viewReference = regions[posReference].first;
+        const BoundingBox& referenceBoundingBox = regions[posReference].second;
+
+        if(!processImage(*panoramaMap, sfmData, compositerType, warpingFolder, panoramaLabels, outputFolder,
                          storageDataType, viewReference, referenceBoundingBox, showBorders, showSeams))
         {
+#pragma omp critical
             succeeded = false;
             continue;
         }
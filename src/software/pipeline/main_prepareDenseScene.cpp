@@ -42,7 +42,7 @@ namespace po = boost::program_options;
 namespace fs = boost::filesystem;
 
 template <class ImageT, class MaskFuncT>
-void process(const std::string &dstColorImage, const IntrinsicBase* cam, const oiio::ParamValueList & metadata, const std::string & srcImage, bool evCorrection, float exposureCompensation, MaskFuncT && maskFunc)
+void process(const std::string &dstColorImage, const IntrinsicBase* cam, camera::UndistortionMapCache& undistortionMaps, const oiio::ParamValueList & metadata, const std::string & srcImage, bool evCorrection, float exposureCompensation, MaskFuncT && maskFunc)
 {
   ImageT image, image_ud;
   readImage(srcImage, image, image::EImageColorSpace::LINEAR);
@@ -65,7 +65,7 @@ void process(const std::string &dstColorImage, const IntrinsicBase* cam, const o
     // undistort the image and save it
     using Pix = typename ImageT::Tpixel;
     Pix pixZero(Pix::Zero());
-    UndistortImage(image, cam, image_ud, pixZero);
+    UndistortImage(image, cam, undistortionMaps, image_ud, pixZero);
     writeImage(dstColorImage, image_ud, image::ImageWriteOptions(), metadata);
   }
   else
@@ -120,6 +120,9 @@ bool prepareDenseScene(const SfMData& sfmData,
   const double medianCameraExposure = sfmData.getMedianCameraExposureSetting().getExposure();
   ALICEVISION_LOG_INFO("Median Camera Exposure: " << medianCameraExposure << ", Median EV: " << std::log2(1.0/medianCameraExposure));
 
+  // views sharing an intrinsic reuse the same undistortion map
+  camera::UndistortionMapCache undistortionMaps;
+
 #pragma omp parallel for num_threads(3)
   for(int i = 0; i < viewIds.size(); ++i)
   {
@@ -246,7 +249,7 @@ bool prepareDenseScene(const SfMData& sfmData,
       image::Image<unsigned char> mask;
       if(tryLoadMask(&mask, masksFolders, viewId, srcImage))
       {
-        process<Image<RGBAfColor>>(dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, [&mask] (Image<RGBAfColor> & image)
+        process<Image<RGBAfColor>>(dstColorImage, cam, undistortionMaps, metadata, srcImage, evCorrection, exposureCompensation, [&mask] (Image<RGBAfColor> & image)
         {
           if(image.Width() * image.Height() != mask.Width() * mask.Height())
           {
@@ -264,7 +267,7 @@ bool prepareDenseScene(const SfMData& sfmData,
       else
       {
         const auto noMaskingFunc = [] (Image<RGBAfColor> & image) {};
-        process<Image<RGBAfColor>>(dstColorImage, cam, metadata, srcImage, evCorrection, exposureCompensation, noMaskingFunc);
+        process<Image<RGBAfColor>>(dstColorImage, cam, undistortionMaps, metadata, srcImage, evCorrection, exposureCompensation, noMaskingFunc);
       }
     }
 